@@ -19,6 +19,7 @@
 #include "MotorDriver.h"
 
 uint8_t flex_sensor_data[4];
+uint8_t flex_sensor_range[4];
 int8_t motor_out[2];
 
 /******************************************************************
@@ -173,53 +174,12 @@ void ledOFF(int LED_number)
 	}
 }
 
-/******************************************************************
- * This routine defines the prescaler for LETIMER
- *
- * Input: None
- *
- * Global variables used:  LFXOfreq, exciteOff
- *
- * Return: LETIMER0_prescaler
- ******************************************************************/
-int prescaler(void)
-{
-	blockSleepMode(energyMode);
-	int LETIMER0_prescaler;
-	if(energyMode != 3)
-	{
-		int Desired_Period = LFXOfreq*exciteOff;
-		LETIMER0_prescaler = 0;
-		int temp = Desired_Period;
-		int Prescaled_two_power = 1;
-		while (temp > LETIMER0_Max_Count)
-		{
-			LETIMER0_prescaler++;
-			Prescaled_two_power = Prescaled_two_power* 2;
-			temp = Desired_Period/ Prescaled_two_power;
-		}
-	}
-	else
-	{
-		LETIMER0_prescaler = 1;
-	}
-	unblockSleepMode(energyMode);
-	return LETIMER0_prescaler;
-}
-
-
 void LETIMERsetup()
 {
 	blockSleepMode(2); 							//EM3 if ULFRCO(1kHz) is used
-	int value0 = 0;
-	int value1 = 0;
-	int val = prescaler();
-	int temp = val;
-	while(temp!=1)
-	{
-		temp--;
-		val=val*2;
-	}
+
+	/* LETIMERComp0/LETIMERComp1 are in ticks of the prescaled clock */
+	CMU_ClockDivSet(cmuClock_LETIMER0, (CMU_ClkDiv_TypeDef)(1 << LETIMERPrescaler));
 
 	//Initializing the LETIMER
 	if(flag == 0)
@@ -266,21 +226,8 @@ void LETIMERsetup()
 	}
 
 
-	if((energyMode == 0 )|(  energyMode == 1 )|( energyMode == 2))
-	{
-		value0 = ((float)LFXOfreq/(float)val)*((float)exciteOff);
-		value1 = ((float)LFXOfreq/(float)val)*((float)exciteOn);
-
-	}
-	else //energyMode == 3
-	{
-		value0 = ((float)ULFRCOfreq)*((float)exciteOff);
-		value1 = ((float)ULFRCOfreq)*((float)exciteOn);
-	}
-
-
-	LETIMER_CompareSet(LETIMER0, 0, value0); //4ms -> (32768/2)*4/1000 = 65.536
-	LETIMER_CompareSet(LETIMER0, 1, value1);//2.5seconds -> (32768/2)*2.5 = 40910
+	LETIMER_CompareSet(LETIMER0, 0, LETIMERComp0); //40ms -> 32768*40/1000 = 1310
+	LETIMER_CompareSet(LETIMER0, 1, LETIMERComp1); //1.5seconds -> 32768*1500/1000 = 49152
 
 	while(LETIMER0->SYNCBUSY == 1);
 	if(flag ==0)
@@ -385,10 +332,11 @@ void ULFRCOCalibrate(void)
 	return;
 }
 
-void parse_flex_sensor_data(uint32_t value)
+bool parse_flex_sensor_data(uint32_t value)
 {
 	uint8_t idx;
 	int i, j;
+	bool moved = false;
 
 	for(i = 24; i >= 0; i -= 8)
 	{
@@ -408,7 +356,16 @@ void parse_flex_sensor_data(uint32_t value)
 			flex_sensor_data[j] = 1;
 		else
 			flex_sensor_data[j] = 0;
+
+		/* Any joint leaving its previous range counts as motion */
+		if (flex_sensor_data[j] != flex_sensor_range[j])
+		{
+			flex_sensor_range[j] = flex_sensor_data[j];
+			moved = true;
+		}
 	}
+
+	return moved;
 }
 
 void timerSetup(uint32_t topVal)
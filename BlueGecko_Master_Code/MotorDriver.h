@@ -10,6 +10,7 @@
 
 #include "stdio.h"
 #include "stdint.h"
+#include "stdbool.h"
 
 #define EM0								0
 #define EM1								1
@@ -20,9 +21,36 @@
 #define selfcalibrate 					0
 #define LFXOfreq 						32768
 #define ULFRCOfreq 						1000
-#define exciteOff 						0.04
-#define exciteOn 						1.5
-#define LETIMER0_Max_Count 				65536
+#define exciteOffMs 					40						/*COMP0 period in ms*/
+#define exciteOnMs 						1500					/*COMP1 period in ms*/
+#define LETIMER0_Max_Count 				65535					/*Largest value COMP0/COMP1 can hold*/
+
+/*LETIMER ticks in periodMs with freq divided by 2^prescale, resolved at compile time*/
+#define periodToTicks(freq, prescale, periodMs)	((((freq) >> (prescale)) * (periodMs)) / 1000)
+#define periodFits(freq, prescale, periodMs)	(periodToTicks(freq, prescale, periodMs) <= LETIMER0_Max_Count)
+#define prescalerFor(freq, periodMs)			(periodFits(freq, 0, periodMs) ? 0 : periodFits(freq, 1, periodMs) ? 1 : \
+												 periodFits(freq, 2, periodMs) ? 2 : periodFits(freq, 3, periodMs) ? 3 : \
+												 periodFits(freq, 4, periodMs) ? 4 : periodFits(freq, 5, periodMs) ? 5 : \
+												 periodFits(freq, 6, periodMs) ? 6 : periodFits(freq, 7, periodMs) ? 7 : 8)
+
+/*LETIMER timing for the selected energy mode: LFXO for EM0-EM2, ULFRCO for EM3*/
+#if energyMode < EM3
+#define LETIMERFreq						LFXOfreq
+#else
+#define LETIMERFreq						ULFRCOfreq
+#endif
+#define LETIMERPrescaler				prescalerFor(LETIMERFreq, exciteOnMs)
+#define LETIMERComp0					periodToTicks(LETIMERFreq, LETIMERPrescaler, exciteOffMs)
+#define LETIMERComp1					periodToTicks(LETIMERFreq, LETIMERPrescaler, exciteOnMs)
+
+#if LETIMERPrescaler > 7
+#error "exciteOnMs cannot be represented by the 16 bit LETIMER0"
+#endif
+
+#if LETIMERComp0 == 0
+#error "exciteOffMs is shorter than one LETIMER0 tick"
+#endif
+
 float LFAselfcal;
 int flag;
 static int sleep_block_counter[4] 		= {0,0,0,0};
@@ -36,7 +64,7 @@ static int sleep_block_counter[4] 		= {0,0,0,0};
 #define Motor1Pin0						2						/*Positive of Motor1*/
 #define Motor1Pin1						3						/*Negative of Motor1*/
 
-void parse_flex_sensor_data(uint32_t value);
+bool parse_flex_sensor_data(uint32_t value);
 
 void motor_control(void);
 
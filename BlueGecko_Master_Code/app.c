@@ -42,6 +42,10 @@
 /* Own header */
 #include "app.h"
 #include "MotorDriver.h"
+#include "conn_params.h"
+#include "reconnect.h"
+#include "gatt_cache.h"
+#include "role_sched.h"
 
 bd_addr slave_bluetooth_addr;
 uint8_t slave_bluetooth_addr_type = 0;
@@ -58,8 +62,6 @@ uint8array temp_service_uuid;
 uint8array temp_char_uuid;
 uint8array env_service_uuid;
 uint8array humidity_char_uuid;
-uint8_t slave_addr_to_match[] = {0x00, 0x0B, 0x57, 0x05, 0xE0, 0xD7};
-bool slave_addr_match = false;
 
 device_role e_dev_role = DEVICE_ROLE_INVALID;
 
@@ -96,7 +98,6 @@ uint8 temp_rcvd_data[20];
 
 #if defined(ENABLE_MASTER_ROLE) && defined(ENABLE_SLAVE_ROLE)
 #define ENABLE_PERIODIC_ROLE_REVERSAL
-#define DEV_SLAVE_PERIOD	327680*2			/* Defines the period for which the blue gecko remains in master/slave mode */
 #endif
 
 #if defined(MEASURE_TEMPERATURE)
@@ -122,6 +123,8 @@ bool device_is_slave = false;
 bool slave_initialized = false;
 bool master_initialized = false;
 int gatt_proc_completed_res = -1;
+/* Handles of the slave came from the GATT cache, not from discovery */
+bool slave_handles_cached = false;
 
 /***********************************************************************************************//**
  * @addtogroup Application
@@ -277,6 +280,209 @@ void manage_master_slave_role_led(void)
 }
 #endif
 
+#ifdef MEASURE_TEMPERATURE
+/***********************************************************************************************//**
+ * \brief Function that handles one joint word received from the slave
+ **************************************************************************************************/
+static void process_joint_data(uint32_t joints)
+{
+#ifdef READ_FLEX_SENSOR_DATA
+	if (parse_flex_sensor_data(joints))
+	{
+		/* Joints are moving, shorten the connection interval */
+		connParamsMotion();
+	}
+	motor_control();
+#endif
+}
+
+/***********************************************************************************************//**
+ * \brief Function that unpacks a temperature measurement notification, either a batch of
+ *        joint samples or a single measurement
+ **************************************************************************************************/
+static void process_temp_notification(uint8 *p_data, uint8 len)
+{
+	uint8 count;
+
+	if ((len >= HTM_JOINT_BATCH_HDR_LEN) && (p_data[0] & HTM_FLAG_JOINT_BATCH))
+	{
+		/* A truncated notification only gives the samples it holds */
+		count = p_data[1];
+		if (count > (len - HTM_JOINT_BATCH_HDR_LEN) / HTM_JOINT_SAMPLE_LEN)
+		{
+			count = (len - HTM_JOINT_BATCH_HDR_LEN) / HTM_JOINT_SAMPLE_LEN;
+		}
+
+		/* Samples are oldest first, each a 16 bit timestamp and the joint word */
+		for (p_data += HTM_JOINT_BATCH_HDR_LEN; count != 0; count--, p_data += HTM_JOINT_SAMPLE_LEN)
+		{
+			process_joint_data((uint32_t)p_data[2] | (uint32_t)p_data[3] << 8 |
+					(uint32_t)p_data[4] << 16 | (uint32_t)p_data[5] << 24);
+		}
+	}
+	else if (len >= 5)
+	{
+		memcpy(temp_rcvd_data, p_data, (len < sizeof(temp_rcvd_data)) ? len : sizeof(temp_rcvd_data));
+		process_joint_data((uint32_t)temp_rcvd_data[4] << 24 | (uint32_t)temp_rcvd_data[3] << 16 |
+				(uint32_t)temp_rcvd_data[2] << 8 | temp_rcvd_data[1]);
+	}
+}
+#endif
+
+#ifdef ENABLE_MASTER_ROLE
+/***********************************************************************************************//**
+ * \brief Function that starts the discovery of the services of the slave
+ **************************************************************************************************/
+static void discover_slave_services(uint8 conn)
+{
+	slave_handles_cached = false;
+
+	/* Discover all the primary services defined in the
+	 * GATT database for the slave identified by the
+	 * newly acquired connection handle */
+
+#ifdef MEASURE_TEMPERATURE
+	slave_temp_service_handle = 0;
+	slave_temp_characteristic_handle = 0;
+
+	/* Discover temperature measurement service -
+	 * with temperature value and type as characteristic */
+	temp_service_uuid.len = 2;
+	temp_service_uuid.data[0] = 0x09;
+	temp_service_uuid.data[1] = 0x18;
+
+	gecko_cmd_gatt_discover_primary_services_by_uuid(conn, temp_service_uuid.len, temp_service_uuid.data);
+#endif
+
+#ifdef MEASURE_HUMIDITY
+	slave_humid_service_handle = 0;
+	slave_humid_characteristic_handle = 0;
+
+	/* Discover environmental sensing service - with humidity info as characteristic */
+	env_service_uuid.len = 2;
+	env_service_uuid.data[0] = 0x1A;
+	env_service_uuid.data[1] = 0x18;
+
+	gecko_cmd_gatt_discover_primary_services_by_uuid(conn, env_service_uuid.len, env_service_uuid.data);
+#endif
+
+	state = eStateFindService;
+}
+
+/***********************************************************************************************//**
+ * \brief Function that enables the humidity notifications, with the discovered or cached handle
+ * @return true if the GATT procedure was started
+ **************************************************************************************************/
+static bool enable_slave_humid(uint8 conn)
+{
+#ifdef MEASURE_HUMIDITY
+	if (slave_humid_characteristic_handle > 0)
+	{
+		/* The slave sends the current humidity on subscription, then every change */
+		struct gecko_msg_gatt_set_characteristic_notification_rsp_t* humid_set_notif_rsp =
+				gecko_cmd_gatt_set_characteristic_notification(conn,
+						slave_humid_characteristic_handle, gatt_notification);
+
+		if (humid_set_notif_rsp->result == 0)
+		{
+			state = eStateEnableHumidNotif;
+			return true;
+		}
+	}
+#endif
+
+	return false;
+}
+
+/***********************************************************************************************//**
+ * \brief Function that enables the temperature and humidity notifications,
+ *        with the discovered or cached characteristic handles. Only one GATT procedure may run
+ *        at a time, so the humidity one is started when the temperature one has completed.
+ * @return true if a GATT procedure was started
+ **************************************************************************************************/
+static bool enable_slave_data(uint8 conn)
+{
+#ifdef MEASURE_TEMPERATURE
+	if (slave_temp_characteristic_handle > 0)
+	{
+		struct gecko_msg_gatt_set_characteristic_notification_rsp_t* temp_set_notif_rsp =
+				gecko_cmd_gatt_set_characteristic_notification(conn,
+						slave_temp_characteristic_handle, gatt_notification);
+
+		if (temp_set_notif_rsp->result == 0)
+		{
+			state = eStateEnableNotif;
+			return true;
+		}
+	}
+#endif
+
+	return enable_slave_humid(conn);
+}
+
+/***********************************************************************************************//**
+ * \brief Function that stores the handles the slave accepted, to skip the discovery next time
+ **************************************************************************************************/
+static void store_slave_handles(void)
+{
+	gattCacheEntry_t entry;
+
+	memcpy(entry.address.addr, slave_bluetooth_addr.addr, sizeof(bd_addr));
+#ifdef MEASURE_TEMPERATURE
+	entry.tempCharacteristic = slave_temp_characteristic_handle;
+#else
+	entry.tempCharacteristic = 0;
+#endif
+#ifdef MEASURE_HUMIDITY
+	entry.humidCharacteristic = slave_humid_characteristic_handle;
+#else
+	entry.humidCharacteristic = 0;
+#endif
+	gattCacheStore(&entry);
+}
+
+/***********************************************************************************************//**
+ * \brief Function that subscribes to a slave seen before, with the handles from the GATT cache
+ * @return true if the slave is in the cache and the subscription was started
+ **************************************************************************************************/
+static bool enable_slave_data_cached(uint8 conn, bd_addr address)
+{
+	gattCacheEntry_t entry;
+
+	if (!gattCacheLookup(address, &entry))
+	{
+		return false;
+	}
+
+#ifdef MEASURE_TEMPERATURE
+	slave_temp_characteristic_handle = entry.tempCharacteristic;
+#endif
+#ifdef MEASURE_HUMIDITY
+	slave_humid_characteristic_handle = entry.humidCharacteristic;
+#endif
+	slave_handles_cached = true;
+
+	if (!enable_slave_data(conn))
+	{
+		/* The stack refused the handles, they are stale */
+		gattCacheForget(address);
+		return false;
+	}
+
+	return true;
+}
+#endif
+
+#ifdef ENABLE_PERIODIC_ROLE_REVERSAL
+/***********************************************************************************************//**
+ * \brief Function that makes the device role, and the role LED, follow the role scheduler
+ **************************************************************************************************/
+static void update_dev_role(void)
+{
+	e_dev_role = (roleSchedGetRole() == ROLE_SCHED_SCAN) ? DEVICE_ROLE_MASTER : DEVICE_ROLE_SLAVE;
+}
+#endif
+
 /***********************************************************************************************//**
  * \brief Event handler function
  * @param[in] evt Event pointer
@@ -321,10 +527,6 @@ void appHandleEvents(struct gecko_cmd_packet *evt)
 		gecko_cmd_hardware_set_soft_timer(32768, MASTER_ROLE_TIMER, false);
 #endif
 
-#ifdef ENABLE_PERIODIC_ROLE_REVERSAL
-		gecko_cmd_hardware_set_soft_timer(49152, MASTER_SLAVE_RR_TIMER, true); /* Timer will expire in 1.5 seconds */
-#endif
-
 #ifdef ENABLE_SLAVE_ROLE
 		/* LED0 - Power LED */
 		GPIO_PinModeSet(gpioPortF, 4, gpioModePushPull, 0);
@@ -335,19 +537,25 @@ void appHandleEvents(struct gecko_cmd_packet *evt)
 		GPIO_PinModeSet(gpioPortF, 5, gpioModePushPull, 0);
 #endif
 
-		/* For the first 1.5 seconds, the device will be in master mode and
-		 * and will scan for advertising packets from any slave */
+#ifdef MEASURE_TEMPERATURE
+		/* Ask for a larger ATT MTU, the slave packs several joint samples per notification */
+		gecko_cmd_gatt_set_max_mtu(HTM_MAX_MTU);
+#endif
 
-		/* start the GAP discovery procedure to scan for advertising devices */
-		/* Configure the scanning parameters */
-		/* scan_interval - 800
-		 * scan_window - 800
-		 * passive scan mode */
-		gecko_cmd_le_gap_set_scan_parameters(100, 100, 1);
+#ifdef ENABLE_MASTER_ROLE
+		/* Handles of the gloves connected to before the reset */
+		gattCacheInit();
+#endif
 
-		/* Start the GAP discovery */
-		gecko_cmd_le_gap_discover(le_gap_general_discoverable); /* Discover using general discoverable mode */
-		//gecko_cmd_le_gap_discover(le_gap_discover_limited); /* Discover only limited devices */
+#ifdef ENABLE_PERIODIC_ROLE_REVERSAL
+		/* Look for the glove first, then take turns with advertising.
+		 * The turns get shorter while nobody is found. */
+		roleSchedStart();
+		update_dev_role();
+#elif defined(ENABLE_MASTER_ROLE)
+		/* Start the GAP discovery, the scan slows down if the glove is not found */
+		reconnectStart();
+#endif
 		state = eStateScanning;
 		/* TODO: Try adding a sleep here just to have a slight delay for the discovery */
 		gecko_sleep_for_ms(100);
@@ -365,7 +573,6 @@ void appHandleEvents(struct gecko_cmd_packet *evt)
 		/* This event is triggered in response to gecko_cmd_le_gap_discover command */
 		/* It reports any advertisement or scan response packet
 		 * that is received by the device's radio while in scanning mode */
-		/* TODO: Can add a check for bluetooth MAC address to identify the correct slave device */
 
 #if 0
 		sprintf((char *)temp_service_uuid_string, "%02x%02x", temp_service_uuid[0], temp_service_uuid[1]);
@@ -394,22 +601,16 @@ void appHandleEvents(struct gecko_cmd_packet *evt)
 				gecko_cmd_le_gap_open(slave_bluetooth_addr, slave_bluetooth_addr_type);
 			}
 #else
-			/* Device is set in active scan mode, so checking for scan response */
-			//if (evt->data.evt_le_gap_scan_response.packet_type == 0x04 && state != eStateFindService)
-			if (evt->data.evt_le_gap_scan_response.packet_type == 0x04)
+			/* Only the glove connected to before, or one advertising the thermometer service,
+			 * is connected to. The connection is opened on its advertisement. */
+			if (reconnectScanResponse(&evt->data.evt_le_gap_scan_response))
 			{
 				state = eStateScanning;
-				if (NULL != slave_bluetooth_addr.addr
-						&& NULL != evt->data.evt_le_gap_scan_response.address.addr)
-				{
-					memcpy(slave_bluetooth_addr.addr, evt->data.evt_le_gap_scan_response.address.addr, sizeof(bd_addr));
-					//format_bluetooth_address(slave_bluetooth_addr.addr, slave_bluetooth_addr.addr);
-				}
-
-				gecko_cmd_le_gap_end_procedure();
-
+				memcpy(slave_bluetooth_addr.addr, evt->data.evt_le_gap_scan_response.address.addr, sizeof(bd_addr));
 				slave_bluetooth_addr_type = evt->data.evt_le_gap_scan_response.address_type;
-				gecko_cmd_le_gap_open(slave_bluetooth_addr, slave_bluetooth_addr_type);
+#ifdef ENABLE_PERIODIC_ROLE_REVERSAL
+				roleSchedFound();
+#endif
 			}
 #endif
 			break;
@@ -434,6 +635,12 @@ void appHandleEvents(struct gecko_cmd_packet *evt)
 			device_is_slave = false;
 		}
 
+#ifdef ENABLE_PERIODIC_ROLE_REVERSAL
+		/* Stay in the role of the connection until it closes */
+		roleSchedOpened(device_is_slave);
+		update_dev_role();
+#endif
+
 		if (e_dev_role == DEVICE_ROLE_SLAVE)
 		{
 #ifdef ENABLE_SLAVE_ROLE
@@ -459,38 +666,21 @@ void appHandleEvents(struct gecko_cmd_packet *evt)
 				{
 					slave_conn_handle = evt->data.evt_le_connection_opened.connection;
 
-					/* Discover all the primary services defined in the
-					 * GATT database for the slave identified by the
-					 * newly acquired connection handle */
-
-#ifdef MEASURE_TEMPERATURE
-					/* Discover temperature measurement service -
-					 * with temperature value and type as characteristic */
-					temp_service_uuid.len = 2;
-					temp_service_uuid.data[0] = 0x09;
-					temp_service_uuid.data[1] = 0x18;
-
-					struct gecko_msg_gatt_discover_primary_services_by_uuid_rsp_t *disc_temp_pri_serv_rsp =
-							gecko_cmd_gatt_discover_primary_services_by_uuid(slave_conn_handle, temp_service_uuid.len,
-									temp_service_uuid.data);
-#endif
+					/* Later drops reconnect to this glove only */
+					reconnectOpened(evt->data.evt_le_connection_opened.address,
+							evt->data.evt_le_connection_opened.address_type);
 
-#ifdef MEASURE_HUMIDITY
-					//service_handling_in_progress = true;
-
-					/* Discover environmental sensing service - with humidity info as characteristic */
-					env_service_uuid.len = 2;
-					env_service_uuid.data[0] = 0x1A;
-					env_service_uuid.data[1] = 0x18;
-					struct gecko_msg_gatt_discover_primary_services_by_uuid_rsp_t *disc_env_pri_serv_rsp =
-							gecko_cmd_gatt_discover_primary_services_by_uuid(slave_conn_handle, env_service_uuid.len,
-									env_service_uuid.data);
+					/* Request a short interval while the arm is operated, a long one when idle */
+					connParamsStart(slave_conn_handle);
 
-					uint16 disc_env_pri_serv_rsp_result = disc_env_pri_serv_rsp->result;
+#ifdef ENABLE_MASTER_ROLE
+					/* A glove seen before is subscribed to straight away,
+					 * a new one has its services discovered first */
+					if (!enable_slave_data_cached(slave_conn_handle, slave_bluetooth_addr))
+					{
+						discover_slave_services(slave_conn_handle);
+					}
 #endif
-
-					//gecko_cmd_gatt_discover_primary_services(slave_conn_handle);
-					state = eStateFindService;
 				}
 			}
 		}
@@ -504,6 +694,8 @@ void appHandleEvents(struct gecko_cmd_packet *evt)
 		security_mode = evt->data.evt_le_connection_parameters.security_mode;
 		txsize = evt->data.evt_le_connection_parameters.txsize;
 
+		/* The granted parameters may differ from the requested ones */
+		connParamsGranted(connection, interval, latency, timeout);
 		break;
 
 	case gecko_evt_gatt_service_id:
@@ -574,40 +766,61 @@ void appHandleEvents(struct gecko_cmd_packet *evt)
 			break;
 		}
 
+#ifdef ENABLE_MASTER_ROLE
 		if ( state == eStateFindCharacteristic )
 		{
-#ifdef MEASURE_TEMPERATURE
-			if ( slave_temp_characteristic_handle > 0 )
-			{
-				struct gecko_msg_gatt_set_characteristic_notification_rsp_t* temp_set_notif_rsp =
-						gecko_cmd_gatt_set_characteristic_notification(slave_conn_handle,
-								slave_temp_characteristic_handle,gatt_notification);
+			enable_slave_data(slave_conn_handle);
+			break;
+		}
 
-				state = eStateEnableNotif;
+		if ( state == eStateEnableNotif )
+		{
+			if (gatt_proc_completed_res != 0)
+			{
+				if (slave_handles_cached)
+				{
+					/* The cached handles no longer match the glove, discover it again */
+					gattCacheForget(slave_bluetooth_addr);
+					discover_slave_services(slave_conn_handle);
+				}
+				break;
 			}
-#endif
 
-#ifdef MEASURE_HUMIDITY
-			if (slave_humid_characteristic_handle > 0)
+			/* Temperature subscribed, humidity next */
+			if (enable_slave_humid(slave_conn_handle))
 			{
-				struct gecko_msg_gatt_read_characteristic_value_by_uuid_rsp_t* char_read_rsp =
-						gecko_cmd_gatt_read_characteristic_value_by_uuid(slave_conn_handle,
-								slave_humid_service_handle, humidity_char_uuid.len, humidity_char_uuid.data);
-
-				uint16 char_rd_rsp_res = char_read_rsp->result;
-
-				state = eStateEnableNotif;
+				break;
 			}
+		}
+		else if ( state == eStateEnableHumidNotif )
+		{
+			if (gatt_proc_completed_res != 0)
+			{
+				if (slave_handles_cached)
+				{
+					/* The cached handles no longer match the glove, discover it again */
+					gattCacheForget(slave_bluetooth_addr);
+					discover_slave_services(slave_conn_handle);
+					break;
+				}
+
+				/* The glove refused the humidity subscription, keep the temperature only */
+#ifdef MEASURE_HUMIDITY
+				slave_humid_characteristic_handle = 0;
 #endif
-			break;
+			}
 		}
 
-		if ( state == eStateEnableNotif )
+		if ( (state == eStateEnableNotif) || (state == eStateEnableHumidNotif) )
 		{
+			/* Subscribing with these handles works, skip the discovery next time */
+			store_slave_handles();
+
 			//notifications enabled -> transparent data mode
 			state = eStateDataMode;
 			break;
 		}
+#endif
 
 		break;
 
@@ -649,15 +862,8 @@ void appHandleEvents(struct gecko_cmd_packet *evt)
 		{
 			if (evt->data.evt_gatt_characteristic_value.att_opcode == gatt_handle_value_notification)
 			{
-				memcpy(temp_rcvd_data, evt->data.evt_gatt_characteristic_value.value.data, evt->data.evt_gatt_characteristic_value.value.len);
-				//int temp_data = ((temp_rcvd_data[4] << 24 | temp_rcvd_data[3] << 16 | temp_rcvd_data[2] << 8 | temp_rcvd_data[1]) & 0x00FFFFFF);
-				int temp_data = ((temp_rcvd_data[4] << 24 | temp_rcvd_data[3] << 16 | temp_rcvd_data[2] << 8 | temp_rcvd_data[1])~);
-				float temp_val = (float)temp_data/1000;
-
-#ifdef READ_FLEX_SENSOR_DATA
-				parse_flex_sensor_data(temp_data);
-				motor_control();
-#endif
+				process_temp_notification(evt->data.evt_gatt_characteristic_value.value.data,
+						evt->data.evt_gatt_characteristic_value.value.len);
 			}
 		}
 #endif
@@ -665,7 +871,9 @@ void appHandleEvents(struct gecko_cmd_packet *evt)
 #ifdef MEASURE_HUMIDITY
 		if (evt->data.evt_gatt_characteristic_value.characteristic == slave_humid_characteristic_handle)
 		{
-			memcpy(humid_rcvd_data, evt->data.evt_gatt_characteristic_value.value.data, evt->data.evt_gatt_characteristic_value.value.len);
+			memcpy(humid_rcvd_data, evt->data.evt_gatt_characteristic_value.value.data,
+					(evt->data.evt_gatt_characteristic_value.value.len < sizeof(humid_rcvd_data)) ?
+							evt->data.evt_gatt_characteristic_value.value.len : sizeof(humid_rcvd_data));
 		}
 #endif
 		break;
@@ -684,6 +892,8 @@ void appHandleEvents(struct gecko_cmd_packet *evt)
 
 		connected = 0;
 
+		connParamsStop();
+
 		device_is_slave = false;
 
 		device_role_in_conn = -1;
@@ -694,8 +904,10 @@ void appHandleEvents(struct gecko_cmd_packet *evt)
 #ifdef ENABLE_SLAVE_ROLE
 			gecko_cmd_hardware_set_soft_timer(32768, SLAVE_ROLE_TIMER, false);
 
+#ifndef ENABLE_PERIODIC_ROLE_REVERSAL
 			/* Restart advertising after client has disconnected */
 			gecko_cmd_le_gap_set_mode(le_gap_general_discoverable, le_gap_undirected_connectable);
+#endif
 #endif
 		}
 		else
@@ -703,10 +915,18 @@ void appHandleEvents(struct gecko_cmd_packet *evt)
 #ifdef ENABLE_MASTER_ROLE
 			gecko_cmd_hardware_set_soft_timer(32768, MASTER_ROLE_TIMER, false);
 
-			/* Start the GAP discovery */
-			gecko_cmd_le_gap_discover(le_gap_general_discoverable); /* Discover using general discoverable mode */
+#ifndef ENABLE_PERIODIC_ROLE_REVERSAL
+			/* Look for the glove again, fastest scan first */
+			reconnectClosed();
+#endif
 #endif
 		}
+
+#ifdef ENABLE_PERIODIC_ROLE_REVERSAL
+		/* A new turn in the role of the connection, the peer is likely to come back */
+		roleSchedClosed();
+		update_dev_role();
+#endif
 		break;
 
 		/* Software Timer event */
@@ -719,6 +939,14 @@ void appHandleEvents(struct gecko_cmd_packet *evt)
 		case ADV_TIMER: /* Advertisement Timer */
 			//advSetup();
 			break;
+		case CONN_PARAMS_TIMER: /* Connection parameters idle check */
+			connParamsTimerTick();
+			break;
+		case RECONNECT_TIMER: /* Next scan stage or connection open timeout */
+#ifdef ENABLE_MASTER_ROLE
+			reconnectTimerTick();
+#endif
+			break;
 #ifndef FEATURE_IOEXPANDER
 		case DISP_POL_INV_TIMER:
 			/*Toggle the the EXTCOMIN signal, which prevents building up a DC bias  within the
@@ -727,49 +955,9 @@ void appHandleEvents(struct gecko_cmd_packet *evt)
 			break;
 #endif /* FEATURE_IOEXPANDER */
 #ifdef ENABLE_PERIODIC_ROLE_REVERSAL
-		case MASTER_SLAVE_RR_TIMER:
-			if (e_dev_role == DEVICE_ROLE_SLAVE)
-			{
-				/* Set advertising parameters. 100ms advertisement interval. All channels used.
-				 * The first two parameters are minimum and maximum advertising interval, both in
-				 * units of (milliseconds * 1.6). The third parameter '7' sets advertising on all channels. */
-				gecko_cmd_le_gap_set_adv_parameters(160,160,7);
-
-				/* Start general advertising and enable connections. */
-				gecko_cmd_le_gap_set_mode(le_gap_general_discoverable, le_gap_undirected_connectable);
-
-				if (device_is_slave == true && connected == 1)
-				{
-					/* Device is connected to a master (like a cellphone) and
-					 * will continue to stay until a disconnect event occurs */
-					/* Resetting the timer to come and check after 5 seconds */
-					gecko_cmd_hardware_set_soft_timer(DEV_SLAVE_PERIOD/4, MASTER_SLAVE_RR_TIMER, true);
-				}
-				else
-				{
-					e_dev_role = DEVICE_ROLE_MASTER;
-					gecko_cmd_hardware_set_soft_timer(DEV_SLAVE_PERIOD, MASTER_SLAVE_RR_TIMER, true);
-				}
-			}
-			else if (e_dev_role == DEVICE_ROLE_MASTER)
-			{
-				/* start the GAP discovery procedure to scan for advertising devices */
-				/* Configure the scanning parameters */
-				/* scan_interval - 800
-				 * scan_window - 800
-				 * passive scan mode */
-				gecko_cmd_le_gap_set_scan_parameters(100, 100, 1);
-
-				/* Start the GAP discovery */
-				gecko_cmd_le_gap_discover(le_gap_general_discoverable); /* Discover using general discoverable mode */
-
-				e_dev_role = DEVICE_ROLE_SLAVE;
-				gecko_cmd_hardware_set_soft_timer(DEV_SLAVE_PERIOD, MASTER_SLAVE_RR_TIMER, true);
-			}
-			else
-			{
-				/* Do Nothing */
-			}
+		case MASTER_SLAVE_RR_TIMER: /* End of a scan or advertise turn */
+			roleSchedTimerTick();
+			update_dev_role();
 			break;
 #endif
 
@@ -44,6 +44,7 @@ typedef enum _connState{
 	eStateFindService,
 	eStateFindCharacteristic,
 	eStateEnableNotif,
+	eStateEnableHumidNotif,
 	eStateDataMode,
 	eStateMax
 }connState;
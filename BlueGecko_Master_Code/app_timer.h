@@ -66,7 +66,13 @@ typedef enum
   MASTER_ROLE_TIMER,
   /** Master Slave Role Reversal Timer
    *  This is an auto-reload timer used for switching device role as master and slave. */
-  MASTER_SLAVE_RR_TIMER
+  MASTER_SLAVE_RR_TIMER,
+  /** Connection Parameters Timer
+   *  This is an auto-reload timer used for relaxing the connection parameters when idle. */
+  CONN_PARAMS_TIMER,
+  /** Reconnect Timer
+   *  This is a one-shot timer used for stepping down the scan and giving up on a connection open. */
+  RECONNECT_TIMER
 } appTimer_t;
 
 
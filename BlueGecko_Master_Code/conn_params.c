@@ -0,0 +1,239 @@
+/***********************************************************************************************//**
+ * \file   conn_params.c
+ * \brief  Connection parameter policy for the link to the glove
+ ***************************************************************************************************
+ * <b> (C) Copyright 2015 Silicon Labs, http://www.silabs.com</b>
+ ***************************************************************************************************
+ * This file is licensed under the Silabs License Agreement. See the file
+ * "Silabs_License_Agreement.txt" for details. Before using this software for
+ * any purpose, you must agree to the terms of that agreement.
+ **************************************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* BG stack headers */
+#include "bg_types.h"
+#include "native_gecko.h"
+
+/* application specific headers */
+#include "app_timer.h"
+
+/* Own header */
+#include "conn_params.h"
+
+/***********************************************************************************************//**
+ * @addtogroup Application
+ * @{
+ **************************************************************************************************/
+
+/***********************************************************************************************//**
+ * @addtogroup connparams
+ * @{
+ **************************************************************************************************/
+
+
+/***************************************************************************************************
+  Local Macros and Definitions
+ **************************************************************************************************/
+
+/** Parameters requested for a policy, in the units of gecko_cmd_le_connection_set_parameters. */
+typedef struct
+{
+  uint16_t minInterval;           /**< 1.25 ms units */
+  uint16_t maxInterval;           /**< 1.25 ms units */
+  uint16_t latency;               /**< Connection events */
+  uint16_t timeout;               /**< 10 ms units */
+} connParamsRequest_t;
+
+/***************************************************************************************************
+  Local Variables
+ **************************************************************************************************/
+
+/* The supervision timeout has to exceed (1 + latency) * interval * 2 */
+static const connParamsRequest_t connParamsTable[CONN_PARAMS_POLICY_COUNT] = {
+  /* 7.5 ms, the shortest interval allowed, every event used; 1 s timeout */
+  [CONN_PARAMS_POLICY_ACTIVE] = { 6, 6, 0, 100 },
+  /* 100 ms, the glove may sleep through 4 events in a row; 4 s timeout */
+  [CONN_PARAMS_POLICY_IDLE]   = { 80, 80, 4, 400 }
+};
+
+static bool connParamsOpen = false;
+static uint8_t connParamsConnection;
+
+/* Policy the joint activity asks for */
+static connParamsPolicy_t connParamsWanted;
+/* Policy of the request in flight, if connParamsPending */
+static connParamsPolicy_t connParamsRequested;
+static bool connParamsPending = false;
+static uint8_t connParamsPendingTicks;
+static uint8_t connParamsRetries;
+
+/* Policy the link runs in, if connParamsGrantedValid */
+static connParamsPolicy_t connParamsCurrent;
+static bool connParamsGrantedValid = false;
+
+static bool connParamsMotionSeen;
+
+static connParamsReport_t connParamsReports[CONN_PARAMS_POLICY_COUNT];
+
+/***************************************************************************************************
+ Static Function Declarations
+ **************************************************************************************************/
+
+static void connParamsRequest(void);
+
+/***************************************************************************************************
+ Function Definitions
+ **************************************************************************************************/
+
+void connParamsStart(uint8_t connection)
+{
+  connParamsOpen = true;
+  connParamsConnection = connection;
+  connParamsPending = false;
+  connParamsGrantedValid = false;
+  connParamsRetries = 0;
+
+  /* The operator is about to move when the link comes up */
+  connParamsWanted = CONN_PARAMS_POLICY_ACTIVE;
+  connParamsMotionSeen = true;
+  connParamsRequest();
+
+  gecko_cmd_hardware_set_soft_timer(TIMER_MS_2_TIMERTICK(CONN_PARAMS_IDLE_CHECK_MS), CONN_PARAMS_TIMER, false);
+}
+
+void connParamsStop(void)
+{
+  connParamsOpen = false;
+  connParamsPending = false;
+  connParamsGrantedValid = false;
+
+  gecko_cmd_hardware_set_soft_timer(TIMER_STOP, CONN_PARAMS_TIMER, false);
+}
+
+void connParamsMotion(void)
+{
+  connParamsMotionSeen = true;
+
+  if (connParamsOpen && (connParamsWanted != CONN_PARAMS_POLICY_ACTIVE)) {
+    connParamsWanted = CONN_PARAMS_POLICY_ACTIVE;
+    connParamsRequest();
+  }
+}
+
+void connParamsTimerTick(void)
+{
+  if (!connParamsOpen) {
+    return;
+  }
+
+  if (connParamsGrantedValid) {
+    connParamsReports[connParamsCurrent].timeMs += CONN_PARAMS_IDLE_CHECK_MS;
+  }
+
+  if (!connParamsMotionSeen && (connParamsWanted != CONN_PARAMS_POLICY_IDLE)) {
+    connParamsWanted = CONN_PARAMS_POLICY_IDLE;
+  }
+  connParamsMotionSeen = false;
+
+  /* A request still unanswered after a whole idle check period is sent again */
+  if (connParamsPending && (++connParamsPendingTicks >= 2)) {
+    connParamsPending = false;
+    connParamsRetries++;
+  }
+
+  if (!connParamsGrantedValid || (connParamsCurrent != connParamsWanted)) {
+    connParamsRequest();
+  }
+}
+
+void connParamsGranted(uint8_t connection, uint16_t interval, uint16_t latency, uint16_t timeout)
+{
+  const connParamsRequest_t *request;
+  connParamsReport_t *report;
+  bool match;
+
+  if (!connParamsOpen || (connection != connParamsConnection)) {
+    return;
+  }
+
+  request = &connParamsTable[connParamsPending ? connParamsRequested : connParamsWanted];
+  match = (interval >= request->minInterval) && (interval <= request->maxInterval)
+          && (latency == request->latency);
+
+  if (!match && (connParamsRetries < CONN_PARAMS_MAX_RETRIES)) {
+    if (!connParamsPending) {
+      /* The glove changed the parameters, put the policy back */
+      connParamsRetries++;
+      connParamsRequest();
+    }
+    /* Otherwise these are the parameters from before the update in flight,
+     * the idle check repeats the request if its grant never comes */
+    return;
+  }
+
+  /* Past the retries the granted parameters are the best this link gives for the policy */
+  connParamsCurrent = connParamsPending ? connParamsRequested : connParamsWanted;
+  connParamsGrantedValid = true;
+  connParamsPending = false;
+  connParamsRetries = 0;
+
+  report = &connParamsReports[connParamsCurrent];
+  report->interval = interval;
+  report->latency = latency;
+  report->timeout = timeout;
+
+  /* Activity may have changed while the update was in flight */
+  if (connParamsCurrent != connParamsWanted) {
+    connParamsRequest();
+  }
+}
+
+void connParamsGetReport(connParamsPolicy_t policy, connParamsReport_t *report)
+{
+  *report = connParamsReports[policy];
+
+  if (report->interval == 0) {
+    report->worstLatencyUs = 0;
+    report->slaveEvents = 0;
+    return;
+  }
+
+  /* The glove can send in any connection event, slave latency only lets it skip idle ones */
+  report->worstLatencyUs = (uint32_t)report->interval * 1250;
+  report->slaveEvents = (uint32_t)(((uint64_t)report->timeMs * 1000)
+                                   / ((uint64_t)report->worstLatencyUs * (1 + report->latency)));
+}
+
+/***********************************************************************************************//**
+ *  \brief  Request the parameters of the wanted policy, unless a request is in flight.
+ *          The grant event follows up on a policy change made meanwhile.
+ **************************************************************************************************/
+static void connParamsRequest(void)
+{
+  const connParamsRequest_t *request;
+  struct gecko_msg_le_connection_set_parameters_rsp_t *rsp;
+
+  if (connParamsPending) {
+    return;
+  }
+
+  request = &connParamsTable[connParamsWanted];
+  rsp = gecko_cmd_le_connection_set_parameters(connParamsConnection,
+                                               request->minInterval,
+                                               request->maxInterval,
+                                               request->latency,
+                                               request->timeout);
+
+  /* A refused request is retried on the next idle check */
+  if (rsp->result == 0) {
+    connParamsRequested = connParamsWanted;
+    connParamsPending = true;
+    connParamsPendingTicks = 0;
+  }
+}
+
+
+/** @} (end addtogroup connparams) */
+/** @} (end addtogroup Application) */
@@ -0,0 +1,117 @@
+/***********************************************************************************************//**
+ * \file   conn_params.h
+ * \brief  Connection parameter policy for the link to the glove
+ ***************************************************************************************************
+ * <b> (C) Copyright 2015 Silicon Labs, http://www.silabs.com</b>
+ ***************************************************************************************************
+ * This file is licensed under the Silabs License Agreement. See the file
+ * "Silabs_License_Agreement.txt" for details. Before using this software for
+ * any purpose, you must agree to the terms of that agreement.
+ **************************************************************************************************/
+
+#ifndef CONN_PARAMS_H
+#define CONN_PARAMS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***********************************************************************************************//**
+ * \defgroup connparams Connection Parameters
+ * \brief Connection parameter policy API
+ **************************************************************************************************/
+
+/***********************************************************************************************//**
+ * @addtogroup Application
+ * @{
+ **************************************************************************************************/
+
+/***********************************************************************************************//**
+ * @addtogroup connparams
+ * @{
+ **************************************************************************************************/
+
+
+/***************************************************************************************************
+  Public Macros and Definitions
+***************************************************************************************************/
+
+/** Period of the idle check. The link relaxes after a whole period without joint motion. */
+#define CONN_PARAMS_IDLE_CHECK_MS     1000
+
+/** Requests repeated when the granted parameters do not match, before they are accepted. */
+#define CONN_PARAMS_MAX_RETRIES       2
+
+/***************************************************************************************************
+  Structures and Enumerations
+***************************************************************************************************/
+
+/** Connection parameter policies. */
+typedef enum
+{
+  CONN_PARAMS_POLICY_ACTIVE = 0,  /**< Joints moving: shortest interval, no slave latency */
+  CONN_PARAMS_POLICY_IDLE,        /**< Joints still: long interval, slave latency */
+  CONN_PARAMS_POLICY_COUNT
+} connParamsPolicy_t;
+
+/** Latency and energy figures of one policy, from the parameters actually granted. */
+typedef struct
+{
+  uint16_t interval;              /**< Granted interval, 1.25 ms units, 0 if never granted */
+  uint16_t latency;               /**< Granted slave latency, in connection events */
+  uint16_t timeout;               /**< Granted supervision timeout, 10 ms units */
+  uint32_t worstLatencyUs;        /**< Longest wait for the next event the glove can send in */
+  uint32_t timeMs;                /**< Time the link spent in this policy */
+  uint32_t slaveEvents;           /**< Connection events the glove had to wake up for, at least */
+} connParamsReport_t;
+
+/***************************************************************************************************
+  Public Function Declarations
+***************************************************************************************************/
+
+/***********************************************************************************************//**
+ *  \brief  Start the policy on a new connection, in the active policy.
+ *  \param[in]  connection  Connection handle
+ **************************************************************************************************/
+void connParamsStart(uint8_t connection);
+
+/***********************************************************************************************//**
+ *  \brief  Stop the policy when the connection closes.
+ **************************************************************************************************/
+void connParamsStop(void);
+
+/***********************************************************************************************//**
+ *  \brief  Indicate that joint data changed, switches the link to the active policy.
+ **************************************************************************************************/
+void connParamsMotion(void);
+
+/***********************************************************************************************//**
+ *  \brief  Idle check, to be called when CONN_PARAMS_TIMER expires.
+ **************************************************************************************************/
+void connParamsTimerTick(void);
+
+/***********************************************************************************************//**
+ *  \brief  Record the parameters granted for a connection.
+ *  \param[in]  connection  Connection handle
+ *  \param[in]  interval  Interval, 1.25 ms units
+ *  \param[in]  latency  Slave latency, in connection events
+ *  \param[in]  timeout  Supervision timeout, 10 ms units
+ **************************************************************************************************/
+void connParamsGranted(uint8_t connection, uint16_t interval, uint16_t latency, uint16_t timeout);
+
+/***********************************************************************************************//**
+ *  \brief  Get the latency and energy figures of a policy.
+ *  \param[in]  policy  Policy to report on
+ *  \param[out]  report  Figures of the policy
+ **************************************************************************************************/
+void connParamsGetReport(connParamsPolicy_t policy, connParamsReport_t *report);
+
+
+/** @} (end addtogroup connparams) */
+/** @} (end addtogroup Application) */
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* CONN_PARAMS_H */
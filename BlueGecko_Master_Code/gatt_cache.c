@@ -0,0 +1,172 @@
+/***********************************************************************************************//**
+ * \file   gatt_cache.c
+ * \brief  Cache of the GATT handles discovered on the gloves
+ ***************************************************************************************************
+ * <b> (C) Copyright 2015 Silicon Labs, http://www.silabs.com</b>
+ ***************************************************************************************************
+ * This file is licensed under the Silabs License Agreement. See the file
+ * "Silabs_License_Agreement.txt" for details. Before using this software for
+ * any purpose, you must agree to the terms of that agreement.
+ **************************************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/* BG stack headers */
+#include "bg_types.h"
+#include "native_gecko.h"
+
+/* Own header */
+#include "gatt_cache.h"
+
+/***********************************************************************************************//**
+ * @addtogroup Application
+ * @{
+ **************************************************************************************************/
+
+/***********************************************************************************************//**
+ * @addtogroup gattcache
+ * @{
+ **************************************************************************************************/
+
+
+/***************************************************************************************************
+  Local Macros and Definitions
+ **************************************************************************************************/
+
+/** Cache slot, as kept in RAM and in the persistent store. */
+typedef struct
+{
+  uint8_t valid;                  /**< Non zero if the slot holds a glove */
+  gattCacheEntry_t entry;
+} gattCacheSlot_t;
+
+/***************************************************************************************************
+  Local Variables
+ **************************************************************************************************/
+
+static gattCacheSlot_t gattCacheSlots[GATT_CACHE_ENTRIES];
+
+/* Slot the next new glove replaces, if the cache is full */
+static uint8_t gattCacheNext = 0;
+
+/***************************************************************************************************
+ Static Function Declarations
+ **************************************************************************************************/
+
+static gattCacheSlot_t *gattCacheFind(bd_addr address);
+static void gattCacheSave(gattCacheSlot_t *slot);
+
+/***************************************************************************************************
+ Function Definitions
+ **************************************************************************************************/
+
+void gattCacheInit(void)
+{
+#ifdef GATT_CACHE_PERSISTENT
+  struct gecko_msg_flash_ps_load_rsp_t *rsp;
+#endif
+  uint8_t i;
+
+  for (i = 0; i < GATT_CACHE_ENTRIES; i++) {
+    gattCacheSlots[i].valid = 0;
+
+#ifdef GATT_CACHE_PERSISTENT
+    /* A key never saved, or saved by another layout, leaves the slot empty */
+    rsp = gecko_cmd_flash_ps_load(GATT_CACHE_PS_KEY + i);
+    if ((rsp->result == 0) && (rsp->value.len == sizeof(gattCacheSlot_t))) {
+      memcpy(&gattCacheSlots[i], rsp->value.data, sizeof(gattCacheSlot_t));
+    }
+#endif
+  }
+
+  gattCacheNext = 0;
+}
+
+bool gattCacheLookup(bd_addr address, gattCacheEntry_t *entry)
+{
+  gattCacheSlot_t *slot = gattCacheFind(address);
+
+  if (slot == NULL) {
+    return false;
+  }
+
+  *entry = slot->entry;
+  return true;
+}
+
+void gattCacheStore(const gattCacheEntry_t *entry)
+{
+  gattCacheSlot_t *slot = gattCacheFind(entry->address);
+  uint8_t i;
+
+  if (slot == NULL) {
+    for (i = 0; i < GATT_CACHE_ENTRIES; i++) {
+      if (!gattCacheSlots[i].valid) {
+        slot = &gattCacheSlots[i];
+        break;
+      }
+    }
+  }
+
+  if (slot == NULL) {
+    slot = &gattCacheSlots[gattCacheNext];
+    gattCacheNext = (gattCacheNext + 1) % GATT_CACHE_ENTRIES;
+  } else if ((slot->entry.tempCharacteristic == entry->tempCharacteristic)
+             && (slot->entry.humidCharacteristic == entry->humidCharacteristic)) {
+    /* Nothing changed, spare the flash a write */
+    return;
+  }
+
+  slot->valid = 1;
+  slot->entry = *entry;
+  gattCacheSave(slot);
+}
+
+void gattCacheForget(bd_addr address)
+{
+  gattCacheSlot_t *slot = gattCacheFind(address);
+
+  if (slot != NULL) {
+    slot->valid = 0;
+    gattCacheSave(slot);
+  }
+}
+
+/***********************************************************************************************//**
+ *  \brief  Find the slot of a glove.
+ *  \param[in]  address  Address of the glove
+ *  \return  The slot, NULL if the glove is not in the cache.
+ **************************************************************************************************/
+static gattCacheSlot_t *gattCacheFind(bd_addr address)
+{
+  uint8_t i;
+
+  for (i = 0; i < GATT_CACHE_ENTRIES; i++) {
+    if (gattCacheSlots[i].valid
+        && (memcmp(gattCacheSlots[i].entry.address.addr, address.addr, sizeof(bd_addr)) == 0)) {
+      return &gattCacheSlots[i];
+    }
+  }
+
+  return NULL;
+}
+
+/***********************************************************************************************//**
+ *  \brief  Write a slot to the persistent store, if GATT_CACHE_PERSISTENT.
+ *  \param[in]  slot  Slot to write
+ **************************************************************************************************/
+static void gattCacheSave(gattCacheSlot_t *slot)
+{
+#ifdef GATT_CACHE_PERSISTENT
+  /* The RAM copy stays valid if the write fails, the glove is discovered again after a reset */
+  gecko_cmd_flash_ps_save(GATT_CACHE_PS_KEY + (slot - gattCacheSlots), sizeof(gattCacheSlot_t), (uint8_t *)slot);
+#else
+  (void)slot;
+#endif
+}
+
+
+/** @} (end addtogroup gattcache) */
+/** @} (end addtogroup Application) */
@@ -0,0 +1,98 @@
+/***********************************************************************************************//**
+ * \file   gatt_cache.h
+ * \brief  Cache of the GATT handles discovered on the gloves
+ ***************************************************************************************************
+ * <b> (C) Copyright 2015 Silicon Labs, http://www.silabs.com</b>
+ ***************************************************************************************************
+ * This file is licensed under the Silabs License Agreement. See the file
+ * "Silabs_License_Agreement.txt" for details. Before using this software for
+ * any purpose, you must agree to the terms of that agreement.
+ **************************************************************************************************/
+
+#ifndef GATT_CACHE_H
+#define GATT_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***********************************************************************************************//**
+ * \defgroup gattcache GATT Cache
+ * \brief GATT handle cache API
+ **************************************************************************************************/
+
+/***********************************************************************************************//**
+ * @addtogroup Application
+ * @{
+ **************************************************************************************************/
+
+/***********************************************************************************************//**
+ * @addtogroup gattcache
+ * @{
+ **************************************************************************************************/
+
+
+/***************************************************************************************************
+  Public Macros and Definitions
+***************************************************************************************************/
+
+/** Keep the cache in the persistent store, so that it survives a reset. Comment out to keep it
+ *  in RAM only. */
+#define GATT_CACHE_PERSISTENT
+
+/** Gloves the cache holds the handles of. */
+#define GATT_CACHE_ENTRIES            4
+
+/** First persistent store key of the cache, one key per entry, in the user range. */
+#define GATT_CACHE_PS_KEY             0x4100
+
+/***************************************************************************************************
+  Structures and Enumerations
+***************************************************************************************************/
+
+/** Handles of one glove. A handle is 0 if the characteristic was not discovered. */
+typedef struct
+{
+  bd_addr address;                /**< Address of the glove */
+  uint16_t tempCharacteristic;    /**< Temperature measurement, carries the joint samples */
+  uint16_t humidCharacteristic;   /**< Humidity */
+} gattCacheEntry_t;
+
+/***************************************************************************************************
+  Public Function Declarations
+***************************************************************************************************/
+
+/***********************************************************************************************//**
+ *  \brief  Initialise the cache, loads it from the persistent store if GATT_CACHE_PERSISTENT.
+ **************************************************************************************************/
+void gattCacheInit(void);
+
+/***********************************************************************************************//**
+ *  \brief  Get the handles cached for a glove.
+ *  \param[in]  address  Address of the glove
+ *  \param[out]  entry  Handles of the glove
+ *  \return  true if the glove is in the cache.
+ **************************************************************************************************/
+bool gattCacheLookup(bd_addr address, gattCacheEntry_t *entry);
+
+/***********************************************************************************************//**
+ *  \brief  Cache the handles discovered on a glove, replacing the oldest glove if the cache is full.
+ *  \param[in]  entry  Handles of the glove
+ **************************************************************************************************/
+void gattCacheStore(const gattCacheEntry_t *entry);
+
+/***********************************************************************************************//**
+ *  \brief  Drop the handles of a glove, after they turned out to be wrong.
+ *  \param[in]  address  Address of the glove
+ **************************************************************************************************/
+void gattCacheForget(bd_addr address);
+
+
+/** @} (end addtogroup gattcache) */
+/** @} (end addtogroup Application) */
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* GATT_CACHE_H */
@@ -55,7 +55,7 @@ GATT_DATA(const uint8_t bg_gattdb_data_uuidtable_128_map [])=
 
 uint8_t bg_gattdb_data_attribute_field_26_data[2]={0x00,0x00,};
 GATT_DATA(const struct bg_gattdb_attribute_chrvalue	bg_gattdb_data_attribute_field_26 ) = {
-	.properties=0x22,
+	.properties=0x32,
 	.index=6,
 	.max_len=2,
 	.data=bg_gattdb_data_attribute_field_26_data,
@@ -63,7 +63,7 @@ GATT_DATA(const struct bg_gattdb_attribute_chrvalue	bg_gattdb_data_attribute_fie
 
 GATT_DATA(const struct bg_gattdb_buffer_with_len	bg_gattdb_data_attribute_field_25 ) = {
 	.len=5,
-	.data={0x22,0x1b,0x00,0x6f,0x2a,}
+	.data={0x32,0x1b,0x00,0x6f,0x2a,}
 };
 GATT_DATA(const struct bg_gattdb_buffer_with_len	bg_gattdb_data_attribute_field_24 ) = {
 	.len=2,
@@ -208,7 +208,7 @@ GATT_DATA(const struct bg_gattdb_attribute bg_gattdb_data_attributes_map[])={
     {.uuid=0x0000,.permissions=0x801,.datatype=0x00,.min_key_size=0x00,.constdata=&bg_gattdb_data_attribute_field_24},
     {.uuid=0x0002,.permissions=0x801,.datatype=0x00,.min_key_size=0x00,.constdata=&bg_gattdb_data_attribute_field_25},
     {.uuid=0x0010,.permissions=0x801,.datatype=0x01,.min_key_size=0x00,.dynamicdata=&bg_gattdb_data_attribute_field_26},
-    {.uuid=0x0011,.permissions=0x807,.datatype=0x03,.min_key_size=0x00,.configdata={.flags=0x02,.index=0x06,.clientconfig_index=0x02}},
+    {.uuid=0x0011,.permissions=0x807,.datatype=0x03,.min_key_size=0x00,.configdata={.flags=0x03,.index=0x06,.clientconfig_index=0x02}},
 };
 
 GATT_DATA(const uint16_t bg_gattdb_data_attributes_dynamic_mapping_map[])={
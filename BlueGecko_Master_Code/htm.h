@@ -36,6 +36,21 @@ extern "C" {
   Public Macros and Definitions
 ***************************************************************************************************/
 
+/** Largest ATT MTU asked for. The MTU is exchanged when the connection opens. */
+#define HTM_MAX_MTU                         247
+
+/* Joint samples batched into the temperature measurement characteristic:
+ * flags, sample count, then per sample a 16 bit timestamp and the 32 bit
+ * joint word, all little endian, oldest sample first. */
+/** Flags field value of a joint sample batch. Bit 7 is reserved in HTM. */
+#define HTM_FLAG_JOINT_BATCH                0x80
+/** Length of the batch flags and sample count. */
+#define HTM_JOINT_BATCH_HDR_LEN             2
+/** Length of one joint sample. */
+#define HTM_JOINT_SAMPLE_LEN                6
+/** Timestamp resolution, the RTCC count rate, LFXO prescaled by 32. Wraps after 64 s. */
+#define HTM_JOINT_TICK_HZ                   1024
+
 
 /***************************************************************************************************
   Structures and Enumerations
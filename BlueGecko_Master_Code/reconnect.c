@@ -0,0 +1,285 @@
+/***********************************************************************************************//**
+ * \file   reconnect.c
+ * \brief  Reconnection to the glove after the link is lost
+ ***************************************************************************************************
+ * <b> (C) Copyright 2015 Silicon Labs, http://www.silabs.com</b>
+ ***************************************************************************************************
+ * This file is licensed under the Silabs License Agreement. See the file
+ * "Silabs_License_Agreement.txt" for details. Before using this software for
+ * any purpose, you must agree to the terms of that agreement.
+ **************************************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/* BG stack headers */
+#include "bg_types.h"
+#include "native_gecko.h"
+
+/* application specific headers */
+#include "app_timer.h"
+
+/* Own header */
+#include "reconnect.h"
+
+/***********************************************************************************************//**
+ * @addtogroup Application
+ * @{
+ **************************************************************************************************/
+
+/***********************************************************************************************//**
+ * @addtogroup reconnect
+ * @{
+ **************************************************************************************************/
+
+
+/***************************************************************************************************
+  Local Macros and Definitions
+ **************************************************************************************************/
+
+/** Scan stages, from the drop on. Each stage lasts durationMs, the last one until the glove is found. */
+typedef struct
+{
+  uint32_t durationMs;            /**< 0 for the last stage */
+  uint16_t interval;              /**< 0.625 ms units */
+  uint16_t window;                /**< 0.625 ms units */
+} reconnectStage_t;
+
+typedef enum
+{
+  RECONNECT_STATE_IDLE = 0,
+  RECONNECT_STATE_SCANNING,
+  RECONNECT_STATE_OPENING,        /**< Connection being opened, RECONNECT_TIMER gives up on it */
+  RECONNECT_STATE_CONNECTED
+} reconnectState_t;
+
+/* Advertising data types of the 16 bit service UUID lists */
+#define RECONNECT_AD_UUID16_MORE      0x02
+#define RECONNECT_AD_UUID16_ALL       0x03
+
+/* Packet types of the scan response event that a connection can be opened to */
+#define RECONNECT_PACKET_CONNECTABLE  0x00
+#define RECONNECT_PACKET_DIRECTED     0x01
+#define RECONNECT_PACKET_SCAN_RSP     0x04
+
+/***************************************************************************************************
+  Local Variables
+ **************************************************************************************************/
+
+/* The glove advertises every 100 ms. A glove that dropped out is usually back within
+ * a few seconds, one that is out of range or switched off is only looked for now and then. */
+static const reconnectStage_t reconnectStages[] = {
+  /* 30 ms interval, scanning all the time */
+  { 3000, 48, 48 },
+  /* 100 ms interval, 50 % duty cycle */
+  { 10000, 160, 80 },
+  /* 500 ms interval, 10 % duty cycle */
+  { 30000, 800, 80 },
+  /* 1.28 s interval, 2.3 % duty cycle */
+  { 0, 2048, 48 }
+};
+
+#define RECONNECT_STAGE_COUNT         (sizeof(reconnectStages) / sizeof(reconnectStages[0]))
+
+static reconnectState_t reconnectState = RECONNECT_STATE_IDLE;
+static uint8_t reconnectStage;
+/* The open in progress was made without scanning */
+static bool reconnectDirect;
+
+/* Last glove connected to, if reconnectKnown */
+static bool reconnectKnown = false;
+static bd_addr reconnectAddress;
+static uint8_t reconnectAddressType;
+
+/***************************************************************************************************
+ Static Function Declarations
+ **************************************************************************************************/
+
+static void reconnectScan(void);
+static bool reconnectOpen(bd_addr address, uint8_t addressType, uint32_t timeoutMs);
+static bool reconnectAdvHasService(uint8array *data, uint16_t uuid);
+
+/***************************************************************************************************
+ Function Definitions
+ **************************************************************************************************/
+
+void reconnectStart(void)
+{
+  reconnectStage = 0;
+  reconnectDirect = false;
+
+#ifdef RECONNECT_DIRECT_OPEN
+  /* The glove is connected to on its first advertisement the initiator hears */
+  if (reconnectKnown) {
+    reconnectDirect = reconnectOpen(reconnectAddress, reconnectAddressType, RECONNECT_DIRECT_OPEN_MS);
+    if (reconnectDirect) {
+      return;
+    }
+  }
+#endif
+
+  reconnectScan();
+}
+
+void reconnectStop(void)
+{
+  if ((reconnectState == RECONNECT_STATE_SCANNING) || (reconnectState == RECONNECT_STATE_OPENING)) {
+    gecko_cmd_le_gap_end_procedure();
+  }
+
+  reconnectState = RECONNECT_STATE_IDLE;
+  gecko_cmd_hardware_set_soft_timer(TIMER_STOP, RECONNECT_TIMER, true);
+}
+
+bool reconnectScanResponse(struct gecko_msg_le_gap_scan_response_evt_t *resp)
+{
+  if (reconnectState != RECONNECT_STATE_SCANNING) {
+    return false;
+  }
+
+  if (reconnectKnown) {
+    /* Only the glove connected to before */
+    if ((resp->address_type != reconnectAddressType)
+        || (memcmp(resp->address.addr, reconnectAddress.addr, sizeof(bd_addr)) != 0)
+        || ((resp->packet_type != RECONNECT_PACKET_CONNECTABLE)
+            && (resp->packet_type != RECONNECT_PACKET_DIRECTED)
+            && (resp->packet_type != RECONNECT_PACKET_SCAN_RSP))) {
+      return false;
+    }
+  } else {
+    /* Any glove, recognised by the service it advertises */
+    if (((resp->packet_type != RECONNECT_PACKET_CONNECTABLE) && (resp->packet_type != RECONNECT_PACKET_SCAN_RSP))
+        || !reconnectAdvHasService(&resp->data, RECONNECT_SERVICE_UUID)) {
+      return false;
+    }
+  }
+
+  gecko_cmd_le_gap_end_procedure();
+
+  if (!reconnectOpen(resp->address, resp->address_type, RECONNECT_OPEN_TIMEOUT_MS)) {
+    reconnectScan();
+    return false;
+  }
+
+  return true;
+}
+
+void reconnectOpened(bd_addr address, uint8_t addressType)
+{
+  memcpy(reconnectAddress.addr, address.addr, sizeof(bd_addr));
+  reconnectAddressType = addressType;
+  reconnectKnown = true;
+
+  reconnectState = RECONNECT_STATE_CONNECTED;
+  gecko_cmd_hardware_set_soft_timer(TIMER_STOP, RECONNECT_TIMER, true);
+}
+
+void reconnectClosed(void)
+{
+  if (reconnectState == RECONNECT_STATE_CONNECTED) {
+    reconnectStart();
+  } else if (reconnectState == RECONNECT_STATE_OPENING) {
+    /* Same as an open that timed out */
+    reconnectTimerTick();
+  }
+}
+
+void reconnectTimerTick(void)
+{
+  if (reconnectState == RECONNECT_STATE_OPENING) {
+    gecko_cmd_le_gap_end_procedure();
+
+    /* The glove did not come back straight away, look for it at a slower pace */
+    if (reconnectDirect) {
+      reconnectDirect = false;
+      reconnectStage = 1;
+    }
+    reconnectScan();
+  } else if (reconnectState == RECONNECT_STATE_SCANNING) {
+    if (reconnectStage < RECONNECT_STAGE_COUNT - 1) {
+      reconnectStage++;
+    }
+    reconnectScan();
+  }
+}
+
+/***********************************************************************************************//**
+ *  \brief  Scan with the parameters of the current stage, until the stage ends.
+ **************************************************************************************************/
+static void reconnectScan(void)
+{
+  const reconnectStage_t *stage = &reconnectStages[reconnectStage];
+
+  /* Scan parameters only apply to a new discovery. The advertisement carries the
+   * service UUIDs, scan requests would only cost the glove and the master power. */
+  gecko_cmd_le_gap_end_procedure();
+  gecko_cmd_le_gap_set_scan_parameters(stage->interval, stage->window, 0);
+  gecko_cmd_le_gap_discover(le_gap_discover_generic);
+
+  reconnectState = RECONNECT_STATE_SCANNING;
+
+  if (stage->durationMs != 0) {
+    gecko_cmd_hardware_set_soft_timer(TIMER_MS_2_TIMERTICK(stage->durationMs), RECONNECT_TIMER, true);
+  } else {
+    gecko_cmd_hardware_set_soft_timer(TIMER_STOP, RECONNECT_TIMER, true);
+  }
+}
+
+/***********************************************************************************************//**
+ *  \brief  Open a connection to a glove.
+ *  \param[in]  address  Address of the glove
+ *  \param[in]  addressType  Address type of the glove
+ *  \param[in]  timeoutMs  Time the connection is given to come up
+ *  \return  false if the stack refused to open it.
+ **************************************************************************************************/
+static bool reconnectOpen(bd_addr address, uint8_t addressType, uint32_t timeoutMs)
+{
+  struct gecko_msg_le_gap_open_rsp_t *rsp;
+
+  rsp = gecko_cmd_le_gap_open(address, addressType);
+  if (rsp->result != 0) {
+    return false;
+  }
+
+  reconnectState = RECONNECT_STATE_OPENING;
+  gecko_cmd_hardware_set_soft_timer(TIMER_MS_2_TIMERTICK(timeoutMs), RECONNECT_TIMER, true);
+  return true;
+}
+
+/***********************************************************************************************//**
+ *  \brief  Look for a 16 bit service UUID in advertising data.
+ *  \param[in]  data  Advertising data
+ *  \param[in]  uuid  Service UUID
+ *  \return  true if one of the UUID lists holds the service.
+ **************************************************************************************************/
+static bool reconnectAdvHasService(uint8array *data, uint16_t uuid)
+{
+  uint8_t i = 0;
+  uint8_t j;
+  uint8_t adLen;
+
+  /* Each AD structure is a length, covering the type and the data, the type, then the data */
+  while (i + 1 < data->len) {
+    adLen = data->data[i];
+    if ((adLen == 0) || (i + 1 + adLen > data->len)) {
+      break;
+    }
+
+    if ((data->data[i + 1] == RECONNECT_AD_UUID16_MORE) || (data->data[i + 1] == RECONNECT_AD_UUID16_ALL)) {
+      for (j = i + 2; j + 1 < i + 1 + adLen; j += 2) {
+        if ((data->data[j] | (data->data[j + 1] << 8)) == uuid) {
+          return true;
+        }
+      }
+    }
+
+    i += adLen + 1;
+  }
+
+  return false;
+}
+
+
+/** @} (end addtogroup reconnect) */
+/** @} (end addtogroup Application) */
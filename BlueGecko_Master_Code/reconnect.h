@@ -0,0 +1,101 @@
+/***********************************************************************************************//**
+ * \file   reconnect.h
+ * \brief  Reconnection to the glove after the link is lost
+ ***************************************************************************************************
+ * <b> (C) Copyright 2015 Silicon Labs, http://www.silabs.com</b>
+ ***************************************************************************************************
+ * This file is licensed under the Silabs License Agreement. See the file
+ * "Silabs_License_Agreement.txt" for details. Before using this software for
+ * any purpose, you must agree to the terms of that agreement.
+ **************************************************************************************************/
+
+#ifndef RECONNECT_H
+#define RECONNECT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***********************************************************************************************//**
+ * \defgroup reconnect Reconnect
+ * \brief Reconnection API
+ **************************************************************************************************/
+
+/***********************************************************************************************//**
+ * @addtogroup Application
+ * @{
+ **************************************************************************************************/
+
+/***********************************************************************************************//**
+ * @addtogroup reconnect
+ * @{
+ **************************************************************************************************/
+
+
+/***************************************************************************************************
+  Public Macros and Definitions
+***************************************************************************************************/
+
+/** Open the connection straight to the address of the last glove after a drop, without scanning
+ *  for it first. Comment out to always scan. */
+#define RECONNECT_DIRECT_OPEN
+
+/** Time a direct open is given before falling back to scanning. */
+#define RECONNECT_DIRECT_OPEN_MS      3000
+
+/** Time a connection opened from a scan is given to come up before scanning again. */
+#define RECONNECT_OPEN_TIMEOUT_MS     1000
+
+/** Service a glove never connected before has to advertise, Health Thermometer. */
+#define RECONNECT_SERVICE_UUID        0x1809
+
+/***************************************************************************************************
+  Public Function Declarations
+***************************************************************************************************/
+
+/***********************************************************************************************//**
+ *  \brief  Start looking for the glove, at boot or when the link is lost.
+ *          Starts with the fastest scan, or a direct open if the glove is known.
+ **************************************************************************************************/
+void reconnectStart(void);
+
+/***********************************************************************************************//**
+ *  \brief  Stop looking for the glove, the glove stays known.
+ **************************************************************************************************/
+void reconnectStop(void);
+
+/***********************************************************************************************//**
+ *  \brief  Check an advertisement or scan response against the glove, and open the connection
+ *          if it matches.
+ *  \param[in]  resp  Scan response event
+ *  \return  true if the connection is being opened to the sender.
+ **************************************************************************************************/
+bool reconnectScanResponse(struct gecko_msg_le_gap_scan_response_evt_t *resp);
+
+/***********************************************************************************************//**
+ *  \brief  Remember the glove once its connection is open, later drops reconnect to it only.
+ *  \param[in]  address  Address of the glove
+ *  \param[in]  addressType  Address type of the glove
+ **************************************************************************************************/
+void reconnectOpened(bd_addr address, uint8_t addressType);
+
+/***********************************************************************************************//**
+ *  \brief  Handle a closed connection. A dropped link starts over with the fastest scan,
+ *          a connection that failed to come up goes back to the scan it came from.
+ **************************************************************************************************/
+void reconnectClosed(void);
+
+/***********************************************************************************************//**
+ *  \brief  Move to the next scan or give up an open, to be called when RECONNECT_TIMER expires.
+ **************************************************************************************************/
+void reconnectTimerTick(void);
+
+
+/** @} (end addtogroup reconnect) */
+/** @} (end addtogroup Application) */
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* RECONNECT_H */
@@ -0,0 +1,178 @@
+/***********************************************************************************************//**
+ * \file   role_sched.c
+ * \brief  Scheduler of the master and slave roles
+ ***************************************************************************************************
+ * <b> (C) Copyright 2015 Silicon Labs, http://www.silabs.com</b>
+ ***************************************************************************************************
+ * This file is licensed under the Silabs License Agreement. See the file
+ * "Silabs_License_Agreement.txt" for details. Before using this software for
+ * any purpose, you must agree to the terms of that agreement.
+ **************************************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* BG stack headers */
+#include "bg_types.h"
+#include "native_gecko.h"
+
+/* application specific headers */
+#include "app_timer.h"
+#include "reconnect.h"
+
+/* Own header */
+#include "role_sched.h"
+
+/***********************************************************************************************//**
+ * @addtogroup Application
+ * @{
+ **************************************************************************************************/
+
+/***********************************************************************************************//**
+ * @addtogroup rolesched
+ * @{
+ **************************************************************************************************/
+
+
+/***************************************************************************************************
+  Local Macros and Definitions
+ **************************************************************************************************/
+
+/** Slot length limits of a role. */
+typedef struct
+{
+  uint32_t minMs;
+  uint32_t maxMs;
+} roleSchedLimits_t;
+
+/***************************************************************************************************
+  Local Variables
+ **************************************************************************************************/
+
+static const roleSchedLimits_t roleSchedLimits[ROLE_SCHED_ROLES] = {
+  [ROLE_SCHED_SCAN]      = { ROLE_SCHED_SCAN_MIN_MS, ROLE_SCHED_SCAN_MAX_MS },
+  [ROLE_SCHED_ADVERTISE] = { ROLE_SCHED_ADV_MIN_MS, ROLE_SCHED_ADV_MAX_MS }
+};
+
+static roleSchedRole_t roleSchedCurrent = ROLE_SCHED_SCAN;
+
+/* Length of the next slot of each role */
+static uint32_t roleSchedSlotMs[ROLE_SCHED_ROLES];
+
+/* Something was found in the current slot */
+static bool roleSchedFoundInSlot;
+
+/* A connection is open, the role is kept until it closes */
+static bool roleSchedConnected = false;
+
+/***************************************************************************************************
+ Static Function Declarations
+ **************************************************************************************************/
+
+static void roleSchedEnter(roleSchedRole_t role);
+
+/***************************************************************************************************
+ Function Definitions
+ **************************************************************************************************/
+
+void roleSchedStart(void)
+{
+  roleSchedSlotMs[ROLE_SCHED_SCAN] = ROLE_SCHED_SCAN_MAX_MS;
+  roleSchedSlotMs[ROLE_SCHED_ADVERTISE] = ROLE_SCHED_ADV_MAX_MS;
+  roleSchedConnected = false;
+
+  roleSchedEnter(ROLE_SCHED_SCAN);
+}
+
+void roleSchedTimerTick(void)
+{
+  const roleSchedLimits_t *limits = &roleSchedLimits[roleSchedCurrent];
+
+  if (roleSchedConnected) {
+    return;
+  }
+
+  /* Nobody there, spend less time on this role next time */
+  if (!roleSchedFoundInSlot) {
+    roleSchedSlotMs[roleSchedCurrent] /= 2;
+    if (roleSchedSlotMs[roleSchedCurrent] < limits->minMs) {
+      roleSchedSlotMs[roleSchedCurrent] = limits->minMs;
+    }
+  }
+
+  roleSchedEnter((roleSchedCurrent == ROLE_SCHED_SCAN) ? ROLE_SCHED_ADVERTISE : ROLE_SCHED_SCAN);
+}
+
+void roleSchedFound(void)
+{
+  if (roleSchedConnected || (roleSchedCurrent != ROLE_SCHED_SCAN)) {
+    return;
+  }
+
+  roleSchedFoundInSlot = true;
+  roleSchedSlotMs[ROLE_SCHED_SCAN] = ROLE_SCHED_SCAN_MAX_MS;
+
+  /* Give the connection being opened a whole slot to come up */
+  gecko_cmd_hardware_set_soft_timer(TIMER_MS_2_TIMERTICK(ROLE_SCHED_SCAN_MAX_MS), MASTER_SLAVE_RR_TIMER, true);
+}
+
+void roleSchedOpened(bool asSlave)
+{
+  roleSchedConnected = true;
+  roleSchedCurrent = asSlave ? ROLE_SCHED_ADVERTISE : ROLE_SCHED_SCAN;
+  roleSchedSlotMs[roleSchedCurrent] = roleSchedLimits[roleSchedCurrent].maxMs;
+
+  gecko_cmd_hardware_set_soft_timer(TIMER_STOP, MASTER_SLAVE_RR_TIMER, true);
+}
+
+void roleSchedClosed(void)
+{
+  if (!roleSchedConnected) {
+    /* A connection that failed to come up, look for the glove for the rest of the slot */
+    if (roleSchedCurrent == ROLE_SCHED_SCAN) {
+      reconnectClosed();
+    }
+    return;
+  }
+
+  /* The peer is likely to come straight back, in the same role. A known glove comes back on a
+   * direct open well inside the shortest slot, so only the shortest slot is kept before the
+   * roles alternate again, and a phone waiting for our advertisements is not held off. */
+  roleSchedConnected = false;
+  roleSchedSlotMs[roleSchedCurrent] = roleSchedLimits[roleSchedCurrent].minMs;
+  roleSchedEnter(roleSchedCurrent);
+}
+
+roleSchedRole_t roleSchedGetRole(void)
+{
+  return roleSchedCurrent;
+}
+
+/***********************************************************************************************//**
+ *  \brief  Start a slot: stop the radio activity of the other role, start the one of this role.
+ *  \param[in]  role  Role of the slot
+ **************************************************************************************************/
+static void roleSchedEnter(roleSchedRole_t role)
+{
+  roleSchedCurrent = role;
+  roleSchedFoundInSlot = false;
+
+  if (role == ROLE_SCHED_SCAN) {
+    gecko_cmd_le_gap_set_mode(le_gap_non_discoverable, le_gap_non_connectable);
+
+    /* Fastest scan first, or a direct open to the glove connected to before */
+    reconnectStart();
+  } else {
+    reconnectStop();
+
+    /* 100 ms advertisement interval. All channels used. */
+    gecko_cmd_le_gap_set_adv_parameters(160, 160, 7);
+    gecko_cmd_le_gap_set_mode(le_gap_general_discoverable, le_gap_undirected_connectable);
+  }
+
+  gecko_cmd_hardware_set_soft_timer(TIMER_MS_2_TIMERTICK(roleSchedSlotMs[role]), MASTER_SLAVE_RR_TIMER, true);
+}
+
+
+/** @} (end addtogroup rolesched) */
+/** @} (end addtogroup Application) */
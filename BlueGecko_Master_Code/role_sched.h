@@ -0,0 +1,107 @@
+/***********************************************************************************************//**
+ * \file   role_sched.h
+ * \brief  Scheduler of the master and slave roles
+ ***************************************************************************************************
+ * <b> (C) Copyright 2015 Silicon Labs, http://www.silabs.com</b>
+ ***************************************************************************************************
+ * This file is licensed under the Silabs License Agreement. See the file
+ * "Silabs_License_Agreement.txt" for details. Before using this software for
+ * any purpose, you must agree to the terms of that agreement.
+ **************************************************************************************************/
+
+#ifndef ROLE_SCHED_H
+#define ROLE_SCHED_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***********************************************************************************************//**
+ * \defgroup rolesched Role Scheduler
+ * \brief Master and slave role scheduler API
+ **************************************************************************************************/
+
+/***********************************************************************************************//**
+ * @addtogroup Application
+ * @{
+ **************************************************************************************************/
+
+/***********************************************************************************************//**
+ * @addtogroup rolesched
+ * @{
+ **************************************************************************************************/
+
+
+/***************************************************************************************************
+  Public Macros and Definitions
+***************************************************************************************************/
+
+/* Each slot in which nothing was found halves the next slot of the same role, down to the
+ * minimum, so that with nobody around short scan and advertise windows interleave. Finding
+ * something puts the slot of the role back to the maximum. */
+/** Longest scan slot. */
+#define ROLE_SCHED_SCAN_MAX_MS        10000
+/** Shortest scan slot, several advertising intervals of the glove. */
+#define ROLE_SCHED_SCAN_MIN_MS        1000
+/** Longest advertise slot. */
+#define ROLE_SCHED_ADV_MAX_MS         10000
+/** Shortest advertise slot. Advertising costs less than scanning, so it gets the longer slot. */
+#define ROLE_SCHED_ADV_MIN_MS         2000
+
+/***************************************************************************************************
+  Structures and Enumerations
+***************************************************************************************************/
+
+/** Roles the scheduler alternates between. */
+typedef enum
+{
+  ROLE_SCHED_SCAN = 0,            /**< Master, looking for the glove */
+  ROLE_SCHED_ADVERTISE,           /**< Slave, connectable advertising */
+  ROLE_SCHED_ROLES
+} roleSchedRole_t;
+
+/***************************************************************************************************
+  Public Function Declarations
+***************************************************************************************************/
+
+/***********************************************************************************************//**
+ *  \brief  Start the scheduler, in the scan role.
+ **************************************************************************************************/
+void roleSchedStart(void);
+
+/***********************************************************************************************//**
+ *  \brief  End the current slot and switch role, to be called when MASTER_SLAVE_RR_TIMER expires.
+ **************************************************************************************************/
+void roleSchedTimerTick(void);
+
+/***********************************************************************************************//**
+ *  \brief  Indicate that the glove was found in the current scan slot.
+ **************************************************************************************************/
+void roleSchedFound(void);
+
+/***********************************************************************************************//**
+ *  \brief  Keep the role of a new connection for as long as the connection is open.
+ *  \param[in]  asSlave  true if this device is the slave of the connection
+ **************************************************************************************************/
+void roleSchedOpened(bool asSlave);
+
+/***********************************************************************************************//**
+ *  \brief  Handle a closed connection, starts a shortest slot in the role of the connection.
+ **************************************************************************************************/
+void roleSchedClosed(void);
+
+/***********************************************************************************************//**
+ *  \brief  Get the current role.
+ *  \return  The role of the current slot or of the open connection.
+ **************************************************************************************************/
+roleSchedRole_t roleSchedGetRole(void);
+
+
+/** @} (end addtogroup rolesched) */
+/** @} (end addtogroup Application) */
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif /* ROLE_SCHED_H */
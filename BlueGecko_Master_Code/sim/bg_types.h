@@ -0,0 +1,36 @@
+/***********************************************************************************************//**
+ * \file   bg_types.h
+ * \brief  Host stand-in for the BG stack types, used by the simulations in this directory
+ ***************************************************************************************************
+ * <b> (C) Copyright 2015 Silicon Labs, http://www.silabs.com</b>
+ ***************************************************************************************************
+ * This file is licensed under the Silabs License Agreement. See the file
+ * "Silabs_License_Agreement.txt" for details. Before using this software for
+ * any purpose, you must agree to the terms of that agreement.
+ **************************************************************************************************/
+
+#ifndef BG_TYPES_H
+#define BG_TYPES_H
+
+#include <stdint.h>
+
+typedef uint8_t  uint8;
+typedef uint16_t uint16;
+typedef uint32_t uint32;
+typedef int8_t   int8;
+typedef int16_t  int16;
+typedef int32_t  int32;
+
+typedef struct
+{
+  uint8 addr[6];
+} bd_addr;
+
+/* Fixed size on the host so that events can be built in static storage */
+typedef struct
+{
+  uint8 len;
+  uint8 data[255];
+} uint8array;
+
+#endif /* BG_TYPES_H */
@@ -0,0 +1,278 @@
+/***********************************************************************************************//**
+ * \file   conn_params_sim.c
+ * \brief  Host simulation of the connection parameter policy
+ ***************************************************************************************************
+ * <b> (C) Copyright 2015 Silicon Labs, http://www.silabs.com</b>
+ ***************************************************************************************************
+ * This file is licensed under the Silabs License Agreement. See the file
+ * "Silabs_License_Agreement.txt" for details. Before using this software for
+ * any purpose, you must agree to the terms of that agreement.
+ ***************************************************************************************************
+ * Runs conn_params.c against a stubbed gecko_cmd_le_connection_set_parameters and prints the
+ * latency and energy report of each policy. Exits non-zero if the policy does not settle on
+ * 7.5 ms while moving and 100 ms while still, if the glove wakes for more than half the events of
+ * a fixed 7.5 ms interval, or if refused and clamped requests are retried without bound.
+ * Build and run from BlueGecko_Master_Code:
+ *
+ *   gcc -O2 -Wall -Isim -I. -o conn_params_sim sim/conn_params_sim.c conn_params.c
+ *   ./conn_params_sim
+ **************************************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+/* BG stack headers */
+#include "bg_types.h"
+#include "native_gecko.h"
+
+/* application specific headers */
+#include "app_timer.h"
+#include "conn_params.h"
+
+/***************************************************************************************************
+  Local Macros and Definitions
+ **************************************************************************************************/
+
+/** Length of the motion trace. */
+#define SIM_DURATION_MS               60000
+
+/** Joint frames are sent every 20 ms while the arm moves. */
+#define SIM_FRAME_PERIOD_MS           20
+
+/** The stack applies a request after this many connection events at the old interval. */
+#define SIM_GRANT_EVENTS              6
+
+/** Interval of the link before the first request, 50 ms, the stack default. */
+#define SIM_DEFAULT_INTERVAL          40
+
+/** Stubbed link layer. */
+typedef struct
+{
+  uint16_t interval;              /**< Applied interval, 1.25 ms units */
+  uint16_t latency;
+  uint16_t timeout;
+  uint16_t minInterval;           /**< Shortest interval the peer accepts */
+  bool refuse;                    /**< Refuse every request */
+  bool pending;                   /**< A request waits to be applied */
+  uint32_t grantAtMs;
+  uint16_t nextInterval;
+  uint16_t nextLatency;
+  uint16_t nextTimeout;
+  uint32_t requests;
+} simLink_t;
+
+/***************************************************************************************************
+  Local Variables
+ **************************************************************************************************/
+
+static simLink_t simLink;
+static uint32_t simNowMs;
+
+static int simFailures;
+
+/***************************************************************************************************
+  Stubbed BG stack
+ **************************************************************************************************/
+
+void gecko_cmd_hardware_set_soft_timer(uint32 time, uint8 handle, uint8 single_shot)
+{
+  /* The simulation calls connParamsTimerTick() on its own period */
+  (void)time;
+  (void)handle;
+  (void)single_shot;
+}
+
+struct gecko_msg_le_connection_set_parameters_rsp_t *gecko_cmd_le_connection_set_parameters(uint8 connection,
+                                                                                           uint16 min_interval,
+                                                                                           uint16 max_interval,
+                                                                                           uint16 latency,
+                                                                                           uint16 timeout)
+{
+  static struct gecko_msg_le_connection_set_parameters_rsp_t rsp;
+
+  (void)connection;
+  (void)max_interval;
+
+  simLink.requests++;
+
+  if (simLink.refuse) {
+    rsp.result = 0x0181;          /* Invalid parameter */
+    return &rsp;
+  }
+
+  simLink.pending = true;
+  simLink.grantAtMs = simNowMs + (SIM_GRANT_EVENTS * simLink.interval * 5) / 4 + 1;
+  simLink.nextInterval = (min_interval < simLink.minInterval) ? simLink.minInterval : min_interval;
+  simLink.nextLatency = latency;
+  simLink.nextTimeout = timeout;
+
+  rsp.result = 0;
+  return &rsp;
+}
+
+/***************************************************************************************************
+  Simulation
+ **************************************************************************************************/
+
+/***********************************************************************************************//**
+ *  \brief  Record a failed check.
+ *  \param[in]  ok  Result of the check
+ *  \param[in]  what  Description of the check
+ **************************************************************************************************/
+static void simCheck(bool ok, const char *what)
+{
+  if (!ok) {
+    printf("FAIL: %s\n", what);
+    simFailures++;
+  }
+}
+
+/***********************************************************************************************//**
+ *  \brief  Open a link on the stubbed stack and start the policy on it.
+ *  \param[in]  connection  Connection handle
+ **************************************************************************************************/
+static void simOpen(uint8_t connection)
+{
+  simLink.interval = SIM_DEFAULT_INTERVAL;
+  simLink.latency = 0;
+  simLink.timeout = 100;
+  simLink.pending = false;
+  simLink.requests = 0;
+
+  connParamsStart(connection);
+  connParamsGranted(connection, simLink.interval, simLink.latency, simLink.timeout);
+}
+
+/***********************************************************************************************//**
+ *  \brief  Apply a pending request once its grant time has come.
+ *  \param[in]  connection  Connection handle
+ *  \param[in]  now  true to grant regardless of the time
+ **************************************************************************************************/
+static void simGrant(uint8_t connection, bool now)
+{
+  if (simLink.pending && (now || (simNowMs >= simLink.grantAtMs))) {
+    simLink.pending = false;
+    simLink.interval = simLink.nextInterval;
+    simLink.latency = simLink.nextLatency;
+    simLink.timeout = simLink.nextTimeout;
+    connParamsGranted(connection, simLink.interval, simLink.latency, simLink.timeout);
+  }
+}
+
+/***********************************************************************************************//**
+ *  \brief  Print the report of each policy and the glove's connection events against 7.5 ms.
+ **************************************************************************************************/
+static void simPrintReport(void)
+{
+  static const char *names[CONN_PARAMS_POLICY_COUNT] = { "active", "idle" };
+  connParamsReport_t report;
+  uint32_t policy;
+  uint32_t slaveEvents = 0;
+
+  for (policy = 0; policy < CONN_PARAMS_POLICY_COUNT; policy++) {
+    connParamsGetReport((connParamsPolicy_t)policy, &report);
+    slaveEvents += report.slaveEvents;
+
+    printf("  %-6s interval %3u latency %u timeout %3u  worst wait %6lu us  time %5lu ms  glove events %lu\n",
+           names[policy], report.interval, report.latency, report.timeout,
+           (unsigned long)report.worstLatencyUs, (unsigned long)report.timeMs,
+           (unsigned long)report.slaveEvents);
+  }
+
+  printf("  glove events in total %lu, %lu at a fixed 7.5 ms interval\n",
+         (unsigned long)slaveEvents, (unsigned long)(SIM_DURATION_MS * 4 / 30));
+
+  connParamsGetReport(CONN_PARAMS_POLICY_ACTIVE, &report);
+  simCheck(report.interval == 6, "active interval of 7.5 ms");
+  simCheck(report.worstLatencyUs <= 7500, "worst wait of 7.5 ms while moving");
+  connParamsGetReport(CONN_PARAMS_POLICY_IDLE, &report);
+  simCheck(report.interval == 80, "idle interval of 100 ms");
+  simCheck(slaveEvents < (SIM_DURATION_MS * 4 / 30) / 2, "glove events below half of a fixed 7.5 ms interval");
+}
+
+/***********************************************************************************************//**
+ *  \brief  Motion for 10 s, still for 20 s, motion for 5 s, still for 25 s.
+ **************************************************************************************************/
+static void simMotionTrace(void)
+{
+  bool moving;
+
+  simLink.minInterval = 6;
+  simLink.refuse = false;
+  simOpen(1);
+
+  for (simNowMs = 0; simNowMs < SIM_DURATION_MS; simNowMs++) {
+    simGrant(1, false);
+
+    moving = (simNowMs < 10000) || ((simNowMs >= 30000) && (simNowMs < 35000));
+    if (moving && ((simNowMs % SIM_FRAME_PERIOD_MS) == 0)) {
+      connParamsMotion();
+    }
+
+    if ((simNowMs % CONN_PARAMS_IDLE_CHECK_MS) == (CONN_PARAMS_IDLE_CHECK_MS - 1)) {
+      connParamsTimerTick();
+    }
+  }
+
+  printf("Motion trace, 15 s moving and 45 s still: %lu requests\n", (unsigned long)simLink.requests);
+  simPrintReport();
+  simCheck(simLink.requests <= 4, "one request per change of motion");
+
+  connParamsStop();
+}
+
+/***********************************************************************************************//**
+ *  \brief  The stack refuses every request, each idle check retries.
+ **************************************************************************************************/
+static void simRefused(void)
+{
+  int tick;
+
+  simLink.refuse = true;
+  simOpen(2);
+
+  for (tick = 0; tick < 10; tick++) {
+    connParamsTimerTick();
+  }
+
+  printf("Refused: %lu requests over 10 idle checks\n", (unsigned long)simLink.requests);
+  simCheck(simLink.requests <= 12, "refused requests retried at most once per idle check");
+
+  connParamsStop();
+}
+
+/***********************************************************************************************//**
+ *  \brief  The peer grants nothing below 15 ms, the policy accepts it after its retries.
+ **************************************************************************************************/
+static void simClamped(void)
+{
+  connParamsReport_t report;
+  int tick;
+
+  simLink.refuse = false;
+  simLink.minInterval = 12;
+  simOpen(3);
+
+  for (tick = 0; tick < 12; tick++) {
+    simGrant(3, true);
+    connParamsMotion();
+    connParamsTimerTick();
+  }
+
+  connParamsGetReport(CONN_PARAMS_POLICY_ACTIVE, &report);
+  printf("Clamped to 15 ms: %lu requests, active interval accepted %u\n",
+         (unsigned long)simLink.requests, report.interval);
+  simCheck((simLink.requests <= 3) && (report.interval == 12), "clamped interval accepted after the retries");
+
+  connParamsStop();
+}
+
+int main(void)
+{
+  simMotionTrace();
+  simRefused();
+  simClamped();
+
+  return simFailures ? 1 : 0;
+}
@@ -0,0 +1,229 @@
+/***********************************************************************************************//**
+ * \file   gatt_cache_sim.c
+ * \brief  Host simulation of the GATT handle cache on reconnect
+ ***************************************************************************************************
+ * <b> (C) Copyright 2015 Silicon Labs, http://www.silabs.com</b>
+ ***************************************************************************************************
+ * This file is licensed under the Silabs License Agreement. See the file
+ * "Silabs_License_Agreement.txt" for details. Before using this software for
+ * any purpose, you must agree to the terms of that agreement.
+ ***************************************************************************************************
+ * Follows the GATT steps of appHandleEvents from the open to the first joint sample, against
+ * gatt_cache.c and a stubbed persistent store:
+ * - Discovering the service and then the characteristic by UUID takes 2 ATT round trips each.
+ * - Enabling notifications takes 3 (find the CCCD, end of the search, write), or fails after 2
+ *   if the handle has no CCCD.
+ * - One round trip per connection event. The interval is 30 ms until the 7.5 ms of the
+ *   connection parameter policy applies, 6 events after the open.
+ * - The first joint sample then waits for the 20 ms flush of the glove and the next event.
+ * Exits non-zero if a reconnect to a cached glove discovers again, writes the store, or is not
+ * faster than the first connection, or if moved handles are not discovered again.
+ *
+ * Build and run from BlueGecko_Master_Code:
+ *
+ *   gcc -O2 -Wall -Isim -I. -o gatt_cache_sim sim/gatt_cache_sim.c gatt_cache.c
+ *   ./gatt_cache_sim
+ **************************************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+/* BG stack headers */
+#include "bg_types.h"
+#include "native_gecko.h"
+
+/* application specific headers */
+#include "gatt_cache.h"
+
+/***************************************************************************************************
+  Local Macros and Definitions
+ **************************************************************************************************/
+
+/** Connection events at 30 ms before the 7.5 ms interval applies. */
+#define SIM_SLOW_EVENTS               6
+
+/** The glove flushes its joint batch every 20 ms. */
+#define SIM_FLUSH_MS                  20.0
+
+/** Persistent store keys the stub holds, from GATT_CACHE_PS_KEY. */
+#define SIM_PS_KEYS                   16
+
+/** Handle of the temperature measurement value on the glove. */
+#define SIM_TEMP_HANDLE               0x0018
+
+/** Handle of the same value after a glove firmware update. */
+#define SIM_TEMP_HANDLE_MOVED         0x001C
+
+/***************************************************************************************************
+  Local Variables
+ **************************************************************************************************/
+
+static uint8 simPs[SIM_PS_KEYS][64];
+static uint8 simPsLen[SIM_PS_KEYS];
+static int simPsWrites;
+
+static int simEvents;
+static double simMs;
+static int simDiscoveries;
+
+static int simFailures;
+
+/* Handle of the temperature measurement value on the glove */
+static uint16 simServerTemp;
+
+/***************************************************************************************************
+  Stubbed BG stack
+ **************************************************************************************************/
+
+struct gecko_msg_flash_ps_load_rsp_t *gecko_cmd_flash_ps_load(uint16 key)
+{
+  static struct gecko_msg_flash_ps_load_rsp_t rsp;
+
+  key -= GATT_CACHE_PS_KEY;
+
+  rsp.result = simPsLen[key] ? 0 : 0x0502;     /* Key not found */
+  rsp.value.len = simPsLen[key];
+  memcpy(rsp.value.data, simPs[key], simPsLen[key]);
+  return &rsp;
+}
+
+struct gecko_msg_flash_ps_save_rsp_t *gecko_cmd_flash_ps_save(uint16 key, uint8 value_len, const uint8 *value_data)
+{
+  static struct gecko_msg_flash_ps_save_rsp_t rsp;
+
+  key -= GATT_CACHE_PS_KEY;
+
+  simPsLen[key] = value_len;
+  memcpy(simPs[key], value_data, value_len);
+  simPsWrites++;
+
+  rsp.result = 0;
+  return &rsp;
+}
+
+/***************************************************************************************************
+  Simulation
+ **************************************************************************************************/
+
+/***********************************************************************************************//**
+ *  \brief  Record a failed check.
+ *  \param[in]  ok  Result of the check
+ *  \param[in]  what  Description of the check
+ **************************************************************************************************/
+static void simCheck(bool ok, const char *what)
+{
+  if (!ok) {
+    printf("FAIL: %s\n", what);
+    simFailures++;
+  }
+}
+
+/***********************************************************************************************//**
+ *  \brief  Spend ATT round trips, one per connection event.
+ *  \param[in]  count  Round trips
+ **************************************************************************************************/
+static void simRoundTrips(int count)
+{
+  while (count-- > 0) {
+    simMs += (simEvents < SIM_SLOW_EVENTS) ? 30.0 : 7.5;
+    simEvents++;
+  }
+}
+
+/***********************************************************************************************//**
+ *  \brief  Enable notifications of a handle on the glove.
+ *  \param[in]  handle  Characteristic value handle
+ *  \return  true if the glove accepted it.
+ **************************************************************************************************/
+static bool simEnable(uint16 handle)
+{
+  if (handle != simServerTemp) {
+    simRoundTrips(2);
+    return false;
+  }
+
+  simRoundTrips(3);
+  return true;
+}
+
+/***********************************************************************************************//**
+ *  \brief  Connect to the glove, as appHandleEvents does.
+ *  \param[in]  address  Address of the glove
+ *  \return  Time from the open to the first joint sample, in ms.
+ **************************************************************************************************/
+static double simConnect(bd_addr address)
+{
+  gattCacheEntry_t entry;
+  bool cached;
+
+  simMs = 0;
+  simEvents = 0;
+
+  cached = gattCacheLookup(address, &entry);
+  if (!cached || !simEnable(entry.tempCharacteristic)) {
+    if (cached) {
+      gattCacheForget(address);
+    }
+
+    /* Service, then characteristic, then notifications */
+    simDiscoveries++;
+    simRoundTrips(2);
+    simRoundTrips(2);
+    simEnable(simServerTemp);
+
+    entry.address = address;
+    entry.tempCharacteristic = simServerTemp;
+    entry.humidCharacteristic = 0;
+    gattCacheStore(&entry);
+  }
+
+  simMs += SIM_FLUSH_MS;
+  simMs += (simEvents < SIM_SLOW_EVENTS) ? 30.0 : 7.5;
+  return simMs;
+}
+
+/***********************************************************************************************//**
+ *  \brief  Connect to the glove and print the time, with the running totals.
+ *  \param[in]  name  Name of the step
+ *  \param[in]  address  Address of the glove
+ *  \param[in]  discovers  true if the connection is expected to discover the handles
+ *  \return  Time from the open to the first joint sample, in ms.
+ **************************************************************************************************/
+static double simPrint(const char *name, bd_addr address, bool discovers)
+{
+  int discoveries = simDiscoveries;
+  int writes = simPsWrites;
+  double ms = simConnect(address);
+
+  printf("  %-24s first sample after %5.1f ms, %d discoveries, %d store writes\n",
+         name, ms, simDiscoveries, simPsWrites);
+
+  simCheck((simDiscoveries != discoveries) == discovers, name);
+  simCheck(discovers || (simPsWrites == writes), name);
+  return ms;
+}
+
+int main(void)
+{
+  bd_addr glove = { { 1, 2, 3, 4, 5, 6 } };
+  double first;
+
+  gattCacheInit();
+  simServerTemp = SIM_TEMP_HANDLE;
+
+  printf("Connections to one glove, running totals:\n");
+  first = simPrint("first connection", glove, true);
+  simCheck(simPrint("reconnect", glove, false) < first, "reconnect faster than the first connection");
+
+  /* A reset loses the RAM copy, the cache comes back from the store */
+  gattCacheInit();
+  simCheck(simPrint("reconnect after a reset", glove, false) < first, "reconnect after a reset faster than the first connection");
+
+  simServerTemp = SIM_TEMP_HANDLE_MOVED;
+  simPrint("handles moved", glove, true);
+  simCheck(simPrint("reconnect", glove, false) < first, "reconnect after moved handles faster than the first connection");
+
+  return simFailures ? 1 : 0;
+}
@@ -0,0 +1,105 @@
+/***********************************************************************************************//**
+ * \file   native_gecko.h
+ * \brief  Host stand-in for the BG stack API. Only the commands the simulated modules call are
+ *         declared, each simulation defines the ones it needs.
+ ***************************************************************************************************
+ * <b> (C) Copyright 2015 Silicon Labs, http://www.silabs.com</b>
+ ***************************************************************************************************
+ * This file is licensed under the Silabs License Agreement. See the file
+ * "Silabs_License_Agreement.txt" for details. Before using this software for
+ * any purpose, you must agree to the terms of that agreement.
+ **************************************************************************************************/
+
+#ifndef NATIVE_GECKO_H
+#define NATIVE_GECKO_H
+
+#include "bg_types.h"
+
+/***************************************************************************************************
+  Hardware
+ **************************************************************************************************/
+
+void gecko_cmd_hardware_set_soft_timer(uint32 time, uint8 handle, uint8 single_shot);
+
+/***************************************************************************************************
+  Persistent store
+ **************************************************************************************************/
+
+struct gecko_msg_flash_ps_load_rsp_t
+{
+  uint16 result;
+  uint8array value;
+};
+
+struct gecko_msg_flash_ps_save_rsp_t
+{
+  uint16 result;
+};
+
+struct gecko_msg_flash_ps_load_rsp_t *gecko_cmd_flash_ps_load(uint16 key);
+struct gecko_msg_flash_ps_save_rsp_t *gecko_cmd_flash_ps_save(uint16 key, uint8 value_len, const uint8 *value_data);
+
+/***************************************************************************************************
+  LE GAP
+ **************************************************************************************************/
+
+enum le_gap_discover_mode
+{
+  le_gap_discover_limited     = 0x0,
+  le_gap_discover_generic     = 0x1,
+  le_gap_discover_observation = 0x2
+};
+
+enum le_gap_discoverable_mode
+{
+  le_gap_non_discoverable     = 0x0,
+  le_gap_limited_discoverable = 0x1,
+  le_gap_general_discoverable = 0x2
+};
+
+enum le_gap_connectable_mode
+{
+  le_gap_non_connectable        = 0x0,
+  le_gap_directed_connectable   = 0x1,
+  le_gap_undirected_connectable = 0x2
+};
+
+struct gecko_msg_le_gap_scan_response_evt_t
+{
+  int8 rssi;
+  uint8 packet_type;
+  bd_addr address;
+  uint8 address_type;
+  uint8 bonding;
+  uint8array data;
+};
+
+struct gecko_msg_le_gap_open_rsp_t
+{
+  uint16 result;
+  uint8 connection;
+};
+
+void gecko_cmd_le_gap_end_procedure(void);
+void gecko_cmd_le_gap_set_scan_parameters(uint16 scan_interval, uint16 scan_window, uint8 active);
+void gecko_cmd_le_gap_discover(uint8 mode);
+struct gecko_msg_le_gap_open_rsp_t *gecko_cmd_le_gap_open(bd_addr address, uint8 address_type);
+void gecko_cmd_le_gap_set_mode(uint8 discover, uint8 connect);
+void gecko_cmd_le_gap_set_adv_parameters(uint16 interval_min, uint16 interval_max, uint8 channel_map);
+
+/***************************************************************************************************
+  LE connection
+ **************************************************************************************************/
+
+struct gecko_msg_le_connection_set_parameters_rsp_t
+{
+  uint16 result;
+};
+
+struct gecko_msg_le_connection_set_parameters_rsp_t *gecko_cmd_le_connection_set_parameters(uint8 connection,
+                                                                                           uint16 min_interval,
+                                                                                           uint16 max_interval,
+                                                                                           uint16 latency,
+                                                                                           uint16 timeout);
+
+#endif /* NATIVE_GECKO_H */
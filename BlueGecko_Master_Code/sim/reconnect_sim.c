@@ -0,0 +1,378 @@
+/***********************************************************************************************//**
+ * \file   reconnect_sim.c
+ * \brief  Host simulation of the reconnection to the glove
+ ***************************************************************************************************
+ * <b> (C) Copyright 2015 Silicon Labs, http://www.silabs.com</b>
+ ***************************************************************************************************
+ * This file is licensed under the Silabs License Agreement. See the file
+ * "Silabs_License_Agreement.txt" for details. Before using this software for
+ * any purpose, you must agree to the terms of that agreement.
+ ***************************************************************************************************
+ * Measures the time from link loss to data flowing, and the radio on time, over 500 seeded runs.
+ * - The glove advertises every 100 ms plus 0 to 10 ms, on channels 37, 38 and 39 0.5 ms apart,
+ *   with the Health Thermometer UUID in its advertising data.
+ * - Eight other connectable advertisers, without the UUID, advertise every 100 ms to 1 s.
+ * - The scanner hears a packet inside its window on the channel of the current interval. The
+ *   initiator listens all the time, 60 ms per channel.
+ * - GATT set up takes a fixed 300 ms once the connection is open.
+ * "Before" models the scanning reconnectStart() replaced: a continuous active scan that opens
+ * the connection to the first device that answers.
+ * Exits non-zero if the new scanning ever connects to another device or never to the glove, if a
+ * known glove is not back faster than before, or if it keeps the receiver on longer than before.
+ *
+ * Build and run from BlueGecko_Master_Code:
+ *
+ *   gcc -O2 -Wall -Isim -I. -o reconnect_sim sim/reconnect_sim.c reconnect.c
+ *   ./reconnect_sim
+ **************************************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* BG stack headers */
+#include "bg_types.h"
+#include "native_gecko.h"
+
+/* application specific headers */
+#include "app_timer.h"
+#include "reconnect.h"
+
+/***************************************************************************************************
+  Local Macros and Definitions
+ **************************************************************************************************/
+
+/** Simulation steps are 0.1 ms. */
+#define SIM_TICKS_PER_MS              10
+
+/** Each run ends after 60 s. */
+#define SIM_RUN_TICKS                 (60000 * SIM_TICKS_PER_MS)
+
+#define SIM_RUNS                      500
+
+/** Device 0 is the glove. */
+#define SIM_DEVICES                   9
+
+/** Time from the open to data flowing. */
+#define SIM_GATT_SETUP_TICKS          (300 * SIM_TICKS_PER_MS)
+
+/** Time the initiator listens on each channel. */
+#define SIM_INIT_CHANNEL_TICKS        (60 * SIM_TICKS_PER_MS)
+
+/** Run results other than a time. */
+#define SIM_WRONG_DEVICE              (-1)
+#define SIM_NEVER                     (-2)
+
+typedef enum
+{
+  SIM_BEFORE = 0,                 /**< Active scan, opens to the first scan response */
+  SIM_UNKNOWN,                    /**< reconnectStart(), glove never connected to */
+  SIM_KNOWN                       /**< reconnectClosed() after a drop of the glove */
+} simMode_t;
+
+/***************************************************************************************************
+  Local Variables
+ **************************************************************************************************/
+
+static long simNow;
+static long simTimerAt;
+
+static bool simScanning;
+static long simScanStart;
+static long simScanInterval;
+static long simScanWindow;
+
+static bool simOpening;
+static long simOpenStart;
+static int simOpenDevice;
+
+/* Ticks the receiver was on in the current run */
+static long simRadioOn;
+
+static int simDeviceCount;
+static bd_addr simAddress[SIM_DEVICES];
+static long simNextAdv[SIM_DEVICES];
+static long simAdvInterval[SIM_DEVICES];
+
+/* Flags, complete list of Health Thermometer, Device Information and Battery */
+static const uint8 simGloveAd[] = { 2, 1, 6, 7, 3, 0x09, 0x18, 0x0A, 0x18, 0x0F, 0x18 };
+/* Flags, complete list of Battery */
+static const uint8 simOtherAd[] = { 2, 1, 6, 3, 3, 0x0F, 0x18 };
+
+static int simFailures;
+
+/***************************************************************************************************
+  Stubbed BG stack
+ **************************************************************************************************/
+
+void gecko_cmd_hardware_set_soft_timer(uint32 time, uint8 handle, uint8 single_shot)
+{
+  (void)handle;
+  (void)single_shot;
+
+  simTimerAt = (time != TIMER_STOP) ? simNow + ((long)time * 1000 * SIM_TICKS_PER_MS) / 32768 : -1;
+}
+
+void gecko_cmd_le_gap_end_procedure(void)
+{
+  simScanning = false;
+  simOpening = false;
+}
+
+void gecko_cmd_le_gap_set_scan_parameters(uint16 scan_interval, uint16 scan_window, uint8 active)
+{
+  (void)active;
+
+  /* 0.625 ms units */
+  simScanInterval = (scan_interval * 625L * SIM_TICKS_PER_MS) / 1000;
+  simScanWindow = (scan_window * 625L * SIM_TICKS_PER_MS) / 1000;
+}
+
+void gecko_cmd_le_gap_discover(uint8 mode)
+{
+  (void)mode;
+
+  simScanning = true;
+  simScanStart = simNow;
+}
+
+struct gecko_msg_le_gap_open_rsp_t *gecko_cmd_le_gap_open(bd_addr address, uint8 address_type)
+{
+  static struct gecko_msg_le_gap_open_rsp_t rsp;
+  int dev;
+
+  (void)address_type;
+
+  simOpening = true;
+  simOpenStart = simNow;
+  simOpenDevice = -1;
+  for (dev = 0; dev < SIM_DEVICES; dev++) {
+    if (memcmp(address.addr, simAddress[dev].addr, sizeof(bd_addr)) == 0) {
+      simOpenDevice = dev;
+    }
+  }
+
+  rsp.result = 0;
+  rsp.connection = 1;
+  return &rsp;
+}
+
+/***************************************************************************************************
+  Simulation
+ **************************************************************************************************/
+
+/***********************************************************************************************//**
+ *  \brief  Record a failed check.
+ *  \param[in]  ok  Result of the check
+ *  \param[in]  what  Description of the check
+ **************************************************************************************************/
+static void simCheck(bool ok, const char *what)
+{
+  if (!ok) {
+    printf("FAIL: %s\n", what);
+    simFailures++;
+  }
+}
+
+static bool simScanHears(int channel)
+{
+  long elapsed = simNow - simScanStart;
+
+  return simScanning
+         && ((elapsed % simScanInterval) < simScanWindow)
+         && (((elapsed / simScanInterval) % 3) == channel);
+}
+
+static bool simInitHears(int channel)
+{
+  return simOpening && ((((simNow - simOpenStart) / SIM_INIT_CHANNEL_TICKS) % 3) == channel);
+}
+
+/***********************************************************************************************//**
+ *  \brief  Hand an advertisement to the scanning under test.
+ *  \param[in]  mode  Scanning under test
+ *  \param[in]  dev  Device that advertised
+ **************************************************************************************************/
+static void simAdvertised(simMode_t mode, int dev)
+{
+  static struct gecko_msg_le_gap_scan_response_evt_t resp;
+
+  memset(&resp, 0, sizeof(resp));
+  resp.address = simAddress[dev];
+  if (dev == 0) {
+    memcpy(resp.data.data, simGloveAd, sizeof(simGloveAd));
+    resp.data.len = sizeof(simGloveAd);
+  } else {
+    memcpy(resp.data.data, simOtherAd, sizeof(simOtherAd));
+    resp.data.len = sizeof(simOtherAd);
+  }
+
+  if (mode == SIM_BEFORE) {
+    gecko_cmd_le_gap_end_procedure();
+    gecko_cmd_le_gap_open(simAddress[dev], 0);
+  } else {
+    reconnectScanResponse(&resp);
+  }
+}
+
+/***********************************************************************************************//**
+ *  \brief  Run one link loss.
+ *  \param[in]  mode  Scanning under test
+ *  \param[in]  gloveBack  Ticks after the drop before the glove advertises again
+ *  \param[in]  seed  Seed of the advertising times
+ *  \return  Ticks until data flows, SIM_WRONG_DEVICE or SIM_NEVER.
+ **************************************************************************************************/
+static long simRun(simMode_t mode, long gloveBack, unsigned seed)
+{
+  int dev;
+  int k;
+  long offset;
+
+  srand(seed);
+  simNow = 0;
+  simTimerAt = -1;
+  simScanning = false;
+  simOpening = false;
+  simRadioOn = 0;
+
+  for (dev = 0; dev < SIM_DEVICES; dev++) {
+    simAdvInterval[dev] = (dev == 0) ? 1000 : 1000 + rand() % 9000;
+    simNextAdv[dev] = rand() % simAdvInterval[dev];
+    for (k = 0; k < 6; k++) {
+      simAddress[dev].addr[k] = (uint8)(dev * 17 + k);
+    }
+  }
+  simNextAdv[0] = gloveBack + rand() % 1000;
+
+  if (mode == SIM_BEFORE) {
+    /* 62.5 ms continuous active scan */
+    gecko_cmd_le_gap_set_scan_parameters(100, 100, 1);
+    gecko_cmd_le_gap_discover(le_gap_discover_generic);
+  } else if (mode == SIM_UNKNOWN) {
+    reconnectStart();
+  } else {
+    reconnectClosed();
+  }
+
+  for (; simNow < SIM_RUN_TICKS; simNow++) {
+    if ((simScanning && (((simNow - simScanStart) % simScanInterval) < simScanWindow)) || simOpening) {
+      simRadioOn++;
+    }
+
+    if ((simTimerAt >= 0) && (simNow >= simTimerAt)) {
+      simTimerAt = -1;
+      reconnectTimerTick();
+    }
+
+    for (dev = 0; dev < simDeviceCount; dev++) {
+      offset = simNow - simNextAdv[dev];
+
+      if ((offset == 0) || (offset == 5) || (offset == 10)) {
+        if (simInitHears(offset / 5) && (simOpenDevice == dev)) {
+          return (dev == 0) ? simNow + SIM_GATT_SETUP_TICKS : SIM_WRONG_DEVICE;
+        }
+        if (simScanHears(offset / 5)) {
+          simAdvertised(mode, dev);
+        }
+      }
+
+      if (offset == 10) {
+        simNextAdv[dev] += simAdvInterval[dev] + rand() % 100;
+      }
+    }
+  }
+
+  return SIM_NEVER;
+}
+
+/***********************************************************************************************//**
+ *  \brief  Run SIM_RUNS link losses and print the times.
+ *  \param[in]  mode  Scanning under test
+ *  \param[in]  name  Name of the scanning
+ *  \param[in]  gloveBackMs  Time after the drop before the glove advertises again
+ *  \param[out]  avgMs  Average time until data flows
+ *  \param[out]  radioOnS  Average receiver on time of a run
+ **************************************************************************************************/
+static void simReport(simMode_t mode, const char *name, long gloveBackMs, double *avgMs, double *radioOnS)
+{
+  unsigned seed;
+  long result;
+  long sum = 0;
+  long max = 0;
+  long radioOn = 0;
+  int ok = 0;
+  int wrong = 0;
+  int never = 0;
+  bd_addr glove;
+  int k;
+
+  for (seed = 1; seed <= SIM_RUNS; seed++) {
+    if (mode == SIM_KNOWN) {
+      for (k = 0; k < 6; k++) {
+        glove.addr[k] = (uint8)k;
+      }
+      reconnectOpened(glove, 0);
+    }
+
+    result = simRun(mode, gloveBackMs * SIM_TICKS_PER_MS, seed);
+    radioOn += simRadioOn;
+
+    if (result >= 0) {
+      ok++;
+      sum += result;
+      if (result > max) {
+        max = result;
+      }
+    } else if (result == SIM_WRONG_DEVICE) {
+      wrong++;
+    } else {
+      never++;
+    }
+  }
+
+  *avgMs = ok ? (double)sum / SIM_TICKS_PER_MS / ok : 0.0;
+  *radioOnS = (double)radioOn / (1000 * SIM_TICKS_PER_MS) / SIM_RUNS;
+
+  printf("  %-28s data after %6.1f ms avg %6.1f ms max, wrong device %3d/%d, never %d, radio on %4.1f s\n",
+         name, *avgMs, (double)max / SIM_TICKS_PER_MS, wrong, SIM_RUNS, never, *radioOnS);
+
+  if (mode != SIM_BEFORE) {
+    simCheck((wrong == 0) && (never == 0), name);
+  }
+}
+
+int main(void)
+{
+  static const long gloveBackMs[] = { 0, 20000 };
+  double beforeMs, beforeRadioS;
+  double aloneMs, aloneRadioS;
+  double afterMs, afterRadioS;
+  unsigned i;
+
+  for (i = 0; i < sizeof(gloveBackMs) / sizeof(gloveBackMs[0]); i++) {
+    printf("Glove back after %ld s:\n", gloveBackMs[i] / 1000);
+
+    simDeviceCount = SIM_DEVICES;
+    simReport(SIM_BEFORE, "before", gloveBackMs[i], &beforeMs, &beforeRadioS);
+
+    simDeviceCount = 1;
+    simReport(SIM_BEFORE, "before, glove alone", gloveBackMs[i], &aloneMs, &aloneRadioS);
+
+    /* reconnectOpened() is only called by SIM_KNOWN, so the glove is unknown until then */
+    simDeviceCount = SIM_DEVICES;
+    if (i == 0) {
+      simReport(SIM_UNKNOWN, "after, unknown glove", gloveBackMs[i], &afterMs, &afterRadioS);
+    }
+    simReport(SIM_KNOWN, "after, known glove", gloveBackMs[i], &afterMs, &afterRadioS);
+
+    /* Before, other devices make it connect to the wrong one, the glove alone is the best case */
+    if (i == 0) {
+      simCheck(afterMs < aloneMs, "known glove back faster than before");
+    }
+    simCheck(afterRadioS < aloneRadioS, "known glove found with less receiver time than before");
+  }
+
+  return simFailures ? 1 : 0;
+}
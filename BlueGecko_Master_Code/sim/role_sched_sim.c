@@ -0,0 +1,462 @@
+/***********************************************************************************************//**
+ * \file   role_sched_sim.c
+ * \brief  Host simulation of the master and slave role scheduling
+ ***************************************************************************************************
+ * <b> (C) Copyright 2015 Silicon Labs, http://www.silabs.com</b>
+ ***************************************************************************************************
+ * This file is licensed under the Silabs License Agreement. See the file
+ * "Silabs_License_Agreement.txt" for details. Before using this software for
+ * any purpose, you must agree to the terms of that agreement.
+ ***************************************************************************************************
+ * Compares role_sched.c, with reconnect.c, against alternating 20 s turns. 200 seeded runs of
+ * 600 s each, in 1 ms steps, for each mix of peers:
+ * - The glove advertises every 100 ms while present. A scan hears an advertisement with the
+ *   probability window / interval, an open in progress hears the next one. It is present for
+ *   20 to 90 s, then away for 10 to 120 s, and the link drops when it goes away.
+ * - A phone connects on one of our advertisements, every 100 ms, with the probability 0.3.
+ *   It stays connected for 20 s, then is away for 30 to 120 s.
+ * - The radio is on for the scan windows, the whole of an open and 1.5 ms per advertising
+ *   event. Connection events cost the same with both schemes and are not counted.
+ * The fixed turns keep the advertise turn while a phone is connected, as app.c did.
+ * Fails if the adaptive scheme keeps the radio on longer, or connects a peer later on average,
+ * than the fixed turns with the same peers.
+ *
+ * Build and run from BlueGecko_Master_Code:
+ *
+ *   gcc -O2 -Wall -Isim -I. -o role_sched_sim sim/role_sched_sim.c role_sched.c reconnect.c
+ *   ./role_sched_sim
+ **************************************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* BG stack headers */
+#include "bg_types.h"
+#include "native_gecko.h"
+
+/* application specific headers */
+#include "app_timer.h"
+#include "reconnect.h"
+#include "role_sched.h"
+
+/***************************************************************************************************
+  Local Macros and Definitions
+ **************************************************************************************************/
+
+#define SIM_RUNS                      200
+#define SIM_RUN_MS                    600000L
+
+/** Soft timers the stub keeps. */
+#define SIM_TIMERS                    (RECONNECT_TIMER + 1)
+
+/** Length of a turn of the fixed scheme. */
+#define SIM_FIXED_TURN_MS             20000
+
+/** Radio on time of one advertising event on three channels. */
+#define SIM_ADV_EVENT_MS              1.5
+
+/** A phone connects on one of our advertisements with this probability. */
+#define SIM_PHONE_CONNECT_P           0.3
+
+/** A phone stays connected this long. */
+#define SIM_PHONE_CONNECTED_MS        20000
+
+typedef enum
+{
+  SIM_PEER_NONE = 0,
+  SIM_PEER_GLOVE,
+  SIM_PEER_PHONE,
+  SIM_PEERS
+} simPeer_t;
+
+/***************************************************************************************************
+  Local Variables
+ **************************************************************************************************/
+
+static long simNow;
+static long simTimerAt[SIM_TIMERS];
+
+/* Stubbed radio */
+static bool simScanning;
+static bool simOpening;
+static bool simAdvertising;
+static uint16 simScanInterval = 1;
+static uint16 simScanWindow = 1;
+static double simRadioOnMs;
+
+static const bd_addr simGloveAddress = { { 1, 2, 3, 4, 5, 6 } };
+
+/* Peers, and the time of their next arrival or departure */
+static bool simGloveHere;
+static bool simPhoneHere;
+static long simGloveChange;
+static long simPhoneChange;
+static long simGloveSince;
+static long simPhoneSince;
+
+static simPeer_t simConnected;
+static long simPhoneLeaves;
+
+/* Time to connect, over the runs of a scheme */
+static double simLatencySum[SIM_PEERS];
+static int simLatencyCount[SIM_PEERS];
+static int simArrivals[SIM_PEERS];
+
+/* The fixed scheme is in its scan turn */
+static bool simFixedScanTurn;
+
+static int simFailures;
+
+/***************************************************************************************************
+  Stubbed BG stack
+ **************************************************************************************************/
+
+void gecko_cmd_hardware_set_soft_timer(uint32 time, uint8 handle, uint8 single_shot)
+{
+  (void)single_shot;
+
+  simTimerAt[handle] = (time != TIMER_STOP) ? simNow + ((long)time * 1000) / 32768 : -1;
+}
+
+void gecko_cmd_le_gap_end_procedure(void)
+{
+  simScanning = false;
+  simOpening = false;
+}
+
+void gecko_cmd_le_gap_set_scan_parameters(uint16 scan_interval, uint16 scan_window, uint8 active)
+{
+  (void)active;
+
+  simScanInterval = scan_interval;
+  simScanWindow = scan_window;
+}
+
+void gecko_cmd_le_gap_discover(uint8 mode)
+{
+  (void)mode;
+
+  simScanning = true;
+}
+
+struct gecko_msg_le_gap_open_rsp_t *gecko_cmd_le_gap_open(bd_addr address, uint8 address_type)
+{
+  static struct gecko_msg_le_gap_open_rsp_t rsp;
+
+  (void)address;
+  (void)address_type;
+
+  simScanning = false;
+  simOpening = true;
+
+  rsp.result = 0;
+  return &rsp;
+}
+
+void gecko_cmd_le_gap_set_mode(uint8 discover, uint8 connect)
+{
+  (void)discover;
+
+  simAdvertising = (connect != le_gap_non_connectable);
+}
+
+void gecko_cmd_le_gap_set_adv_parameters(uint16 interval_min, uint16 interval_max, uint8 channel_map)
+{
+  (void)interval_min;
+  (void)interval_max;
+  (void)channel_map;
+}
+
+/***************************************************************************************************
+  Simulation
+ **************************************************************************************************/
+
+/***********************************************************************************************//**
+ *  \brief  Record a failed check.
+ *  \param[in]  ok  Result of the check
+ *  \param[in]  what  Description of the check
+ **************************************************************************************************/
+static void simCheck(bool ok, const char *what)
+{
+  if (!ok) {
+    printf("FAIL: %s\n", what);
+    simFailures++;
+  }
+}
+
+static double simRandom(void)
+{
+  return rand() / (RAND_MAX + 1.0);
+}
+
+/***********************************************************************************************//**
+ *  \brief  Scan with the parameters the fixed scheme used, 62.5 ms continuous active scan.
+ **************************************************************************************************/
+static void simFixedScan(void)
+{
+  gecko_cmd_le_gap_set_scan_parameters(100, 100, 1);
+  gecko_cmd_le_gap_discover(le_gap_discover_generic);
+}
+
+/***********************************************************************************************//**
+ *  \brief  End a turn of the fixed scheme, when MASTER_SLAVE_RR_TIMER expires.
+ **************************************************************************************************/
+static void simFixedTimerTick(void)
+{
+  /* The advertise turn is kept while a phone is connected */
+  if (!simFixedScanTurn && (simConnected == SIM_PEER_PHONE)) {
+    simTimerAt[MASTER_SLAVE_RR_TIMER] = simNow + 5000;
+    return;
+  }
+
+  simFixedScanTurn = !simFixedScanTurn;
+  if (simFixedScanTurn) {
+    simAdvertising = false;
+    if (simConnected == SIM_PEER_NONE) {
+      simFixedScan();
+    }
+  } else {
+    simScanning = false;
+    simOpening = false;
+    if (simConnected == SIM_PEER_NONE) {
+      simAdvertising = true;
+    }
+  }
+
+  simTimerAt[MASTER_SLAVE_RR_TIMER] = simNow + SIM_FIXED_TURN_MS;
+}
+
+/***********************************************************************************************//**
+ *  \brief  A connection came up.
+ *  \param[in]  peer  Peer of the connection
+ *  \param[in]  adaptive  true for role_sched.c, false for the fixed turns
+ **************************************************************************************************/
+static void simOpened(simPeer_t peer, bool adaptive)
+{
+  simConnected = peer;
+  simScanning = false;
+  simOpening = false;
+  simAdvertising = false;
+
+  simLatencySum[peer] += simNow - ((peer == SIM_PEER_GLOVE) ? simGloveSince : simPhoneSince);
+  simLatencyCount[peer]++;
+
+  if (peer == SIM_PEER_PHONE) {
+    simPhoneLeaves = simNow + SIM_PHONE_CONNECTED_MS;
+  }
+
+  if (adaptive) {
+    if (peer == SIM_PEER_GLOVE) {
+      reconnectOpened(simGloveAddress, 0);
+    }
+    roleSchedOpened(peer == SIM_PEER_PHONE);
+  }
+}
+
+/***********************************************************************************************//**
+ *  \brief  The connection closed.
+ *  \param[in]  adaptive  true for role_sched.c, false for the fixed turns
+ **************************************************************************************************/
+static void simClosed(bool adaptive)
+{
+  simConnected = SIM_PEER_NONE;
+
+  if (adaptive) {
+    roleSchedClosed();
+  } else if (simFixedScanTurn) {
+    simFixedScan();
+  } else {
+    simAdvertising = true;
+  }
+}
+
+/***********************************************************************************************//**
+ *  \brief  The scan heard the glove.
+ *  \param[in]  adaptive  true for role_sched.c, false for the fixed turns
+ **************************************************************************************************/
+static void simGloveHeard(bool adaptive)
+{
+  static struct gecko_msg_le_gap_scan_response_evt_t resp;
+  /* Flags, complete list of Health Thermometer */
+  static const uint8 ad[] = { 2, 1, 6, 3, 3, 0x09, 0x18 };
+
+  if (!adaptive) {
+    gecko_cmd_le_gap_open(simGloveAddress, 0);
+    return;
+  }
+
+  memset(&resp, 0, sizeof(resp));
+  resp.address = simGloveAddress;
+  memcpy(resp.data.data, ad, sizeof(ad));
+  resp.data.len = sizeof(ad);
+
+  if (reconnectScanResponse(&resp)) {
+    roleSchedFound();
+  }
+}
+
+/***********************************************************************************************//**
+ *  \brief  Run one scripted 600 s.
+ *  \param[in]  adaptive  true for role_sched.c, false for the fixed turns
+ *  \param[in]  glove  true if the glove comes and goes
+ *  \param[in]  phone  true if a phone comes and goes
+ *  \param[in]  seed  Seed of the script
+ **************************************************************************************************/
+static void simRun(bool adaptive, bool glove, bool phone, unsigned seed)
+{
+  long nextGloveAdv;
+  long nextOwnAdv = 0;
+  int timer;
+
+  srand(seed);
+  simNow = 0;
+  simScanning = false;
+  simOpening = false;
+  simAdvertising = false;
+  simRadioOnMs = 0;
+  simConnected = SIM_PEER_NONE;
+  for (timer = 0; timer < SIM_TIMERS; timer++) {
+    simTimerAt[timer] = -1;
+  }
+
+  simGloveHere = false;
+  simPhoneHere = false;
+  simGloveChange = glove ? 5000 + rand() % 60000 : -1;
+  simPhoneChange = phone ? 5000 + rand() % 60000 : -1;
+
+  if (adaptive) {
+    roleSchedStart();
+  } else {
+    simFixedScanTurn = false;
+    simFixedTimerTick();
+  }
+
+  nextGloveAdv = rand() % 100;
+
+  for (; simNow < SIM_RUN_MS; simNow++) {
+    for (timer = 0; timer < SIM_TIMERS; timer++) {
+      if ((simTimerAt[timer] >= 0) && (simNow >= simTimerAt[timer])) {
+        simTimerAt[timer] = -1;
+        if (timer == RECONNECT_TIMER) {
+          reconnectTimerTick();
+        } else if (adaptive) {
+          roleSchedTimerTick();
+        } else {
+          simFixedTimerTick();
+        }
+      }
+    }
+
+    /* Presence script */
+    if ((simGloveChange >= 0) && (simNow >= simGloveChange)) {
+      simGloveHere = !simGloveHere;
+      if (simGloveHere) {
+        simGloveSince = simNow;
+        simArrivals[SIM_PEER_GLOVE]++;
+        simGloveChange = simNow + 20000 + rand() % 70000;
+      } else {
+        simGloveChange = simNow + 10000 + rand() % 110000;
+        if (simConnected == SIM_PEER_GLOVE) {
+          simClosed(adaptive);
+        }
+      }
+    }
+
+    if ((simPhoneChange >= 0) && (simNow >= simPhoneChange) && !simPhoneHere) {
+      simPhoneHere = true;
+      simPhoneSince = simNow;
+      simArrivals[SIM_PEER_PHONE]++;
+      simPhoneChange = -1;
+    }
+
+    if ((simConnected == SIM_PEER_PHONE) && (simNow >= simPhoneLeaves)) {
+      simPhoneHere = false;
+      simPhoneChange = simNow + 30000 + rand() % 90000;
+      simClosed(adaptive);
+    }
+
+    /* Radio */
+    if (simScanning) {
+      simRadioOnMs += (double)simScanWindow / simScanInterval;
+    }
+    if (simOpening) {
+      simRadioOnMs += 1;
+    }
+
+    if (simNow >= nextOwnAdv) {
+      nextOwnAdv = simNow + 100 + rand() % 10;
+      if (simAdvertising && (simConnected == SIM_PEER_NONE)) {
+        simRadioOnMs += SIM_ADV_EVENT_MS;
+        if (simPhoneHere && (simRandom() < SIM_PHONE_CONNECT_P)) {
+          simOpened(SIM_PEER_PHONE, adaptive);
+          continue;
+        }
+      }
+    }
+
+    if (simNow >= nextGloveAdv) {
+      nextGloveAdv = simNow + 100 + rand() % 10;
+      if (simGloveHere && (simConnected == SIM_PEER_NONE)) {
+        if (simOpening) {
+          simOpened(SIM_PEER_GLOVE, adaptive);
+          continue;
+        }
+        if (simScanning && (simRandom() < (double)simScanWindow / simScanInterval)) {
+          simGloveHeard(adaptive);
+        }
+      }
+    }
+  }
+}
+
+int main(void)
+{
+  static const char *names[] = { "nobody", "glove", "phone", "glove+phone" };
+  double radioOn[2];
+  double latency[2][SIM_PEERS];
+  simPeer_t peer;
+  int peers;
+  int adaptive;
+  int run;
+
+  for (peers = 0; peers < 4; peers++) {
+    for (adaptive = 0; adaptive < 2; adaptive++) {
+      memset(simLatencySum, 0, sizeof(simLatencySum));
+      memset(simLatencyCount, 0, sizeof(simLatencyCount));
+      memset(simArrivals, 0, sizeof(simArrivals));
+      radioOn[adaptive] = 0;
+
+      for (run = 0; run < SIM_RUNS; run++) {
+        simRun(adaptive, (peers & 1) != 0, (peers & 2) != 0, 1000 + run);
+        radioOn[adaptive] += simRadioOnMs;
+      }
+
+      for (peer = SIM_PEER_GLOVE; peer < SIM_PEERS; peer++) {
+        latency[adaptive][peer] = simLatencyCount[peer] ? simLatencySum[peer] / simLatencyCount[peer] / 1000 : 0.0;
+      }
+
+      printf("%-12s %-8s radio on %5.1f %%", names[peers], adaptive ? "adaptive" : "fixed",
+             100.0 * radioOn[adaptive] / SIM_RUNS / SIM_RUN_MS);
+      if (peers & 1) {
+        printf("  glove %5.2f s (%d/%d)", latency[adaptive][SIM_PEER_GLOVE],
+               simLatencyCount[SIM_PEER_GLOVE], simArrivals[SIM_PEER_GLOVE]);
+      }
+      if (peers & 2) {
+        printf("  phone %5.2f s (%d/%d)", latency[adaptive][SIM_PEER_PHONE],
+               simLatencyCount[SIM_PEER_PHONE], simArrivals[SIM_PEER_PHONE]);
+      }
+      printf("\n");
+    }
+
+    simCheck(radioOn[1] < radioOn[0], "adaptive radio on time below the fixed turns");
+    simCheck(!(peers & 1) || (latency[1][SIM_PEER_GLOVE] <= latency[0][SIM_PEER_GLOVE]),
+             "adaptive glove connection no later than the fixed turns");
+    simCheck(!(peers & 2) || (latency[1][SIM_PEER_PHONE] <= latency[0][SIM_PEER_PHONE]),
+             "adaptive phone connection no later than the fixed turns");
+  }
+
+  return simFailures ? 1 : 0;
+}
@@ -30,6 +30,7 @@
 #include "em_system.h"
 #include "em_cmu.h"
 #include "em_gpio.h"
+#include "em_rtcc.h"
 
 /* application specific headers */
 #include "app_ui.h"
@@ -74,6 +75,9 @@ int8 rssi = 0;
  Local Variables
  **************************************************************************************************/
 
+/* DMADRV channel receiving the joint words from the LEUART */
+static unsigned int leuart_rx_dma_channel;
+
 /***************************************************************************************************
  Static Function Declarations
  **************************************************************************************************/
@@ -84,6 +88,8 @@ int8 rssi = 0;
 static void (*dispPolarityInvert)(void *);
   #endif /* FEATURE_IOEXPANDER */
 
+static bool LDMA_Rx_Done(unsigned int channel, unsigned int sequenceNo, void *userParam);
+
 /***************************************************************************************************
  Function Definitions
  **************************************************************************************************/
@@ -115,9 +121,6 @@ void appInit(void)
 
   /* Hardware initialization. Initializes temperature sensor. */
   appHwInit();
-
-  /* Initialize services */
-  htmInit();
 }
 
 void manage_power_led()
@@ -169,7 +172,6 @@ void manage_alarm_led()
  **************************************************************************************************/
 void appHandleEvents(struct gecko_cmd_packet *evt)
 {
-	static int i = 0;
 	/* Flag for indicating DFU Reset must be performed */
 	static uint8_t boot_to_dfu = 0;
 
@@ -215,6 +217,9 @@ void appHandleEvents(struct gecko_cmd_packet *evt)
 		 * units of (milliseconds * 1.6). The third parameter '7' sets advertising on all channels. */
 		gecko_cmd_le_gap_set_adv_parameters(160,160,7);
 
+		/* Ask for a larger ATT MTU, so that one notification carries several joint samples */
+		gecko_cmd_gatt_set_max_mtu(HTM_MAX_MTU);
+
 		/* Set the transmit power :
 		 * power - parameter to be set to configure the tx power
 		 * TX power in 0.1dBm steps, for example the value of 10 is 1dBm and 55 is 5.5dBm*/
@@ -237,22 +242,30 @@ void appHandleEvents(struct gecko_cmd_packet *evt)
 		 * 2) sent a confirmation upon a successful reception of the indication. */
 	case gecko_evt_le_connection_closed_id:
 
-		/* Initialize app */
-		appInit(); /* App initialization */
-		htmInit(); /* Health thermometer initialization */
-		advSetup(); /* Advertisement initialization */
+		htmConnectionClosed(evt->data.evt_le_connection_closed.connection); /* Drop the clients of the connection */
 
 		/* Enter to DFU OTA mode if needed */
 		if (boot_to_dfu) {
 			gecko_cmd_system_reset(2);
 		}
 
-		connected = 0;
+		if (connected) {
+			connected--;
+		}
 		//gecko_cmd_hardware_set_soft_timer(32768, ALARM_TIMER, false);
 
 		//gecko_cmd_hardware_set_soft_timer(TIMER_STOP, LED_TIMER, false);
 
-		GPIO_PinOutClear(gpioPortF, 4);
+		if (!connected) {
+			/* The last client is gone, back to the boot state: re-initialize the app and the
+			 * advertisement, power LED off */
+			appInit(); /* App initialization */
+			advSetup(); /* Advertisement initialization */
+			GPIO_PinOutClear(gpioPortF, 4);
+		} else {
+			/* The other clients stay served, a slot is free again for a further client */
+			gecko_cmd_le_gap_set_mode(le_gap_general_discoverable, le_gap_undirected_connectable);
+		}
 
 		break;
 
@@ -262,7 +275,12 @@ void appHandleEvents(struct gecko_cmd_packet *evt)
 		advConnectionStarted();
 		/* Connection Open Event */
 
-		connected = 1;
+		connected++;
+
+		/* Keep advertising, so that further clients can connect */
+		if (connected < HTM_MAX_CONNECTIONS) {
+			gecko_cmd_le_gap_set_mode(le_gap_general_discoverable, le_gap_undirected_connectable);
+		}
 
 		gecko_cmd_hardware_set_soft_timer(32768, LED_TIMER, false);
 
@@ -274,6 +292,16 @@ void appHandleEvents(struct gecko_cmd_packet *evt)
 
 		break;
 
+		/* ATT MTU exchanged with the master */
+	case gecko_evt_gatt_mtu_exchanged_id:
+		htmMtuExchanged(evt->data.evt_gatt_mtu_exchanged.connection, evt->data.evt_gatt_mtu_exchanged.mtu);
+		break;
+
+		/* Raised by htmJointSampleQueue() from the LDMA interrupt */
+	case gecko_evt_system_external_signal_id:
+		htmJointSignal(evt->data.evt_system_external_signal.extsignals);
+		break;
+
 		/* Value of attribute changed from the local database by remote GATT client */
 	case gecko_evt_gatt_server_attribute_value_id:
 		/* Check if changed characteristic is the Immediate Alert level */
@@ -294,58 +322,42 @@ void appHandleEvents(struct gecko_cmd_packet *evt)
 					evt->data.evt_gatt_server_characteristic_status.client_config_flags);
 		}
 
+		/* Check if changed client char config is for the humidity */
+		if ((gattdb_humidity_measurement == evt->data.evt_gatt_server_characteristic_status.characteristic)
+				&& (evt->data.evt_gatt_server_characteristic_status.status_flags == 0x01)) {
+			htmHumidityCharStatusChange(
+					evt->data.evt_gatt_server_characteristic_status.connection,
+					evt->data.evt_gatt_server_characteristic_status.client_config_flags);
+		}
+
 		break;
 
 		/* Software Timer event */
 	case gecko_evt_hardware_soft_timer_id:
 		/* Check which software timer handle is in question */
 		switch (evt->data.evt_hardware_soft_timer.handle) {
-		case UI_TIMER: /* App UI Timer (LEDs, Buttons) */
+		case UI_TIMER: /* App UI Timer (LEDs, Buttons, LCD) */
+			htmDisplayRefresh();
 			appUiTick();
 			break;
 		case ADV_TIMER: /* Advertisement Timer */
 			advSetup();
 			break;
 		case TEMP_TIMER: /* Temperature measurement timer */
-#if defined(SEND_FLEX_SENSOR_DATA_INSTEAD_OF_TEMP_DATA)
-			while(i < READ_SIZE)
-			{
-				if (sensor_data_buffer[i] == sensor_data_buffer_dummy[i])
-				{
-					is_leuart_data_available = false;
-					break;
-				}
-				i++;
-			}
-
-			if (i == READ_SIZE)
-			{
-				is_leuart_data_available = true;
-			}
-
-			i = 0;
-
-			if (is_leuart_data_available == true)
-			{
-				/* Make a temperature measurement */
-				htmTemperatureMeasure();
-				is_leuart_data_available = false;
-			}
-#else
+			/* With SEND_FLEX_SENSOR_DATA_INSTEAD_OF_TEMP_DATA this sends the joint samples queued so far */
 			htmTemperatureMeasure();
-#endif
+			break;
+		case SENSOR_TIMER: /* Humidity and temperature conversion */
+			appHwSensorMeasure();
+			break;
+		case SENSOR_READ_TIMER: /* Humidity and temperature conversion done */
+			appHwSensorRead();
 			break;
 		case HUMIDITY_TIMER:
-			appHwReadHumidity((uint32_t *)&humidityData);
-
-			htmHumidityMeas.humidity = humidityData/1000;
-
-			//htmHumidityMeas.humidity = 45;
-
-			gecko_cmd_gatt_server_write_attribute_value(gattdb_humidity_measurement,
-					0,
-					sizeof(struct htmHumidityMeas_t),
-					(uint8_t *)&htmHumidityMeas);
+			/* Subscribed clients are notified when the humidity changes */
+			if (appHwReadHumidity((uint32_t *)&humidityData) == 0) {
+				htmHumidityUpdate(humidityData/1000);
+			}
 			break;
 #ifndef FEATURE_IOEXPANDER
 		case DISP_POL_INV_TIMER:
@@ -499,17 +511,31 @@ void LDMA_SetUp(void)
 	/* Set the bit to trigger the DMA Done Interrupt */
 	xfer.xfer.doneIfs = 1;
 
-	/* LDMA initialization mode definition */
-	LDMA_Init_t init = LDMA_INIT_DEFAULT;
+	/* The stack links DMADRV, which owns the LDMA interrupt. Taking the channel from
+	 * it gets LDMA_Rx_Done called for every joint word received. */
+	DMADRV_Init();
+	DMADRV_AllocateChannel(&leuart_rx_dma_channel, NULL);
+	DMADRV_LdmaStartTransfer(leuart_rx_dma_channel, (LDMA_TransferCfg_t *)&periTransferRx, &xfer,
+			LDMA_Rx_Done, NULL);
+
+}
 
-	/* Enable the interrupts */
-	LDMA->IEN = 0x01;
-	NVIC_EnableIRQ(LDMA_IRQn);
+/************************************************************************************
+ * @function 	LDMA_Rx_Done
+ * @params 		channel, sequenceNo, userParam - DMADRV callback parameters, unused
+ * @brief 		Called from the LDMA interrupt when a joint word has been received,
+ * 				queues it with its reception time for the next notification.
+ ************************************************************************************/
+static bool LDMA_Rx_Done(unsigned int channel, unsigned int sequenceNo, void *userParam)
+{
+	uint32_t joints = (sensor_data_buffer[0] | sensor_data_buffer[1] << 8 |
+				sensor_data_buffer[2] << 16 | sensor_data_buffer[3] << 24);
 
-	/* LDMA initialization */
-	LDMA_Init(&init);
-	LDMA_StartTransfer(0, (LDMA_TransferCfg_t *)&periTransferRx, &xfer);
+	/* The RTCC counts at HTM_JOINT_TICK_HZ */
+	htmJointSampleQueue(joints, (uint16_t)RTCC_CounterGet());
 
+	/* Keep the descriptor looping */
+	return true;
 }
 
 void LEUART0_IRQHandler(void)
@@ -13,6 +13,10 @@
 
 /* BG stack headers */
 #include "bg_types.h"
+#include "native_gecko.h"
+
+/* em library */
+#include "em_rtcc.h"
 
 /* STK header files. */
 #include "bspconfig.h"
@@ -27,6 +31,7 @@
 /* application specific headers */
 #include "advertisement.h"
 #include "app_ui.h"
+#include "app_timer.h"
 
 /* Own headers*/
 #include "app_hw.h"
@@ -57,6 +62,12 @@
 /** Status flag of the Temperature Sensor. */
 static bool si7013_status = false;
 
+/** Last humidity and temperature conversion, shared by all readers. */
+static appHwSensorData_t appHwSensorData = { .valid = false };
+
+/** Reads of the conversion in progress, 0 if none is in progress. */
+static uint8_t appHwSensorReads = 0;
+
 /** I2C init structure. */
 
 /***************************************************************************************************
@@ -78,19 +89,79 @@ void appHwInit(void)
   if (!appHwInitTempSens())
   {
     appUiWriteString(APP_HW_SENSOR_FAIL_TEXT); /* Display error message on screen. */
+    return;
   }
+
+  /* One conversion gives both humidity and temperature, run it on its own timer
+   * and let the temperature and humidity services read the cached result */
+  appHwSensorReads = 0;
+  appHwSensorMeasure();
+  gecko_cmd_hardware_set_soft_timer(TIMER_MS_2_TIMERTICK(APP_HW_SENSOR_PERIOD_MS), SENSOR_TIMER, false);
 }
 
 int32_t appHwReadTm(int32_t* tempData)
 {
-  uint32_t rhData = 0;
-  return Si7013_MeasureRHAndTemp(I2C0, SI7021_ADDR, &rhData, tempData);
+  if (!appHwSensorData.valid) {
+    return -1;
+  }
+
+  *tempData = appHwSensorData.tempData;
+  return 0;
 }
 
 int32_t appHwReadHumidity(uint32_t* humidityData)
 {
-  int32_t tData = 0;
-  return Si7013_MeasureRHAndTemp(I2C0, SI7021_ADDR, humidityData, &tData);
+  if (!appHwSensorData.valid) {
+    return -1;
+  }
+
+  *humidityData = appHwSensorData.rhData;
+  return 0;
+}
+
+void appHwSensorMeasure(void)
+{
+  /* The previous conversion is still being read */
+  if (!si7013_status || (appHwSensorReads != 0)) {
+    return;
+  }
+
+  /* Only the command goes over the bus here. The sensor converts on its own and
+   * NACKs reads until it is done, so the event loop keeps running meanwhile. */
+  if (Si7013_StartNoHoldMeasureRHAndTemp(I2C0, SI7021_ADDR) != 0) {
+    return;
+  }
+
+  appHwSensorReads = APP_HW_SENSOR_MAX_READS;
+  gecko_cmd_hardware_set_soft_timer(TIMER_MS_2_TIMERTICK(APP_HW_SENSOR_CONV_MS), SENSOR_READ_TIMER, true);
+}
+
+void appHwSensorRead(void)
+{
+  uint32_t rhData;
+  int32_t tempData;
+
+  if (appHwSensorReads == 0) {
+    return;
+  }
+  appHwSensorReads--;
+
+  /* A failed conversion keeps the last good result */
+  if (Si7013_ReadNoHoldRHAndTemp(I2C0, SI7021_ADDR, &rhData, &tempData) == 0) {
+    appHwSensorData.rhData = rhData;
+    appHwSensorData.tempData = tempData;
+    appHwSensorData.timestamp = RTCC_CounterGet();
+    appHwSensorData.valid = true;
+    appHwSensorReads = 0;
+  } else if (appHwSensorReads != 0) {
+    /* Not done yet, look again shortly */
+    gecko_cmd_hardware_set_soft_timer(TIMER_MS_2_TIMERTICK(APP_HW_SENSOR_RETRY_MS), SENSOR_READ_TIMER, true);
+  }
+}
+
+const appHwSensorData_t *appHwSensorGet(void)
+{
+  return &appHwSensorData;
 }
 
 bool appHwInitTempSens(void)
@@ -16,6 +16,7 @@
 extern "C" {
 #endif
 
+#include <stdint.h>
 #include <stdbool.h>
 
 /***********************************************************************************************//**
@@ -34,10 +35,31 @@ extern "C" {
  **************************************************************************************************/
 
 
+/***************************************************************************************************
+  Public Macros and Definitions
+***************************************************************************************************/
+
+/** Period of the humidity and temperature conversion in ms. */
+#define APP_HW_SENSOR_PERIOD_MS         1000
+/** Longest RH and temperature conversion in ms, 12 bit RH and 14 bit temperature. */
+#define APP_HW_SENSOR_CONV_MS           25
+/** Wait before reading again while the sensor still NACKs its result, in ms. */
+#define APP_HW_SENSOR_RETRY_MS          5
+/** Reads of one conversion before it is given up. */
+#define APP_HW_SENSOR_MAX_READS         4
+
 /***************************************************************************************************
   Data Types
 ***************************************************************************************************/
 
+/** Result of the last humidity and temperature conversion. */
+typedef struct {
+  uint32_t rhData;    /**< Relative humidity in milli-percent */
+  int32_t tempData;   /**< Temperature in milli-Celsius */
+  uint32_t timestamp; /**< RTCC count when the conversion was read */
+  bool valid;         /**< Set once a conversion has succeeded */
+} appHwSensorData_t;
+
 /***************************************************************************************************
   Function Declarations
 ***************************************************************************************************/
@@ -48,14 +70,37 @@ extern "C" {
 void appHwInit(void);
 
 /***********************************************************************************************//**
- *  \brief  Perform a temperature measurement.  Return the measurement data.
- *  \param[out]  tempData  Result of temperature conversion.
- *  \return  0 if Temp Read successful, otherwise -1
+ *  \brief  Get the temperature of the last conversion.
+ *  \param[out]  tempData  Temperature in milli-Celsius.
+ *  \return  0 if a conversion has succeeded, otherwise -1
  **************************************************************************************************/
 int32_t appHwReadTm(int32_t* tempData);
 
+/***********************************************************************************************//**
+ *  \brief  Get the relative humidity of the last conversion.
+ *  \param[out]  humidityData  Relative humidity in milli-percent.
+ *  \return  0 if a conversion has succeeded, otherwise -1
+ **************************************************************************************************/
 int32_t appHwReadHumidity(uint32_t* humidityData);
 
+/***********************************************************************************************//**
+ *  \brief  Start one humidity and temperature conversion, without waiting for it.
+ *          To be called when SENSOR_TIMER expires.
+ **************************************************************************************************/
+void appHwSensorMeasure(void);
+
+/***********************************************************************************************//**
+ *  \brief  Read the conversion started by appHwSensorMeasure() and cache both results.
+ *          To be called when SENSOR_READ_TIMER expires.
+ **************************************************************************************************/
+void appHwSensorRead(void);
+
+/***********************************************************************************************//**
+ *  \brief  Get the cached result of the last conversion.
+ *  \return  Pointer to the cached result
+ **************************************************************************************************/
+const appHwSensorData_t *appHwSensorGet(void);
+
 /***********************************************************************************************//**
  *  \brief  Initialise temperature measurement.
  *  \return  true if a Si7013 is detected, false otherwise
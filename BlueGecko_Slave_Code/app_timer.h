@@ -60,6 +60,10 @@ typedef enum
   /* */
   LED_TIMER,
   ALARM_TIMER,
+  /** Humidity and temperature sensor timer. */
+  SENSOR_TIMER,
+  /** Humidity and temperature conversion done timer. */
+  SENSOR_READ_TIMER,
 } appTimer_t;
 
 
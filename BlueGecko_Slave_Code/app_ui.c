@@ -65,6 +65,8 @@
 
 /** UI Timer periodical call frequency in ms. */
 #define APP_UITIMER_PERIOD            100
+/** LCD refresh period in ms, a multiple of the UI Timer period. */
+#define APP_LCD_REFRESH_PERIOD        500
 #define APP_RC_DISCHARGE_PERIOD       2
 /** Max. short Press Duration as a multiple of 100 ms. */
 #define APP_SHORT_PRESS_DUR           20
@@ -145,6 +147,7 @@ static void appUiLedTimerCback(void);
 static uint8_t appUiPushButtonsGet(uint8_t button);
 static void appUiButtonTimerCallback(void);
 static void appUiBtnSendEvent(AppUiBtnEvt_t btn);
+static void appUiLcdRefresh(void);
 
 #ifdef FEATURE_LED_BUTTON_ON_SAME_PIN
 static void appUiButtonInit(void);
@@ -224,6 +227,8 @@ void appUiTick(void)
     appUiLedsInit();
     appUiLedTimerCback();
 
+    appUiLcdRefresh();
+
     /* Restart timer */
     gecko_cmd_hardware_set_soft_timer(TIMER_MS_2_TIMERTICK(APP_UITIMER_PERIOD - APP_RC_DISCHARGE_PERIOD), UI_TIMER, false);
 
@@ -236,6 +241,7 @@ void appUiTick(void)
 {
   appUiLedTimerCback();
   appUiButtonTimerCallback();
+  appUiLcdRefresh();
   gecko_cmd_hardware_set_soft_timer(TIMER_MS_2_TIMERTICK(APP_UITIMER_PERIOD), UI_TIMER, false);
 }
 #endif /* BRD4300A */
@@ -244,6 +250,7 @@ void appUiTick(void)
 void appUiWriteString(char *string)
 {
 #ifdef FEATURE_LCD_SUPPORT
+  /* Drawn on the next LCD refresh */
   graphWriteString(string);
 #endif /* BRD4301A */
 }
@@ -252,6 +259,21 @@ void appUiWriteString(char *string)
  Static Function Definitions
  **************************************************************************************************/
 
+/***********************************************************************************************//**
+ *  \brief  Timer callback for the LCD, draws the text changed since the last refresh.
+ **************************************************************************************************/
+static void appUiLcdRefresh(void)
+{
+#ifdef FEATURE_LCD_SUPPORT
+  static uint8_t appUiLcdTicks = 0;
+
+  if (++appUiLcdTicks >= (APP_LCD_REFRESH_PERIOD / APP_UITIMER_PERIOD)) {
+    appUiLcdTicks = 0;
+    graphRefresh();
+  }
+#endif /* BRD4301A */
+}
+
 /***********************************************************************************************//**
  *  \brief  Timer callback for driving the LEDs on the DK based on the requested sequence.
  **************************************************************************************************/
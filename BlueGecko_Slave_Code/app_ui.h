@@ -117,7 +117,7 @@ void appUiInit(uint16 devId);
 void appUiTick(void);
 
 /***********************************************************************************************//**
- *  \brief  Write string to graphical display.
+ *  \brief  Write string to graphical display. The LCD is updated on the next refresh.
  *  \param[in]  string  String to be displayed.
  **************************************************************************************************/
 void appUiWriteString(char *string);
@@ -22,6 +22,15 @@
 /* Own header */
 #include "graphics.h"
 
+/***************************************************************************************************
+ Local Macros and Definitions
+ **************************************************************************************************/
+
+/** Text lines kept for the display, 128 pixels high with the narrow font */
+#define GRAPH_MAX_LINES       12
+/** Characters per line, 128 pixels wide with the narrow font */
+#define GRAPH_LINE_LEN        21
+
 /***************************************************************************************************
  Local Variables
  **************************************************************************************************/
@@ -32,11 +41,15 @@ static GLIB_Context_t glibContext;
 static uint8_t graphLineNum = 0;
 /* Device name string */
 static char *deviceHeader = NULL;
+/* Text on the display, and the lines to draw on the next refresh */
+static char graphLines[GRAPH_MAX_LINES][GRAPH_LINE_LEN + 1];
+static uint16_t graphDirtyLines = 0;
 
 /***************************************************************************************************
  Static Function Declarations
  **************************************************************************************************/
 static void graphPrintCenter(GLIB_Context_t *pContext, char *pString);
+static void graphDrawLine(GLIB_Context_t *pContext, uint8_t line);
 
 /***************************************************************************************************
  Function Definitions
@@ -69,21 +82,61 @@ void graphInit(char *header)
   /* Use Narrow font */
   GLIB_setFont(&glibContext, (GLIB_Font_t *)&GLIB_FontNarrow6x8);
 
+  /* Start from a blank frame, refreshes only redraw the lines that change */
+  GLIB_clear(&glibContext);
+
+  /* The frame is blank, so the stored text is too, and every line is drawn on the next refresh */
+  memset(graphLines, 0, sizeof(graphLines));
+  graphDirtyLines = (1 << GRAPH_MAX_LINES) - 1;
+  graphLineNum = 0;
+
   deviceHeader = header;
 }
 
 void graphWriteString(char *string)
 {
-  GLIB_clear(&glibContext);
-
-  /* Reset line number, print header and device name */
+  /* Only the text is stored here, graphRefresh() draws the lines that changed */
   graphLineNum = 0;
   graphPrintCenter(&glibContext, deviceHeader);
-
-  /* Print the string below the header center aligned */
   graphPrintCenter(&glibContext, string);
+  /* A last line without a new line character is kept too */
+  if ((*string != '\0') && (string[strlen(string) - 1] != '\n'))
+  {
+    graphLineNum++;
+  }
+
+  /* Lines left over from a longer text are blanked */
+  for (; graphLineNum < GRAPH_MAX_LINES; graphLineNum++)
+  {
+    if (graphLines[graphLineNum][0] != '\0')
+    {
+      graphLines[graphLineNum][0] = '\0';
+      graphDirtyLines |= (1 << graphLineNum);
+    }
+  }
+}
+
+bool graphRefresh(void)
+{
+  uint8_t line;
+
+  if (graphDirtyLines == 0)
+  {
+    return false;
+  }
+
+  for (line = 0; line < GRAPH_MAX_LINES; line++)
+  {
+    if (graphDirtyLines & (1 << line))
+    {
+      graphDrawLine(&glibContext, line);
+    }
+  }
+  graphDirtyLines = 0;
 
   DMD_updateDisplay();
+
+  return true;
 }
 
 /***************************************************************************************************
@@ -91,7 +144,7 @@ void graphWriteString(char *string)
  **************************************************************************************************/
 
 /***********************************************************************************************//**
- *  \brief  Print the given string center aligned
+ *  \brief  Store the given string in the text lines, marking the lines that change
  *  \note   The string may contain several lines separated by new line
  *          characters ('\n'). Each line will be printed center aligned.
  *  \param[in]  pContext  Context
@@ -108,14 +161,18 @@ static void graphPrintCenter(GLIB_Context_t *pContext, char *pString)
     for (nextToken = pString; ((*nextToken != '\n') && (*nextToken != '\0')); nextToken++);
 
     len = nextToken - pString;
-    /* Print the line if it is not null length */
-    if (len)
+    if (len > GRAPH_LINE_LEN)
     {
-      uint8_t strWidth = len * pContext->font.fontWidth;
-      uint8_t posX = (pContext->pDisplayGeometry->xSize - strWidth) >> 1;
-      uint8_t posY = (pContext->font.lineSpacing + pContext->font.fontHeight) * graphLineNum +
-                     pContext->font.lineSpacing;
-      GLIB_drawString(pContext, pString, len, posX, posY, 0);
+      len = GRAPH_LINE_LEN;
+    }
+    /* Keep the line if it differs from what is on the display */
+    if ((graphLineNum < GRAPH_MAX_LINES)
+        && ((strncmp(graphLines[graphLineNum], pString, len) != 0)
+            || (graphLines[graphLineNum][len] != '\0')))
+    {
+      memcpy(graphLines[graphLineNum], pString, len);
+      graphLines[graphLineNum][len] = '\0';
+      graphDirtyLines |= (1 << graphLineNum);
     }
     pString = nextToken;
     /* If the token at the end of the line is new line character, then increase line number */
@@ -127,4 +184,33 @@ static void graphPrintCenter(GLIB_Context_t *pContext, char *pString)
   } while (*pString); /* while terminating NULL is not reached */
 }
 
+/***********************************************************************************************//**
+ *  \brief  Clear one text line and draw it center aligned
+ *  \param[in]  pContext  Context
+ *  \param[in]  line  Line number
+ **************************************************************************************************/
+static void graphDrawLine(GLIB_Context_t *pContext, uint8_t line)
+{
+  uint8_t len = strlen(graphLines[line]);
+  uint8_t lineHeight = pContext->font.lineSpacing + pContext->font.fontHeight;
+  GLIB_Rectangle_t rect;
+
+  /* Blank the line, rectangles are filled with the foreground color */
+  rect.xMin = 0;
+  rect.xMax = pContext->pDisplayGeometry->xSize - 1;
+  rect.yMin = lineHeight * line;
+  rect.yMax = rect.yMin + lineHeight - 1;
+  pContext->foregroundColor = White;
+  GLIB_drawRectFilled(pContext, &rect);
+  pContext->foregroundColor = Black;
+
+  if (len)
+  {
+    uint8_t strWidth = len * pContext->font.fontWidth;
+    uint8_t posX = (pContext->pDisplayGeometry->xSize - strWidth) >> 1;
+    uint8_t posY = lineHeight * line + pContext->font.lineSpacing;
+    GLIB_drawString(pContext, graphLines[line], len, posX, posY, 0);
+  }
+}
+
 
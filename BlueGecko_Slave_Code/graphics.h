@@ -12,6 +12,8 @@
 #ifndef GRAPHICS_H
 #define GRAPHICS_H
 
+#include <stdbool.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -32,6 +34,12 @@ void graphInit(char* header);
  **************************************************************************************************/
 void graphWriteString(char *string);
 
+/***********************************************************************************************//**
+ *  \brief  Draw the text lines changed since the last refresh and update the LCD
+ *  \return  true if the LCD was updated
+ **************************************************************************************************/
+bool graphRefresh(void);
+
 
 #ifdef __cplusplus
 }
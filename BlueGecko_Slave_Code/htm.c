@@ -11,6 +11,7 @@
 /* standard library headers */
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 #include <stdbool.h>
 
 /* BG stack headers */
@@ -81,7 +82,7 @@
 #define HTM_TT                              HTM_TT_ARMPIT
 /* Other profile specific macros */
 /* Text definitions*/
-#define HTM_TEMP_VALUE_TEXT                 "\nTemperature:\n%3.1f C / %3.1f F\n"
+#define HTM_TEMP_VALUE_TEXT                 "\nTemperature:\n"
 #define HTM_TEMP_VALUE_TEXT_DEFAULT  	    "\nTemperature:\n---.- C / ---.- F\n"
 #define HTM_TEMP_VALUE_TEXT_SIZE     	    (sizeof(HTM_TEMP_VALUE_TEXT_DEFAULT))
 
@@ -106,6 +107,16 @@
 #define HTM_TEMP_IND_TIMEOUT                1000
 /** Indicates currently there is no active connection using this service. */
 #define HTM_NO_CONNECTION                   0xFF
+/** Notification payload length for an ATT MTU. */
+#define HTM_MTU_TO_PAYLOAD_LEN(mtu)         ((mtu) - 3)
+/** Joint samples the queue holds, a power of 2 that divides 256. */
+#define HTM_JOINT_QUEUE_LEN                 64
+/** Joint samples a client can fall behind by before its oldest ones are skipped. */
+#define HTM_JOINT_MAX_LAG                   (HTM_JOINT_QUEUE_LEN / 2)
+/** Characteristics a client can subscribe to, the temperature measurement and the humidity. */
+#define HTM_NOTIFY_CHARACTERISTICS          2
+/** Subscriber table entries, every connection to every characteristic. */
+#define HTM_MAX_SUBSCRIBERS                 (HTM_MAX_CONNECTIONS * HTM_NOTIFY_CHARACTERISTICS)
 /***************************************************************************************************
  Local Type Definitions
  **************************************************************************************************/
@@ -133,6 +144,20 @@ typedef struct {
   uint16_t period; /**< Measurement timer expiration period in seconds */
 } htmTempMeas_t;
 
+/** Client subscribed to a characteristic. */
+typedef struct {
+  uint8_t connection;      /**< Connection ID, HTM_NO_CONNECTION if the entry is free */
+  uint16_t characteristic; /**< Characteristic of the CCCD */
+  uint16_t clientConfig;   /**< Value of the CCCD */
+  uint8_t tail;            /**< Next joint sample to send to this client */
+  uint32_t dropped;        /**< Joint samples skipped while this client could not keep up */
+} htmSubscriber_t;
+
+/** Notification payload length of a connection. */
+typedef struct {
+  uint8_t connection;      /**< Connection ID, HTM_NO_CONNECTION if the entry is free */
+  uint8_t payloadLen;      /**< From the exchanged ATT MTU */
+} htmLink_t;
 
 /***************************************************************************************************
  Local Variables
@@ -152,12 +177,45 @@ static htmDateTime_t htmDateTime = { 2000, /*! Year, 0 means not known */
                                      0     /*! Seconds */
 };
 
-static uint8_t htmClientConnection = HTM_NO_CONNECTION; /* Current connection or 0xFF if invalid */
+/* Clients, keyed by connection and characteristic */
+static htmSubscriber_t htmSubscribers[HTM_MAX_SUBSCRIBERS];
+/* Connections that exchanged their MTU */
+static htmLink_t htmLinks[HTM_MAX_CONNECTIONS];
+
+/* Humidity sent to the clients, not valid until the first update */
+static bool htmHumidityValid = false;
+
+/* Temperature to show on the LCD in milli-Celsius, formatted on the next refresh */
+static int32_t htmDisplayTemp;
+static bool htmDisplayDirty = false;
+
+/* Joint sample queue, filled by the LDMA interrupt. Samples are stored encoded,
+ * every client is sent the same bytes. The indexes run free, the head is only
+ * written by the producer and the tail, the slowest client, by the consumer. */
+static uint8_t htmJointQueue[HTM_JOINT_QUEUE_LEN][HTM_JOINT_SAMPLE_LEN];
+static volatile uint8_t htmJointHead = 0;
+static volatile uint8_t htmJointTail = 0;
+/* Smallest batch of the clients, 0 while nobody is subscribed */
+static volatile uint8_t htmJointFullCount = 0;
+/* Samples queued since the last HTM_JOINT_SIGNAL_FULL */
+static uint8_t htmJointSinceFull = 0;
+/* TEMP_TIMER is running for a flush */
+static bool htmJointFlushArmed = false;
+/* Samples lost while the queue was full */
+static uint32_t htmJointDropped = 0;
 
 /***************************************************************************************************
  Static Function Declarations
  **************************************************************************************************/
 static uint8_t htmBuildTempMeas(uint8_t *pBuf, htmTempMeas_t *pTempMeas);
+static htmSubscriber_t *htmSubscribe(uint8_t connection, uint16_t characteristic, uint16_t clientConfig);
+static bool htmIsSubscribed(uint16_t characteristic);
+static uint8_t htmLinkPayloadLen(uint8_t connection);
+static uint8_t htmJointBatchLen(uint8_t payloadLen);
+static char *htmFormatTenths(char *pBuf, int32_t milli);
+static void htmJointFlush(bool fullOnly);
+static void htmJointFlushArm(void);
+static void htmJointSubscribersChanged(void);
 
 /***************************************************************************************************
  Public Function Definitions
@@ -168,9 +226,20 @@ static uint8_t htmBuildTempMeas(uint8_t *pBuf, htmTempMeas_t *pTempMeas);
  **************************************************************************************************/
 void htmInit(void)
 {
-	htmClientConnection = HTM_NO_CONNECTION; /* Initially no connection is set. */
+	uint8_t i;
+
+	/* Initially no connection is set. */
+	for (i = 0; i < HTM_MAX_SUBSCRIBERS; i++) {
+		htmSubscribers[i].connection = HTM_NO_CONNECTION;
+	}
+	for (i = 0; i < HTM_MAX_CONNECTIONS; i++) {
+		htmLinks[i].connection = HTM_NO_CONNECTION;
+	}
+	htmJointSubscribersChanged();
+	htmHumidityValid = false;
 
 	gecko_cmd_hardware_set_soft_timer(TIMER_STOP, TEMP_TIMER, true); /* Initially stop the timer. */
+	htmJointFlushArmed = false;
 }
 
 /***********************************************************************************************//**
@@ -179,12 +248,80 @@ void htmInit(void)
 void htmTemperatureCharStatusChange(uint8_t connection, uint16_t clientConfig)
 {
 	/* If the new value of Client Characteristic Config is not 0 (either indication or
-	 * notification enabled) update connection ID and start temp. measurement */
-	if (clientConfig) {
-		htmClientConnection = connection; /* Save connection ID */
+	 * notification enabled) add the client and start temp. measurement */
+	if (htmSubscribe(connection, gattdb_temp_measurement, clientConfig) != NULL) {
+		htmJointSubscribersChanged();
 		htmTemperatureMeasure(); /* Make an initial measurement of temperature */
 	} else {
+		htmJointSubscribersChanged();
+		if (!htmIsSubscribed(gattdb_temp_measurement)) {
+			gecko_cmd_hardware_set_soft_timer(TIMER_STOP, TEMP_TIMER, true);
+			htmJointFlushArmed = false;
+		}
+	}
+}
+
+/***********************************************************************************************//**
+ *  \brief Function that is called when the Client Characteristic Configuration of the humidity
+ *         has changed.
+ **************************************************************************************************/
+void htmHumidityCharStatusChange(uint8_t connection, uint16_t clientConfig)
+{
+	/* A new client gets the current humidity straight away, not on the next change */
+	if ((htmSubscribe(connection, gattdb_humidity_measurement, clientConfig) != NULL) && htmHumidityValid) {
+		gecko_cmd_gatt_server_send_characteristic_notification(connection, gattdb_humidity_measurement,
+				sizeof(struct htmHumidityMeas_t), (uint8_t *)&htmHumidityMeas);
+	}
+}
+
+/***********************************************************************************************//**
+ *  \brief Function that is called periodically by the application with the last humidity.
+ **************************************************************************************************/
+void htmHumidityUpdate(uint16_t humidity)
+{
+	htmSubscriber_t *sub;
+
+	if (htmHumidityValid && (htmHumidityMeas.humidity == humidity)) {
+		return;
+	}
+	htmHumidityMeas.humidity = humidity;
+	htmHumidityValid = true;
+
+	/* Keep the value up to date for clients that read it */
+	gecko_cmd_gatt_server_write_attribute_value(gattdb_humidity_measurement, 0,
+			sizeof(struct htmHumidityMeas_t), (uint8_t *)&htmHumidityMeas);
+
+	/* The stack notifies or indicates, as each client configured it */
+	for (sub = htmSubscribers; sub < &htmSubscribers[HTM_MAX_SUBSCRIBERS]; sub++) {
+		if ((sub->connection != HTM_NO_CONNECTION) && (sub->characteristic == gattdb_humidity_measurement)) {
+			gecko_cmd_gatt_server_send_characteristic_notification(sub->connection, gattdb_humidity_measurement,
+					sizeof(struct htmHumidityMeas_t), (uint8_t *)&htmHumidityMeas);
+		}
+	}
+}
+
+/***********************************************************************************************//**
+ *  \brief Function that is called when a connection is closed.
+ **************************************************************************************************/
+void htmConnectionClosed(uint8_t connection)
+{
+	uint8_t i;
+
+	for (i = 0; i < HTM_MAX_SUBSCRIBERS; i++) {
+		if (htmSubscribers[i].connection == connection) {
+			htmSubscribers[i].connection = HTM_NO_CONNECTION;
+		}
+	}
+	for (i = 0; i < HTM_MAX_CONNECTIONS; i++) {
+		if (htmLinks[i].connection == connection) {
+			htmLinks[i].connection = HTM_NO_CONNECTION;
+		}
+	}
+	htmJointSubscribersChanged();
+
+	if (!htmIsSubscribed(gattdb_temp_measurement)) {
 		gecko_cmd_hardware_set_soft_timer(TIMER_STOP, TEMP_TIMER, true);
+		htmJointFlushArmed = false;
 	}
 }
 
@@ -193,28 +330,148 @@ void htmTemperatureCharStatusChange(uint8_t connection, uint16_t clientConfig)
  **************************************************************************************************/
 void htmTemperatureMeasure(void)
 {
+#if defined(SEND_FLEX_SENSOR_DATA_INSTEAD_OF_TEMP_DATA)
+	/* Send the queued joint samples, as many per notification as the MTU of each client takes */
+	htmJointFlushArmed = false;
+	htmJointFlush(false);
+
+	/* Samples the stack had no buffers for go out with the next flush */
+	if (htmJointHead != htmJointTail) {
+		htmJointFlushArm();
+	}
+#else
 	uint8_t htmTempBuffer[ATT_DEFAULT_PAYLOAD_LEN]; /* Stores the temperature data in the HTM format. */
 	uint8_t length; /* Length of the temperature measurement characteristic */
+	htmSubscriber_t *sub;
 
-	/* Check if the connection is still open */
-	if (HTM_NO_CONNECTION == htmClientConnection) {
+	/* Check if any client is still subscribed */
+	if (!htmIsSubscribed(gattdb_temp_measurement)) {
 		return;
 	}
 
 	/* Create the temperature measurement characteristic in htmTempBuffer and store its length */
 	length = htmProcMsg(htmTempBuffer);
 
-	/* Send indication of the temperature in htmTempBuffer to all "listening" clients.
-	 * This enables the Health Thermometer in the Blue Gecko app to display the temperature.
-	 *  0xFF as connection ID will send indications to all connections. */
-	struct gecko_msg_gatt_server_send_characteristic_notification_rsp_t* temp_notif_rsp =
+	/* Send the temperature in htmTempBuffer to all "listening" clients.
+	 * This enables the Health Thermometer in the Blue Gecko app to display the temperature. */
+	for (sub = htmSubscribers; sub < &htmSubscribers[HTM_MAX_SUBSCRIBERS]; sub++) {
+		if ((sub->connection != HTM_NO_CONNECTION) && (sub->characteristic == gattdb_temp_measurement)) {
 			gecko_cmd_gatt_server_send_characteristic_notification(
-					htmClientConnection, gattdb_temp_measurement, length, htmTempBuffer);
-
-	uint16 temp_notif_rsp_res = temp_notif_rsp->result;
+					sub->connection, gattdb_temp_measurement, length, htmTempBuffer);
+		}
+	}
 
 	/* Start the repeating timer for temperature measurement */
 	gecko_cmd_hardware_set_soft_timer(TIMER_MS_2_TIMERTICK(htmTempMeas.period), TEMP_TIMER, true);
+#endif
+}
+
+/***********************************************************************************************//**
+ *  \brief Function that is called periodically by the application to show the last temperature.
+ **************************************************************************************************/
+void htmDisplayRefresh(void)
+{
+	char tempString[HTM_TEMP_VALUE_TEXT_SIZE]; /* Temperature as string for the LCD */
+	char *p = tempString;
+
+	if (!htmDisplayDirty) {
+		return;
+	}
+	htmDisplayDirty = false;
+
+	/* Temp in C and F should both appear on LCD display, F = C * 1.8 + 32 */
+	strcpy(p, HTM_TEMP_VALUE_TEXT);
+	p = htmFormatTenths(p + strlen(HTM_TEMP_VALUE_TEXT), htmDisplayTemp);
+	strcpy(p, " C / ");
+	p = htmFormatTenths(p + strlen(" C / "), htmDisplayTemp * 9 / 5 + 32000);
+	strcpy(p, " F\n");
+
+	/* Write the string to LCD */
+	appUiWriteString(tempString);
+}
+
+/***********************************************************************************************//**
+ *  \brief Function that is called when the ATT MTU of the connection has been exchanged.
+ **************************************************************************************************/
+void htmMtuExchanged(uint8_t connection, uint16_t mtu)
+{
+	htmLink_t *link = NULL;
+	uint8_t i;
+
+	if (mtu > HTM_MAX_MTU) {
+		mtu = HTM_MAX_MTU;
+	}
+
+	for (i = 0; i < HTM_MAX_CONNECTIONS; i++) {
+		if (htmLinks[i].connection == connection) {
+			link = &htmLinks[i];
+			break;
+		}
+		if ((link == NULL) && (htmLinks[i].connection == HTM_NO_CONNECTION)) {
+			link = &htmLinks[i];
+		}
+	}
+	if (link == NULL) {
+		return;
+	}
+
+	link->connection = connection;
+	link->payloadLen = (uint8_t)HTM_MTU_TO_PAYLOAD_LEN(mtu);
+	htmJointSubscribersChanged();
+}
+
+/***********************************************************************************************//**
+ *  \brief Function that is called by the LDMA interrupt for every joint word received.
+ **************************************************************************************************/
+void htmJointSampleQueue(uint32_t joints, uint16_t timestamp)
+{
+	uint8_t head = htmJointHead;
+	uint8_t count = (uint8_t)(head - htmJointTail);
+	uint8_t fullCount = htmJointFullCount;
+	uint8_t *p;
+
+	/* Nobody to send to */
+	if (fullCount == 0) {
+		return;
+	}
+
+	/* Keep the queued samples in order, drop the new one */
+	if (count >= HTM_JOINT_QUEUE_LEN) {
+		htmJointDropped++;
+		return;
+	}
+
+	/* Encoded here once, whatever the number of clients */
+	p = htmJointQueue[head & (HTM_JOINT_QUEUE_LEN - 1)];
+	UINT16_TO_BITSTREAM(p, timestamp);
+	UINT32_TO_BITSTREAM(p, joints);
+	htmJointHead = head + 1;
+
+	/* Commands can not be sent from here, the main loop gets an external signal event */
+	if (count == 0) {
+		gecko_external_signal(HTM_JOINT_SIGNAL_QUEUED);
+	}
+	if (++htmJointSinceFull >= fullCount) {
+		htmJointSinceFull = 0;
+		gecko_external_signal(HTM_JOINT_SIGNAL_FULL);
+	}
+}
+
+/***********************************************************************************************//**
+ *  \brief Function that is called by the application on an external signal event.
+ **************************************************************************************************/
+void htmJointSignal(uint32_t signals)
+{
+	if (signals & HTM_JOINT_SIGNAL_FULL) {
+		/* Whole notifications are waiting, no point in holding them back. Clients
+		 * with a larger MTU keep filling theirs until the flush timer expires. */
+		htmJointFlush(true);
+	}
+
+	/* Give the batches a chance to fill before they are sent */
+	if (htmJointHead != htmJointTail) {
+		htmJointFlushArm();
+	}
 }
 
 /***************************************************************************************************
@@ -257,6 +514,236 @@ static uint8_t htmBuildTempMeas(uint8_t *pBuf, htmTempMeas_t *pTempMeas)
 	return (uint8_t)(p - pBuf);
 }
 
+/***********************************************************************************************//**
+ *  \brief  Write a value in thousandths as a decimal with one digit after the point.
+ *  \param[in]  pBuf  Buffer to write to, not terminated.
+ *  \param[in]  milli  Value in thousandths, rounded to the nearest tenth.
+ *  \return  Pointer past the last character written.
+ **************************************************************************************************/
+static char *htmFormatTenths(char *pBuf, int32_t milli)
+{
+	char digits[10];
+	uint8_t n = 0;
+	uint32_t tenths;
+
+	if (milli < 0) {
+		*pBuf++ = '-';
+		tenths = ((uint32_t)-(milli + 1) + 51) / 100;
+	} else {
+		tenths = ((uint32_t)milli + 50) / 100;
+	}
+
+	/* Digits come out lowest first, the tenths digit and at least one before the point */
+	do {
+		digits[n++] = '0' + (tenths % 10);
+		tenths /= 10;
+	} while ((tenths != 0) || (n < 2));
+
+	while (n > 1) {
+		*pBuf++ = digits[--n];
+	}
+	*pBuf++ = '.';
+	*pBuf++ = digits[0];
+
+	return pBuf;
+}
+
+/***********************************************************************************************//**
+ *  \brief  Add, update or remove the subscription of a client to a characteristic.
+ *  \param[in]  connection  Connection ID.
+ *  \param[in]  characteristic  Characteristic of the CCCD.
+ *  \param[in]  clientConfig  New value of the CCCD, 0 removes the subscription.
+ *  \return  The subscriber, NULL if removed or the table is full.
+ **************************************************************************************************/
+static htmSubscriber_t *htmSubscribe(uint8_t connection, uint16_t characteristic, uint16_t clientConfig)
+{
+	htmSubscriber_t *sub;
+	htmSubscriber_t *freeSub = NULL;
+
+	for (sub = htmSubscribers; sub < &htmSubscribers[HTM_MAX_SUBSCRIBERS]; sub++) {
+		if ((sub->connection == connection) && (sub->characteristic == characteristic)) {
+			break;
+		}
+		if ((freeSub == NULL) && (sub->connection == HTM_NO_CONNECTION)) {
+			freeSub = sub;
+		}
+	}
+
+	if (sub == &htmSubscribers[HTM_MAX_SUBSCRIBERS]) {
+		if ((clientConfig == 0) || (freeSub == NULL)) {
+			return NULL;
+		}
+		/* A new client starts with the samples queued from now on */
+		sub = freeSub;
+		sub->connection = connection;
+		sub->characteristic = characteristic;
+		sub->tail = htmJointHead;
+		sub->dropped = 0;
+	} else if (clientConfig == 0) {
+		sub->connection = HTM_NO_CONNECTION;
+		return NULL;
+	}
+
+	sub->clientConfig = clientConfig;
+	return sub;
+}
+
+/***********************************************************************************************//**
+ *  \brief  Check if any client is subscribed to a characteristic.
+ *  \param[in]  characteristic  Characteristic of the CCCD.
+ *  \return  true if at least one client is subscribed.
+ **************************************************************************************************/
+static bool htmIsSubscribed(uint16_t characteristic)
+{
+	htmSubscriber_t *sub;
+
+	for (sub = htmSubscribers; sub < &htmSubscribers[HTM_MAX_SUBSCRIBERS]; sub++) {
+		if ((sub->connection != HTM_NO_CONNECTION) && (sub->characteristic == characteristic)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/***********************************************************************************************//**
+ *  \brief  Notification payload length of a connection.
+ *  \param[in]  connection  Connection ID.
+ *  \return  Payload length from the exchanged MTU, the default if not exchanged.
+ **************************************************************************************************/
+static uint8_t htmLinkPayloadLen(uint8_t connection)
+{
+	uint8_t i;
+
+	for (i = 0; i < HTM_MAX_CONNECTIONS; i++) {
+		if (htmLinks[i].connection == connection) {
+			return htmLinks[i].payloadLen;
+		}
+	}
+	return ATT_DEFAULT_PAYLOAD_LEN;
+}
+
+/***********************************************************************************************//**
+ *  \brief  Number of joint samples a notification takes.
+ *  \param[in]  payloadLen  Notification payload length.
+ *  \return  Samples per batch.
+ **************************************************************************************************/
+static uint8_t htmJointBatchLen(uint8_t payloadLen)
+{
+	return (payloadLen - HTM_JOINT_BATCH_HDR_LEN) / HTM_JOINT_SAMPLE_LEN;
+}
+
+/***********************************************************************************************//**
+ *  \brief  Send the queued joint samples to every client, oldest first, in as few notifications
+ *          as the MTU of each client allows. A client the stack runs out of buffers for keeps its
+ *          remaining samples queued, the other clients are still served.
+ *  \param[in]  fullOnly  Only send whole batches, a partial one waits for more samples.
+ **************************************************************************************************/
+static void htmJointFlush(bool fullOnly)
+{
+	uint8_t htmJointBuffer[HTM_MTU_TO_PAYLOAD_LEN(HTM_MAX_MTU)]; /* Stores one batch */
+	uint8_t *p;
+	uint8_t head = htmJointHead;
+	uint8_t count;
+	uint8_t batchLen;
+	uint8_t builtTail = 0;
+	uint8_t builtCount = 0;
+	uint8_t i;
+	htmSubscriber_t *sub;
+	struct gecko_msg_gatt_server_send_characteristic_notification_rsp_t *rsp;
+
+	for (sub = htmSubscribers; sub < &htmSubscribers[HTM_MAX_SUBSCRIBERS]; sub++) {
+		if ((sub->connection == HTM_NO_CONNECTION) || (sub->characteristic != gattdb_temp_measurement)) {
+			continue;
+		}
+
+		batchLen = htmJointBatchLen(htmLinkPayloadLen(sub->connection));
+
+		while ((count = (uint8_t)(head - sub->tail)) != 0) {
+			if (count > batchLen) {
+				count = batchLen;
+			} else if (fullOnly && (count < batchLen)) {
+				break;
+			}
+
+			/* Clients level with the previous one get the batch already in the buffer */
+			if ((count != builtCount) || (sub->tail != builtTail)) {
+				p = htmJointBuffer;
+				UINT8_TO_BITSTREAM(p, HTM_FLAG_JOINT_BATCH);
+				UINT8_TO_BITSTREAM(p, count);
+				for (i = 0; i < count; i++, p += HTM_JOINT_SAMPLE_LEN) {
+					memcpy(p, htmJointQueue[(uint8_t)(sub->tail + i) & (HTM_JOINT_QUEUE_LEN - 1)],
+							HTM_JOINT_SAMPLE_LEN);
+				}
+				builtTail = sub->tail;
+				builtCount = count;
+			}
+
+			rsp = gecko_cmd_gatt_server_send_characteristic_notification(sub->connection,
+					gattdb_temp_measurement, HTM_JOINT_BATCH_HDR_LEN + count * HTM_JOINT_SAMPLE_LEN,
+					htmJointBuffer);
+			if (rsp->result != 0) {
+				break;
+			}
+
+			/* Sent, the slots can be reused once every client is past them */
+			sub->tail += count;
+		}
+
+		/* A client that can not keep up skips its oldest samples, rather than
+		 * filling the queue and making the other clients lose the new ones */
+		if ((uint8_t)(head - sub->tail) > HTM_JOINT_MAX_LAG) {
+			sub->dropped += (uint8_t)(head - sub->tail) - HTM_JOINT_MAX_LAG;
+			sub->tail = head - HTM_JOINT_MAX_LAG;
+		}
+	}
+
+	htmJointSubscribersChanged();
+}
+
+/***********************************************************************************************//**
+ *  \brief  Start the flush timer, unless it is already running. Restarting it would hold back
+ *          the samples already waiting.
+ **************************************************************************************************/
+static void htmJointFlushArm(void)
+{
+	if (!htmJointFlushArmed) {
+		gecko_cmd_hardware_set_soft_timer(TIMER_MS_2_TIMERTICK(HTM_JOINT_FLUSH_MS), TEMP_TIMER, true);
+		htmJointFlushArmed = true;
+	}
+}
+
+/***********************************************************************************************//**
+ *  \brief  Update what the LDMA interrupt works with after the clients or their progress changed:
+ *          the tail of the queue, at the slowest client, and the smallest batch of all clients.
+ **************************************************************************************************/
+static void htmJointSubscribersChanged(void)
+{
+	uint8_t head = htmJointHead;
+	uint8_t lag = 0;
+	uint8_t fullCount = 0;
+	uint8_t batchLen;
+	htmSubscriber_t *sub;
+
+	for (sub = htmSubscribers; sub < &htmSubscribers[HTM_MAX_SUBSCRIBERS]; sub++) {
+		if ((sub->connection == HTM_NO_CONNECTION) || (sub->characteristic != gattdb_temp_measurement)) {
+			continue;
+		}
+
+		if ((uint8_t)(head - sub->tail) > lag) {
+			lag = (uint8_t)(head - sub->tail);
+		}
+
+		batchLen = htmJointBatchLen(htmLinkPayloadLen(sub->connection));
+		if ((fullCount == 0) || (batchLen < fullCount)) {
+			fullCount = batchLen;
+		}
+	}
+
+	/* Without clients the queue is emptied, and the LDMA interrupt stops filling it */
+	htmJointTail = head - lag;
+	htmJointFullCount = fullCount;
+}
+
 /***********************************************************************************************//**
  *  \brief  This function is called by the application when the periodic measurement timer expires.
  *  \param[in]  buf  Event message.
@@ -266,8 +753,6 @@ uint8_t htmProcMsg(uint8_t *buf)
 {
 	uint8_t len = 0; /* Length of the temperature measurement */
 #if !defined(SEND_FLEX_SENSOR_DATA_INSTEAD_OF_TEMP_DATA)
-	float tempC; /* Temperature in right format for the LCD */
-	char tempString[HTM_TEMP_VALUE_TEXT_SIZE]; /* Temperature as string for the LCD */
 	int32_t tempData; /* Temperature data from the sensor */
 #endif
 
@@ -284,16 +769,11 @@ uint8_t htmProcMsg(uint8_t *buf)
 		} else {
 			htmTempMeas.temperature = FLT_TO_UINT32(tempData, -3);
 		}
-	}
 
-	/* Convert temperature to the right format for LCD display */
-	tempC = tempData / 1000.0;
-
-	/* Temp in C and F should both appear on LCD display */
-	snprintf(tempString, HTM_TEMP_VALUE_TEXT_SIZE, HTM_TEMP_VALUE_TEXT, tempC, tempC * 1.8 + 32.0);
-
-	/* Write the string to LCD */
-	appUiWriteString(tempString);
+		/* The LCD is drawn from htmDisplayRefresh(), off the notification path */
+		htmDisplayTemp = tempData;
+		htmDisplayDirty = true;
+	}
 
 #else
 
@@ -36,6 +36,32 @@ extern "C" {
   Public Macros and Definitions
 ***************************************************************************************************/
 
+/** Largest ATT MTU asked for. The MTU is exchanged when the connection opens. */
+#define HTM_MAX_MTU                         247
+
+/** Clients served at the same time, the MAX_CONNECTIONS the stack is configured for. */
+#define HTM_MAX_CONNECTIONS                 4
+
+/* Joint samples batched into the temperature measurement characteristic:
+ * flags, sample count, then per sample a 16 bit timestamp and the 32 bit
+ * joint word, all little endian, oldest sample first. */
+/** Flags field value of a joint sample batch. Bit 7 is reserved in HTM. */
+#define HTM_FLAG_JOINT_BATCH                0x80
+/** Length of the batch flags and sample count. */
+#define HTM_JOINT_BATCH_HDR_LEN             2
+/** Length of one joint sample. */
+#define HTM_JOINT_SAMPLE_LEN                6
+/** Timestamp resolution, the RTCC count rate, LFXO prescaled by 32. Wraps after 64 s. */
+#define HTM_JOINT_TICK_HZ                   1024
+/** Longest a queued sample waits for the batch to fill, in ms. */
+#define HTM_JOINT_FLUSH_MS                  20
+
+/* External signals raised by htmJointSampleQueue() */
+/** A sample was queued into an empty queue. */
+#define HTM_JOINT_SIGNAL_QUEUED             0x01
+/** A whole batch is queued. */
+#define HTM_JOINT_SIGNAL_FULL               0x02
+
 
 /***************************************************************************************************
   Structures and Enumerations
@@ -72,11 +98,55 @@ void htmInit(void);
 **************************************************************************************************/
 void htmTemperatureCharStatusChange(uint8_t connection, uint16_t clientConfig);
 
+/***********************************************************************************************//**
+ *  \brief  Humidity CCCD has changed event handler function.
+ *  \param[in]  connection  Connection ID.
+ *  \param[in]  clientConfig  New value of CCCD.
+ **************************************************************************************************/
+void htmHumidityCharStatusChange(uint8_t connection, uint16_t clientConfig);
+
+/***********************************************************************************************//**
+ *  \brief  Update the humidity characteristic, notifies the subscribed clients if it changed.
+ *  \param[in]  humidity  Relative humidity, in %.
+ **************************************************************************************************/
+void htmHumidityUpdate(uint16_t humidity);
+
+/***********************************************************************************************//**
+ *  \brief  Connection closed event handler function, drops the subscriptions of the connection.
+ *  \param[in]  connection  Connection ID.
+ **************************************************************************************************/
+void htmConnectionClosed(uint8_t connection);
+
 /***********************************************************************************************//**
  *  \brief  Make one temperature measurement.
  **************************************************************************************************/
 void htmTemperatureMeasure(void);
 
+/***********************************************************************************************//**
+ *  \brief  Show the last temperature measured on the LCD, if it changed since the last call.
+ **************************************************************************************************/
+void htmDisplayRefresh(void);
+
+/***********************************************************************************************//**
+ *  \brief  Record the ATT MTU exchanged on a connection, sets the size of its joint batches.
+ *  \param[in]  connection  Connection ID.
+ *  \param[in]  mtu  Exchanged ATT MTU.
+ **************************************************************************************************/
+void htmMtuExchanged(uint8_t connection, uint16_t mtu);
+
+/***********************************************************************************************//**
+ *  \brief  Queue one joint sample for the next batch. Can be called from interrupt context.
+ *  \param[in]  joints  Joint word received from the glove.
+ *  \param[in]  timestamp  Reception time, HTM_JOINT_TICK_HZ units.
+ **************************************************************************************************/
+void htmJointSampleQueue(uint32_t joints, uint16_t timestamp);
+
+/***********************************************************************************************//**
+ *  \brief  External signal event handler function, sends or schedules the queued joint samples.
+ *  \param[in]  signals  Signals of the event.
+ **************************************************************************************************/
+void htmJointSignal(uint32_t signals);
+
 /***********************************************************************************************//**
  *  \brief  Make one humididty measurement.
  **************************************************************************************************/
@@ -0,0 +1,17 @@
+/***********************************************************************************************//**
+ * \file   bg_gattdb_def.h
+ * \brief  Host stand-in for the GATT database definition
+ ***************************************************************************************************
+ * <b> (C) Copyright 2015 Silicon Labs, http://www.silabs.com</b>
+ ***************************************************************************************************
+ * This file is licensed under the Silabs License Agreement. See the file
+ * "Silabs_License_Agreement.txt" for details. Before using this software for
+ * any purpose, you must agree to the terms of that agreement.
+ **************************************************************************************************/
+
+#ifndef BG_GATTDB_DEF_H
+#define BG_GATTDB_DEF_H
+
+struct bg_gattdb_def;
+
+#endif /* BG_GATTDB_DEF_H */
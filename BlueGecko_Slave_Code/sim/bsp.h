@@ -0,0 +1,15 @@
+/***********************************************************************************************//**
+ * \file   bsp.h
+ * \brief  Host stand-in for the kit BSP, app_hw.c includes it
+ ***************************************************************************************************
+ * <b> (C) Copyright 2015 Silicon Labs, http://www.silabs.com</b>
+ ***************************************************************************************************
+ * This file is licensed under the Silabs License Agreement. See the file
+ * "Silabs_License_Agreement.txt" for details. Before using this software for
+ * any purpose, you must agree to the terms of that agreement.
+ **************************************************************************************************/
+
+#ifndef BSP_H
+#define BSP_H
+
+#endif /* BSP_H */
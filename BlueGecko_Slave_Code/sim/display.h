@@ -0,0 +1,21 @@
+/***********************************************************************************************//**
+ * \file   display.h
+ * \brief  Host stand-in for the kit display driver, the simulation defines DISPLAY_Init
+ ***************************************************************************************************
+ * <b> (C) Copyright 2015 Silicon Labs, http://www.silabs.com</b>
+ ***************************************************************************************************
+ * This file is licensed under the Silabs License Agreement. See the file
+ * "Silabs_License_Agreement.txt" for details. Before using this software for
+ * any purpose, you must agree to the terms of that agreement.
+ **************************************************************************************************/
+
+#ifndef DISPLAY_H
+#define DISPLAY_H
+
+#include "em_types.h"
+
+#define DISPLAY_EMSTATUS_OK  0
+
+EMSTATUS DISPLAY_Init(void);
+
+#endif /* DISPLAY_H */
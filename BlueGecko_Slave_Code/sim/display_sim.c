@@ -0,0 +1,218 @@
+/***********************************************************************************************//**
+ * \file   display_sim.c
+ * \brief  Host simulation of the LCD refresh
+ ***************************************************************************************************
+ * <b> (C) Copyright 2015 Silicon Labs, http://www.silabs.com</b>
+ ***************************************************************************************************
+ * This file is licensed under the Silabs License Agreement. See the file
+ * "Silabs_License_Agreement.txt" for details. Before using this software for
+ * any purpose, you must agree to the terms of that agreement.
+ ***************************************************************************************************
+ * Runs graphics.c against a stub GLIB and DMD driver for 60 s. The temperature text is written
+ * once a second, as htmDisplayRefresh does, and changes every 5 s. graphRefresh runs every
+ * 500 ms, as appUiLcdRefresh does. "Before" is a frame clear, a redraw of every text line and
+ * an LCD push per measurement, as graphWriteString did.
+ *
+ * Exits non-zero if a refresh draws a line that did not change, if the LCD is pushed without a
+ * change, or if the lines are not all drawn again after graphInit.
+ *
+ * Build and run from BlueGecko_Slave_Code:
+ *
+ *   gcc -O2 -Wall -Isim -I. -o display_sim sim/display_sim.c graphics.c
+ *   ./display_sim
+ **************************************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Display driver headers */
+#include "glib.h"
+#include "dmd.h"
+#include "display.h"
+
+/* application specific headers */
+#include "graphics.h"
+
+/***************************************************************************************************
+  Local Macros and Definitions
+ **************************************************************************************************/
+
+#define SIM_RUN_MS                    60000
+
+/** The temperature is measured once a second and changes every 5 s. */
+#define SIM_MEASURE_MS                1000
+#define SIM_CHANGE_MS                 5000
+
+/** LCD refresh period of appUiLcdRefresh. */
+#define SIM_REFRESH_MS                500
+
+/** Header appUiInit passes to graphInit. */
+#define SIM_HEADER                    "SILICON LABORATORIES\nBluetooth Smart Demo\n\nBlue Gecko #12345 \n\n"
+
+/** Text lines of the header and the temperature text that are not empty. */
+#define SIM_TEXT_STRINGS              5
+
+/***************************************************************************************************
+  Local Variables
+ **************************************************************************************************/
+
+static const GLIB_Display_Geometry_t simGeometry = { 128, 128 };
+const GLIB_Font_t GLIB_FontNarrow6x8 = { 6, 8, 2 };
+
+/* Stub driver counts */
+static int simClears;
+static int simStrings;
+static int simRects;
+static int simPushes;
+
+static int simFailures;
+
+/***************************************************************************************************
+  Stubbed display driver
+ **************************************************************************************************/
+
+EMSTATUS DISPLAY_Init(void)
+{
+  return DISPLAY_EMSTATUS_OK;
+}
+
+EMSTATUS DMD_init(void *initConfig)
+{
+  (void)initConfig;
+
+  return DMD_OK;
+}
+
+EMSTATUS DMD_updateDisplay(void)
+{
+  simPushes++;
+  return DMD_OK;
+}
+
+EMSTATUS GLIB_contextInit(GLIB_Context_t *pContext)
+{
+  pContext->pDisplayGeometry = &simGeometry;
+  return GLIB_OK;
+}
+
+EMSTATUS GLIB_setFont(GLIB_Context_t *pContext, GLIB_Font_t *pFont)
+{
+  pContext->font = *pFont;
+  return GLIB_OK;
+}
+
+EMSTATUS GLIB_clear(GLIB_Context_t *pContext)
+{
+  (void)pContext;
+
+  simClears++;
+  return GLIB_OK;
+}
+
+EMSTATUS GLIB_drawRectFilled(GLIB_Context_t *pContext, const GLIB_Rectangle_t *pRect)
+{
+  (void)pContext;
+  (void)pRect;
+
+  simRects++;
+  return GLIB_OK;
+}
+
+EMSTATUS GLIB_drawString(GLIB_Context_t *pContext, const char *pString, uint32_t sLength,
+                         int32_t x0, int32_t y0, bool opaque)
+{
+  (void)pContext;
+  (void)pString;
+  (void)sLength;
+  (void)x0;
+  (void)y0;
+  (void)opaque;
+
+  simStrings++;
+  return GLIB_OK;
+}
+
+/***************************************************************************************************
+  Simulation
+ **************************************************************************************************/
+
+/***********************************************************************************************//**
+ *  \brief  Record a failed check.
+ *  \param[in]  ok  Result of the check
+ *  \param[in]  what  Description of the check
+ **************************************************************************************************/
+static void simCheck(bool ok, const char *what)
+{
+  if (!ok) {
+    printf("FAIL: %s\n", what);
+    simFailures++;
+  }
+}
+
+/***********************************************************************************************//**
+ *  \brief  Clear the driver counts.
+ **************************************************************************************************/
+static void simReset(void)
+{
+  simClears = 0;
+  simStrings = 0;
+  simRects = 0;
+  simPushes = 0;
+}
+
+int main(void)
+{
+  static char header[] = SIM_HEADER;
+  char text[40];
+  int changes = 0;
+  int ms;
+  int milli;
+
+  printf("Temperature written every %d ms, changing every %d ms, over %d s:\n",
+         SIM_MEASURE_MS, SIM_CHANGE_MS, SIM_RUN_MS / 1000);
+
+  /* Before: every measurement cleared the frame, drew all the text and pushed it */
+  printf("  before  %3d frame clears, %3d LCD pushes, %3d strings drawn\n",
+         SIM_RUN_MS / SIM_MEASURE_MS, SIM_RUN_MS / SIM_MEASURE_MS,
+         SIM_RUN_MS / SIM_MEASURE_MS * SIM_TEXT_STRINGS);
+
+  graphInit(header);
+  graphRefresh();
+  simReset();
+
+  for (ms = 0; ms < SIM_RUN_MS; ms++) {
+    if ((ms % SIM_MEASURE_MS) == 0) {
+      milli = 23500 + (ms / SIM_CHANGE_MS) * 100;
+      snprintf(text, sizeof(text), "\nTemperature:\n%d.%d C / ---.- F\n", milli / 1000, (milli % 1000) / 100);
+      graphWriteString(text);
+      if ((ms % SIM_CHANGE_MS) == 0) {
+        changes++;
+      }
+    }
+    if ((ms % SIM_REFRESH_MS) == (SIM_REFRESH_MS - 1)) {
+      graphRefresh();
+    }
+  }
+
+  printf("  after   %3d frame clears, %3d LCD pushes, %3d strings drawn\n", simClears, simPushes, simStrings);
+
+  simCheck(simClears == 0, "no frame clears");
+  simCheck(simPushes == changes, "one LCD push per change");
+  /* The first write draws the whole text, every other change one line */
+  simCheck((simRects == SIM_TEXT_STRINGS + changes - 1) && (simStrings == SIM_TEXT_STRINGS + changes - 1),
+           "only the changed line drawn");
+  simCheck(!graphRefresh(), "no push without a change");
+
+  /* A new init starts from a blank frame, the whole text is drawn again */
+  simReset();
+  graphInit(header);
+  graphWriteString(text);
+  graphRefresh();
+  printf("  init    %3d frame clears, %3d LCD pushes, %3d strings drawn\n", simClears, simPushes, simStrings);
+
+  simCheck(simStrings == SIM_TEXT_STRINGS, "every text line drawn after graphInit");
+
+  return simFailures ? 1 : 0;
+}
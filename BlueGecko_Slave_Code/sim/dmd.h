@@ -0,0 +1,22 @@
+/***********************************************************************************************//**
+ * \file   dmd.h
+ * \brief  Host stand-in for the dot matrix display driver, the simulation defines the functions
+ ***************************************************************************************************
+ * <b> (C) Copyright 2015 Silicon Labs, http://www.silabs.com</b>
+ ***************************************************************************************************
+ * This file is licensed under the Silabs License Agreement. See the file
+ * "Silabs_License_Agreement.txt" for details. Before using this software for
+ * any purpose, you must agree to the terms of that agreement.
+ **************************************************************************************************/
+
+#ifndef DMD_H
+#define DMD_H
+
+#include "em_types.h"
+
+#define DMD_OK  0
+
+EMSTATUS DMD_init(void *initConfig);
+EMSTATUS DMD_updateDisplay(void);
+
+#endif /* DMD_H */
@@ -0,0 +1,17 @@
+/***********************************************************************************************//**
+ * \file   em_leuart.h
+ * \brief  Host stand-in for the emlib LEUART, app.h only needs the type
+ ***************************************************************************************************
+ * <b> (C) Copyright 2015 Silicon Labs, http://www.silabs.com</b>
+ ***************************************************************************************************
+ * This file is licensed under the Silabs License Agreement. See the file
+ * "Silabs_License_Agreement.txt" for details. Before using this software for
+ * any purpose, you must agree to the terms of that agreement.
+ **************************************************************************************************/
+
+#ifndef EM_LEUART_H
+#define EM_LEUART_H
+
+typedef struct LEUART_TypeDef LEUART_TypeDef;
+
+#endif /* EM_LEUART_H */
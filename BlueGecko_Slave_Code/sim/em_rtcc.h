@@ -0,0 +1,19 @@
+/***********************************************************************************************//**
+ * \file   em_rtcc.h
+ * \brief  Host stand-in for the emlib RTCC, the simulation defines RTCC_CounterGet
+ ***************************************************************************************************
+ * <b> (C) Copyright 2015 Silicon Labs, http://www.silabs.com</b>
+ ***************************************************************************************************
+ * This file is licensed under the Silabs License Agreement. See the file
+ * "Silabs_License_Agreement.txt" for details. Before using this software for
+ * any purpose, you must agree to the terms of that agreement.
+ **************************************************************************************************/
+
+#ifndef EM_RTCC_H
+#define EM_RTCC_H
+
+#include <stdint.h>
+
+uint32_t RTCC_CounterGet(void);
+
+#endif /* EM_RTCC_H */
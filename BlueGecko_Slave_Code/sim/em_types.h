@@ -0,0 +1,20 @@
+/***********************************************************************************************//**
+ * \file   em_types.h
+ * \brief  Host stand-in for the emlib types
+ ***************************************************************************************************
+ * <b> (C) Copyright 2015 Silicon Labs, http://www.silabs.com</b>
+ ***************************************************************************************************
+ * This file is licensed under the Silabs License Agreement. See the file
+ * "Silabs_License_Agreement.txt" for details. Before using this software for
+ * any purpose, you must agree to the terms of that agreement.
+ **************************************************************************************************/
+
+#ifndef EM_TYPES_H
+#define EM_TYPES_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef uint32_t EMSTATUS;
+
+#endif /* EM_TYPES_H */
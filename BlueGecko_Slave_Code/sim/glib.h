@@ -0,0 +1,63 @@
+/***********************************************************************************************//**
+ * \file   glib.h
+ * \brief  Host stand-in for the graphics library, the simulation defines the functions
+ ***************************************************************************************************
+ * <b> (C) Copyright 2015 Silicon Labs, http://www.silabs.com</b>
+ ***************************************************************************************************
+ * This file is licensed under the Silabs License Agreement. See the file
+ * "Silabs_License_Agreement.txt" for details. Before using this software for
+ * any purpose, you must agree to the terms of that agreement.
+ **************************************************************************************************/
+
+#ifndef GLIB_H
+#define GLIB_H
+
+#include "em_types.h"
+
+#define GLIB_OK  0
+
+typedef enum
+{
+  Black = 0,
+  White = 1
+} GLIB_Color_t;
+
+typedef struct
+{
+  int32_t xSize;
+  int32_t ySize;
+} GLIB_Display_Geometry_t;
+
+typedef struct
+{
+  uint8_t fontWidth;
+  uint8_t fontHeight;
+  uint8_t lineSpacing;
+} GLIB_Font_t;
+
+typedef struct
+{
+  const GLIB_Display_Geometry_t *pDisplayGeometry;
+  uint32_t foregroundColor;
+  uint32_t backgroundColor;
+  GLIB_Font_t font;
+} GLIB_Context_t;
+
+typedef struct
+{
+  int32_t xMin;
+  int32_t yMin;
+  int32_t xMax;
+  int32_t yMax;
+} GLIB_Rectangle_t;
+
+extern const GLIB_Font_t GLIB_FontNarrow6x8;
+
+EMSTATUS GLIB_contextInit(GLIB_Context_t *pContext);
+EMSTATUS GLIB_setFont(GLIB_Context_t *pContext, GLIB_Font_t *pFont);
+EMSTATUS GLIB_clear(GLIB_Context_t *pContext);
+EMSTATUS GLIB_drawRectFilled(GLIB_Context_t *pContext, const GLIB_Rectangle_t *pRect);
+EMSTATUS GLIB_drawString(GLIB_Context_t *pContext, const char *pString, uint32_t sLength,
+                         int32_t x0, int32_t y0, bool opaque);
+
+#endif /* GLIB_H */
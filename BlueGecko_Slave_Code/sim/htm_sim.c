@@ -0,0 +1,395 @@
+/***********************************************************************************************//**
+ * \file   htm_sim.c
+ * \brief  Host simulation of the joint sample notifications of the Health Thermometer service
+ ***************************************************************************************************
+ * <b> (C) Copyright 2015 Silicon Labs, http://www.silabs.com</b>
+ ***************************************************************************************************
+ * This file is licensed under the Silabs License Agreement. See the file
+ * "Silabs_License_Agreement.txt" for details. Before using this software for
+ * any purpose, you must agree to the terms of that agreement.
+ ***************************************************************************************************
+ * Runs htm.c against a stubbed stack, 10 s per run in 0.25 ms steps:
+ * - The glove sends a joint word at 50, 100 or 200 Hz, the LDMA interrupt queues it.
+ * - One connection event every 7.5 ms. The stack holds SIM_TX_BUFFERS notifications per
+ *   connection and sends them all in the next event.
+ * - Bytes on air count the ATT, L2CAP and LL overhead of each notification.
+ * "Before" is one 13 byte temperature measurement per joint word, as htmTemperatureMeasure sent.
+ * The stub unpacks every batch as the master does, and checks the samples come in order.
+ *
+ * Exits non-zero if a sample is lost, out of order or waits longer than the flush time and two
+ * connection events, or if batching does not send fewer notifications and bytes than before.
+ * With three clients at different MTUs, also if a client that keeps up loses a sample, or if a
+ * client that stalls is not skipped forward to the newest samples. Also if the humidity is
+ * notified when it did not change, to a client that did not subscribe to it, or is not sent to a
+ * new subscriber straight away.
+ *
+ * Build and run from BlueGecko_Slave_Code:
+ *
+ *   gcc -O2 -Wall -fcommon -Isim -I. -o htm_sim sim/htm_sim.c htm.c
+ *   ./htm_sim
+ **************************************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+/* BG stack headers */
+#include "bg_types.h"
+#include "native_gecko.h"
+#include "gatt_db.h"
+
+/* application specific headers */
+#include "app_timer.h"
+#include "app_ui.h"
+#include "htm.h"
+
+/***************************************************************************************************
+  Local Macros and Definitions
+ **************************************************************************************************/
+
+/** Simulation steps are 0.25 ms. */
+#define SIM_STEP_US                   250L
+
+#define SIM_RUN_US                    10000000L
+
+/** Connection interval, 7.5 ms. */
+#define SIM_INTERVAL_US               7500L
+
+/** Notifications the stack holds per connection. */
+#define SIM_TX_BUFFERS                4
+
+/** ATT opcode and handle, L2CAP header, LL preamble, access address, header and CRC. */
+#define SIM_PACKET_OVERHEAD           (3 + 4 + 10)
+
+/** Length of the temperature measurement sent per joint word before. */
+#define SIM_TEMP_MEAS_LEN             13
+
+#define SIM_CONNECTIONS               4
+
+/** Joint words of one run, at 200 Hz. */
+#define SIM_MAX_SAMPLES               2048
+
+/** Stall of connection 2 in the fan-out run. */
+#define SIM_STALL_FROM_US             3000000L
+#define SIM_STALL_US                  2000000L
+
+/** Result of a notification the stack has no buffer for, bg_err_out_of_memory. */
+#define SIM_OUT_OF_MEMORY             0x0101
+
+/** Stubbed connection. */
+typedef struct
+{
+  bool stalled;                   /**< The peer acknowledges nothing, the buffers stay full */
+  int txQueued;
+  uint32_t nextJoints;            /**< Joint word expected next */
+  uint32_t received;
+  uint32_t skipped;
+  uint32_t outOfOrder;
+  uint32_t notifications;
+  uint32_t bytes;
+  long maxWaitUs;
+  uint32_t humidity;              /**< Humidity notifications */
+  uint16_t lastHumidity;
+} simConn_t;
+
+/***************************************************************************************************
+  Local Variables
+ **************************************************************************************************/
+
+static long simNowUs;
+static long simTempTimerAt;
+static uint32 simSignals;
+
+static simConn_t simConns[SIM_CONNECTIONS];
+
+/* Time each joint word was queued */
+static long simQueuedAt[SIM_MAX_SAMPLES];
+
+static int simFailures;
+
+/***************************************************************************************************
+  Stubbed BG stack and application
+ **************************************************************************************************/
+
+void gecko_cmd_hardware_set_soft_timer(uint32 time, uint8 handle, uint8 single_shot)
+{
+  (void)single_shot;
+
+  if (handle == TEMP_TIMER) {
+    simTempTimerAt = (time != TIMER_STOP) ? simNowUs + ((long)time * 1000000) / 32768 : -1;
+  }
+}
+
+void gecko_external_signal(uint32 signals)
+{
+  simSignals |= signals;
+}
+
+struct gecko_msg_gatt_server_send_characteristic_notification_rsp_t *gecko_cmd_gatt_server_send_characteristic_notification(uint8 connection,
+                                                                                                                           uint16 characteristic,
+                                                                                                                           uint8 value_len,
+                                                                                                                           const uint8 *value_data)
+{
+  static struct gecko_msg_gatt_server_send_characteristic_notification_rsp_t rsp;
+  simConn_t *conn = &simConns[connection];
+  const uint8 *p = value_data + HTM_JOINT_BATCH_HDR_LEN;
+  uint32_t joints;
+  uint8 i;
+
+  if (conn->txQueued >= SIM_TX_BUFFERS) {
+    rsp.result = SIM_OUT_OF_MEMORY;
+    return &rsp;
+  }
+  conn->txQueued++;
+  conn->notifications++;
+  conn->bytes += value_len + SIM_PACKET_OVERHEAD;
+
+  if (characteristic == gattdb_humidity_measurement) {
+    conn->humidity++;
+    conn->lastHumidity = value_data[0] | (value_data[1] << 8);
+  }
+
+  /* Unpack the batch as the master does */
+  if ((characteristic == gattdb_temp_measurement) && (value_data[0] == HTM_FLAG_JOINT_BATCH)) {
+    for (i = 0; i < value_data[1]; i++, p += HTM_JOINT_SAMPLE_LEN) {
+      joints = p[2] | (p[3] << 8) | (p[4] << 16) | ((uint32_t)p[5] << 24);
+      if (joints < conn->nextJoints) {
+        conn->outOfOrder++;
+        continue;
+      }
+      conn->skipped += joints - conn->nextJoints;
+      conn->nextJoints = joints + 1;
+      conn->received++;
+      if (simNowUs - simQueuedAt[joints] > conn->maxWaitUs) {
+        conn->maxWaitUs = simNowUs - simQueuedAt[joints];
+      }
+    }
+  }
+
+  rsp.result = 0;
+  return &rsp;
+}
+
+struct gecko_msg_gatt_server_write_attribute_value_rsp_t *gecko_cmd_gatt_server_write_attribute_value(uint16 attribute,
+                                                                                                     uint16 offset,
+                                                                                                     uint8 value_len,
+                                                                                                     const uint8 *value_data)
+{
+  static struct gecko_msg_gatt_server_write_attribute_value_rsp_t rsp;
+
+  (void)attribute;
+  (void)offset;
+  (void)value_len;
+  (void)value_data;
+
+  rsp.result = 0;
+  return &rsp;
+}
+
+void appUiWriteString(char *string)
+{
+  (void)string;
+}
+
+/***************************************************************************************************
+  Simulation
+ **************************************************************************************************/
+
+/***********************************************************************************************//**
+ *  \brief  Record a failed check.
+ *  \param[in]  ok  Result of the check
+ *  \param[in]  what  Description of the check
+ **************************************************************************************************/
+static void simCheck(bool ok, const char *what)
+{
+  if (!ok) {
+    printf("FAIL: %s\n", what);
+    simFailures++;
+  }
+}
+
+/***********************************************************************************************//**
+ *  \brief  Open a connection, exchange its MTU and subscribe it to the joint samples.
+ *  \param[in]  connection  Connection ID
+ *  \param[in]  mtu  Exchanged ATT MTU, 0 if not exchanged
+ **************************************************************************************************/
+static void simOpen(uint8 connection, uint16 mtu)
+{
+  memset(&simConns[connection], 0, sizeof(simConn_t));
+
+  if (mtu != 0) {
+    htmMtuExchanged(connection, mtu);
+  }
+  htmTemperatureCharStatusChange(connection, gatt_notification);
+}
+
+/***********************************************************************************************//**
+ *  \brief  Run the glove for SIM_RUN_US with the connections opened so far.
+ *  \param[in]  rateHz  Joint words per second
+ *  \param[in]  stallFromUs  Time connection 2 stops acknowledging, -1 for never
+ *  \param[in]  stallUs  Length of the stall
+ **************************************************************************************************/
+static void simRun(long rateHz, long stallFromUs, long stallUs)
+{
+  long periodUs = 1000000L / rateHz;
+  uint32_t joints = 0;
+  uint32 signals;
+  int c;
+
+  for (simNowUs = 0; simNowUs < SIM_RUN_US; simNowUs += SIM_STEP_US) {
+    simConns[2].stalled = (stallFromUs >= 0) && (simNowUs >= stallFromUs) && (simNowUs < stallFromUs + stallUs);
+
+    /* LDMA interrupt */
+    if ((simNowUs % periodUs) == 0) {
+      simQueuedAt[joints] = simNowUs;
+      htmJointSampleQueue(joints++, (uint16_t)((simNowUs * HTM_JOINT_TICK_HZ) / 1000000));
+    }
+
+    /* Main loop */
+    if (simSignals != 0) {
+      signals = simSignals;
+      simSignals = 0;
+      htmJointSignal(signals);
+    }
+    if ((simTempTimerAt >= 0) && (simNowUs >= simTempTimerAt)) {
+      simTempTimerAt = -1;
+      htmTemperatureMeasure();
+    }
+
+    /* Connection events */
+    if ((simNowUs % SIM_INTERVAL_US) == 0) {
+      for (c = 0; c < SIM_CONNECTIONS; c++) {
+        if (!simConns[c].stalled) {
+          simConns[c].txQueued = 0;
+        }
+      }
+    }
+  }
+}
+
+/***********************************************************************************************//**
+ *  \brief  One client at each glove rate and MTU, against one notification per joint word.
+ **************************************************************************************************/
+static void simBatching(void)
+{
+  static const long rates[] = { 50, 100, 200 };
+  static const uint16 mtus[] = { 23, 247 };
+  simConn_t *conn = &simConns[0];
+  double beforeNotif, beforeBytes;
+  double notif, bytes;
+  unsigned r, m;
+
+  printf("One client, notifications and bytes on air per second:\n");
+  printf("  glove rate  before             MTU 23             MTU 247\n");
+
+  for (r = 0; r < sizeof(rates) / sizeof(rates[0]); r++) {
+    beforeNotif = rates[r];
+    beforeBytes = rates[r] * (SIM_TEMP_MEAS_LEN + SIM_PACKET_OVERHEAD);
+    printf("  %3ld Hz      %3.0f/s, %5.0f B/s", rates[r], beforeNotif, beforeBytes);
+
+    for (m = 0; m < sizeof(mtus) / sizeof(mtus[0]); m++) {
+      htmInit();
+      simOpen(0, mtus[m]);
+      simRun(rates[r], -1, 0);
+      htmConnectionClosed(0);
+
+      notif = conn->notifications * 1000000.0 / SIM_RUN_US;
+      bytes = conn->bytes * 1000000.0 / SIM_RUN_US;
+      printf("  %3.0f/s, %5.0f B/s", notif, bytes);
+
+      simCheck((conn->skipped == 0) && (conn->outOfOrder == 0), "samples complete and in order");
+      simCheck(conn->received + rates[r] * HTM_JOINT_FLUSH_MS / 1000 + 1 >= (uint32_t)(rates[r] * SIM_RUN_US / 1000000),
+               "samples delivered by the end of the run");
+      simCheck(conn->maxWaitUs <= HTM_JOINT_FLUSH_MS * 1000L + 2 * SIM_INTERVAL_US, "sample wait within the flush time");
+      simCheck((notif < beforeNotif) && (bytes < beforeBytes), "fewer notifications and bytes than one per sample");
+    }
+    printf("\n");
+  }
+}
+
+/***********************************************************************************************//**
+ *  \brief  Three clients at different MTUs, one of them stalls for SIM_STALL_US.
+ **************************************************************************************************/
+static void simFanOut(void)
+{
+  static const uint16 mtus[] = { 247, 23, 100 };
+  simConn_t *conn;
+  uint8 c;
+
+  printf("Three clients at 200 Hz, client 2 stalls for %ld s:\n", SIM_STALL_US / 1000000);
+  printf("  client  MTU  notifications  received  skipped  out of order  longest wait\n");
+
+  htmInit();
+  for (c = 0; c < 3; c++) {
+    simOpen(c, mtus[c]);
+  }
+  simRun(200, SIM_STALL_FROM_US, SIM_STALL_US);
+
+  for (c = 0; c < 3; c++) {
+    conn = &simConns[c];
+    printf("  %d       %3u  %13u  %8u  %7u  %12u  %8.1f ms\n", c, mtus[c], (unsigned)conn->notifications,
+           (unsigned)conn->received, (unsigned)conn->skipped, (unsigned)conn->outOfOrder, conn->maxWaitUs / 1e3);
+
+    simCheck(conn->outOfOrder == 0, "samples in order on every client");
+    simCheck((c == 2) || (conn->skipped == 0), "clients that keep up lose no sample");
+    simCheck((c == 2) || (conn->maxWaitUs <= HTM_JOINT_FLUSH_MS * 1000L + 2 * SIM_INTERVAL_US),
+             "clients that keep up are not held back by the stalled one");
+  }
+  simCheck(simConns[2].skipped > 0, "the stalled client is skipped forward");
+  simCheck(simConns[2].nextJoints + 200 * HTM_JOINT_FLUSH_MS / 1000 + 1 >= 200 * SIM_RUN_US / 1000000,
+           "the stalled client catches up after the stall");
+
+  for (c = 0; c < 3; c++) {
+    htmConnectionClosed(c);
+  }
+}
+
+/***********************************************************************************************//**
+ *  \brief  Humidity updates to a humidity client, a temperature client and a late subscriber.
+ **************************************************************************************************/
+static void simHumidity(void)
+{
+  static const uint16_t updates[] = { 45, 45, 45, 46, 46, 47, 47, 47, 47, 46 };
+  unsigned i;
+
+  htmInit();
+  memset(simConns, 0, sizeof(simConns));
+  htmTemperatureCharStatusChange(0, gatt_notification);
+  htmHumidityCharStatusChange(1, gatt_notification);
+
+  /* Nothing to send before the first conversion */
+  simCheck(simConns[1].humidity == 0, "no humidity notification before the first value");
+
+  for (i = 0; i < sizeof(updates) / sizeof(updates[0]); i++) {
+    htmHumidityUpdate(updates[i]);
+    simConns[1].txQueued = 0;
+  }
+
+  /* A late subscriber gets the current value without waiting for a change */
+  htmHumidityCharStatusChange(2, gatt_notification);
+
+  printf("Humidity, %u updates with 4 changes:\n", (unsigned)(sizeof(updates) / sizeof(updates[0])));
+  printf("  humidity client %u notifications, temperature client %u, late subscriber %u\n",
+         (unsigned)simConns[1].humidity, (unsigned)simConns[0].humidity, (unsigned)simConns[2].humidity);
+
+  simCheck(simConns[1].humidity == 4, "humidity notified on change only");
+  simCheck(simConns[1].lastHumidity == 46, "humidity client has the last value");
+  simCheck(simConns[0].humidity == 0, "no humidity to a temperature only client");
+  simCheck((simConns[2].humidity == 1) && (simConns[2].lastHumidity == 46), "late subscriber gets the current value");
+
+  htmConnectionClosed(0);
+  htmConnectionClosed(1);
+  htmConnectionClosed(2);
+}
+
+int main(void)
+{
+  simTempTimerAt = -1;
+
+  simBatching();
+  simFanOut();
+  simHumidity();
+
+  return simFailures ? 1 : 0;
+}
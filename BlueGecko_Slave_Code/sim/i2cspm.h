@@ -0,0 +1,19 @@
+/***********************************************************************************************//**
+ * \file   i2cspm.h
+ * \brief  Host stand-in for the I2C simple polled master driver
+ ***************************************************************************************************
+ * <b> (C) Copyright 2015 Silicon Labs, http://www.silabs.com</b>
+ ***************************************************************************************************
+ * This file is licensed under the Silabs License Agreement. See the file
+ * "Silabs_License_Agreement.txt" for details. Before using this software for
+ * any purpose, you must agree to the terms of that agreement.
+ **************************************************************************************************/
+
+#ifndef I2CSPM_H
+#define I2CSPM_H
+
+typedef struct I2C_TypeDef I2C_TypeDef;
+
+#define I2C0  ((I2C_TypeDef *)0x4000C000UL)
+
+#endif /* I2CSPM_H */
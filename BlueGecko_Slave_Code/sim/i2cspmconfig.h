@@ -0,0 +1,15 @@
+/***********************************************************************************************//**
+ * \file   i2cspmconfig.h
+ * \brief  Host stand-in for the I2CSPM configuration, app_hw.c includes it
+ ***************************************************************************************************
+ * <b> (C) Copyright 2015 Silicon Labs, http://www.silabs.com</b>
+ ***************************************************************************************************
+ * This file is licensed under the Silabs License Agreement. See the file
+ * "Silabs_License_Agreement.txt" for details. Before using this software for
+ * any purpose, you must agree to the terms of that agreement.
+ **************************************************************************************************/
+
+#ifndef I2CSPMCONFIG_H
+#define I2CSPMCONFIG_H
+
+#endif /* I2CSPMCONFIG_H */
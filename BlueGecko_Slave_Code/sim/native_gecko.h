@@ -0,0 +1,57 @@
+/***********************************************************************************************//**
+ * \file   native_gecko.h
+ * \brief  Host stand-in for the BG stack API. Only the commands the simulated modules call are
+ *         declared, each simulation defines the ones it needs.
+ ***************************************************************************************************
+ * <b> (C) Copyright 2015 Silicon Labs, http://www.silabs.com</b>
+ ***************************************************************************************************
+ * This file is licensed under the Silabs License Agreement. See the file
+ * "Silabs_License_Agreement.txt" for details. Before using this software for
+ * any purpose, you must agree to the terms of that agreement.
+ **************************************************************************************************/
+
+#ifndef NATIVE_GECKO_H
+#define NATIVE_GECKO_H
+
+#include "bg_types.h"
+
+struct gecko_cmd_packet;
+
+/***************************************************************************************************
+  Hardware and system
+ **************************************************************************************************/
+
+void gecko_cmd_hardware_set_soft_timer(uint32 time, uint8 handle, uint8 single_shot);
+void gecko_external_signal(uint32 signals);
+
+/***************************************************************************************************
+  GATT server
+ **************************************************************************************************/
+
+enum gatt_client_config_flag
+{
+  gatt_disable      = 0x0,
+  gatt_notification = 0x1,
+  gatt_indication   = 0x2
+};
+
+struct gecko_msg_gatt_server_send_characteristic_notification_rsp_t
+{
+  uint16 result;
+};
+
+struct gecko_msg_gatt_server_write_attribute_value_rsp_t
+{
+  uint16 result;
+};
+
+struct gecko_msg_gatt_server_send_characteristic_notification_rsp_t *gecko_cmd_gatt_server_send_characteristic_notification(uint8 connection,
+                                                                                                                           uint16 characteristic,
+                                                                                                                           uint8 value_len,
+                                                                                                                           const uint8 *value_data);
+struct gecko_msg_gatt_server_write_attribute_value_rsp_t *gecko_cmd_gatt_server_write_attribute_value(uint16 attribute,
+                                                                                                     uint16 offset,
+                                                                                                     uint8 value_len,
+                                                                                                     const uint8 *value_data);
+
+#endif /* NATIVE_GECKO_H */
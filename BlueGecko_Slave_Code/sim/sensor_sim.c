@@ -0,0 +1,311 @@
+/***********************************************************************************************//**
+ * \file   sensor_sim.c
+ * \brief  Host simulation of the Si7013 humidity and temperature conversions
+ ***************************************************************************************************
+ * <b> (C) Copyright 2015 Silicon Labs, http://www.silabs.com</b>
+ ***************************************************************************************************
+ * This file is licensed under the Silabs License Agreement. See the file
+ * "Silabs_License_Agreement.txt" for details. Before using this software for
+ * any purpose, you must agree to the terms of that agreement.
+ ***************************************************************************************************
+ * Runs app_hw.c for 60 s, in 0.1 ms steps, against a Si7013 model on a 100 kHz bus:
+ * - A byte takes 90 us on the bus, address and acknowledge included.
+ * - An RH and temperature conversion takes 22.8 ms, 12 bit RH and 14 bit temperature. A hold
+ *   master measurement holds the bus for it, a no hold read is NACKed until it is done.
+ * - TEMP_TIMER and HUMIDITY_TIMER read the temperature and the humidity once a second each.
+ * "Before" is the two Si7013_MeasureRHAndTemp calls appHwReadTm and appHwReadHumidity made.
+ *
+ * Exits non-zero if the readers cost bus transactions, if both values do not come from the same
+ * conversion, or if the cache does not at least halve the conversions and the blocked time and
+ * lower the bus transactions. Also if a call keeps the event loop from the stack for longer than
+ * SIM_MAX_BLOCK_US, or if a conversion is given up on.
+ *
+ * Build and run from BlueGecko_Slave_Code:
+ *
+ *   gcc -O2 -Wall -fcommon -Isim -I. -o sensor_sim sim/sensor_sim.c app_hw.c
+ *   ./sensor_sim
+ **************************************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+/* BG stack headers */
+#include "bg_types.h"
+#include "native_gecko.h"
+
+/* Temp sensor and I2c*/
+#include "si7013.h"
+
+/* application specific headers */
+#include "advertisement.h"
+#include "app_ui.h"
+#include "app_timer.h"
+#include "app_hw.h"
+
+/***************************************************************************************************
+  Local Macros and Definitions
+ **************************************************************************************************/
+
+/** Simulation steps are 0.1 ms. */
+#define SIM_STEP_US                   100L
+
+#define SIM_RUN_US                    60000000L
+
+/** One byte with its acknowledge at 100 kHz. */
+#define SIM_BYTE_US                   90L
+
+/** RH conversion at 12 bit and temperature conversion at 14 bit. */
+#define SIM_CONVERSION_US             22800L
+
+/** Longest the event loop may be kept from the stack, well inside a 7.5 ms connection event. */
+#define SIM_MAX_BLOCK_US              1000L
+
+/** Soft timers the stub keeps. */
+#define SIM_TIMERS                    (SENSOR_READ_TIMER + 1)
+
+/***************************************************************************************************
+  Local Variables
+ **************************************************************************************************/
+
+static long simNowUs;
+static long simTimerAt[SIM_TIMERS];
+static long simTimerPeriod[SIM_TIMERS];
+
+/* Sensor model */
+static long simConvDoneAt = -1;
+static uint32_t simConversions;
+
+/* Bus use */
+static uint32_t simTransactions;
+static long simBlockedUs;
+static long simLongestBlockUs;
+
+static int simFailures;
+
+/***************************************************************************************************
+  Stubbed BG stack, UI and sensor
+ **************************************************************************************************/
+
+void gecko_cmd_hardware_set_soft_timer(uint32 time, uint8 handle, uint8 single_shot)
+{
+  long periodUs = ((long)time * 1000000) / 32768;
+
+  simTimerAt[handle] = (time != TIMER_STOP) ? simNowUs + periodUs : -1;
+  simTimerPeriod[handle] = single_shot ? 0 : periodUs;
+}
+
+uint32_t RTCC_CounterGet(void)
+{
+  return (uint32_t)(simNowUs * 1024 / 1000000);
+}
+
+void appUiBtnRegister(appUiBtnCback_t cback)
+{
+  (void)cback;
+}
+
+void appUiWriteString(char *string)
+{
+  (void)string;
+}
+
+void advSwitchAdvMessage(void)
+{
+}
+
+/***********************************************************************************************//**
+ *  \brief  Spend one bus transaction, the caller and the event loop wait for it.
+ *  \param[in]  bytes  Bytes transferred, address included
+ *  \param[in]  holdUs  Time the sensor holds the clock low
+ **************************************************************************************************/
+static void simBus(int bytes, long holdUs)
+{
+  long us = bytes * SIM_BYTE_US + holdUs;
+
+  simTransactions++;
+  simBlockedUs += us;
+  if (us > simLongestBlockUs) {
+    simLongestBlockUs = us;
+  }
+  simNowUs += us;
+}
+
+bool Si7013_Detect(I2C_TypeDef *i2c, uint8_t addr, uint8_t *deviceId)
+{
+  (void)i2c;
+  (void)addr;
+  (void)deviceId;
+
+  return true;
+}
+
+int32_t Si7013_MeasureRHAndTemp(I2C_TypeDef *i2c, uint8_t addr, uint32_t *rhData, int32_t *tData)
+{
+  (void)i2c;
+  (void)addr;
+
+  /* Hold master RH measurement, then the temperature of that conversion */
+  simBus(5, SIM_CONVERSION_US);
+  simBus(5, 0);
+  simConversions++;
+
+  *rhData = 45000;
+  *tData = 23500;
+  return 0;
+}
+
+int32_t Si7013_StartNoHoldMeasureRHAndTemp(I2C_TypeDef *i2c, uint8_t addr)
+{
+  (void)i2c;
+  (void)addr;
+
+  simBus(2, 0);
+  simConvDoneAt = simNowUs + SIM_CONVERSION_US;
+  return 0;
+}
+
+int32_t Si7013_ReadNoHoldRHAndTemp(I2C_TypeDef *i2c, uint8_t addr, uint32_t *rhData, int32_t *tData)
+{
+  (void)i2c;
+  (void)addr;
+
+  /* Still converting, the address is NACKed */
+  if ((simConvDoneAt < 0) || (simNowUs < simConvDoneAt)) {
+    simBus(1, 0);
+    return -1;
+  }
+
+  /* RH, then the temperature of that conversion */
+  simBus(3, 0);
+  simBus(5, 0);
+  simConvDoneAt = -1;
+  simConversions++;
+
+  *rhData = 45000;
+  *tData = 23500;
+  return 0;
+}
+
+/***************************************************************************************************
+  Simulation
+ **************************************************************************************************/
+
+/***********************************************************************************************//**
+ *  \brief  Record a failed check.
+ *  \param[in]  ok  Result of the check
+ *  \param[in]  what  Description of the check
+ **************************************************************************************************/
+static void simCheck(bool ok, const char *what)
+{
+  if (!ok) {
+    printf("FAIL: %s\n", what);
+    simFailures++;
+  }
+}
+
+/***********************************************************************************************//**
+ *  \brief  Clear the bus figures and the timers.
+ **************************************************************************************************/
+static void simReset(void)
+{
+  int timer;
+
+  simNowUs = 0;
+  simTransactions = 0;
+  simBlockedUs = 0;
+  simLongestBlockUs = 0;
+  simConversions = 0;
+  simConvDoneAt = -1;
+  for (timer = 0; timer < SIM_TIMERS; timer++) {
+    simTimerAt[timer] = -1;
+  }
+}
+
+/***********************************************************************************************//**
+ *  \brief  Print the bus figures of a run.
+ *  \param[in]  name  Name of the run
+ **************************************************************************************************/
+static void simPrint(const char *name)
+{
+  printf("  %-8s %4.1f transactions/s, %4.1f conversions/s, %5.1f ms/s blocked, %5.2f ms longest block\n",
+         name, simTransactions * 1e6 / SIM_RUN_US, simConversions * 1e6 / SIM_RUN_US,
+         simBlockedUs * 1e3 / SIM_RUN_US, simLongestBlockUs / 1e3);
+}
+
+int main(void)
+{
+  const appHwSensorData_t *data;
+  uint32_t beforeTransactions;
+  uint32_t beforeConversions;
+  long beforeBlockedUs;
+  uint32_t rhData;
+  int32_t tempData;
+  uint32_t transactions;
+  uint32_t readerTransactions = 0;
+  bool sameConversion = true;
+  long second;
+  int timer;
+
+  printf("Temperature and humidity once a second each, over %ld s:\n", SIM_RUN_US / 1000000);
+
+  /* Before: each reader ran its own blocking conversion */
+  simReset();
+  for (second = 0; second < SIM_RUN_US / 1000000; second++) {
+    Si7013_MeasureRHAndTemp(I2C0, SI7021_ADDR, &rhData, &tempData);
+    Si7013_MeasureRHAndTemp(I2C0, SI7021_ADDR, &rhData, &tempData);
+  }
+  simPrint("before");
+  beforeTransactions = simTransactions;
+  beforeConversions = simConversions;
+  beforeBlockedUs = simBlockedUs;
+
+  /* After: one conversion per period, the readers are served from the cache */
+  simReset();
+  appHwInit();
+  gecko_cmd_hardware_set_soft_timer(TIMER_MS_2_TIMERTICK(1000), TEMP_TIMER, false);
+  gecko_cmd_hardware_set_soft_timer(TIMER_MS_2_TIMERTICK(1000), HUMIDITY_TIMER, false);
+
+  for (; simNowUs < SIM_RUN_US; simNowUs += SIM_STEP_US) {
+    for (timer = 0; timer < SIM_TIMERS; timer++) {
+      if ((simTimerAt[timer] < 0) || (simNowUs < simTimerAt[timer])) {
+        continue;
+      }
+      simTimerAt[timer] = simTimerPeriod[timer] ? simTimerAt[timer] + simTimerPeriod[timer] : -1;
+
+      transactions = simTransactions;
+      switch (timer) {
+        case SENSOR_TIMER:
+          appHwSensorMeasure();
+          break;
+        case SENSOR_READ_TIMER:
+          appHwSensorRead();
+          break;
+        case TEMP_TIMER:
+          appHwReadTm(&tempData);
+          readerTransactions += simTransactions - transactions;
+          break;
+        case HUMIDITY_TIMER:
+          appHwReadHumidity(&rhData);
+          readerTransactions += simTransactions - transactions;
+          break;
+      }
+    }
+  }
+  simPrint("after");
+
+  /* Both readers see the one cached conversion */
+  data = appHwSensorGet();
+  sameConversion = data->valid && (appHwReadTm(&tempData) == 0) && (appHwReadHumidity(&rhData) == 0)
+                   && (tempData == data->tempData) && (rhData == data->rhData);
+
+  simCheck(readerTransactions == 0, "readers served from the cache");
+  simCheck(sameConversion, "temperature and humidity from the same conversion");
+  simCheck(simConversions * 2 <= beforeConversions, "conversions at least halved");
+  simCheck(simTransactions < beforeTransactions, "fewer bus transactions");
+  simCheck(simLongestBlockUs <= SIM_MAX_BLOCK_US, "event loop never blocked for a conversion");
+  simCheck(simConversions + 1 >= SIM_RUN_US / (APP_HW_SENSOR_PERIOD_MS * 1000L), "a conversion every period");
+  simCheck(simBlockedUs * 2 <= beforeBlockedUs, "blocked time at least halved");
+
+  return simFailures ? 1 : 0;
+}
@@ -0,0 +1,15 @@
+/***********************************************************************************************//**
+ * \file   tempsens.h
+ * \brief  Host stand-in for the kit temperature sensor driver, app_hw.c includes it
+ ***************************************************************************************************
+ * <b> (C) Copyright 2015 Silicon Labs, http://www.silabs.com</b>
+ ***************************************************************************************************
+ * This file is licensed under the Silabs License Agreement. See the file
+ * "Silabs_License_Agreement.txt" for details. Before using this software for
+ * any purpose, you must agree to the terms of that agreement.
+ **************************************************************************************************/
+
+#ifndef TEMPSENS_H
+#define TEMPSENS_H
+
+#endif /* TEMPSENS_H */
@@ -7,6 +7,8 @@ C_SRCS += \
 ../src/MCIoT_ACMP.c \
 ../src/MCIoT_ADC.c \
 ../src/MCIoT_CMU.c \
+../src/MCIoT_Calibration.c \
+../src/MCIoT_CoreProfile.c \
 ../src/MCIoT_DMA.c \
 ../src/MCIoT_GPIO.c \
 ../src/MCIoT_I2C.c \
@@ -14,8 +16,10 @@ C_SRCS += \
 ../src/MCIoT_LESENSE_Main.c \
 ../src/MCIoT_LETimer.c \
 ../src/MCIoT_LEUART.c \
+../src/MCIoT_Power.c \
 ../src/MCIoT_Sleep.c \
 ../src/MCIoT_Timer.c \
+../src/MCIoT_Touch_Pattern.c \
 ../src/MCIoT_main.c \
 ../src/dmactrl.c 
 
@@ -23,6 +27,8 @@ OBJS += \
 ./src/MCIoT_ACMP.o \
 ./src/MCIoT_ADC.o \
 ./src/MCIoT_CMU.o \
+./src/MCIoT_Calibration.o \
+./src/MCIoT_CoreProfile.o \
 ./src/MCIoT_DMA.o \
 ./src/MCIoT_GPIO.o \
 ./src/MCIoT_I2C.o \
@@ -30,8 +36,10 @@ OBJS += \
 ./src/MCIoT_LESENSE_Main.o \
 ./src/MCIoT_LETimer.o \
 ./src/MCIoT_LEUART.o \
+./src/MCIoT_Power.o \
 ./src/MCIoT_Sleep.o \
 ./src/MCIoT_Timer.o \
+./src/MCIoT_Touch_Pattern.o \
 ./src/MCIoT_main.o \
 ./src/dmactrl.o 
 
@@ -39,6 +47,8 @@ C_DEPS += \
 ./src/MCIoT_ACMP.d \
 ./src/MCIoT_ADC.d \
 ./src/MCIoT_CMU.d \
+./src/MCIoT_Calibration.d \
+./src/MCIoT_CoreProfile.d \
 ./src/MCIoT_DMA.d \
 ./src/MCIoT_GPIO.d \
 ./src/MCIoT_I2C.d \
@@ -46,8 +56,10 @@ C_DEPS += \
 ./src/MCIoT_LESENSE_Main.d \
 ./src/MCIoT_LETimer.d \
 ./src/MCIoT_LEUART.d \
+./src/MCIoT_Power.d \
 ./src/MCIoT_Sleep.d \
 ./src/MCIoT_Timer.d \
+./src/MCIoT_Touch_Pattern.d \
 ./src/MCIoT_main.d \
 ./src/dmactrl.d 
 
@@ -74,6 +86,20 @@ src/MCIoT_CMU.o: ../src/MCIoT_CMU.c
 	@echo 'Finished building: $<'
 	@echo ' '
 
+src/MCIoT_Calibration.o: ../src/MCIoT_Calibration.c
+	@echo 'Building file: $<'
+	@echo 'Invoking: GNU ARM C Compiler'
+	arm-none-eabi-gcc -g -gdwarf-2 -mcpu=cortex-m3 -mthumb -std=c99 '-DEFM32LG990F256=1' '-DDEBUG=1' -I"/Users/pavandhareshwar/SimplicityStudio/workspace_2/LeopardGecko_Slave_Code/inc" -I"/Applications/Simplicity Studio.app/Contents/Eclipse/developer/sdks/exx32/v5.0.0.0//platform/CMSIS/Include" -I"/Applications/Simplicity Studio.app/Contents/Eclipse/developer/sdks/exx32/v5.0.0.0//hardware/kit/common/bsp" -I"/Applications/Simplicity Studio.app/Contents/Eclipse/developer/sdks/exx32/v5.0.0.0//platform/emlib/inc" -I"/Applications/Simplicity Studio.app/Contents/Eclipse/developer/sdks/exx32/v5.0.0.0//hardware/kit/common/drivers" -I"/Applications/Simplicity Studio.app/Contents/Eclipse/developer/sdks/exx32/v5.0.0.0//platform/Device/SiliconLabs/EFM32LG/Include" -I"/Applications/Simplicity Studio.app/Contents/Eclipse/developer/sdks/exx32/v5.0.0.0//hardware/kit/EFM32LG_STK3600/config" -O0 -Wall -c -fmessage-length=0 -mno-sched-prolog -fno-builtin -ffunction-sections -fdata-sections -MMD -MP -MF"src/MCIoT_Calibration.d" -MT"src/MCIoT_Calibration.o" -o "$@" "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
+src/MCIoT_CoreProfile.o: ../src/MCIoT_CoreProfile.c
+	@echo 'Building file: $<'
+	@echo 'Invoking: GNU ARM C Compiler'
+	arm-none-eabi-gcc -g -gdwarf-2 -mcpu=cortex-m3 -mthumb -std=c99 '-DEFM32LG990F256=1' '-DDEBUG=1' -I"/Users/pavandhareshwar/SimplicityStudio/workspace_2/LeopardGecko_Slave_Code/inc" -I"/Applications/Simplicity Studio.app/Contents/Eclipse/developer/sdks/exx32/v5.0.0.0//platform/CMSIS/Include" -I"/Applications/Simplicity Studio.app/Contents/Eclipse/developer/sdks/exx32/v5.0.0.0//hardware/kit/common/bsp" -I"/Applications/Simplicity Studio.app/Contents/Eclipse/developer/sdks/exx32/v5.0.0.0//platform/emlib/inc" -I"/Applications/Simplicity Studio.app/Contents/Eclipse/developer/sdks/exx32/v5.0.0.0//hardware/kit/common/drivers" -I"/Applications/Simplicity Studio.app/Contents/Eclipse/developer/sdks/exx32/v5.0.0.0//platform/Device/SiliconLabs/EFM32LG/Include" -I"/Applications/Simplicity Studio.app/Contents/Eclipse/developer/sdks/exx32/v5.0.0.0//hardware/kit/EFM32LG_STK3600/config" -O0 -Wall -c -fmessage-length=0 -mno-sched-prolog -fno-builtin -ffunction-sections -fdata-sections -MMD -MP -MF"src/MCIoT_CoreProfile.d" -MT"src/MCIoT_CoreProfile.o" -o "$@" "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
 src/MCIoT_DMA.o: ../src/MCIoT_DMA.c
 	@echo 'Building file: $<'
 	@echo 'Invoking: GNU ARM C Compiler'
@@ -123,6 +149,13 @@ src/MCIoT_LEUART.o: ../src/MCIoT_LEUART.c
 	@echo 'Finished building: $<'
 	@echo ' '
 
+src/MCIoT_Power.o: ../src/MCIoT_Power.c
+	@echo 'Building file: $<'
+	@echo 'Invoking: GNU ARM C Compiler'
+	arm-none-eabi-gcc -g -gdwarf-2 -mcpu=cortex-m3 -mthumb -std=c99 '-DEFM32LG990F256=1' '-DDEBUG=1' -I"/Users/pavandhareshwar/SimplicityStudio/workspace_2/LeopardGecko_Slave_Code/inc" -I"/Applications/Simplicity Studio.app/Contents/Eclipse/developer/sdks/exx32/v5.0.0.0//platform/CMSIS/Include" -I"/Applications/Simplicity Studio.app/Contents/Eclipse/developer/sdks/exx32/v5.0.0.0//hardware/kit/common/bsp" -I"/Applications/Simplicity Studio.app/Contents/Eclipse/developer/sdks/exx32/v5.0.0.0//platform/emlib/inc" -I"/Applications/Simplicity Studio.app/Contents/Eclipse/developer/sdks/exx32/v5.0.0.0//hardware/kit/common/drivers" -I"/Applications/Simplicity Studio.app/Contents/Eclipse/developer/sdks/exx32/v5.0.0.0//platform/Device/SiliconLabs/EFM32LG/Include" -I"/Applications/Simplicity Studio.app/Contents/Eclipse/developer/sdks/exx32/v5.0.0.0//hardware/kit/EFM32LG_STK3600/config" -O0 -Wall -c -fmessage-length=0 -mno-sched-prolog -fno-builtin -ffunction-sections -fdata-sections -MMD -MP -MF"src/MCIoT_Power.d" -MT"src/MCIoT_Power.o" -o "$@" "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
 src/MCIoT_Sleep.o: ../src/MCIoT_Sleep.c
 	@echo 'Building file: $<'
 	@echo 'Invoking: GNU ARM C Compiler'
@@ -137,6 +170,13 @@ src/MCIoT_Timer.o: ../src/MCIoT_Timer.c
 	@echo 'Finished building: $<'
 	@echo ' '
 
+src/MCIoT_Touch_Pattern.o: ../src/MCIoT_Touch_Pattern.c
+	@echo 'Building file: $<'
+	@echo 'Invoking: GNU ARM C Compiler'
+	arm-none-eabi-gcc -g -gdwarf-2 -mcpu=cortex-m3 -mthumb -std=c99 '-DEFM32LG990F256=1' '-DDEBUG=1' -I"/Users/pavandhareshwar/SimplicityStudio/workspace_2/LeopardGecko_Slave_Code/inc" -I"/Applications/Simplicity Studio.app/Contents/Eclipse/developer/sdks/exx32/v5.0.0.0//platform/CMSIS/Include" -I"/Applications/Simplicity Studio.app/Contents/Eclipse/developer/sdks/exx32/v5.0.0.0//hardware/kit/common/bsp" -I"/Applications/Simplicity Studio.app/Contents/Eclipse/developer/sdks/exx32/v5.0.0.0//platform/emlib/inc" -I"/Applications/Simplicity Studio.app/Contents/Eclipse/developer/sdks/exx32/v5.0.0.0//hardware/kit/common/drivers" -I"/Applications/Simplicity Studio.app/Contents/Eclipse/developer/sdks/exx32/v5.0.0.0//platform/Device/SiliconLabs/EFM32LG/Include" -I"/Applications/Simplicity Studio.app/Contents/Eclipse/developer/sdks/exx32/v5.0.0.0//hardware/kit/EFM32LG_STK3600/config" -O0 -Wall -c -fmessage-length=0 -mno-sched-prolog -fno-builtin -ffunction-sections -fdata-sections -MMD -MP -MF"src/MCIoT_Touch_Pattern.d" -MT"src/MCIoT_Touch_Pattern.o" -o "$@" "$<"
+	@echo 'Finished building: $<'
+	@echo ' '
+
 src/MCIoT_main.o: ../src/MCIoT_main.c
 	@echo 'Building file: $<'
 	@echo 'Invoking: GNU ARM C Compiler'
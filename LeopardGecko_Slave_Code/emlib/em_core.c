@@ -83,6 +83,10 @@
 
   // Method used for interrupt disable/enable within ATOMIC sections.
   #define CORE_ATOMIC_METHOD                 CORE_ATOMIC_METHOD_PRIMASK
+
+  // Call the profiling hooks on CRITICAL and ATOMIC section entry, exit and
+  // yield.
+  #define CORE_PROFILE_HOOKS                 0
   @endverbatim
 
   If the default values does not support your needs, they can be overridden
@@ -291,12 +295,91 @@
 #define CORE_INTERRUPT_EXIT()
 #endif
 
+#if !defined(CORE_PROFILE_HOOKS)
+/** Set to 1 to call @ref CORE_ProfileEnterHook(), @ref CORE_ProfileExitHook()
+ *  and @ref CORE_ProfileYieldHook() from the CRITICAL and ATOMIC functions. */
+#define CORE_PROFILE_HOOKS    0
+#endif
+
 // Compile time sanity check.
 #if (CORE_ATOMIC_METHOD != CORE_ATOMIC_METHOD_PRIMASK) \
     && (CORE_ATOMIC_METHOD != CORE_ATOMIC_METHOD_BASEPRI)
 #error "em_core: Undefined ATOMIC IRQ handling strategy."
 #endif
 
+/*******************************************************************************
+ **************************   PROFILING HOOKS   ********************************
+ ******************************************************************************/
+
+#if (CORE_PROFILE_HOOKS == 1)
+
+#if defined(__GNUC__)
+#define CORE_PROFILE_CALL_SITE()    __builtin_return_address(0)
+#else
+#define CORE_PROFILE_CALL_SITE()    NULL
+#endif
+
+void CORE_ProfileEnterHook(CORE_irqState_t irqState, void *callSite);
+void CORE_ProfileExitHook(CORE_irqState_t irqState);
+void CORE_ProfileYieldHook(bool resumed);
+
+/***************************************************************************//**
+ * @brief
+ *   Called on entry to every CRITICAL or ATOMIC section, with interrupts
+ *   already disabled. The default implementation does nothing.
+ *
+ * @param[in] irqState
+ *   The state returned by the enter function, non zero for a nested section.
+ *
+ * @param[in] callSite
+ *   Return address of the enter function, NULL if the compiler does not
+ *   provide it.
+ ******************************************************************************/
+SL_WEAK void CORE_ProfileEnterHook(CORE_irqState_t irqState, void *callSite)
+{
+  (void)irqState;
+  (void)callSite;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Called on exit from every CRITICAL or ATOMIC section, before interrupts
+ *   are enabled again. The default implementation does nothing.
+ *
+ * @param[in] irqState
+ *   The state being restored, matches the one of the entry hook.
+ ******************************************************************************/
+SL_WEAK void CORE_ProfileExitHook(CORE_irqState_t irqState)
+{
+  (void)irqState;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Called by the yield functions around the time interrupts are briefly
+ *   enabled. The default implementation does nothing.
+ *
+ * @param[in] resumed
+ *   False before interrupts are enabled, true once they are disabled again.
+ ******************************************************************************/
+SL_WEAK void CORE_ProfileYieldHook(bool resumed)
+{
+  (void)resumed;
+}
+
+#define CORE_PROFILE_ENTER(irqState) \
+  CORE_ProfileEnterHook((irqState), CORE_PROFILE_CALL_SITE())
+#define CORE_PROFILE_EXIT(irqState)   CORE_ProfileExitHook(irqState)
+#define CORE_PROFILE_YIELD(resumed)   CORE_ProfileYieldHook(resumed)
+
+#else
+
+#define CORE_PROFILE_ENTER(irqState)
+#define CORE_PROFILE_EXIT(irqState)
+#define CORE_PROFILE_YIELD(resumed)
+
+#endif // (CORE_PROFILE_HOOKS == 1)
+
 /*******************************************************************************
  ******************************   FUNCTIONS   **********************************
  ******************************************************************************/
@@ -338,6 +421,7 @@ SL_WEAK CORE_irqState_t CORE_EnterCritical(void)
 {
   CORE_irqState_t irqState = __get_PRIMASK();
   __disable_irq();
+  CORE_PROFILE_ENTER(irqState);
   return irqState;
 }
 
@@ -352,6 +436,7 @@ SL_WEAK CORE_irqState_t CORE_EnterCritical(void)
  ******************************************************************************/
 SL_WEAK void CORE_ExitCritical(CORE_irqState_t irqState)
 {
+  CORE_PROFILE_EXIT(irqState);
   if (irqState == 0) {
     __enable_irq();
   }
@@ -368,8 +453,10 @@ SL_WEAK void CORE_ExitCritical(CORE_irqState_t irqState)
 SL_WEAK void CORE_YieldCritical(void)
 {
   if (__get_PRIMASK() & 1) {
+    CORE_PROFILE_YIELD(false);
     __enable_irq();
     __disable_irq();
+    CORE_PROFILE_YIELD(true);
   }
 }
 
@@ -437,10 +524,12 @@ SL_WEAK CORE_irqState_t CORE_EnterAtomic(void)
 #if (CORE_ATOMIC_METHOD == CORE_ATOMIC_METHOD_BASEPRI)
   CORE_irqState_t irqState = __get_BASEPRI();
   __set_BASEPRI(CORE_ATOMIC_BASE_PRIORITY_LEVEL << (8 - __NVIC_PRIO_BITS));
+  CORE_PROFILE_ENTER(irqState);
   return irqState;
 #else
   CORE_irqState_t irqState = __get_PRIMASK();
   __disable_irq();
+  CORE_PROFILE_ENTER(irqState);
   return irqState;
 #endif // (CORE_ATOMIC_METHOD == CORE_ATOMIC_METHOD_BASEPRI)
 }
@@ -460,6 +549,7 @@ SL_WEAK CORE_irqState_t CORE_EnterAtomic(void)
  ******************************************************************************/
 SL_WEAK void CORE_ExitAtomic(CORE_irqState_t irqState)
 {
+  CORE_PROFILE_EXIT(irqState);
 #if (CORE_ATOMIC_METHOD == CORE_ATOMIC_METHOD_BASEPRI)
   __set_BASEPRI(irqState);
 #else
@@ -486,13 +576,17 @@ SL_WEAK void CORE_YieldAtomic(void)
 #if (CORE_ATOMIC_METHOD == CORE_ATOMIC_METHOD_BASEPRI)
   CORE_irqState_t basepri = __get_BASEPRI();
   if (basepri >= (CORE_ATOMIC_BASE_PRIORITY_LEVEL << (8 - __NVIC_PRIO_BITS))) {
+    CORE_PROFILE_YIELD(false);
     __set_BASEPRI(0);
     __set_BASEPRI(basepri);
+    CORE_PROFILE_YIELD(true);
   }
 #else
   if (__get_PRIMASK() & 1) {
+    CORE_PROFILE_YIELD(false);
     __enable_irq();
     __disable_irq();
+    CORE_PROFILE_YIELD(true);
   }
 #endif // (CORE_ATOMIC_METHOD == CORE_ATOMIC_METHOD_BASEPRI)
 }
@@ -17,6 +17,9 @@
 
 /* ADC Init Param Macros */
 #define ADC_INPUT_CHANNEL				adcSingleInputCh1
+/* The flex sensors have no switched excitation, no GPIO feeds them, so there
+ * is nothing to sequence. A switched one would get a POWER_DOMAIN like the
+ * TSL2561 supply. */
 #define flexSensorCh1					adcSingleInputCh1
 #define flexSensorCh2					adcSingleInputCh2
 #define flexSensorCh3					adcSingleInputCh3
@@ -33,6 +36,7 @@
 #define ADC_PRS_CHANNEL					adcPRSSELCh0
 
 #define ADC_ACQ_TIME_ADC_CLK_CYCLES		adcAcqTime4
+#define ADC_MEASURE_ACQ_TIME			adcAcqTime32	/* The temperature sensor needs a long acquisition time */
 
 
 /* Temperature Limits */
@@ -64,6 +68,8 @@ void ADC_SetUp(void);
 
 void ADC_Interrupt_Enable(void);
 
+void ADC_Measure_Temp_Vdd(uint16_t *p_temp_raw, uint16_t *p_vdd_raw);
+
 void ADC0_IRQHandler(void);
 
 float converttoCelsius(int32_t adcSample);
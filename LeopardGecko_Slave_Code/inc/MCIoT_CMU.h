@@ -6,19 +6,98 @@
 
 #include "em_cmu.h"
 
+#ifdef USE_INT
+#include "em_int.h"
+#else
+#include "em_core.h"
+#endif
+
 /************************************ INCLUDES **************************************/
 
+/************************************* MACROS ***************************************/
+
+/* Bit for a clock branch in CMU_CONSUMER_CONFIG.branches */
+#define CMU_BRANCH(branch)			(1UL << (branch))
+
+/* Longest time CMU_LF_Ticks_To_us() returns, one below SLEEP_NO_DEADLINE */
+#define CMU_LF_US_MAX				0xFFFFFFFE
+
+/************************************* MACROS ***************************************/
+
+/********************************** ENUMERATIONS ************************************/
+
+/* Clock branches managed by the clock tree planner. The LE branches come after
+ * CORELE so that they are enabled after, and disabled before, the LE interface */
+typedef enum _CMU_CLOCK_BRANCHES
+{
+	CMU_BRANCH_HFPER,
+	CMU_BRANCH_GPIO,
+	CMU_BRANCH_ACMP0,
+	CMU_BRANCH_ACMP1,
+	CMU_BRANCH_ADC0,
+	CMU_BRANCH_DMA,
+	CMU_BRANCH_I2C1,
+	CMU_BRANCH_TIMER0,
+	CMU_BRANCH_TIMER1,
+	CMU_BRANCH_CORELE,
+	CMU_BRANCH_LETIMER0,
+	CMU_BRANCH_LEUART0,
+	CMU_BRANCH_LESENSE,
+	CMU_BRANCH_RTC,
+	CMU_BRANCH_MAX
+} CMU_CLOCK_BRANCHES;
+
+/* Modules that request clocks from the clock tree planner */
+typedef enum _CMU_CONSUMERS
+{
+	CMU_CONSUMER_GPIO,
+	CMU_CONSUMER_ACMP,
+	CMU_CONSUMER_ADC,
+	CMU_CONSUMER_DMA,
+	CMU_CONSUMER_I2C,
+	CMU_CONSUMER_LESENSE,
+	CMU_CONSUMER_LETIMER,
+	CMU_CONSUMER_LEUART,
+	CMU_CONSUMER_OSC_CALIBRATION,
+	CMU_CONSUMER_OSC_CALIBRATION_LFXO,
+	CMU_CONSUMER_RTC,
+	CMU_CONSUMER_MAX
+} CMU_CONSUMERS;
+
+/* Clocks a consumer needs while it is active */
+typedef struct _CMU_CONSUMER_CONFIG_
+{
+	uint32_t			branches;			/* CMU_BRANCH() mask of clock branches */
+	CMU_Clock_TypeDef	lf_tree;			/* cmuClock_LFA or cmuClock_LFB */
+	CMU_Select_TypeDef	lf_select_em0_em2;	/* LF tree source in EM0-EM2, cmuSelect_Disabled if unused */
+	CMU_Select_TypeDef	lf_select_em3_em4;	/* LF tree source in EM3-EM4, cmuSelect_Disabled if unused */
+} CMU_CONSUMER_CONFIG;
+
+/********************************** ENUMERATIONS ************************************/
+
 /****************************** FUNCTION PROTOTYPES *********************************/
 
 void CMU_SetUp(void);
 
+void CMU_Consumer_Prepare(CMU_CONSUMERS e_consumer);
+
+bool CMU_Consumer_Start(CMU_CONSUMERS e_consumer);
+
+void CMU_Consumer_Stop(CMU_CONSUMERS e_consumer);
+
+bool CMU_Is_LFXO_In_Use(void);
+
+void CMU_SetUp_LF_Clocks(void);
+
+void CMU_SetUp_HF_Clocks(void);
+
 void CMU_Obtain_Freq_Count(uint32_t *count, uint32_t freq,
 							uint32_t calibration_period);
 
 void Calibrate_ULFRCO(void);
 
-void check_and_comp_prescaler_if(float period, uint32_t osc_cnt);
+void CMU_Set_LETimer_Prescaler(ENERGY_MODES e_energy_mode);
 
-void cal_prescaler_value(float period, uint32_t osc_cnt);
+uint32_t CMU_LF_Ticks_To_us(CMU_Select_TypeDef lf_select, uint64_t ticks);
 
 /****************************** FUNCTION PROTOTYPES *********************************/
@@ -0,0 +1,75 @@
+#ifndef _MCIOT_CALIBRATION_H_
+#define _MCIOT_CALIBRATION_H_
+
+/************************************ INCLUDES **************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "em_device.h"
+
+/************************************ INCLUDES **************************************/
+
+/************************************* MACROS ***************************************/
+
+/* The record has the last flash page to itself, the FLASH region of the linker
+ * script ends below it */
+#define CAL_RECORD_FLASH_ADDR			((uint32_t *)(FLASH_BASE + FLASH_SIZE - FLASH_PAGE_SIZE))
+
+#define CAL_RECORD_MAGIC				0x4C414354		/* "TCAL" */
+#define CAL_RECORD_VERSION				1
+
+/* One entry per LESENSE channel */
+#define CAL_RECORD_CHANNELS				16
+
+/* Drift since the record was written that makes it stale, in ADC codes
+ * against the 1.25 V reference */
+#define CAL_RECORD_MAX_TEMP_DRIFT		63				/* About 10 C at -6.27 codes per C */
+#define CAL_RECORD_MAX_VDD_DRIFT		109				/* About 100 mV, VDD/3 is sampled */
+
+/************************************* MACROS ***************************************/
+
+/********************************** ENUMERATIONS ************************************/
+
+/* Layout of the flash record, a whole number of words */
+typedef struct _CALIBRATION_RECORD_
+{
+	uint32_t						magic;
+	uint16_t						version;
+	uint16_t						size;
+	uint16_t						channels_used_mask;
+	uint16_t						temp_raw;		/* Temperature sensor reading when written */
+	uint16_t						vdd_raw;		/* VDD/3 reading when written */
+	uint16_t						reserved;
+	uint32_t						osc_ratio;		/* 0 if the ULFRCO was not calibrated */
+	uint16_t						baseline[CAL_RECORD_CHANNELS];
+	uint16_t						threshold[CAL_RECORD_CHANNELS];
+	uint32_t						crc;			/* CRC-32 of all the fields above */
+} CALIBRATION_RECORD;
+
+/********************************** ENUMERATIONS ************************************/
+
+/************************************ GLOBALS ***************************************/
+
+/* Copy of the flash record, only used while calibration_record_valid is set */
+CALIBRATION_RECORD calibration_record;
+bool calibration_record_valid;
+
+/************************************ GLOBALS ***************************************/
+
+/****************************** FUNCTION PROTOTYPES *********************************/
+
+bool Calibration_Record_Load(uint16_t temp_raw, uint16_t vdd_raw);
+
+bool Calibration_Record_Touch_Valid(uint16_t channels_used_mask);
+
+void Calibration_Record_Drop_Touch(void);
+
+bool Calibration_Record_Baseline_Matches(uint8_t channel, uint16_t count);
+
+bool Calibration_Record_Osc_Ratio(uint32_t *p_osc_ratio);
+
+void Calibration_Record_Save(uint16_t channels_used_mask, const uint16_t *p_baseline, const uint16_t *p_threshold, uint32_t osc_ratio);
+
+/****************************** FUNCTION PROTOTYPES *********************************/
+
+#endif /* _MCIOT_CALIBRATION_H_ */
@@ -0,0 +1,61 @@
+#ifndef _MCIOT_COREPROFILE_H_
+#define _MCIOT_COREPROFILE_H_
+
+/************************************ INCLUDES **************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "em_core.h"
+
+/************************************ INCLUDES **************************************/
+
+/************************************* MACROS ***************************************/
+
+/* Build with -DCORE_PROFILE_HOOKS=1, the emlib option that makes em_core.c call
+ * the CORE_Profile*Hook functions, to time every outermost CORE_ENTER_ATOMIC or
+ * CORE_ENTER_CRITICAL section. main() calls CORE_ProfileReset() at boot,
+ * core_profile_table is read from the debugger */
+
+/* Number of call sites kept, the shortest worst case is evicted when full */
+#ifndef CORE_PROFILE_TABLE_SIZE
+#define CORE_PROFILE_TABLE_SIZE		8
+#endif
+
+/* Sections open at the same time, a section nested deeper is not timed */
+#define CORE_PROFILE_NESTING_MAX	8
+
+#define CORE_PROFILE_CYCLES()		(DWT->CYCCNT)
+
+/************************************* MACROS ***************************************/
+
+/********************************** ENUMERATIONS ************************************/
+
+/* Worst masked time seen for one CORE_ENTER_* call site */
+typedef struct _CORE_PROFILE_ENTRY_
+{
+	uint32_t	call_site;			/* Return address of the CORE_Enter* call, 0 if unused */
+	uint32_t	max_cycles;			/* Longest time interrupts stayed masked */
+	uint32_t	count;				/* Sections closed from this site */
+} CORE_PROFILE_ENTRY;
+
+/********************************** ENUMERATIONS ************************************/
+
+/************************************ GLOBALS ***************************************/
+
+extern CORE_PROFILE_ENTRY core_profile_table[CORE_PROFILE_TABLE_SIZE];
+
+/************************************ GLOBALS ***************************************/
+
+/****************************** FUNCTION PROTOTYPES *********************************/
+
+void CORE_ProfileReset(void);
+
+void CORE_ProfileEnterHook(CORE_irqState_t irqState, void *callSite);
+
+void CORE_ProfileExitHook(CORE_irqState_t irqState);
+
+void CORE_ProfileYieldHook(bool resumed);
+
+/****************************** FUNCTION PROTOTYPES *********************************/
+
+#endif /* _MCIOT_COREPROFILE_H_ */
@@ -12,6 +12,7 @@
 /************************************* MACROS ***************************************/
 
 #define DMA_CHANNEL_ADC       		0
+#define DMA_CHANNEL_LESENSE			1
 #define ADC_SAMPLE_TRANSFER_SIZE	1
 
 /* DMA Channel Configuration Macros */
@@ -23,6 +24,10 @@
 #define DMA_TRANSFER_SIZE			dmaDataSize2
 #define DMA_TRANSFER_ARBRATE		dmaArbitrate1
 
+/* LESENSE result buffer, the request is raised at the half full trigger level (8 results) */
+#define DMA_LESENSE_SIGNAL_SOURCE	DMAREQ_LESENSE_BUFDATAV
+#define DMA_LESENSE_ARBRATE			dmaArbitrate8
+
 /************************************* MACROS ***************************************/
 
 /************************************ GLOBALS ***************************************/
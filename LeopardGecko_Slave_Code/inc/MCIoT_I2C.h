@@ -56,6 +56,26 @@
 #define I2C_TSL_INIT_CMD_REG_VAL_2		0x9C				/* Command Code to start block read
 																from 0x0C TSL register*/
 
+#define I2C_TSL_DATA_NUM_BYTES			4					/* DATA0LOW..DATA1HIGH */
+
+#define I2C_TSL_POWER_SETTLE_MS			10					/* Supply settle time before the first I2C access */
+
+/* Integer lux calculation, TSL2561 datasheet T, FN and CL package */
+#define TSL_LUX_SCALE					14					/* Scale by 2^14 */
+#define TSL_RATIO_SCALE					9					/* Scale CH1/CH0 ratio by 2^9 */
+#define TSL_CH_SCALE					10					/* Scale channel values by 2^10 */
+#define TSL_CHSCALE_TINT0				0x7517				/* 322/11 * 2^TSL_CH_SCALE, 13.7 ms */
+#define TSL_CHSCALE_TINT1				0x0FE7				/* 322/81 * 2^TSL_CH_SCALE, 101 ms */
+#define TSL_LUX_SEGMENTS				8
+
+#define TSL_TIMING_GAIN_16X				0x10				/* GAIN bit of the timing register */
+#define TSL_TIMING_INTEG_MASK			0x03				/* INTEG field of the timing register */
+
+/* Transaction engine */
+#define I2C_TRANSFER_QUEUE_SIZE			4					/* Transfers waiting for the bus, including the active one */
+#define I2C_CLOCK_LOW_TIMEOUT			5					/* CLTO field: SCL held low for 1024 prescaled clock cycles */
+#define I2C_TRANSFER_TIMEOUT_PERIODS	2					/* LETIMER0 periods before an active transfer is abandoned */
+
 /************************************* MACROS ***************************************/
 
 /********************************** ENUMERATIONS ************************************/
@@ -66,23 +86,64 @@ typedef enum _I2C_ALS_STATE_X_
 	ALS_STATE_LIGHT
 } I2C_ALS_STATE_X;
 
+/* One segment of the piecewise lux formula, lux = CH0 * b - CH1 * m for
+ * CH1/CH0 ratios up to ratio_max, all scaled as in the datasheet */
+typedef struct _TSL_LUX_SEGMENT_
+{
+	uint16_t	ratio_max;
+	uint16_t	b;
+	uint16_t	m;
+} TSL_LUX_SEGMENT;
+
+/* Outcome of a queued I2C transfer */
+typedef enum _I2C_TRANSFER_STATUS_
+{
+	I2C_TRANSFER_IDLE = 0,			/* Never submitted */
+	I2C_TRANSFER_PENDING,			/* Queued behind another transfer */
+	I2C_TRANSFER_IN_PROGRESS,		/* Owns the bus */
+	I2C_TRANSFER_DONE,
+	I2C_TRANSFER_NACK,				/* Slave did not acknowledge address or data */
+	I2C_TRANSFER_BUS_ERROR,			/* Arbitration lost, bus error or usage fault */
+	I2C_TRANSFER_TIMEOUT			/* SCL stuck low or no progress for I2C_TRANSFER_TIMEOUT_PERIODS */
+} I2C_TRANSFER_STATUS;
+
+typedef struct _I2C_TRANSFER_ I2C_TRANSFER;
+
+/* Called from I2C1_IRQHandler once the transfer has finished or failed */
+typedef void (*I2C_TRANSFER_CALLBACK)(I2C_TRANSFER *p_transfer);
+
+/* Transfer descriptor, owned by the caller until its callback has run */
+struct _I2C_TRANSFER_
+{
+	I2C_TransferSeq_TypeDef			seq;			/* Slave address, direction and buffers */
+	I2C_TRANSFER_CALLBACK			callback;		/* May be NULL */
+	volatile I2C_TRANSFER_STATUS	e_status;
+};
+
 /********************************** ENUMERATIONS ************************************/
 
 /************************************ GLOBALS  **************************************/
 I2C_ALS_STATE_X i2c_als_state;
+
+/* Latest burst read of the TSL2561, published for the sampling logic and upstream reporting */
+extern uint16_t tsl_ch0;					/* Visible + infrared ADC count */
+extern uint16_t tsl_ch1;					/* Infrared ADC count */
+extern uint32_t tsl_lux;
+extern volatile bool tsl_lux_available;		/* Set on every new reading, cleared by the LETIMER0 ALS scheduler */
 /************************************ GLOBALS  **************************************/
 
 /****************************** FUNCTION PROTOTYPES *********************************/
 
 void I2C_SetUp(void);
 
-void I2C_Write_And_Wait_for_ACK(uint8_t data);
+void I2C_Transfer_Prepare(I2C_TRANSFER *p_transfer, uint8_t slave_addr,
+		uint8_t *p_write_buf, uint16_t write_len,
+		uint8_t *p_read_buf, uint16_t read_len,
+		I2C_TRANSFER_CALLBACK callback);
 
-void I2C_Wait_For_Ack(void);
+bool I2C_Transfer_Submit(I2C_TRANSFER *p_transfer);
 
-void I2C_Send_Start(void);
-
-void I2C_Send_Stop(void);
+void I2C_Transfer_Timeout_Tick(void);
 
 void Initialize_TSL2651(void);
 
@@ -102,6 +163,10 @@ void I2C_TSL_PowerOff_Routine(void);
 
 void I2C_TSL_Deinit(void);
 
+void I2C_TSL_Read_Lux(void);
+
+uint32_t I2C_TSL_Calculate_Lux(uint16_t ch0, uint16_t ch1, uint8_t timing_reg_val);
+
 /****************************** FUNCTION PROTOTYPES *********************************/
 
 #endif /* INC_MCIOT_I2C_H_ */
@@ -27,7 +27,10 @@
 
 /** Validate count is the number of consecutive scan-cycles a button needs to */
 /** be in the changed state before an actual button press or release is acknowledged. */
-#define VALIDATE_CNT                   	10
+/** These are scans started back to back after the periodic scan that first flags the change, */
+/** SAMPLE_DELAY LFXO ticks per used channel each, so a change is confirmed at most one scan */
+/** period and about 3 ms per used channel after the touch starts. */
+#define VALIDATE_CNT                   	3
 
 /** Number of calibration events used to calculate threshold. */
 #define NUMBER_OF_CALIBRATION_VALUES    10
@@ -35,6 +38,14 @@
 /** Interval between calibration, in seconds. */
 #define CALIBRATION_INTERVAL            5
 
+/** Sensitivity is kept as percent in Q8, the threshold divisor is 100 percent in Q8. */
+#define LETOUCH_THRESHOLD_Q8_ONE        256
+#define LETOUCH_THRESHOLD_Q8_DIVISOR    (100 * LETOUCH_THRESHOLD_Q8_ONE)
+
+/** Results per DMA batch, 8 scans with two channels used. The core wakes up once per batch */
+/** while no pad changes, see LETOUCH_Process_Batch. */
+#define LESENSE_DMA_BATCH_ENTRIES       16
+
 /* LESENSE number of channels possible to use, should be 16 */
 #define NUM_LESENSE_CHANNELS    		16
 
@@ -43,7 +54,11 @@
 #define	LESENSE_CORE_CTRL_PRS_SOURCE	lesensePRSCh0
 #define	LESENSE_CORE_CTRL_SCAN_CONFIG	lesenseScanConfDirMap
 #define	LESENSE_CORE_CTRL_BUFTRIG_LEVEL	lesenseBufTrigHalf
+#ifdef USE_DMA_FOR_LESENSE
+#define	LESENSE_CORE_CTRL_DMA_WAKEUP	lesenseDMAWakeUpBufLevel	// wake the DMA in EM2 at the buffer trigger level
+#else
 #define	LESENSE_CORE_CTRL_DMA_WAKEUP	lesenseDMAWakeUpDisable
+#endif
 #define	LESENSE_CORE_CTRL_BIAS_MODE		lesenseBiasModeDutyCycle
 
 /* LESENSE peripheral ctrl descriptor structure */
@@ -80,6 +95,14 @@
 
 /**************************** STRUCTURES/ENUMERATIONS *******************************/
 
+/* Monotonic deque of calibration value slots, oldest sample at the front */
+typedef struct _LETOUCH_DEQUE_
+{
+	uint8_t		slot[NUMBER_OF_CALIBRATION_VALUES];
+	uint8_t		head;
+	uint8_t		count;
+} LETOUCH_DEQUE;
+
 /**************************** STRUCTURES/ENUMERATIONS *******************************/
 
 /************************************ GLOBALS ***************************************/
@@ -91,11 +114,15 @@
 void LESENSE_SetUp(void);
 
 void LESENSE_IRQHandler(void);
-void LETOUCH_Init(float sensitivity[]);
+void LETOUCH_Init(const uint16_t threshold_q8[]);
+void LETOUCH_DeInit(void);
+bool LETOUCH_IsCalibrated(void);
 
 uint16_t LETOUCH_GetChannelsTouched(void);
 uint16_t LETOUCH_GetChannelMaxValue(uint8_t channel);
 uint16_t LETOUCH_GetChannelMinValue(uint8_t channel);
+uint16_t LETOUCH_GetCalibration(uint16_t *p_baseline, uint16_t *p_threshold);
+uint32_t LETOUCH_Time_To_Next_Event_us(void);
 
 void LETOUCH_Calibration(void);
 
@@ -27,11 +27,6 @@
 //#define LED_PORT gpioPortE
 //#define LED_PIN  2
 
-#define CHANNEL_EIGHT_TOUCH_VAL	256
-#define CHANNEL_NINE_TOUCH_VAL	512
-#define CHANNEL_TEN_TOUCH_VAL	1024
-#define CHANNEL_ELEVEN_TOUCH_VAL	2048
-
 /************************************* MACROS ***************************************/
 
 /**************************** STRUCTURES/ENUMERATIONS *******************************/
@@ -46,6 +41,14 @@
 
 void LESENSE_SetUp(void);
 
+void LESENSE_Auth_Touch_Event(uint16_t channels_touched, uint32_t elapsed_rtc_ticks);
+
+void LESENSE_Auth_Timeout_Event(void);
+
+void LESENSE_TearDown(void);
+
+void LESENSE_Save_Calibration(void);
+
 /****************************** FUNCTION PROTOTYPES *********************************/
 
 #endif /* INC_PROJECT_LESENSE_MAIN_H_ */
@@ -5,23 +5,93 @@
 /************************************ INCLUDES **************************************/
 
 #include "em_letimer.h"
+#include "em_cmu.h"
 
 /************************************ INCLUDES **************************************/
 
 /************************************* MACROS ***************************************/
 
-#define LETIMER0_MAX_COUNT			65536
+#define LETIMER0_MAX_COUNT			0xFFFF		/* Largest value COMP0/COMP1 can hold */
+#define LETIMER0_MAX_PRESCALER		15			/* LFAPRESC0 LETIMER0 field, DIV1 to DIV32768 */
 
 #define LETIMER_MIN_ENERGY_MODE		EM3
 
+/* Number of LETIMER ticks in period_ms with the clock freq divided by 2^presc */
+#define LETIMER_PERIOD_TO_TICKS(freq, presc, period_ms) \
+	((((freq) >> (presc)) * (period_ms)) / 1000)
+
+#define LETIMER_FITS(freq, presc, period_ms) \
+	(LETIMER_PERIOD_TO_TICKS(freq, presc, period_ms) <= LETIMER0_MAX_COUNT)
+
+/* Smallest prescaler that makes period_ms fit into the 16 bit LETIMER0.
+ * Evaluates to LETIMER0_MAX_PRESCALER + 1 if the period cannot be represented. */
+#define LETIMER_PRESCALER_FOR(freq, period_ms) \
+	(LETIMER_FITS(freq, 0, period_ms)  ? 0  : LETIMER_FITS(freq, 1, period_ms)  ? 1  : \
+	 LETIMER_FITS(freq, 2, period_ms)  ? 2  : LETIMER_FITS(freq, 3, period_ms)  ? 3  : \
+	 LETIMER_FITS(freq, 4, period_ms)  ? 4  : LETIMER_FITS(freq, 5, period_ms)  ? 5  : \
+	 LETIMER_FITS(freq, 6, period_ms)  ? 6  : LETIMER_FITS(freq, 7, period_ms)  ? 7  : \
+	 LETIMER_FITS(freq, 8, period_ms)  ? 8  : LETIMER_FITS(freq, 9, period_ms)  ? 9  : \
+	 LETIMER_FITS(freq, 10, period_ms) ? 10 : LETIMER_FITS(freq, 11, period_ms) ? 11 : \
+	 LETIMER_FITS(freq, 12, period_ms) ? 12 : LETIMER_FITS(freq, 13, period_ms) ? 13 : \
+	 LETIMER_FITS(freq, 14, period_ms) ? 14 : LETIMER_FITS(freq, 15, period_ms) ? 15 : \
+	 (LETIMER0_MAX_PRESCALER + 1))
+
+/* Timing for the LFXO clocked LETIMER (energy modes EM0-EM2) */
+#define LETIMER_LFXO_PRESCALER		LETIMER_PRESCALER_FOR(LFXO_FREQUENCY, ALS_EXCITE_PERIOD_MS)
+#define LETIMER_LFXO_COMP0_VAL		LETIMER_PERIOD_TO_TICKS(LFXO_FREQUENCY, LETIMER_LFXO_PRESCALER, ALS_EXCITE_PERIOD_MS)
+#define LETIMER_LFXO_EXCITE_TICKS	LETIMER_PERIOD_TO_TICKS(LFXO_FREQUENCY, LETIMER_LFXO_PRESCALER, ALS_MIN_EXCITE_PERIOD_MS)
+#define LETIMER_LFXO_COMP1_VAL		(LETIMER_LFXO_COMP0_VAL - LETIMER_LFXO_EXCITE_TICKS)
+
+/* Timing for the ULFRCO clocked LETIMER (energy modes EM3-EM4), before self calibration */
+#define LETIMER_ULFRCO_PRESCALER	LETIMER_PRESCALER_FOR(ULFRCO_FREQUENCY, ALS_EXCITE_PERIOD_MS)
+#define LETIMER_ULFRCO_COMP0_VAL	LETIMER_PERIOD_TO_TICKS(ULFRCO_FREQUENCY, LETIMER_ULFRCO_PRESCALER, ALS_EXCITE_PERIOD_MS)
+#define LETIMER_ULFRCO_EXCITE_TICKS	LETIMER_PERIOD_TO_TICKS(ULFRCO_FREQUENCY, LETIMER_ULFRCO_PRESCALER, ALS_MIN_EXCITE_PERIOD_MS)
+#define LETIMER_ULFRCO_COMP1_VAL	(LETIMER_ULFRCO_COMP0_VAL - LETIMER_ULFRCO_EXCITE_TICKS)
+
 /************************************* MACROS ***************************************/
 
+/********************************** ENUMERATIONS ************************************/
+
+/* LETIMER0 timing for one energy mode, computed at compile time */
+typedef struct _LETIMER_TIMING_CONFIG_
+{
+	CMU_Select_TypeDef	lfa_clock;		/* LFA clock source */
+	uint8_t				prescaler;		/* LFAPRESC0 LETIMER0 value, clock divided by 2^prescaler */
+	uint16_t			comp0_val;		/* COMP0 (TOP), the excite period */
+	uint16_t			comp1_val;		/* COMP1, start of the minimum excite window */
+} LETIMER_TIMING_CONFIG;
+
+/********************************** ENUMERATIONS ************************************/
+
 /************************************ GLOBALS ***************************************/
+
+/* Indexed by ENERGY_MODES */
+extern const LETIMER_TIMING_CONFIG letimer_timing_config[LETIMER_ENERGY_MODE_MAX];
+
 #ifdef USE_ACTIVE_ALS
 uint32_t letimer0_comp0_period_count;
 uint32_t letimer0_comp1_period_count;
 #endif
 
+#ifdef USE_ADAPTIVE_ALS
+/* ALS check interval in LETIMER0 periods (passive) or TSL2561 power cycles (active),
+ * 0 until the first check */
+uint32_t als_check_interval;
+
+/* LETIMER0 periods left before the next check */
+uint32_t als_periods_to_check;
+
+/* ACMP output of the last check */
+uint32_t als_last_acmp_out;
+
+/* Set on COMP0 when the ALS was excited this period, consumed on COMP1. The active
+ * ALS keeps it for the whole power cycle */
+bool als_check_pending;
+
+/* Excitations skipped since reset, for measuring the saving */
+uint32_t als_checks_skipped;
+#endif
+
 /************************************ GLOBALS ***************************************/
 
 /****************************** FUNCTION PROTOTYPES *********************************/
@@ -41,4 +111,6 @@ void LETIMER_Interrupt_Enable(LETIMER_TypeDef *LETimer);
 
 void LETIMER0_IRQHandler(void);
 
+uint32_t LETimer_Time_To_Next_Event_us(void);
+
 /****************************** FUNCTION PROTOTYPES *********************************/
@@ -0,0 +1,66 @@
+#ifndef _MCIOT_POWER_H_
+#define _MCIOT_POWER_H_
+
+/************************************ INCLUDES **************************************/
+
+#include "em_gpio.h"
+#include "em_rtc.h"
+
+/************************************ INCLUDES **************************************/
+
+/************************************* MACROS ***************************************/
+
+/* External sensor supplies that can be settling at the same time */
+#define POWER_DOMAIN_MAX			4
+
+/* The RTC counter is 24 bits wide */
+#define POWER_RTC_COUNTER_MASK		0x00FFFFFF
+
+/* Closest a compare match is armed ahead of the counter, so the write has
+ * synchronised to the LF domain before the match */
+#define POWER_RTC_MIN_TICKS			2
+
+/************************************* MACROS ***************************************/
+
+/********************************** ENUMERATIONS ************************************/
+
+typedef enum _POWER_DOMAIN_STATE_
+{
+	POWER_DOMAIN_OFF = 0,
+	POWER_DOMAIN_SETTLING,			/* Supply raised, waiting for settle_ms on the RTC */
+	POWER_DOMAIN_ON
+} POWER_DOMAIN_STATE;
+
+typedef struct _POWER_DOMAIN_ POWER_DOMAIN;
+
+/* Deferred init step, called from RTC_IRQHandler once the supply has settled */
+typedef void (*POWER_DOMAIN_CALLBACK)(POWER_DOMAIN *p_domain);
+
+/* A GPIO switched sensor supply, e.g. the TSL2561 power pin or a sensor
+ * excitation line. Owned by the sensor driver. */
+struct _POWER_DOMAIN_
+{
+	GPIO_Port_TypeDef				port;
+	uint8_t							pin;
+	uint32_t						settle_ms;		/* Time from raising the pin to on_ready */
+	POWER_DOMAIN_CALLBACK			on_ready;		/* May be NULL */
+	volatile POWER_DOMAIN_STATE		e_state;
+	uint32_t						start_tick;		/* RTC count when the pin was raised */
+	uint32_t						settle_ticks;
+};
+
+/********************************** ENUMERATIONS ************************************/
+
+/****************************** FUNCTION PROTOTYPES *********************************/
+
+void Power_Domain_On(POWER_DOMAIN *p_domain);
+
+void Power_Domain_Off(POWER_DOMAIN *p_domain);
+
+void Power_RTC_IRQHandler(void);
+
+uint32_t Power_RTC_Time_To_Next_Event_us(void);
+
+/****************************** FUNCTION PROTOTYPES *********************************/
+
+#endif /* _MCIOT_POWER_H_ */
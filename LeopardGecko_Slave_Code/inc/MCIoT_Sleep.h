@@ -12,6 +12,56 @@
 
 /************************************ INCLUDES **************************************/
 
+/************************************* MACROS ***************************************/
+
+/* Time to next event when no deadline is known */
+#define SLEEP_NO_DEADLINE			0xFFFFFFFF
+
+/* Supply current per energy mode in nA, EFM32LG datasheet typicals at 14 MHz HFRCO */
+#define SLEEP_EM0_CURRENT_NA		2950000
+#define SLEEP_EM1_CURRENT_NA		880000
+#define SLEEP_EM2_CURRENT_NA		1000
+#define SLEEP_EM3_CURRENT_NA		650
+
+/* Time from wakeup interrupt to code execution in EM0 with the HFRCO restored.
+ * EM4 is not in the table, Sleep() never enters it: it stops LETIMER0 and
+ * wakes up through a reset */
+#define SLEEP_EM1_WAKEUP_US			0
+#define SLEEP_EM2_WAKEUP_US			2
+#define SLEEP_EM3_WAKEUP_US			2
+
+/* The HFXO is stopped from EM2 down, EMU_EnterEM2/3() wait for it to restart
+ * on wakeup if it drives HFCLK */
+#define SLEEP_HFXO_RESTART_US		400
+
+/* The ADC loses HFPERCLK from EM2 down. Unless it already warms up for every
+ * conversion, the next sample waits for the ADC and its 1.25 V reference */
+#define SLEEP_ADC_WARMUP_US			6
+
+/* The LFXO is stopped in EM3, a wakeup has to wait for it to restart if a
+ * peripheral still runs from it */
+#define SLEEP_LFXO_RESTART_US		400000
+
+/************************************* MACROS ***************************************/
+
+/********************************** ENUMERATIONS ************************************/
+
+/* Cost of sleeping in an energy mode */
+typedef struct _SLEEP_MODE_COST_
+{
+	uint32_t	current_na;			/* Supply current while asleep */
+	uint32_t	wakeup_latency_us;	/* Time spent in EM0 before the wakeup source can be serviced */
+} SLEEP_MODE_COST;
+
+/********************************** ENUMERATIONS ************************************/
+
+/************************************ GLOBALS ***************************************/
+
+/* Indexed by ENERGY_MODES */
+extern const SLEEP_MODE_COST sleep_mode_cost[LETIMER_ENERGY_MODE_MAX];
+
+/************************************ GLOBALS ***************************************/
+
 /****************************** FUNCTION PROTOTYPES *********************************/
 
 void blockSleepMode(ENERGY_MODES e_letimer_energy_modes);
@@ -20,4 +70,6 @@ void unblockSleepMode(ENERGY_MODES e_letimer_energy_modes);
 
 void Sleep(void);
 
+ENERGY_MODES Sleep_Select_Mode(ENERGY_MODES e_deepest_mode, uint32_t time_to_event_us);
+
 /****************************** FUNCTION PROTOTYPES *********************************/
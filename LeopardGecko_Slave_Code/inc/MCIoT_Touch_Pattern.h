@@ -0,0 +1,104 @@
+#ifndef _MCIOT_TOUCH_PATTERN_H_
+#define _MCIOT_TOUCH_PATTERN_H_
+
+/************************************ INCLUDES **************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/************************************ INCLUDES **************************************/
+
+/************************************* MACROS ***************************************/
+
+/* Longest pattern the step table holds */
+#define TOUCH_PATTERN_MAX_STEPS					8
+
+/* Resolution of the inter-touch timing windows, the 32768 Hz RTC divided by 64 */
+#define TOUCH_PATTERN_TICK_SHIFT				6
+#define TOUCH_PATTERN_TICK_HZ					(32768 >> TOUCH_PATTERN_TICK_SHIFT)
+
+/* Widest timing window a step can hold, about 128 s */
+#define TOUCH_PATTERN_MAX_GAP_TICKS				0xFFFF
+
+/* Quiet intervals before a started pattern counts as a failed attempt */
+#define TOUCH_PATTERN_STEP_TIMEOUT_INTERVALS	1
+
+/* Failed attempts in a row before touches are ignored */
+#define TOUCH_PATTERN_MAX_FAILURES				3
+
+/* Quiet intervals before a lockout runs out */
+#define TOUCH_PATTERN_LOCKOUT_INTERVALS			6
+
+/* Pad bit for a LESENSE channel in the chord masks */
+#define TOUCH_PATTERN_PAD(channel)				((uint16_t)(1 << (channel)))
+
+/************************************* MACROS ***************************************/
+
+/********************************** ENUMERATIONS ************************************/
+
+typedef enum _TOUCH_PATTERN_STATES_
+{
+	TOUCH_PATTERN_STATE_WAIT_RELEASE = 0,	/* Pads held, wait for all of them to be released */
+	TOUCH_PATTERN_STATE_IDLE,				/* Wait for the first pad of the next step */
+	TOUCH_PATTERN_STATE_CHORD,				/* Pads of the current step held, the step ends on release */
+	TOUCH_PATTERN_STATE_DONE,
+	TOUCH_PATTERN_STATE_LOCKED				/* Too many failures, or no pattern compiled */
+} TOUCH_PATTERN_STATES;
+
+typedef enum _TOUCH_PATTERN_RESULT_
+{
+	TOUCH_PATTERN_RESULT_NONE = 0,			/* Pattern still being entered */
+	TOUCH_PATTERN_RESULT_ACCEPTED,
+	TOUCH_PATTERN_RESULT_REJECTED,
+	TOUCH_PATTERN_RESULT_LOCKED
+} TOUCH_PATTERN_RESULT;
+
+/* One step as written by the application. The gap is measured from the release
+ * of the previous step to the first press of this one, and is ignored for the
+ * first step. */
+typedef struct _TOUCH_PATTERN_STEP_DEF_
+{
+	uint16_t						chord_mask;		/* Pads touched together, TOUCH_PATTERN_PAD() or'ed */
+	uint16_t						min_gap_ms;
+	uint16_t						max_gap_ms;
+} TOUCH_PATTERN_STEP_DEF;
+
+/* One compiled step, the gap window in TOUCH_PATTERN_TICK_HZ ticks */
+typedef struct _TOUCH_PATTERN_STEP_
+{
+	uint16_t						chord_mask;
+	uint16_t						min_gap_ticks;
+	uint16_t						max_gap_ticks;
+} TOUCH_PATTERN_STEP;
+
+typedef struct _TOUCH_PATTERN_
+{
+	TOUCH_PATTERN_STEP				steps[TOUCH_PATTERN_MAX_STEPS];
+	uint8_t							num_steps;
+	uint16_t						channels_mask;		/* Every pad used by the pattern */
+
+	volatile TOUCH_PATTERN_STATES	e_state;
+	uint8_t							step_index;
+	uint16_t						chord_touched;		/* Pads touched in the current step */
+	uint16_t						mismatch;			/* Non zero once any step did not match */
+	uint16_t						last_touched;
+	uint8_t							quiet_intervals;
+	uint8_t							failures;
+	uint8_t							lockout_intervals;
+} TOUCH_PATTERN;
+
+/********************************** ENUMERATIONS ************************************/
+
+/****************************** FUNCTION PROTOTYPES *********************************/
+
+bool Touch_Pattern_Compile(TOUCH_PATTERN *p_pattern, const TOUCH_PATTERN_STEP_DEF *p_steps, uint8_t num_steps);
+
+void Touch_Pattern_Reset(TOUCH_PATTERN *p_pattern, uint16_t channels_touched);
+
+TOUCH_PATTERN_RESULT Touch_Pattern_Touch_Event(TOUCH_PATTERN *p_pattern, uint16_t channels_touched, uint32_t elapsed_ticks);
+
+TOUCH_PATTERN_RESULT Touch_Pattern_Timeout_Event(TOUCH_PATTERN *p_pattern);
+
+/****************************** FUNCTION PROTOTYPES *********************************/
+
+#endif /* _MCIOT_TOUCH_PATTERN_H_ */
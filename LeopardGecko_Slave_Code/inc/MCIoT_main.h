@@ -23,17 +23,18 @@
 #define ULFRCO_FREQUENCY 			1000		/* 1 kHz */
 #define ULFRCO_SELF_CALIBRATE 		1			/* Self Calibrate ULFRCO */
 
-/* One Second and One millisecond definitions */
+/* One Second definition */
 #define ONE_SEC 					1
-#define ONE_MS 						1/1000
 
 /* Calibration Period */
 #define CALIBRATION_PERIOD 			1*ONE_SEC 	/* ULFRCO calibration period*/
 
-#define MAX_PERIOD_32kHZ   			2*ONE_SEC 	/* Max time duration that can be generated using 32kHz clock */
+/* ULFRCO to LFXO oscillator ratio is kept in Q16 fixed point */
+#define OSC_RATIO_FRAC_BITS			16
+#define OSC_RATIO_UNITY				(1 << OSC_RATIO_FRAC_BITS)
 
 /* LED On Time */
-#define ALS_MIN_EXCITE_PERIOD 		4*ONE_MS 	/* Keep the ambient light sensor excited for a minimum of 4 ms */
+#define ALS_MIN_EXCITE_PERIOD_MS 	4		 	/* Keep the ambient light sensor excited for a minimum of 4 ms */
 
 #define DARK_REFERENCE_VDDLEVEL 	2
 #define LIGHT_REFERENCE_VDDLEVEL 	61
@@ -42,15 +43,25 @@
 
 #define USE_DMA_FOR_ADC				1			/* Enable this to use DMA to transfer ADC samples to RAM */
 
+#define USE_DMA_FOR_LESENSE			1			/* Enable this to use DMA to batch LESENSE scan results in RAM */
+
+#define USE_CALIBRATION_RECORD		1			/* Enable this to keep the touch and ULFRCO calibration in flash (needs ENABLE_ADC_MODULE) */
+
 //#define USE_ANY_ALS							/* Enable this to use ALS. Active or Passive*/
 //#define USE_ACTIVE_ALS				1		/* Enable this to use active ALS */
 
-#define ALS_EXCITE_PERIOD  			3.75*ONE_SEC/* Ambient Light Sensor Excite Time */
+#define ALS_EXCITE_PERIOD_MS		3750		/* Ambient Light Sensor Excite Time (3.75 s) */
 
-#define I2C_EM						EM3
+#define USE_ADAPTIVE_ALS			1			/* Enable this to back off the ALS checks while the light level is stable */
+#define ALS_MAX_CHECK_INTERVAL		8			/* Longest back off, in LETIMER0 periods (30 s) or active ALS power cycles (90 s) */
+#define ALS_LUX_STABLE_SHIFT		3			/* Active ALS readings within 1/8 of the last one count as stable */
+
+#define I2C_EM						EM1			/* I2C1 runs from HFPERCLK */
 
 #define LEUART_EM					EM2
 
+#define LESENSE_EM					EM2			/* LESENSE and its calibration RTC run from the LFXO */
+
 //#define USE_INT						1
 
 #define ENABLE_ADC_MODULE			1
@@ -59,6 +70,15 @@
 
 //#define USE_LFRCO_FOR_LEUART_IN_EM3 1
 
+//#define ENABLE_BOOT_TRACE			1			/* Enable this to timestamp each boot stage with the BURTC */
+
+#ifdef ENABLE_BOOT_TRACE
+#define BOOT_TRACE(stage)			Boot_Trace_Stage(stage)
+#define BOOT_TRACE_TICK_HZ			32768		/* BURTC on the LFRCO, undivided */
+#else
+#define BOOT_TRACE(stage)
+#endif
+
 /************************************* MACROS ***************************************/
 
 /********************************** ENUMERATIONS ************************************/
@@ -75,6 +95,20 @@ typedef enum _ENERGY_MODES
 	LETIMER_ENERGY_MODE_MAX
 } ENERGY_MODES;
 
+/* Cold boot stages, in the order main() completes them */
+typedef enum _BOOT_STAGES
+{
+	BOOT_STAGE_RESET,				/* Entered main, BURTC started */
+	BOOT_STAGE_CHIP_INIT,			/* Chip errata applied, LFXO start-up kicked off */
+	BOOT_STAGE_HF_PERIPHERALS,		/* GPIO, ADC, DMA and I2C set up while the LFXO settles */
+	BOOT_STAGE_TOUCH_CALIBRATED,	/* LESENSE settling scans done from its interrupt */
+	BOOT_STAGE_TOUCH_AUTH,			/* Touch authentication passed */
+	BOOT_STAGE_LF_CLOCKS,			/* LFA/LFB clock trees routed to LETIMER0 and LEUART0 */
+	BOOT_STAGE_LETIMER_STARTED,		/* Sampling timer running */
+	BOOT_STAGE_FIRST_SAMPLE_TX,		/* First sample written to the LEUART */
+	BOOT_STAGE_MAX
+} BOOT_STAGES;
+
 /********************************** ENUMERATIONS ************************************/
 
 /************************************ GLOBALS ***************************************/
@@ -89,13 +123,29 @@ uint32_t sleep_block_counter[MAX_ENERGY_MODE+1];
 /* Initializing LETimer in energy mode EM2 */
 ENERGY_MODES e_letimer_energy_modes;
 
-float osc_ratio;
-
-uint32_t prescaled_two_power;
-uint32_t letimer0_prescaler;
+/* LFXO/ULFRCO count ratio in Q16 fixed point (OSC_RATIO_UNITY == 1.0) */
+uint32_t osc_ratio;
 
 bool LEUART_is_Enabled;
 
-bool is_lesense_auth_done;
+/* Set from the LESENSE interrupt while LESENSE_SetUp() sleeps on it */
+volatile bool is_lesense_auth_done;
+
+#ifdef ENABLE_BOOT_TRACE
+/* BURTC ticks from reset to each boot stage. The BURTC keeps counting in
+ * EM2/EM3, where the core sleeps while the LFXO starts and LESENSE scans */
+uint32_t boot_trace_ticks[BOOT_STAGE_MAX];
+/* Ticks from reset to the first sample sent, without the time spent waiting
+ * for the touch authentication. 0 until the first sample is sent */
+uint32_t boot_trace_span_ticks;
+#endif
 
 /************************************ GLOBALS ***************************************/
+
+/****************************** FUNCTION PROTOTYPES *********************************/
+
+#ifdef ENABLE_BOOT_TRACE
+void Boot_Trace_Stage(BOOT_STAGES e_boot_stage);
+#endif
+
+/****************************** FUNCTION PROTOTYPES *********************************/
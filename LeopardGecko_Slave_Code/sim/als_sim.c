@@ -0,0 +1,848 @@
+/*****************************************************************************
+ * @file 	als_sim.c
+ * @brief 	Host simulation of the ambient light sensing. Runs LETIMER0_IRQHandler
+ * 			of MCIoT_LETimer.c once per ALS_EXCITE_PERIOD_MS, with the light
+ * 			level changing over the run, in one of the two ALS configurations:
+ * 			- USE_ACTIVE_ALS: MCIoT_I2C.c and MCIoT_Power.c against a TSL2561
+ * 			  model on I2C1. The sensor acks once its supply has been up for
+ * 			  SIM_TSL_POWER_UP_MS, integrates both channels every 101 ms and
+ * 			  pulls its interrupt line after 4 integrations of CH0 outside the
+ * 			  thresholds. The RTC times the supply settle time.
+ * 			- Passive: the ACMP compares the ALS pin against a VDD level, its
+ * 			  output is high while the light is on.
+ * 			Both are run with USE_ADAPTIVE_ALS. With USE_ACTIVE_ALS the lux
+ * 			formula is also checked on its own against the floating point
+ * 			formula of the datasheet.
+ *
+ * 			Exits non-zero if the lux is off the datasheet formula, if a reading
+ * 			is not the one of the light at the time, if a light change is seen
+ * 			later than ALS_MAX_CHECK_INTERVAL checks, if the checks are not
+ * 			backed off while the light is stable, if the sensor is accessed
+ * 			before its supply has settled or if its threshold interrupt is missed.
+ *
+ * 			Build and run from LeopardGecko_Slave_Code, once per configuration,
+ * 			the interrupt handlers of the modules not under test are left out
+ * 			of the link:
+ *
+ * 			  gcc -O2 -Wall -fcommon -ffunction-sections -Wl,--gc-sections -DUSE_ANY_ALS -DUSE_ACTIVE_ALS \
+ * 			    -Isim -Iinc -o als_sim sim/als_sim.c src/MCIoT_LETimer.c src/MCIoT_I2C.c src/MCIoT_Power.c -lm
+ * 			  ./als_sim
+ * 			  gcc -O2 -Wall -fcommon -ffunction-sections -Wl,--gc-sections -DUSE_ANY_ALS \
+ * 			    -Isim -Iinc -o als_sim sim/als_sim.c src/MCIoT_LETimer.c -lm
+ * 			  ./als_sim
+ ******************************************************************************/
+
+/************************************ INCLUDES **************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "em_device.h"
+#include "em_cmu.h"
+#include "em_letimer.h"
+#include "em_acmp.h"
+#include "em_adc.h"
+#include "em_gpio.h"
+#include "em_i2c.h"
+#include "em_rtc.h"
+#include "em_leuart.h"
+#include "MCIoT_main.h"
+#include "MCIoT_CMU.h"
+#include "MCIoT_Sleep.h"
+#include "MCIoT_GPIO.h"
+#include "MCIoT_LETimer.h"
+#include "MCIoT_I2C.h"
+#include "MCIoT_Power.h"
+#include "MCIoT_LEUART.h"
+
+/************************************ INCLUDES **************************************/
+
+/************************************* MACROS ***************************************/
+
+#if !defined(USE_ANY_ALS) || !defined(USE_ADAPTIVE_ALS)
+#error "Build with -DUSE_ANY_ALS, and USE_ADAPTIVE_ALS in MCIoT_main.h"
+#endif
+
+/* LETIMER0 periods of each light level */
+#define SIM_STABLE_PERIODS			60
+#define SIM_CHANGED_PERIODS			60
+
+#define SIM_RTC_HZ					32768
+
+/* TSL2561 model */
+#define SIM_TSL_POWER_UP_MS			5			/* Supply up to the first I2C ack */
+#define SIM_TSL_INTEGRATION_MS		101			/* Timing register INTEG = 1 */
+#define SIM_TSL_PERSIST				4			/* Interrupt register PERSIST field of 0x14 */
+#define SIM_TSL_REG_COUNT			16
+
+#define SIM_TSL_CMD					0x80
+#define SIM_TSL_CMD_CLEAR			0x40
+#define SIM_TSL_CMD_BLOCK			0x10
+#define SIM_TSL_CMD_ADDR_MASK		0x0F
+
+/************************************* MACROS ***************************************/
+
+/********************************** ENUMERATIONS ************************************/
+
+/* Light level, as the counts of both channels in 101 ms at 1x gain */
+typedef struct
+{
+	const char	*name;
+	uint16_t	ch0;
+	uint16_t	ch1;
+	bool		bright;				/* ALS pin above the ACMP reference */
+} SIM_LIGHT;
+
+/********************************** ENUMERATIONS ************************************/
+
+/****************************** FUNCTION PROTOTYPES *********************************/
+
+/* Interrupt handlers of MCIoT_I2C.c, only known to the vector table */
+void I2C1_IRQHandler(void);
+void GPIO_ODD_IRQHandler(void);
+
+/****************************** FUNCTION PROTOTYPES *********************************/
+
+/************************************ GLOBALS ***************************************/
+
+CMU_TypeDef sim_cmu;
+RTC_TypeDef sim_rtc;
+ACMP_TypeDef sim_acmp[2];
+ADC_TypeDef sim_adc0;
+LEUART_TypeDef sim_leuart0;
+I2C_TypeDef sim_i2c1;
+
+static LETIMER_TypeDef sim_letimer0;
+
+static const SIM_LIGHT sim_office = { "office", 300, 60, true };
+#ifdef USE_ACTIVE_ALS
+static const SIM_LIGHT sim_dusk = { "dusk", 40, 25, true };
+#endif
+static const SIM_LIGHT sim_dark = { "dark", 8, 2, false };
+
+static const SIM_LIGHT *sim_light;
+static uint32_t sim_now_ms;
+static int sim_failures;
+
+/* Checks run, and the longest gap between two in LETIMER0 periods */
+static uint32_t sim_checks;
+static uint32_t sim_periods;
+static uint32_t sim_last_check_period;
+static uint32_t sim_max_check_gap;
+
+#ifdef USE_ACTIVE_ALS
+/* TSL2561 model */
+static bool sim_tsl_powered;
+static uint32_t sim_tsl_power_ms;
+static uint8_t sim_tsl_regs[SIM_TSL_REG_COUNT];
+static uint8_t sim_tsl_addr;
+static uint32_t sim_tsl_integrations;
+static uint32_t sim_tsl_out_of_range;
+static bool sim_tsl_int_asserted;
+static uint32_t sim_tsl_interrupts;
+static bool sim_tsl_int_enabled;
+
+/* I2C1 */
+static bool sim_i2c_pins_enabled;
+static I2C_TransferSeq_TypeDef *sim_i2c_seq;
+static uint32_t sim_i2c_early;
+static uint32_t sim_i2c_nacks;
+
+/* Light level of the last TSL2561 conversion and of the last one read */
+static const SIM_LIGHT *sim_tsl_light;
+static const SIM_LIGHT *sim_tsl_read_light;
+static uint32_t sim_tsl_reads;
+#endif
+
+/************************************ GLOBALS ***************************************/
+
+/************************************************************************************
+ * @function 	Sim_Check
+ * @params 		[in] ok - result of the check
+ * 				[in] what - description of the check
+ * @brief 		Records a failed check.
+ ************************************************************************************/
+static void Sim_Check(bool ok, const char *what)
+{
+	if (!ok)
+	{
+		printf("FAIL: %s\n", what);
+		sim_failures++;
+	}
+}
+
+/************************************************************************************
+ * Stubbed emlib calls
+ ************************************************************************************/
+LETIMER_TypeDef *Sim_LETIMER0(void)
+{
+	return &sim_letimer0;
+}
+
+uint32_t Sim_Core_Enter(void)
+{
+	return 0;
+}
+
+void Sim_Core_Exit(uint32_t state)
+{
+	(void)state;
+}
+
+void NVIC_EnableIRQ(IRQn_Type irq)
+{
+	(void)irq;
+}
+
+void NVIC_DisableIRQ(IRQn_Type irq)
+{
+	(void)irq;
+}
+
+void NVIC_ClearPendingIRQ(IRQn_Type irq)
+{
+	(void)irq;
+}
+
+uint32_t CMU_ClockFreqGet(CMU_Clock_TypeDef clock)
+{
+	(void)clock;
+	return SIM_RTC_HZ;
+}
+
+void ADC_Start(ADC_TypeDef *adc, ADC_Start_TypeDef cmd)
+{
+	(void)cmd;
+	adc->STATUS |= ADC_STATUS_WARM;
+
+	/* The samples are taken and ADC0_IRQHandler releases its block */
+	unblockSleepMode(ADC_EM);
+}
+
+void GPIO_PinModeSet(GPIO_Port_TypeDef port, unsigned int pin, GPIO_Mode_TypeDef mode, unsigned int out)
+{
+#ifdef USE_ACTIVE_ALS
+	if ((port == GPIO_PORT_D) && (pin == TSL2651_POWER_PIN))
+	{
+		if ((mode == gpioModePushPull) && out && !sim_tsl_powered)
+		{
+			sim_tsl_powered = true;
+			sim_tsl_power_ms = sim_now_ms;
+		}
+		else if ((mode == gpioModeDisabled) || !out)
+		{
+			sim_tsl_powered = false;
+		}
+	}
+#else
+	(void)port;
+	(void)pin;
+	(void)mode;
+	(void)out;
+#endif
+}
+
+void GPIO_PinOutClear(GPIO_Port_TypeDef port, unsigned int pin)
+{
+	GPIO_PinModeSet(port, pin, gpioModePushPull, 0);
+}
+
+void LED_On(GPIO_Port_TypeDef port, unsigned int pin)
+{
+	(void)port;
+	(void)pin;
+}
+
+void LED_Off(GPIO_Port_TypeDef port, unsigned int pin)
+{
+	(void)port;
+	(void)pin;
+}
+
+/************************************************************************************
+ * Stubbed application calls
+ ************************************************************************************/
+void blockSleepMode(ENERGY_MODES e_energy_mode)
+{
+	sleep_block_counter[e_energy_mode]++;
+}
+
+void unblockSleepMode(ENERGY_MODES e_energy_mode)
+{
+	if (sleep_block_counter[e_energy_mode] > 0)
+	{
+		sleep_block_counter[e_energy_mode]--;
+	}
+}
+
+bool CMU_Consumer_Start(CMU_CONSUMERS e_consumer)
+{
+	(void)e_consumer;
+	return true;
+}
+
+void CMU_Consumer_Stop(CMU_CONSUMERS e_consumer)
+{
+	(void)e_consumer;
+}
+
+#ifdef USE_ACTIVE_ALS
+/************************************************************************************
+ * TSL2561 on I2C1
+ ************************************************************************************/
+void I2C_GPIO_Enable(void)
+{
+	sim_i2c_pins_enabled = true;
+}
+
+void I2C_GPIO_Disable(void)
+{
+	sim_i2c_pins_enabled = false;
+}
+
+void GPIO_IntConfig(GPIO_Port_TypeDef port, unsigned int pin, bool risingEdge, bool fallingEdge, bool enable)
+{
+	(void)port;
+	(void)pin;
+	(void)risingEdge;
+	(void)fallingEdge;
+	sim_tsl_int_enabled = enable;
+}
+
+void GPIO_IntClear(uint32_t flags)
+{
+	(void)flags;
+}
+
+void I2C_Init(I2C_TypeDef *i2c, const I2C_Init_TypeDef *init)
+{
+	(void)i2c;
+	(void)init;
+}
+
+/************************************************************************************
+ * @function 	Sim_TSL_Write
+ * @params 		[in] data, len - bytes written after the address
+ * @brief 		Command byte, then the block count and registers of a block write.
+ ************************************************************************************/
+static void Sim_TSL_Write(const uint8_t *data, uint16_t len)
+{
+	uint16_t i = 1;
+
+	if ((len == 0) || ((data[0] & SIM_TSL_CMD) == 0))
+	{
+		return;
+	}
+
+	sim_tsl_addr = data[0] & SIM_TSL_CMD_ADDR_MASK;
+
+	if (data[0] & SIM_TSL_CMD_CLEAR)
+	{
+		sim_tsl_int_asserted = false;
+		sim_tsl_out_of_range = 0;
+	}
+
+	/* The block protocol sends the byte count first */
+	if ((data[0] & SIM_TSL_CMD_BLOCK) && (len > 1))
+	{
+		i = 2;
+	}
+
+	for (; i < len; i++)
+	{
+		sim_tsl_regs[sim_tsl_addr++ & SIM_TSL_CMD_ADDR_MASK] = data[i];
+	}
+}
+
+I2C_TransferReturn_TypeDef I2C_TransferInit(I2C_TypeDef *i2c, I2C_TransferSeq_TypeDef *seq)
+{
+	(void)i2c;
+	sim_i2c_seq = seq;
+	return i2cTransferInProgress;
+}
+
+I2C_TransferReturn_TypeDef I2C_Transfer(I2C_TypeDef *i2c)
+{
+	I2C_TransferSeq_TypeDef *seq = sim_i2c_seq;
+	uint16_t i;
+
+	(void)i2c;
+	sim_i2c_seq = NULL;
+
+	if ((seq == NULL) || ((seq->addr >> 1) != I2C_TSL2561_SLAVE_ADDR))
+	{
+		return i2cTransferNack;
+	}
+
+	if (!sim_i2c_pins_enabled || !sim_tsl_powered)
+	{
+		sim_i2c_nacks++;
+		return i2cTransferNack;
+	}
+
+	if ((sim_now_ms - sim_tsl_power_ms) < SIM_TSL_POWER_UP_MS)
+	{
+		sim_i2c_early++;
+		return i2cTransferNack;
+	}
+
+	if (seq->flags & (I2C_FLAG_WRITE | I2C_FLAG_WRITE_READ))
+	{
+		Sim_TSL_Write(seq->buf[0].data, seq->buf[0].len);
+	}
+
+	if (seq->flags & (I2C_FLAG_READ | I2C_FLAG_WRITE_READ))
+	{
+		I2C_TransferSeq_TypeDef *p = seq;
+		uint8_t b = (seq->flags & I2C_FLAG_READ) ? 0 : 1;
+
+		if (sim_tsl_addr == I2C_TSL_DATA0LOW_REG)
+		{
+			sim_tsl_read_light = sim_tsl_light;
+			sim_tsl_reads++;
+		}
+
+		for (i = 0; i < p->buf[b].len; i++)
+		{
+			p->buf[b].data[i] = sim_tsl_regs[sim_tsl_addr++ & SIM_TSL_CMD_ADDR_MASK];
+		}
+	}
+
+	return i2cTransferDone;
+}
+
+/************************************************************************************
+ * @function 	Sim_TSL_Step
+ * @params 		None
+ * @brief 		Latches a conversion of the current light at the end of every
+ * 				integration and pulls the interrupt line on the persistence.
+ ************************************************************************************/
+static void Sim_TSL_Step(void)
+{
+	uint16_t low;
+	uint16_t high;
+	uint32_t on_ms;
+
+	if (!sim_tsl_powered || ((sim_tsl_regs[I2C_TSL_CTRL_REG] & 0x03) != 0x03))
+	{
+		if (!sim_tsl_powered)
+		{
+			memset(sim_tsl_regs, 0, sizeof(sim_tsl_regs));
+			sim_tsl_int_asserted = false;
+			sim_tsl_out_of_range = 0;
+			sim_tsl_integrations = 0;
+		}
+		return;
+	}
+
+	on_ms = sim_now_ms - sim_tsl_power_ms;
+	if ((on_ms == 0) || ((on_ms % SIM_TSL_INTEGRATION_MS) != 0))
+	{
+		return;
+	}
+
+	sim_tsl_integrations++;
+	sim_tsl_light = sim_light;
+	sim_tsl_regs[I2C_TSL_DATA0LOW_REG] = sim_light->ch0 & 0xFF;
+	sim_tsl_regs[I2C_TSL_DATA0HIGH_REG] = sim_light->ch0 >> 8;
+	sim_tsl_regs[I2C_TSL_DATA1LOW_REG] = sim_light->ch1 & 0xFF;
+	sim_tsl_regs[I2C_TSL_DATA1HIGH_REG] = sim_light->ch1 >> 8;
+
+	/* Level interrupt on CH0 outside the thresholds */
+	low = sim_tsl_regs[I2C_TSL_THRES_LOW_LOW_REG] | (sim_tsl_regs[I2C_TSL_THRES_LOW_HIGH_REG] << 8);
+	high = sim_tsl_regs[I2C_TSL_THRES_HIGH_LOW_REG] | (sim_tsl_regs[I2C_TSL_THRES_HIGH_HIGH_REG] << 8);
+	if ((sim_tsl_regs[I2C_TSL_INTERRUPT_REG] & 0x30) && ((sim_light->ch0 < low) || (sim_light->ch0 > high)))
+	{
+		if (++sim_tsl_out_of_range >= SIM_TSL_PERSIST)
+		{
+			if (!sim_tsl_int_asserted && sim_tsl_int_enabled)
+			{
+				sim_tsl_int_asserted = true;
+				sim_tsl_interrupts++;
+				GPIO_ODD_IRQHandler();
+			}
+		}
+	}
+	else
+	{
+		sim_tsl_out_of_range = 0;
+	}
+}
+
+/************************************************************************************
+ * @function 	Sim_RTC_Step
+ * @params 		None
+ * @brief 		Counts the RTC and raises COMP1 on its match.
+ ************************************************************************************/
+static void Sim_RTC_Step(void)
+{
+	uint32_t ticks;
+
+	if ((RTC->CTRL & RTC_CTRL_EN) == 0)
+	{
+		return;
+	}
+
+	ticks = (uint32_t)(((uint64_t)(sim_now_ms + 1) * SIM_RTC_HZ) / 1000 - ((uint64_t)sim_now_ms * SIM_RTC_HZ) / 1000);
+	while (ticks-- > 0)
+	{
+		RTC->CNT = (RTC->CNT + 1) & POWER_RTC_COUNTER_MASK;
+		if ((RTC->CNT == RTC->COMP1) && (RTC->IEN & RTC_IEN_COMP1))
+		{
+			RTC->IF |= RTC_IF_COMP1;
+			Power_RTC_IRQHandler();
+		}
+	}
+}
+#endif
+
+/************************************************************************************
+ * @function 	Sim_Period
+ * @params 		None
+ * @brief 		Runs one LETIMER0 period: COMP0, COMP1 ALS_MIN_EXCITE_PERIOD_MS
+ * 				later, and the sensor and bus in between, 1 ms at a time.
+ ************************************************************************************/
+static void Sim_Period(void)
+{
+	uint32_t ms;
+
+	for (ms = 0; ms < ALS_EXCITE_PERIOD_MS; ms++, sim_now_ms++)
+	{
+		if (ms == 0)
+		{
+#ifndef USE_ACTIVE_ALS
+			/* The ACMP is warm by the time the handler polls it */
+			ACMP0->STATUS = ACMP_STATUS_ACMPACT | (sim_light->bright ? ACMP_STATUS_ACMPOUT : 0);
+#endif
+			LETIMER0->IF |= LETIMER_IF_COMP0;
+			LETIMER0_IRQHandler();
+#ifndef USE_ACTIVE_ALS
+			if (ACMP0->CTRL & ACMP_CTRL_EN)
+			{
+				sim_checks++;
+			}
+#endif
+		}
+		else if (ms == ALS_MIN_EXCITE_PERIOD_MS)
+		{
+			LETIMER0->IF |= LETIMER_IF_COMP1;
+			LETIMER0_IRQHandler();
+		}
+
+#ifdef USE_ACTIVE_ALS
+		Sim_RTC_Step();
+		Sim_TSL_Step();
+
+		/* One interrupt completes a transfer */
+		while (sim_i2c_seq != NULL)
+		{
+			I2C1_IRQHandler();
+		}
+#endif
+	}
+
+	/* LEUART0 sends the LED state and releases its block */
+	if (led_data_available)
+	{
+		led_data_available = false;
+		if (state_is_em1_for_leuart_tx)
+		{
+			unblockSleepMode(LEUART_EM);
+			state_is_em1_for_leuart_tx = false;
+		}
+	}
+}
+
+#ifdef USE_ACTIVE_ALS
+/************************************************************************************
+ * @function 	Sim_Reference_Lux
+ * @params 		[in] ch0, ch1 - counts
+ * 				[in] timing - timing register value
+ * 				[out] p_c0 - CH0 normalised to 402 ms at 16x gain
+ * @brief 		Floating point lux of the datasheet for the T, FN and CL packages.
+ ************************************************************************************/
+static double Sim_Reference_Lux(uint16_t ch0, uint16_t ch1, uint8_t timing, double *p_c0)
+{
+	static const double integ_scale[3] = { 402.0 / 13.7, 402.0 / 101.0, 1.0 };
+	double scale = integ_scale[timing & TSL_TIMING_INTEG_MASK];
+	double c0;
+	double c1;
+	double ratio;
+
+	/* The formula is for 402 ms at 16x gain */
+	if ((timing & TSL_TIMING_GAIN_16X) == 0)
+	{
+		scale *= 16;
+	}
+	c0 = ch0 * scale;
+	c1 = ch1 * scale;
+	*p_c0 = c0;
+
+	if (c0 == 0)
+	{
+		return 0;
+	}
+
+	ratio = c1 / c0;
+	if (ratio <= 0.50)
+	{
+		return 0.0304 * c0 - 0.062 * c0 * pow(ratio, 1.4);
+	}
+	if (ratio <= 0.61)
+	{
+		return 0.0224 * c0 - 0.031 * c1;
+	}
+	if (ratio <= 0.80)
+	{
+		return 0.0128 * c0 - 0.0153 * c1;
+	}
+	if (ratio <= 1.30)
+	{
+		return 0.00146 * c0 - 0.00112 * c1;
+	}
+	return 0;
+}
+
+/************************************************************************************
+ * @function 	Sim_Lux_Ratios
+ * @params 		None
+ * @brief 		Runs I2C_TSL_Calculate_Lux over the CH1/CH0 ratios of every segment
+ * 				and the integration times and gains, against the datasheet.
+ ************************************************************************************/
+static void Sim_Lux_Ratios(void)
+{
+	static const uint8_t timings[] = { 0x00, 0x01, 0x02, 0x10, 0x11, 0x12 };
+	static const uint16_t ch0s[] = { 100, 1000, 5000, 37177, 65535 };
+	/* Counts the channels saturate at, for each integration time */
+	static const uint16_t saturation[3] = { 5047, 37177, 65535 };
+	double worst = 0;
+	double reference;
+	double error;
+	double normalised_ch0;
+	uint32_t lux;
+	uint32_t t;
+	uint32_t c;
+	uint32_t r;
+	uint32_t runs = 0;
+	uint16_t ch1;
+	bool in_tolerance = true;
+	bool zero_past_130 = true;
+
+	for (t = 0; t < sizeof(timings); t++)
+	{
+		for (c = 0; c < sizeof(ch0s) / sizeof(ch0s[0]); c++)
+		{
+			if (ch0s[c] > saturation[timings[t] & TSL_TIMING_INTEG_MASK])
+			{
+				continue;
+			}
+
+			/* CH1/CH0 from 0 to 1.5 in steps of 1/64 */
+			for (r = 0; r <= 96; r++)
+			{
+				if (((uint32_t)ch0s[c] * r) / 64 > saturation[timings[t] & TSL_TIMING_INTEG_MASK])
+				{
+					break;
+				}
+
+				ch1 = (uint16_t)(((uint32_t)ch0s[c] * r) / 64);
+				runs++;
+				lux = I2C_TSL_Calculate_Lux(ch0s[c], ch1, timings[t]);
+				reference = Sim_Reference_Lux(ch0s[c], ch1, timings[t], &normalised_ch0);
+
+				if (r > 84)
+				{
+					zero_past_130 = zero_past_130 && (lux == 0);
+					continue;
+				}
+
+				/* The integer coefficients of the datasheet are rounded to 2^-14
+				 * and its ratio^1.4 term is approximated with straight lines,
+				 * which shows most where both channel terms nearly cancel */
+				error = fabs((double)lux - reference);
+				if (error > reference * 0.02 + normalised_ch0 * 0.0001 + 1)
+				{
+					in_tolerance = false;
+				}
+				if ((r * 100 <= 80 * 64) && (reference > 100) && (error / reference > worst))
+				{
+					worst = error / reference;
+				}
+			}
+		}
+	}
+
+	printf("  lux at %u ratios, levels and timings: worst %.1f%% off the datasheet formula up to a ratio of 0.80\n",
+			runs, worst * 100);
+
+	Sim_Check(in_tolerance, "lux on the datasheet formula at every ratio");
+	Sim_Check(zero_past_130, "no lux past a CH1/CH0 ratio of 1.30");
+	Sim_Check(I2C_TSL_Calculate_Lux(0, 0, I2C_TSL_INIT_TIM_REG_VAL) == 0, "no lux without light");
+}
+
+#endif
+
+/************************************************************************************
+ * @function 	Sim_Light
+ * @params 		[in] p_light - light level
+ * 				[in] periods - LETIMER0 periods to run
+ * 				[out] p_seen_period - period of the first check that saw the
+ * 				level, periods if none did
+ * 				[out] p_recheck_period - period of the check after that one
+ * @brief 		Runs the ALS under one light level and returns the checks run.
+ ************************************************************************************/
+static uint32_t Sim_Light(const SIM_LIGHT *p_light, uint32_t periods, uint32_t *p_seen_period,
+		uint32_t *p_recheck_period)
+{
+	uint32_t start_checks = sim_checks;
+	uint32_t period;
+	uint32_t checks;
+#ifdef USE_ACTIVE_ALS
+	bool read_ok = true;
+#endif
+
+	sim_light = p_light;
+	*p_seen_period = periods;
+	*p_recheck_period = periods;
+
+	for (period = 0; period < periods; period++)
+	{
+#ifdef USE_ACTIVE_ALS
+		bool was_powered = sim_tsl_powered;
+		uint32_t reads = sim_tsl_reads;
+#endif
+		checks = sim_checks;
+		Sim_Period();
+
+#ifdef USE_ACTIVE_ALS
+		if (!was_powered && sim_tsl_powered)
+		{
+			sim_checks++;
+		}
+#endif
+
+		if (sim_checks != checks)
+		{
+			if (sim_periods - sim_last_check_period > sim_max_check_gap)
+			{
+				sim_max_check_gap = sim_periods - sim_last_check_period;
+			}
+			sim_last_check_period = sim_periods;
+
+			if ((*p_seen_period < period) && (*p_recheck_period == periods))
+			{
+				*p_recheck_period = period;
+			}
+		}
+		sim_periods++;
+
+#ifdef USE_ACTIVE_ALS
+		if (sim_tsl_reads != reads)
+		{
+			/* The reading is the one of the last conversion */
+			read_ok = read_ok && (sim_tsl_read_light != NULL) &&
+					(tsl_ch0 == sim_tsl_read_light->ch0) && (tsl_ch1 == sim_tsl_read_light->ch1) &&
+					(tsl_lux == I2C_TSL_Calculate_Lux(tsl_ch0, tsl_ch1, I2C_TSL_INIT_TIM_REG_VAL));
+
+			if ((*p_seen_period == periods) && (tsl_ch0 == p_light->ch0))
+			{
+				*p_seen_period = period;
+			}
+		}
+#else
+		if ((*p_seen_period == periods) && (sim_checks != checks) &&
+				(als_last_acmp_out == (p_light->bright ? 1 : 0)))
+		{
+			*p_seen_period = period;
+		}
+#endif
+	}
+
+#ifdef USE_ACTIVE_ALS
+	Sim_Check(read_ok, "every reading is the latest conversion of both channels");
+#endif
+
+	return sim_checks - start_checks;
+}
+
+/************************************************************************************
+ * @function 	Sim_Change
+ * @params 		[in] p_light - light level changed to
+ * 				[in] periods_per_check - LETIMER0 periods of one check
+ * @brief 		Changes the light after a stable one and checks it is seen within
+ * 				ALS_MAX_CHECK_INTERVAL checks, and checked again in the next one.
+ ************************************************************************************/
+static void Sim_Change(const SIM_LIGHT *p_light, uint32_t periods_per_check)
+{
+	uint32_t seen_period;
+	uint32_t recheck_period;
+
+	Sim_Light(p_light, SIM_CHANGED_PERIODS, &seen_period, &recheck_period);
+
+	printf("  %-7s seen %2u periods after the change, checked again %u periods later\n",
+			p_light->name, seen_period, recheck_period - seen_period);
+
+	Sim_Check(seen_period <= ALS_MAX_CHECK_INTERVAL * periods_per_check,
+			"light change seen within ALS_MAX_CHECK_INTERVAL checks");
+	Sim_Check(recheck_period - seen_period <= periods_per_check, "every check run again after a change");
+}
+
+int main(void)
+{
+	uint32_t stable_checks;
+	uint32_t seen_period;
+	uint32_t recheck_period;
+	/* A check runs once per period (passive) or power cycle of 3 periods (active) */
+#ifdef USE_ACTIVE_ALS
+	uint32_t periods_per_check = 3;
+	uint32_t interrupts_in_light;
+#else
+	uint32_t periods_per_check = 1;
+#endif
+
+	e_letimer_energy_modes = ENERGY_MODE_EM2;
+#ifdef USE_ACTIVE_ALS
+	Sim_Lux_Ratios();
+	I2C_SetUp();
+	printf("Active ALS, TSL2561 on I2C1, one power cycle per 3 LETIMER0 periods of %d ms:\n", ALS_EXCITE_PERIOD_MS);
+#else
+	printf("Passive ALS, ACMP check in each LETIMER0 period of %d ms:\n", ALS_EXCITE_PERIOD_MS);
+#endif
+
+	stable_checks = Sim_Light(&sim_office, SIM_STABLE_PERIODS, &seen_period, &recheck_period);
+	printf("  %-7s %2u checks in %u periods, %u without the back off\n",
+			sim_office.name, stable_checks, SIM_STABLE_PERIODS, SIM_STABLE_PERIODS / periods_per_check);
+	Sim_Check(stable_checks * 2 < SIM_STABLE_PERIODS / periods_per_check, "checks backed off while the light is stable");
+
+#ifdef USE_ACTIVE_ALS
+	/* Only the TSL2561 tells dusk from office light */
+	Sim_Light(&sim_office, SIM_STABLE_PERIODS, &seen_period, &recheck_period);
+	Sim_Change(&sim_dusk, periods_per_check);
+	interrupts_in_light = sim_tsl_interrupts;
+#endif
+
+	/* Dark: the passive ALS flips its ACMP output, the TSL2561 raises its interrupt */
+	Sim_Light(&sim_office, SIM_STABLE_PERIODS, &seen_period, &recheck_period);
+	Sim_Change(&sim_dark, periods_per_check);
+
+	printf("  longest gap between checks %u periods\n", sim_max_check_gap);
+
+	Sim_Check(sim_max_check_gap <= ALS_MAX_CHECK_INTERVAL * periods_per_check,
+			"checks at most ALS_MAX_CHECK_INTERVAL apart");
+	Sim_Check(sleep_block_counter[EM1] == 0, "no EM1 block left once the transfers are done");
+
+#ifdef USE_ACTIVE_ALS
+	printf("  %u early accesses, %u NACKs, %u threshold interrupts, LED state %s\n", sim_i2c_early, sim_i2c_nacks,
+			sim_tsl_interrupts, (i2c_als_state == ALS_STATE_LIGHT) ? "on" : "off");
+
+	Sim_Check(sim_i2c_early == 0, "TSL2561 never accessed before its supply has settled");
+	Sim_Check(sim_i2c_nacks == 0, "TSL2561 acknowledges every transfer");
+	Sim_Check((sim_tsl_interrupts > 0) && (interrupts_in_light == 0), "TSL2561 interrupt raised in the dark only");
+	Sim_Check(i2c_als_state == ALS_STATE_LIGHT, "LED switched on in the dark");
+#else
+	Sim_Check(((ACMP0->CTRL & ACMP_CTRL_EN) == 0), "ACMP switched off after each check");
+#endif
+
+	return sim_failures ? 1 : 0;
+}
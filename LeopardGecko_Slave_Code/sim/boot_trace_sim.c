@@ -0,0 +1,338 @@
+/*****************************************************************************
+ * @file 	boot_trace_sim.c
+ * @brief 	Host simulation of the boot trace. Runs main() of MCIoT_main.c,
+ * 			built with ENABLE_BOOT_TRACE, against a timing model of the calls
+ * 			it makes:
+ * 			- The LFXO takes SIM_LFXO_STARTUP_US to start. LESENSE_SetUp()
+ * 			  sleeps until it runs, then for SIM_CALIBRATION_US of settling
+ * 			  scans, then until the user completes the touch authentication.
+ * 			- The first sample goes out SIM_FIRST_SAMPLE_US after LETIMER0
+ * 			  starts, from the LEUART interrupt.
+ * 			- The BURTC counts wall clock time on the LFRCO, once it is out of
+ * 			  the backup domain reset and its oscillator runs.
+ * 			The boot is run with a short and a long authentication.
+ *
+ * 			Exits non-zero if a stage is not stamped in order, if a stage
+ * 			reached after sleeping misses the time slept, or if the span to
+ * 			the first sample is off the modelled boot time or depends on how
+ * 			long the user takes to authenticate.
+ *
+ * 			Build and run from LeopardGecko_Slave_Code, main() of the firmware
+ * 			never returns:
+ *
+ * 			  gcc -O2 -Wall -Wno-return-type -fcommon -Isim -Iinc -o boot_trace_sim sim/boot_trace_sim.c
+ * 			  ./boot_trace_sim
+ ******************************************************************************/
+
+/************************************ INCLUDES **************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <setjmp.h>
+
+#define ENABLE_BOOT_TRACE			1
+
+/* main() of the firmware runs as MCIoT_Main() */
+#define main						MCIoT_Main
+#include "../src/MCIoT_main.c"
+#undef main
+
+/************************************ INCLUDES **************************************/
+
+/************************************* MACROS ***************************************/
+
+#define SIM_LFXO_STARTUP_US			400000.0
+#define SIM_LFRCO_STARTUP_US		150.0
+#define SIM_CALIBRATION_US			250000.0	/* LESENSE settling scans */
+#define SIM_HF_SETUP_US				2000.0		/* GPIO, ADC, temperature and VDD, DMA */
+#define SIM_LF_SETUP_US				1000.0		/* LF clocks, LESENSE tear down, LETIMER0, LEUART0 */
+#define SIM_FIRST_SAMPLE_US			(ALS_EXCITE_PERIOD_MS * 1000.0 + 1000.0)
+
+/* Touch authentication times the boot is run with */
+#define SIM_AUTH_SHORT_US			1500000.0
+#define SIM_AUTH_LONG_US			20000000.0
+
+#define SIM_US_TO_TICKS(us)			((us) * BOOT_TRACE_TICK_HZ / 1e6)
+
+/************************************* MACROS ***************************************/
+
+/************************************ GLOBALS ***************************************/
+
+CMU_TypeDef sim_cmu;
+
+static double sim_now_us;
+static double sim_auth_us;
+static double sim_lfxo_ready_us;
+static double sim_letimer0_start_us;
+
+/* BURTC model */
+static bool sim_bu_reset_released;
+static bool sim_lfrco_enabled;
+static double sim_burtc_start_us;
+static bool sim_burtc_running;
+
+/* Wall clock time spent asleep */
+static double sim_slept_us;
+
+static LETIMER_TypeDef sim_letimer0;
+static jmp_buf sim_boot_jmp;
+static int sim_failures;
+
+/************************************ GLOBALS ***************************************/
+
+/************************************************************************************
+ * @function 	Sim_Check
+ * @params 		[in] ok - result of the check
+ * 				[in] what - description of the check
+ * @brief 		Records a failed check.
+ ************************************************************************************/
+static void Sim_Check(bool ok, const char *what)
+{
+	if (!ok)
+	{
+		printf("FAIL: %s\n", what);
+		sim_failures++;
+	}
+}
+
+/************************************************************************************
+ * @function 	Sim_Sleep_Until
+ * @params 		[in] until_us - wakeup time
+ * @brief 		Sleeps until an interrupt at until_us.
+ ************************************************************************************/
+static void Sim_Sleep_Until(double until_us)
+{
+	if (until_us > sim_now_us)
+	{
+		sim_slept_us += until_us - sim_now_us;
+		sim_now_us = until_us;
+	}
+}
+
+/************************************************************************************
+ * Stubbed emlib calls
+ ************************************************************************************/
+void CHIP_Init(void)
+{
+	sim_now_us += 10.0;
+}
+
+void NVIC_EnableIRQ(IRQn_Type irq)
+{
+	(void)irq;
+}
+
+LETIMER_TypeDef *Sim_LETIMER0(void)
+{
+	/* The START command of main() is the only access */
+	sim_letimer0_start_us = sim_now_us;
+	return &sim_letimer0;
+}
+
+void CMU_OscillatorEnable(CMU_Osc_TypeDef osc, bool enable, bool wait)
+{
+	if (osc == cmuOsc_LFRCO)
+	{
+		sim_lfrco_enabled = enable;
+		if (wait)
+		{
+			sim_now_us += SIM_LFRCO_STARTUP_US;
+		}
+	}
+}
+
+void RMU_ResetControl(RMU_Reset_TypeDef reset, RMU_ResetMode_TypeDef mode)
+{
+	if (reset == rmuResetBU)
+	{
+		sim_bu_reset_released = (mode == rmuResetModeClear);
+	}
+}
+
+void BURTC_Init(const BURTC_Init_TypeDef *burtcInit)
+{
+	/* Held in reset or without a clock, the BURTC does not count */
+	sim_burtc_running = sim_bu_reset_released && burtcInit->enable &&
+			(burtcInit->clkSel == burtcClkSelLFRCO) && sim_lfrco_enabled &&
+			(burtcInit->mode >= burtcModeEM3);
+	sim_burtc_start_us = sim_now_us;
+}
+
+uint32_t BURTC_CounterGet(void)
+{
+	if (!sim_burtc_running)
+	{
+		return 0;
+	}
+
+	return (uint32_t)SIM_US_TO_TICKS(sim_now_us - sim_burtc_start_us);
+}
+
+/************************************************************************************
+ * Stubbed application calls, with the time main() spends in them
+ ************************************************************************************/
+void CMU_Consumer_Prepare(CMU_CONSUMERS e_consumer)
+{
+	if (e_consumer == CMU_CONSUMER_LESENSE)
+	{
+		sim_lfxo_ready_us = sim_now_us + SIM_LFXO_STARTUP_US;
+	}
+}
+
+void CMU_Consumer_Stop(CMU_CONSUMERS e_consumer)
+{
+	(void)e_consumer;
+}
+
+void CMU_SetUp_HF_Clocks(void)
+{
+}
+
+void GPIO_SetUp(void)
+{
+}
+
+void ADC_SetUp(void)
+{
+}
+
+void ADC_Measure_Temp_Vdd(uint16_t *p_temp_raw, uint16_t *p_vdd_raw)
+{
+	*p_temp_raw = 2000;
+	*p_vdd_raw = 2500;
+}
+
+bool Calibration_Record_Load(uint16_t temp_raw, uint16_t vdd_raw)
+{
+	(void)temp_raw;
+	(void)vdd_raw;
+
+	return false;
+}
+
+void DMA_SetUp(void)
+{
+	sim_now_us += SIM_HF_SETUP_US;
+}
+
+void LESENSE_SetUp(void)
+{
+	/* Asleep until the LFXO runs, then through the settling scans */
+	Sim_Sleep_Until(sim_lfxo_ready_us);
+	Sim_Sleep_Until(sim_now_us + SIM_CALIBRATION_US);
+	BOOT_TRACE(BOOT_STAGE_TOUCH_CALIBRATED);
+
+	/* Asleep until the user completes the pattern */
+	Sim_Sleep_Until(sim_now_us + sim_auth_us);
+	is_lesense_auth_done = true;
+}
+
+void CMU_Set_LETimer_Prescaler(ENERGY_MODES e_energy_mode)
+{
+	(void)e_energy_mode;
+}
+
+void CMU_SetUp_LF_Clocks(void)
+{
+	sim_now_us += SIM_LF_SETUP_US;
+}
+
+void LESENSE_TearDown(void)
+{
+}
+
+void LESENSE_Save_Calibration(void)
+{
+}
+
+void blockSleepMode(ENERGY_MODES e_letimer_energy_modes)
+{
+	(void)e_letimer_energy_modes;
+}
+
+void LETimer_Config_LETimer(LETIMER_TypeDef *LETimer, LETIMER_Init_TypeDef letimer_init_params)
+{
+	(void)LETimer;
+	(void)letimer_init_params;
+}
+
+void LEUART_SetUp(void)
+{
+}
+
+void Sleep(void)
+{
+	/* LETIMER0 takes the sample, the LEUART interrupt sends it */
+	Sim_Sleep_Until(sim_letimer0_start_us + SIM_FIRST_SAMPLE_US);
+	BOOT_TRACE(BOOT_STAGE_FIRST_SAMPLE_TX);
+
+	longjmp(sim_boot_jmp, 1);
+}
+
+/************************************************************************************
+ * @function 	Sim_Boot
+ * @params 		[in] auth_us - time the user takes to authenticate
+ * @brief 		Runs main() from reset to the first sample sent and checks the
+ *				stages it stamped. Returns the span to the first sample.
+ ************************************************************************************/
+static uint32_t Sim_Boot(double auth_us)
+{
+	double expected_span_ticks;
+	int stage;
+	bool ordered = true;
+
+	memset(boot_trace_ticks, 0, sizeof(boot_trace_ticks));
+	boot_trace_span_ticks = 0;
+	sim_now_us = 0;
+	sim_slept_us = 0;
+	sim_auth_us = auth_us;
+	sim_bu_reset_released = false;
+	sim_lfrco_enabled = false;
+	sim_burtc_running = false;
+
+	if (setjmp(sim_boot_jmp) == 0)
+	{
+		MCIoT_Main();
+	}
+
+	for (stage = BOOT_STAGE_CHIP_INIT; stage < BOOT_STAGE_MAX; stage++)
+	{
+		ordered = ordered && (boot_trace_ticks[stage] >= boot_trace_ticks[stage - 1]);
+	}
+	ordered = ordered && (boot_trace_ticks[BOOT_STAGE_FIRST_SAMPLE_TX] != 0);
+
+	/* Everything but the authentication, from the BURTC start */
+	expected_span_ticks = SIM_US_TO_TICKS(sim_now_us - sim_burtc_start_us - auth_us);
+
+	printf("  auth %5.1f s  LFXO and calibration %6.1f ms, first sample %6.1f ms after reset, %6.1f ms without the auth, %4.1f%% asleep\n",
+			auth_us / 1e6,
+			(boot_trace_ticks[BOOT_STAGE_TOUCH_CALIBRATED] - boot_trace_ticks[BOOT_STAGE_CHIP_INIT]) * 1e3 / BOOT_TRACE_TICK_HZ,
+			(boot_trace_ticks[BOOT_STAGE_FIRST_SAMPLE_TX] - boot_trace_ticks[BOOT_STAGE_RESET]) * 1e3 / BOOT_TRACE_TICK_HZ,
+			boot_trace_span_ticks * 1e3 / BOOT_TRACE_TICK_HZ, sim_slept_us * 100 / sim_now_us);
+
+	Sim_Check(ordered, "every stage stamped, in order");
+	Sim_Check(boot_trace_ticks[BOOT_STAGE_TOUCH_CALIBRATED] - boot_trace_ticks[BOOT_STAGE_HF_PERIPHERALS] >=
+			(uint32_t)SIM_US_TO_TICKS(SIM_LFXO_STARTUP_US + SIM_CALIBRATION_US - SIM_HF_SETUP_US),
+			"time asleep for the LFXO and the settling scans counted");
+	Sim_Check((boot_trace_span_ticks + 2 >= expected_span_ticks) && (boot_trace_span_ticks <= expected_span_ticks + 2),
+			"span to the first sample within 2 ticks of the boot time");
+
+	return boot_trace_span_ticks;
+}
+
+int main(void)
+{
+	uint32_t short_span;
+	uint32_t long_span;
+
+	printf("Boot to the first sample, %.1f s LFXO start-up, BURTC at %d Hz:\n",
+			SIM_LFXO_STARTUP_US / 1e6, BOOT_TRACE_TICK_HZ);
+	short_span = Sim_Boot(SIM_AUTH_SHORT_US);
+	long_span = Sim_Boot(SIM_AUTH_LONG_US);
+
+	Sim_Check((short_span + 1 >= long_span) && (long_span + 1 >= short_span),
+			"span independent of the authentication time");
+
+	return sim_failures ? 1 : 0;
+}
@@ -0,0 +1,555 @@
+/*****************************************************************************
+ * @file 	cmu_clock_sim.c
+ * @brief 	Host simulation of the CMU clock tree planner. Runs MCIoT_CMU.c
+ * 			against a model of the oscillators, the LFA/LFB trees, the clock
+ * 			branches, LETIMER0 and the TIMER0/TIMER1 cascade:
+ * 			- The LFXO takes SIM_LFXO_STARTUP_US to start, the ULFRCO runs at
+ * 			  SIM_ULFRCO_HZ instead of its nominal 1 kHz.
+ * 			- A wait for an oscillator with interrupts masked is timed.
+ * 			- LETIMER0 only counts while its branch is on and its LF tree runs
+ * 			  from a ready oscillator.
+ * 			The boot sequence of main() is followed in EM2 and in EM3, with the
+ * 			clocks it leaves on checked after every step.
+ *
+ * 			Exits non-zero if an oscillator is waited for with interrupts
+ * 			masked, if a clock is on outside the interval of the consumers that
+ * 			need it, if a consumer is started on an LF tree that runs from
+ * 			another source, or if the ULFRCO calibration gets the ratio wrong.
+ *
+ * 			Build and run from LeopardGecko_Slave_Code:
+ *
+ * 			  gcc -O2 -Wall -fcommon -Isim -Iinc -o cmu_clock_sim sim/cmu_clock_sim.c src/MCIoT_CMU.c
+ * 			  ./cmu_clock_sim
+ ******************************************************************************/
+
+/************************************ INCLUDES **************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <setjmp.h>
+#include "em_cmu.h"
+#include "em_letimer.h"
+#include "em_timer.h"
+#include "MCIoT_main.h"
+#include "MCIoT_LETimer.h"
+#include "MCIoT_CMU.h"
+#include "MCIoT_Timer.h"
+#include "MCIoT_Calibration.h"
+
+/************************************ INCLUDES **************************************/
+
+/************************************* MACROS ***************************************/
+
+#define SIM_LFXO_STARTUP_US			400000.0
+#define SIM_LFRCO_STARTUP_US		150.0
+#define SIM_ULFRCO_HZ				1180.0
+#define SIM_HFPER_HZ				14000000.0
+
+/* Time from the boot to the touch authentication */
+#define SIM_AUTH_US					3000000.0
+#define SIM_RUN_US					10000000.0
+
+/* Longest a poll loop may spin on a counter that does not count */
+#define SIM_POLL_LIMIT_US			5000000.0
+
+/************************************* MACROS ***************************************/
+
+/************************************ GLOBALS ***************************************/
+
+CMU_TypeDef sim_cmu;
+
+/* Indexed by ENERGY_MODES, only the prescaler is read */
+const LETIMER_TIMING_CONFIG letimer_timing_config[LETIMER_ENERGY_MODE_MAX];
+
+static double sim_now_us;
+static uint32_t sim_core_masked;
+static double sim_masked_wait_us;
+
+/* Oscillator and clock model */
+static bool sim_osc_enabled[SIM_CMU_OSCS];
+static double sim_osc_ready_us[SIM_CMU_OSCS];
+static bool sim_clock_on[SIM_CMU_CLOCKS];
+static CMU_Select_TypeDef sim_lfa_select;
+static CMU_Select_TypeDef sim_lfb_select;
+
+/* Peripheral model */
+static LETIMER_TypeDef sim_letimer0;
+static bool sim_letimer0_running;
+static TIMER_TypeDef sim_timer[2];
+static bool sim_timer_running[2];
+static uint32_t sim_timer_cnt_shadow[2];
+static double sim_timer_cycles;
+
+/* Poll loop deadline */
+static jmp_buf sim_poll_jmp;
+static double sim_poll_deadline_us;
+static bool sim_poll_armed;
+
+/* Time each checked clock was on */
+static double sim_lfxo_on_us;
+static double sim_lesense_on_us;
+static int sim_failures;
+
+/************************************ GLOBALS ***************************************/
+
+/************************************************************************************
+ * @function 	Sim_Check
+ * @params 		[in] ok - result of the check
+ * 				[in] what - description of the check
+ * @brief 		Records a failed check.
+ ************************************************************************************/
+static void Sim_Check(bool ok, const char *what)
+{
+	if (!ok)
+	{
+		printf("FAIL: %s\n", what);
+		sim_failures++;
+	}
+}
+
+/************************************************************************************
+ * @function 	Sim_Osc_Ready
+ * @params 		[in] osc - oscillator
+ * @brief 		Returns true if the oscillator is enabled and has started.
+ ************************************************************************************/
+static bool Sim_Osc_Ready(CMU_Osc_TypeDef osc)
+{
+	return (osc == cmuOsc_ULFRCO) ||
+		(sim_osc_enabled[osc] && (sim_now_us >= sim_osc_ready_us[osc]));
+}
+
+/************************************************************************************
+ * @function 	Sim_Select_Osc
+ * @params 		[in] lf_select - LF tree source
+ * @brief 		Maps an LF tree source onto the oscillator that drives it.
+ ************************************************************************************/
+static CMU_Osc_TypeDef Sim_Select_Osc(CMU_Select_TypeDef lf_select)
+{
+	if (lf_select == cmuSelect_LFRCO)
+	{
+		return cmuOsc_LFRCO;
+	}
+	else if (lf_select == cmuSelect_ULFRCO)
+	{
+		return cmuOsc_ULFRCO;
+	}
+
+	return cmuOsc_LFXO;
+}
+
+/************************************************************************************
+ * @function 	Sim_Advance
+ * @params 		[in] us - time to advance by
+ * @brief 		Advances the simulated time and the on time of the checked clocks.
+ ************************************************************************************/
+static void Sim_Advance(double us)
+{
+	if (sim_osc_enabled[cmuOsc_LFXO])
+	{
+		sim_lfxo_on_us += us;
+	}
+	if (sim_clock_on[cmuClock_LESENSE])
+	{
+		sim_lesense_on_us += us;
+	}
+	if (sim_timer_running[0] && sim_clock_on[cmuClock_HFPER] && sim_clock_on[cmuClock_TIMER0])
+	{
+		sim_timer_cycles += us * SIM_HFPER_HZ / 1e6;
+	}
+
+	sim_now_us += us;
+
+	if (sim_poll_armed && (sim_now_us > sim_poll_deadline_us))
+	{
+		longjmp(sim_poll_jmp, 1);
+	}
+}
+
+/************************************************************************************
+ * @function 	Sim_Wait_Osc
+ * @params 		[in] osc - oscillator
+ * @brief 		Waits for an oscillator to start, as emlib does. The wait is
+ *				recorded if it is done with interrupts masked.
+ ************************************************************************************/
+static void Sim_Wait_Osc(CMU_Osc_TypeDef osc)
+{
+	double wait_us;
+
+	if (Sim_Osc_Ready(osc) || !sim_osc_enabled[osc])
+	{
+		return;
+	}
+
+	wait_us = sim_osc_ready_us[osc] - sim_now_us;
+	if (sim_core_masked)
+	{
+		sim_masked_wait_us += wait_us;
+	}
+	Sim_Advance(wait_us);
+}
+
+/************************************************************************************
+ * @function 	Sim_Sync
+ * @params 		None
+ * @brief 		Applies the commands written to the simulated peripherals and the
+ *				counter values written by the code.
+ ************************************************************************************/
+static void Sim_Sync(void)
+{
+	int timer;
+
+	if (sim_letimer0.CMD & LETIMER_CMD_START)
+	{
+		sim_letimer0_running = true;
+	}
+	if (sim_letimer0.CMD & LETIMER_CMD_STOP)
+	{
+		sim_letimer0_running = false;
+	}
+	sim_letimer0.CMD = 0;
+
+	/* A counter written by the code restarts the cascade from that value */
+	if ((sim_timer[0].CNT != sim_timer_cnt_shadow[0]) || (sim_timer[1].CNT != sim_timer_cnt_shadow[1]))
+	{
+		sim_timer_cycles = (double)(((uint32_t)sim_timer[1].CNT << 16) | (sim_timer[0].CNT & 0xFFFF));
+	}
+
+	for (timer = 0; timer < 2; timer++)
+	{
+		if (sim_timer[timer].CMD & TIMER_CMD_START)
+		{
+			sim_timer_running[timer] = true;
+		}
+		if (sim_timer[timer].CMD & TIMER_CMD_STOP)
+		{
+			sim_timer_running[timer] = false;
+		}
+		sim_timer[timer].CMD = 0;
+	}
+
+	/* TIMER1 counts the TIMER0 overflows */
+	sim_timer[0].CNT = (uint32_t)sim_timer_cycles & 0xFFFF;
+	sim_timer[1].CNT = ((uint32_t)sim_timer_cycles >> 16) & 0xFFFF;
+	sim_timer_cnt_shadow[0] = sim_timer[0].CNT;
+	sim_timer_cnt_shadow[1] = sim_timer[1].CNT;
+}
+
+/************************************************************************************
+ * @function 	Sim_LETIMER0
+ * @params 		None
+ * @brief 		Every access to LETIMER0 lets it count one tick of its LF clock,
+ *				if the clock runs. Otherwise the poll only spends time.
+ ************************************************************************************/
+LETIMER_TypeDef *Sim_LETIMER0(void)
+{
+	uint32_t prescaler = (sim_cmu.LFAPRESC0 & _CMU_LFAPRESC0_LETIMER0_MASK) >> _CMU_LFAPRESC0_LETIMER0_SHIFT;
+	double hz = 0;
+
+	Sim_Sync();
+
+	if (sim_letimer0_running && sim_clock_on[cmuClock_CORELE] && sim_clock_on[cmuClock_LETIMER0] &&
+		(sim_lfa_select != cmuSelect_Disabled) && Sim_Osc_Ready(Sim_Select_Osc(sim_lfa_select)))
+	{
+		hz = (sim_lfa_select == cmuSelect_ULFRCO) ? SIM_ULFRCO_HZ : 32768.0;
+	}
+
+	if ((hz != 0) && (sim_letimer0.CNT != 0))
+	{
+		sim_letimer0.CNT--;
+		Sim_Advance((1 << prescaler) * 1e6 / hz);
+	}
+	else
+	{
+		Sim_Advance(1);
+	}
+
+	return &sim_letimer0;
+}
+
+/************************************************************************************
+ * @function 	Sim_TIMER
+ * @params 		[in] timer - 0 for TIMER0, 1 for TIMER1
+ * @brief 		Every access to TIMER0 or TIMER1 brings the counters up to date.
+ ************************************************************************************/
+TIMER_TypeDef *Sim_TIMER(int timer)
+{
+	Sim_Sync();
+
+	return &sim_timer[timer];
+}
+
+/************************************************************************************
+ * @function 	Sim_Core_Enter
+ * @params 		None
+ * @brief 		Masks interrupts, returns the previous mask state.
+ ************************************************************************************/
+uint32_t Sim_Core_Enter(void)
+{
+	uint32_t state = sim_core_masked;
+
+	sim_core_masked = 1;
+	return state;
+}
+
+/************************************************************************************
+ * @function 	Sim_Core_Exit
+ * @params 		[in] state - mask state returned by Sim_Core_Enter()
+ * @brief 		Restores the interrupt mask state.
+ ************************************************************************************/
+void Sim_Core_Exit(uint32_t state)
+{
+	sim_core_masked = state;
+}
+
+/************************************************************************************
+ * @function 	CMU_OscillatorEnable
+ * @params 		[in] osc - oscillator
+ * 				[in] enable - true to start it, false to stop it
+ * 				[in] wait - true to wait for it to start
+ * @brief 		Oscillator model, the start-up time runs from the first enable.
+ ************************************************************************************/
+void CMU_OscillatorEnable(CMU_Osc_TypeDef osc, bool enable, bool wait)
+{
+	if (!enable)
+	{
+		sim_osc_enabled[osc] = false;
+		return;
+	}
+
+	if (!sim_osc_enabled[osc])
+	{
+		sim_osc_enabled[osc] = true;
+		sim_osc_ready_us[osc] = sim_now_us + ((osc == cmuOsc_LFXO) ? SIM_LFXO_STARTUP_US : SIM_LFRCO_STARTUP_US);
+	}
+
+	if (wait)
+	{
+		Sim_Wait_Osc(osc);
+	}
+}
+
+/************************************************************************************
+ * @function 	CMU_ClockSelectSet
+ * @params 		[in] clock - cmuClock_LFA or cmuClock_LFB
+ * 				[in] ref - source
+ * @brief 		Selects an LF tree source. Like emlib, enables the oscillator and
+ *				waits for it first.
+ ************************************************************************************/
+void CMU_ClockSelectSet(CMU_Clock_TypeDef clock, CMU_Select_TypeDef ref)
+{
+	if (ref != cmuSelect_Disabled)
+	{
+		CMU_OscillatorEnable(Sim_Select_Osc(ref), true, true);
+	}
+
+	if (clock == cmuClock_LFA)
+	{
+		sim_lfa_select = ref;
+	}
+	else
+	{
+		sim_lfb_select = ref;
+	}
+}
+
+/************************************************************************************
+ * @function 	CMU_ClockEnable
+ * @params 		[in] clock - clock branch
+ * 				[in] enable - true to turn it on
+ * @brief 		Clock branch model.
+ ************************************************************************************/
+void CMU_ClockEnable(CMU_Clock_TypeDef clock, bool enable)
+{
+	sim_clock_on[clock] = enable;
+}
+
+/************************************************************************************
+ * @function 	LETIMER_Setup
+ * @params 		[in] LETimer - LETIMER
+ * 				[in] letimer_init_params - init params
+ * @brief 		Stub, the calibration only uses the counter.
+ ************************************************************************************/
+void LETIMER_Setup(LETIMER_TypeDef *LETimer, LETIMER_Init_TypeDef letimer_init_params)
+{
+	(void)LETimer;
+	(void)letimer_init_params;
+}
+
+/************************************************************************************
+ * @function 	TIMER_Setup
+ * @params 		[in] timer - TIMER
+ * 				[in] timerInit - init params
+ * @brief 		Stub, TIMER1 always counts the TIMER0 overflows.
+ ************************************************************************************/
+void TIMER_Setup(TIMER_TypeDef *timer, TIMER_Init_TypeDef timerInit)
+{
+	(void)timer;
+	(void)timerInit;
+}
+
+/************************************************************************************
+ * @function 	Calibration_Record_Osc_Ratio
+ * @params 		[out] p_osc_ratio - stored ratio
+ * @brief 		Stub, there is no stored ratio so the ULFRCO is calibrated.
+ ************************************************************************************/
+bool Calibration_Record_Osc_Ratio(uint32_t *p_osc_ratio)
+{
+	(void)p_osc_ratio;
+
+	return false;
+}
+
+/************************************************************************************
+ * @function 	Sim_Expect
+ * @params 		[in] step - name of the step
+ * 				[in] lfxo - LFXO expected on
+ * 				[in] lesense - LESENSE branch expected on
+ * 				[in] letimer - LETIMER0 branch expected on
+ * 				[in] lfa_select - expected LFA source
+ * @brief 		Checks the clocks are on exactly while their consumers are active.
+ ************************************************************************************/
+static void Sim_Expect(const char *step, bool lfxo, bool lesense, bool letimer, CMU_Select_TypeDef lfa_select)
+{
+	bool ok = (sim_osc_enabled[cmuOsc_LFXO] == lfxo) &&
+			(sim_clock_on[cmuClock_LESENSE] == lesense) &&
+			(sim_clock_on[cmuClock_LETIMER0] == letimer) &&
+			(sim_lfa_select == lfa_select);
+
+	if (!ok)
+	{
+		printf("  after %s: LFXO %d, LESENSE %d, LETIMER0 %d, LFA source %d\n", step,
+				sim_osc_enabled[cmuOsc_LFXO], sim_clock_on[cmuClock_LESENSE],
+				sim_clock_on[cmuClock_LETIMER0], sim_lfa_select);
+	}
+	Sim_Check(ok, "clocks on only while their consumers are active");
+}
+
+/************************************************************************************
+ * @function 	Sim_Boot
+ * @params 		[in] e_energy_mode - energy mode LETIMER0 runs in
+ * @brief 		Follows the clock requests of main() from reset to the sampling
+ *				timer, then stops every consumer.
+ ************************************************************************************/
+static void Sim_Boot(ENERGY_MODES e_energy_mode)
+{
+	CMU_Select_TypeDef letimer_select = (e_energy_mode == ENERGY_MODE_EM3) ? cmuSelect_ULFRCO : cmuSelect_LFXO;
+	double boot_us = sim_now_us;
+	double masked_wait_us = sim_masked_wait_us;
+	double teardown_us;
+	uint32_t expected_ratio;
+	bool calibrated;
+	int consumer;
+
+	e_letimer_energy_modes = e_energy_mode;
+	osc_ratio = (e_energy_mode == ENERGY_MODE_EM3) ? 0 : OSC_RATIO_UNITY;
+	sim_lfxo_on_us = 0;
+	sim_lesense_on_us = 0;
+
+	/* Reset to the touch authentication, LESENSE waits for the prepared LFXO */
+	CMU_Consumer_Prepare(CMU_CONSUMER_LESENSE);
+	CMU_SetUp_HF_Clocks();
+	Sim_Advance(5000);
+	CMU_Consumer_Stop(CMU_CONSUMER_ADC);
+	Sim_Check(CMU_Consumer_Start(CMU_CONSUMER_LESENSE), "LESENSE started");
+	Sim_Expect("LESENSE start", true, true, false, cmuSelect_LFXO);
+	Sim_Advance(boot_us + SIM_AUTH_US - sim_now_us);
+
+	/* The poll loops of the calibration give up if LETIMER0 does not count */
+	sim_poll_deadline_us = sim_now_us + SIM_POLL_LIMIT_US;
+	sim_poll_armed = true;
+	calibrated = (setjmp(sim_poll_jmp) == 0);
+	if (calibrated)
+	{
+		/* LF clocks and LESENSE tear down, in the order of main() */
+		if (e_energy_mode == ENERGY_MODE_EM3)
+		{
+			CMU_Consumer_Stop(CMU_CONSUMER_LESENSE);
+			teardown_us = sim_now_us;
+			CMU_SetUp_LF_Clocks();
+		}
+		else
+		{
+			CMU_SetUp_LF_Clocks();
+			CMU_Consumer_Stop(CMU_CONSUMER_LESENSE);
+			teardown_us = sim_now_us;
+		}
+	}
+	sim_poll_armed = false;
+	Sim_Check(calibrated, "LETIMER0 counts during the ULFRCO calibration");
+	if (!calibrated)
+	{
+		teardown_us = sim_now_us;
+	}
+
+	/* LEUART0 keeps the LFXO on the LFB tree in every mode */
+	Sim_Expect("LF clock set up", true, false, true, letimer_select);
+	Sim_Check(sim_lfb_select == cmuSelect_LFXO, "LEUART0 on the LFXO");
+	Sim_Advance(boot_us + SIM_RUN_US - sim_now_us);
+
+	printf("  EM%d  LESENSE on %5.2f s, torn down %5.2f s after boot, LFXO on %5.2f s, masked oscillator waits %.0f us",
+			e_energy_mode, sim_lesense_on_us / 1e6, (teardown_us - boot_us) / 1e6,
+			sim_lfxo_on_us / 1e6, sim_masked_wait_us - masked_wait_us);
+	if (e_energy_mode == ENERGY_MODE_EM3)
+	{
+		expected_ratio = (uint32_t)(SIM_ULFRCO_HZ / ULFRCO_FREQUENCY * OSC_RATIO_UNITY);
+		printf(", osc_ratio %.4f (%.4f)", (double)osc_ratio / OSC_RATIO_UNITY, (double)expected_ratio / OSC_RATIO_UNITY);
+		Sim_Check((osc_ratio > expected_ratio - expected_ratio / 200) &&
+				(osc_ratio < expected_ratio + expected_ratio / 200), "ULFRCO calibrated to within 0.5%");
+	}
+	printf("\n");
+
+	Sim_Check(sim_masked_wait_us == masked_wait_us, "no oscillator waited for with interrupts masked");
+	Sim_Check(sim_lesense_on_us <= SIM_AUTH_US, "LESENSE off after the authentication");
+
+	for (consumer = 0; consumer < CMU_CONSUMER_MAX; consumer++)
+	{
+		CMU_Consumer_Stop((CMU_CONSUMERS)consumer);
+	}
+	Sim_Expect("every consumer stopped", false, false, false, cmuSelect_Disabled);
+	Sim_Check(sim_lfb_select == cmuSelect_Disabled, "LFB off once every consumer stopped");
+}
+
+/************************************************************************************
+ * @function 	Sim_Conflict
+ * @params 		None
+ * @brief 		LETIMER0 holds the LFA tree on the ULFRCO in EM3. LESENSE asks for
+ *				the LFXO on the same tree, the RTC for the same ULFRCO.
+ ************************************************************************************/
+static void Sim_Conflict(void)
+{
+	bool lesense_started;
+	bool rtc_started;
+
+	e_letimer_energy_modes = ENERGY_MODE_EM3;
+
+	CMU_Consumer_Start(CMU_CONSUMER_LETIMER);
+	lesense_started = CMU_Consumer_Start(CMU_CONSUMER_LESENSE);
+	Sim_Expect("LESENSE start on a ULFRCO tree", false, false, true, cmuSelect_ULFRCO);
+
+	rtc_started = CMU_Consumer_Start(CMU_CONSUMER_RTC);
+	CMU_Consumer_Stop(CMU_CONSUMER_RTC);
+	Sim_Expect("RTC start and stop", false, false, true, cmuSelect_ULFRCO);
+
+	printf("  LESENSE on the LFXO %s, RTC on the ULFRCO %s\n",
+			lesense_started ? "started" : "rejected", rtc_started ? "started" : "rejected");
+
+	Sim_Check(!lesense_started, "a consumer on another source is rejected");
+	Sim_Check(rtc_started, "a consumer on the same source shares the tree");
+
+	CMU_Consumer_Stop(CMU_CONSUMER_LESENSE);
+	CMU_Consumer_Stop(CMU_CONSUMER_LETIMER);
+	Sim_Expect("LETIMER0 stop", false, false, false, cmuSelect_Disabled);
+}
+
+int main(void)
+{
+	printf("Boot to the sampling timer, %.1f s LFXO start-up, ULFRCO at %.0f Hz:\n",
+			SIM_LFXO_STARTUP_US / 1e6, SIM_ULFRCO_HZ);
+	Sim_Boot(ENERGY_MODE_EM2);
+	Sim_Boot(ENERGY_MODE_EM3);
+
+	printf("Shared LFA tree in EM3:\n");
+	Sim_Conflict();
+
+	return sim_failures ? 1 : 0;
+}
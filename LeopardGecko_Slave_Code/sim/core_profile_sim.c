@@ -0,0 +1,294 @@
+/*****************************************************************************
+ * @file 	core_profile_sim.c
+ * @brief 	Host simulation of the critical section profiler. Runs the hooks of
+ * 			MCIoT_CoreProfile.c in the order emlib/em_core.c calls them, with
+ * 			CORE_PROFILE_HOOKS set:
+ * 			- CRITICAL sections save PRIMASK, ATOMIC sections BASEPRI, as with
+ * 			  CORE_ATOMIC_METHOD_BASEPRI.
+ * 			- DWT->CYCCNT advances only when the simulation runs code.
+ * 			- A yield lets an interrupt run its own CRITICAL section.
+ * 			Sections are run nested, a CRITICAL section inside an ATOMIC one,
+ * 			around a yield and from more call sites than the table holds.
+ *
+ * 			Exits non-zero if a section is timed off the cycles it had
+ * 			interrupts masked, if a nested section is timed on its own, or if
+ * 			a full table keeps a shorter worst case than a new call site.
+ *
+ * 			Build and run from LeopardGecko_Slave_Code:
+ *
+ * 			  gcc -O2 -Wall -fcommon -DCORE_PROFILE_HOOKS=1 -Isim -Iinc \
+ * 			    -o core_profile_sim sim/core_profile_sim.c src/MCIoT_CoreProfile.c
+ * 			  ./core_profile_sim
+ ******************************************************************************/
+
+/************************************ INCLUDES **************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "em_device.h"
+#include "em_core.h"
+#include "MCIoT_CoreProfile.h"
+
+/************************************ INCLUDES **************************************/
+
+/************************************* MACROS ***************************************/
+
+/* BASEPRI an ATOMIC section sets, CORE_ATOMIC_BASE_PRIORITY_LEVEL 3 with 3
+ * priority bits */
+#define SIM_ATOMIC_BASEPRI			(3 << 5)
+
+/* Call sites */
+#define SIM_SITE_SINGLE				0x1000
+#define SIM_SITE_OUTER				0x2000
+#define SIM_SITE_NESTED				0x2010
+#define SIM_SITE_ATOMIC				0x3000
+#define SIM_SITE_CRITICAL			0x3010
+#define SIM_SITE_YIELD				0x4000
+#define SIM_SITE_IRQ				0x4010
+#define SIM_SITE_FILL				0x5000
+
+/************************************* MACROS ***************************************/
+
+/************************************ GLOBALS ***************************************/
+
+CoreDebug_Type sim_core_debug;
+uint32_t sim_primask;
+
+static DWT_Type sim_dwt;
+static uint32_t sim_basepri;
+static int sim_failures;
+
+/************************************ GLOBALS ***************************************/
+
+/************************************************************************************
+ * @function 	Sim_Check
+ * @params 		[in] ok - result of the check
+ * 				[in] what - description of the check
+ * @brief 		Records a failed check.
+ ************************************************************************************/
+static void Sim_Check(bool ok, const char *what)
+{
+	if (!ok)
+	{
+		printf("FAIL: %s\n", what);
+		sim_failures++;
+	}
+}
+
+DWT_Type *Sim_DWT(void)
+{
+	return &sim_dwt;
+}
+
+/************************************************************************************
+ * @function 	Sim_Run
+ * @params 		[in] cycles - cycles of code to run
+ * @brief 		Advances the cycle counter.
+ ************************************************************************************/
+static void Sim_Run(uint32_t cycles)
+{
+	sim_dwt.CYCCNT += cycles;
+}
+
+/************************************************************************************
+ * CORE_EnterCritical, CORE_ExitCritical, CORE_EnterAtomic, CORE_ExitAtomic and
+ * CORE_YieldCritical of em_core.c, called from call_site
+ ************************************************************************************/
+static CORE_irqState_t Sim_Enter_Critical(uint32_t call_site)
+{
+	CORE_irqState_t irqState = __get_PRIMASK();
+
+	__disable_irq();
+	CORE_ProfileEnterHook(irqState, (void *)(uintptr_t)call_site);
+	return irqState;
+}
+
+static void Sim_Exit_Critical(CORE_irqState_t irqState)
+{
+	CORE_ProfileExitHook(irqState);
+	if (irqState == 0)
+	{
+		__enable_irq();
+	}
+}
+
+static CORE_irqState_t Sim_Enter_Atomic(uint32_t call_site)
+{
+	CORE_irqState_t irqState = sim_basepri;
+
+	sim_basepri = SIM_ATOMIC_BASEPRI;
+	CORE_ProfileEnterHook(irqState, (void *)(uintptr_t)call_site);
+	return irqState;
+}
+
+static void Sim_Exit_Atomic(CORE_irqState_t irqState)
+{
+	CORE_ProfileExitHook(irqState);
+	sim_basepri = irqState;
+}
+
+static void Sim_Yield_Critical(void (*irq_handler)(void))
+{
+	if (__get_PRIMASK() & 1)
+	{
+		CORE_ProfileYieldHook(false);
+		__enable_irq();
+		irq_handler();
+		__disable_irq();
+		CORE_ProfileYieldHook(true);
+	}
+}
+
+/************************************************************************************
+ * @function 	Sim_Find
+ * @params 		[in] call_site - call site to look up
+ * @brief 		Returns the table entry of a call site, NULL if it has none.
+ ************************************************************************************/
+static CORE_PROFILE_ENTRY *Sim_Find(uint32_t call_site)
+{
+	uint32_t i;
+
+	for (i = 0; i < CORE_PROFILE_TABLE_SIZE; i++)
+	{
+		if (core_profile_table[i].call_site == call_site)
+		{
+			return &core_profile_table[i];
+		}
+	}
+	return NULL;
+}
+
+/************************************************************************************
+ * @function 	Sim_Max_Cycles
+ * @params 		[in] call_site - call site to look up
+ * @brief 		Returns the worst case of a call site, 0 if it has no entry.
+ ************************************************************************************/
+static uint32_t Sim_Max_Cycles(uint32_t call_site)
+{
+	CORE_PROFILE_ENTRY *p_entry = Sim_Find(call_site);
+
+	return (p_entry != NULL) ? p_entry->max_cycles : 0;
+}
+
+/************************************************************************************
+ * @function 	Sim_IRQ_Handler
+ * @params 		None
+ * @brief 		Interrupt taken during a yield, 500 cycles of which 25 masked.
+ ************************************************************************************/
+static void Sim_IRQ_Handler(void)
+{
+	CORE_irqState_t irqState;
+
+	Sim_Run(200);
+	irqState = Sim_Enter_Critical(SIM_SITE_IRQ);
+	Sim_Run(25);
+	Sim_Exit_Critical(irqState);
+	Sim_Run(275);
+}
+
+/************************************************************************************
+ * @function 	Sim_Sections
+ * @params 		None
+ * @brief 		Runs single, nested and yielding sections and checks their times.
+ ************************************************************************************/
+static void Sim_Sections(void)
+{
+	CORE_irqState_t outer;
+	CORE_irqState_t inner;
+	CORE_PROFILE_ENTRY *p_yield;
+
+	/* A single section */
+	outer = Sim_Enter_Critical(SIM_SITE_SINGLE);
+	Sim_Run(120);
+	Sim_Exit_Critical(outer);
+
+	/* A section nested in another one counts towards the outer one only */
+	outer = Sim_Enter_Critical(SIM_SITE_OUTER);
+	Sim_Run(30);
+	inner = Sim_Enter_Critical(SIM_SITE_NESTED);
+	Sim_Run(50);
+	Sim_Exit_Critical(inner);
+	Sim_Run(20);
+	Sim_Exit_Critical(outer);
+
+	/* A CRITICAL section inside a BASEPRI ATOMIC section is outermost too */
+	outer = Sim_Enter_Atomic(SIM_SITE_ATOMIC);
+	Sim_Run(40);
+	inner = Sim_Enter_Critical(SIM_SITE_CRITICAL);
+	Sim_Run(60);
+	Sim_Exit_Critical(inner);
+	Sim_Run(10);
+	Sim_Exit_Atomic(outer);
+
+	/* A yield splits the section, the interrupt it lets in is timed on its own */
+	outer = Sim_Enter_Critical(SIM_SITE_YIELD);
+	Sim_Run(80);
+	Sim_Yield_Critical(Sim_IRQ_Handler);
+	Sim_Run(30);
+	Sim_Exit_Critical(outer);
+
+	p_yield = Sim_Find(SIM_SITE_YIELD);
+
+	printf("  single %u, nested %u, ATOMIC %u with CRITICAL %u inside, yield %u over %u parts with IRQ %u cycles\n",
+			Sim_Max_Cycles(SIM_SITE_SINGLE), Sim_Max_Cycles(SIM_SITE_OUTER), Sim_Max_Cycles(SIM_SITE_ATOMIC),
+			Sim_Max_Cycles(SIM_SITE_CRITICAL), Sim_Max_Cycles(SIM_SITE_YIELD),
+			(p_yield != NULL) ? p_yield->count : 0, Sim_Max_Cycles(SIM_SITE_IRQ));
+
+	Sim_Check(Sim_Max_Cycles(SIM_SITE_SINGLE) == 120, "single section timed");
+	Sim_Check(Sim_Max_Cycles(SIM_SITE_OUTER) == 100, "outer section timed across the nested one");
+	Sim_Check(Sim_Find(SIM_SITE_NESTED) == NULL, "nested section not timed on its own");
+	Sim_Check(Sim_Max_Cycles(SIM_SITE_ATOMIC) == 110, "ATOMIC section timed from its own entry");
+	Sim_Check(Sim_Max_Cycles(SIM_SITE_CRITICAL) == 60, "CRITICAL section inside the ATOMIC one timed");
+	Sim_Check((p_yield != NULL) && (p_yield->max_cycles == 80) && (p_yield->count == 2),
+			"yield splits the section, the unmasked time left out");
+	Sim_Check(Sim_Max_Cycles(SIM_SITE_IRQ) == 25, "interrupt section during the yield timed");
+	Sim_Check((sim_primask == 0) && (sim_basepri == 0), "interrupts enabled after the sections");
+}
+
+/************************************************************************************
+ * @function 	Sim_Full_Table
+ * @params 		None
+ * @brief 		Fills the table, then runs a shorter and a longer new call site.
+ ************************************************************************************/
+static void Sim_Full_Table(void)
+{
+	CORE_irqState_t irqState;
+	uint32_t i;
+
+	CORE_ProfileReset();
+	Sim_Check((core_profile_table[0].call_site == 0) && (DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) &&
+			(CoreDebug->DEMCR & CoreDebug_DEMCR_TRCENA_Msk) && (sim_primask == 0),
+			"reset clears the table and starts the cycle counter");
+
+	for (i = 0; i < CORE_PROFILE_TABLE_SIZE; i++)
+	{
+		irqState = Sim_Enter_Critical(SIM_SITE_FILL + i);
+		Sim_Run(10 * (i + 1));
+		Sim_Exit_Critical(irqState);
+	}
+
+	irqState = Sim_Enter_Critical(SIM_SITE_SINGLE);
+	Sim_Run(5);
+	Sim_Exit_Critical(irqState);
+
+	irqState = Sim_Enter_Critical(SIM_SITE_OUTER);
+	Sim_Run(200);
+	Sim_Exit_Critical(irqState);
+
+	printf("  table of %d full: new site of 5 cycles %s, of 200 cycles %s, shortest %s\n",
+			CORE_PROFILE_TABLE_SIZE, Sim_Find(SIM_SITE_SINGLE) ? "kept" : "dropped",
+			Sim_Find(SIM_SITE_OUTER) ? "kept" : "dropped", Sim_Find(SIM_SITE_FILL) ? "kept" : "evicted");
+
+	Sim_Check(Sim_Find(SIM_SITE_SINGLE) == NULL, "site shorter than every entry dropped");
+	Sim_Check((Sim_Max_Cycles(SIM_SITE_OUTER) == 200) && (Sim_Find(SIM_SITE_FILL) == NULL),
+			"longer site takes the entry with the shortest worst case");
+}
+
+int main(void)
+{
+	printf("Critical sections through the em_core.c profiling hooks:\n");
+	Sim_Sections();
+	Sim_Full_Table();
+
+	return sim_failures ? 1 : 0;
+}
@@ -0,0 +1,10 @@
+/*****************************************************************************
+ * @file 	dmactrl.h
+ * @brief 	Host stand-in for the DMA control block header, for the
+ * 			simulations in sim/. The simulated modules use none of it.
+ ******************************************************************************/
+
+#ifndef DMACTRL_H
+#define DMACTRL_H
+
+#endif /* DMACTRL_H */
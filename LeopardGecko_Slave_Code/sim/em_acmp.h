@@ -0,0 +1,92 @@
+/*****************************************************************************
+ * @file 	em_acmp.h
+ * @brief 	Host stand-in for the emlib ACMP API, for the simulations in sim/.
+ * 			Only the definitions the simulated modules use.
+ ******************************************************************************/
+
+#ifndef EM_ACMP_H
+#define EM_ACMP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "em_device.h"
+
+typedef enum
+{
+	acmpChannel0,
+	acmpChannel1,
+	acmpChannel2,
+	acmpChannel3,
+	acmpChannel4,
+	acmpChannel5,
+	acmpChannel6,
+	acmpChannel7,
+	acmpChannel1V25,
+	acmpChannel2V5,
+	acmpChannelVDD
+} ACMP_Channel_TypeDef;
+
+typedef enum
+{
+	acmpWarmTime4,
+	acmpWarmTime8,
+	acmpWarmTime16,
+	acmpWarmTime32,
+	acmpWarmTime64,
+	acmpWarmTime128,
+	acmpWarmTime256,
+	acmpWarmTime512
+} ACMP_WarmTime_TypeDef;
+
+typedef enum
+{
+	acmpHysteresisLevel0,
+	acmpHysteresisLevel1,
+	acmpHysteresisLevel2,
+	acmpHysteresisLevel3,
+	acmpHysteresisLevel4,
+	acmpHysteresisLevel5,
+	acmpHysteresisLevel6,
+	acmpHysteresisLevel7
+} ACMP_HysteresisLevel_TypeDef;
+
+typedef enum
+{
+	acmpResistor0,
+	acmpResistor1,
+	acmpResistor2,
+	acmpResistor3
+} ACMP_CapsenseResistor_TypeDef;
+
+typedef struct
+{
+	bool							fullBias;
+	bool							halfBias;
+	uint32_t						biasProg;
+	ACMP_WarmTime_TypeDef			warmTime;
+	ACMP_HysteresisLevel_TypeDef	hysteresisLevel;
+	ACMP_CapsenseResistor_TypeDef	resistor;
+	bool							lowPowerReferenceEnabled;
+	uint32_t						vddLevel;
+	bool							enable;
+} ACMP_CapsenseInit_TypeDef;
+
+typedef struct
+{
+	volatile uint32_t CTRL;
+	volatile uint32_t INPUTSEL;
+	volatile uint32_t STATUS;
+} ACMP_TypeDef;
+
+extern ACMP_TypeDef sim_acmp[2];
+#define ACMP0						(&sim_acmp[0])
+#define ACMP1						(&sim_acmp[1])
+
+#define ACMP_CTRL_EN				(0x1UL << 0)
+#define ACMP_STATUS_ACMPACT			(0x1UL << 0)
+#define ACMP_STATUS_ACMPOUT			(0x1UL << 1)
+#define _ACMP_INPUTSEL_VDDLEVEL_SHIFT	8
+
+void ACMP_CapsenseInit(ACMP_TypeDef *acmp, const ACMP_CapsenseInit_TypeDef *init);
+
+#endif /* EM_ACMP_H */
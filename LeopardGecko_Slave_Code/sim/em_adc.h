@@ -0,0 +1,63 @@
+/*****************************************************************************
+ * @file 	em_adc.h
+ * @brief 	Host stand-in for the emlib ADC API, for the simulations in sim/.
+ * 			Only the definitions the simulated modules use.
+ ******************************************************************************/
+
+#ifndef EM_ADC_H
+#define EM_ADC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "em_device.h"
+
+typedef enum
+{
+	adcSingleInputCh0,
+	adcSingleInputCh1,
+	adcSingleInputCh2,
+	adcSingleInputCh3,
+	adcSingleInputCh4,
+	adcSingleInputCh5,
+	adcSingleInputCh6,
+	adcSingleInputCh7
+} ADC_SingleInput_TypeDef;
+
+typedef enum { adcOvsRateSel2 } ADC_OvsRateSel_TypeDef;
+typedef enum { adcLPFilterBypass } ADC_LPFilter_TypeDef;
+typedef enum { adcWarmupNormal, adcWarmupFastBG, adcWarmupKeepScanRefWarm, adcWarmupKeepADCWarm } ADC_Warmup_TypeDef;
+typedef enum { adcRef1V25, adcRef2V5, adcRefVDD } ADC_Ref_TypeDef;
+typedef enum { adcRes12Bit, adcRes8Bit, adcRes6Bit, adcResOVS } ADC_Res_TypeDef;
+typedef enum { adcPRSSELCh0 } ADC_PRSSEL_TypeDef;
+typedef enum { adcAcqTime1, adcAcqTime2, adcAcqTime4, adcAcqTime8, adcAcqTime16, adcAcqTime32 } ADC_AcqTime_TypeDef;
+typedef enum { adcStartSingle = 1, adcStartScan = 4 } ADC_Start_TypeDef;
+
+typedef struct
+{
+	volatile uint32_t CTRL;
+	volatile uint32_t CMD;
+	volatile uint32_t STATUS;
+	volatile uint32_t SINGLEDATA;
+} ADC_TypeDef;
+
+#define ADC_STATUS_WARM				(0x1UL << 12)
+
+extern ADC_TypeDef sim_adc0;
+#define ADC0						(&sim_adc0)
+
+void ADC_Start(ADC_TypeDef *adc, ADC_Start_TypeDef cmd);
+
+typedef struct
+{
+	uint32_t					prsSel;
+	uint32_t					acqTime;
+	uint32_t					reference;
+	uint32_t					resolution;
+	ADC_SingleInput_TypeDef		input;
+	bool						diff;
+	bool						prsEnable;
+	bool						leftAdjust;
+	bool						rep;
+} ADC_InitSingle_TypeDef;
+
+#endif /* EM_ADC_H */
@@ -0,0 +1,54 @@
+/*****************************************************************************
+ * @file 	em_burtc.h
+ * @brief 	Host stand-in for the emlib BURTC API, for the simulations in sim/.
+ * 			The simulation provides BURTC_CounterGet(), so that the counter
+ * 			follows its clock.
+ ******************************************************************************/
+
+#ifndef EM_BURTC_H
+#define EM_BURTC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum
+{
+	burtcModeDisable,
+	burtcModeEM2,
+	burtcModeEM3,
+	burtcModeEM4
+} BURTC_Mode_TypeDef;
+
+typedef enum
+{
+	burtcClkSelLFRCO,
+	burtcClkSelLFXO,
+	burtcClkSelULFRCO
+} BURTC_ClkSel_TypeDef;
+
+typedef enum
+{
+	burtcLPDisable,
+	burtcLPEnable,
+	burtcLPBU
+} BURTC_LP_TypeDef;
+
+#define burtcClkDiv_1				1
+
+typedef struct
+{
+	bool						enable;
+	BURTC_Mode_TypeDef			mode;
+	bool						debugRun;
+	BURTC_ClkSel_TypeDef		clkSel;
+	uint32_t					clkDiv;
+	uint32_t					lowPowerComp;
+	bool						timeStamp;
+	bool						compare0Top;
+	BURTC_LP_TypeDef			lowPowerMode;
+} BURTC_Init_TypeDef;
+
+void BURTC_Init(const BURTC_Init_TypeDef *burtcInit);
+uint32_t BURTC_CounterGet(void);
+
+#endif /* EM_BURTC_H */
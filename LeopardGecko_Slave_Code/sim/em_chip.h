@@ -0,0 +1,13 @@
+/*****************************************************************************
+ * @file 	em_chip.h
+ * @brief 	Host stand-in for the emlib CHIP API, for the simulations in sim/.
+ ******************************************************************************/
+
+#ifndef EM_CHIP_H
+#define EM_CHIP_H
+
+#include "em_device.h"
+
+void CHIP_Init(void);
+
+#endif /* EM_CHIP_H */
@@ -0,0 +1,81 @@
+/*****************************************************************************
+ * @file 	em_cmu.h
+ * @brief 	Host stand-in for the emlib CMU API, for the simulations in sim/.
+ * 			The simulation provides the functions.
+ ******************************************************************************/
+
+#ifndef EM_CMU_H
+#define EM_CMU_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum
+{
+	cmuClock_HFPER,
+	cmuClock_GPIO,
+	cmuClock_ACMP0,
+	cmuClock_ACMP1,
+	cmuClock_ADC0,
+	cmuClock_DMA,
+	cmuClock_I2C1,
+	cmuClock_TIMER0,
+	cmuClock_TIMER1,
+	cmuClock_CORELE,
+	cmuClock_LETIMER0,
+	cmuClock_LEUART0,
+	cmuClock_LESENSE,
+	cmuClock_RTC,
+	cmuClock_LFA,
+	cmuClock_LFB,
+	cmuClock_HF,
+	SIM_CMU_CLOCKS
+} CMU_Clock_TypeDef;
+
+typedef enum
+{
+	cmuSelect_Disabled,
+	cmuSelect_LFXO,
+	cmuSelect_LFRCO,
+	cmuSelect_ULFRCO,
+	cmuSelect_CORELEDIV2,
+	cmuSelect_HFCLK,
+	cmuSelect_HFXO,
+	cmuSelect_HFRCO
+} CMU_Select_TypeDef;
+
+typedef enum
+{
+	cmuOsc_LFXO,
+	cmuOsc_LFRCO,
+	cmuOsc_HFXO,
+	cmuOsc_HFRCO,
+	cmuOsc_AUXHFRCO,
+	cmuOsc_ULFRCO,
+	SIM_CMU_OSCS
+} CMU_Osc_TypeDef;
+
+typedef struct
+{
+	volatile uint32_t LFAPRESC0;
+} CMU_TypeDef;
+
+#define _CMU_LFAPRESC0_LETIMER0_SHIFT	8
+#define _CMU_LFAPRESC0_LETIMER0_MASK	0xF00UL
+
+extern CMU_TypeDef sim_cmu;
+#define CMU							(&sim_cmu)
+
+void CMU_ClockEnable(CMU_Clock_TypeDef clock, bool enable);
+
+void CMU_ClockSelectSet(CMU_Clock_TypeDef clock, CMU_Select_TypeDef ref);
+
+void CMU_OscillatorEnable(CMU_Osc_TypeDef osc, bool enable, bool wait);
+
+CMU_Select_TypeDef CMU_ClockSelectGet(CMU_Clock_TypeDef clock);
+
+uint32_t CMU_ClockDivGet(CMU_Clock_TypeDef clock);
+
+uint32_t CMU_ClockFreqGet(CMU_Clock_TypeDef clock);
+
+#endif /* EM_CMU_H */
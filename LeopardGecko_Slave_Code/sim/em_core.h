@@ -0,0 +1,29 @@
+/*****************************************************************************
+ * @file 	em_core.h
+ * @brief 	Host stand-in for the emlib CORE API, for the simulations in sim/.
+ * 			The simulation provides Sim_Core_Enter() and Sim_Core_Exit(),
+ * 			so that it knows when interrupts are masked.
+ ******************************************************************************/
+
+#ifndef EM_CORE_H
+#define EM_CORE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef uint32_t CORE_irqState_t;
+
+#define CORE_DECLARE_IRQ_STATE		CORE_irqState_t irqState
+
+#define CORE_ENTER_ATOMIC()			(irqState = Sim_Core_Enter())
+#define CORE_EXIT_ATOMIC()			Sim_Core_Exit(irqState)
+#define CORE_ENTER_CRITICAL()		(irqState = Sim_Core_Enter())
+#define CORE_EXIT_CRITICAL()		Sim_Core_Exit(irqState)
+
+/* Returns the previous mask state, masks interrupts */
+uint32_t Sim_Core_Enter(void);
+
+/* Restores the mask state returned by Sim_Core_Enter() */
+void Sim_Core_Exit(uint32_t state);
+
+#endif /* EM_CORE_H */
@@ -0,0 +1,101 @@
+/*****************************************************************************
+ * @file 	em_device.h
+ * @brief 	Host stand-in for the device header, for the simulations in sim/.
+ * 			Only the definitions the simulated modules use.
+ ******************************************************************************/
+
+#ifndef EM_DEVICE_H
+#define EM_DEVICE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* EFM32LG990F256 flash, a host array of the simulation that provides the
+ * em_msc.h calls */
+extern uint32_t sim_flash[];
+#define FLASH_BASE					((uintptr_t)sim_flash)
+#define FLASH_SIZE					(0x00040000UL)
+#define FLASH_PAGE_SIZE				2048
+
+/* DMA request sources */
+#define DMAREQ_ADC0_SINGLE			((8 << 16) + 0)
+#define DMAREQ_LESENSE_BUFDATAV		((59 << 16) + 0)
+
+typedef enum
+{
+	DMA_IRQn = 0,
+	I2C1_IRQn = 10,
+	GPIO_ODD_IRQn = 11,
+	LEUART0_IRQn = 24,
+	LETIMER0_IRQn = 26,
+	RTC_IRQn = 30,
+	LESENSE_IRQn = 37
+} IRQn_Type;
+
+/* The simulation provides the NVIC calls it is built with */
+void NVIC_EnableIRQ(IRQn_Type irq);
+
+void NVIC_DisableIRQ(IRQn_Type irq);
+
+void NVIC_ClearPendingIRQ(IRQn_Type irq);
+
+void SystemCoreClockUpdate(void);
+
+/* Debug cycle counter, DWT->CYCCNT is read through Sim_DWT() */
+typedef struct
+{
+	volatile uint32_t CTRL;
+	volatile uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct
+{
+	volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+#define DWT_CTRL_CYCCNTENA_Msk			(1UL << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk		(1UL << 24)
+
+extern CoreDebug_Type sim_core_debug;
+#define CoreDebug					(&sim_core_debug)
+
+DWT_Type *Sim_DWT(void);
+#define DWT							Sim_DWT()
+
+/* PRIMASK */
+extern uint32_t sim_primask;
+
+static inline uint32_t __get_PRIMASK(void)
+{
+	return sim_primask;
+}
+
+static inline void __disable_irq(void)
+{
+	sim_primask = 1;
+}
+
+static inline void __enable_irq(void)
+{
+	sim_primask = 0;
+}
+
+static inline uint32_t __RBIT(uint32_t value)
+{
+	uint32_t result = 0;
+	int bit;
+
+	for (bit = 0; bit < 32; bit++)
+	{
+		result = (result << 1) | ((value >> bit) & 1);
+	}
+	return result;
+}
+
+static inline uint32_t __CLZ(uint32_t value)
+{
+	return value ? (uint32_t)__builtin_clz(value) : 32;
+}
+
+#endif /* EM_DEVICE_H */
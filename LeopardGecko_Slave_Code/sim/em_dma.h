@@ -0,0 +1,82 @@
+/*****************************************************************************
+ * @file 	em_dma.h
+ * @brief 	Host stand-in for the emlib DMA API, for the simulations in sim/.
+ * 			Only the definitions the simulated modules use.
+ ******************************************************************************/
+
+#ifndef EM_DMA_H
+#define EM_DMA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "em_device.h"
+
+typedef void (*DMA_FuncPtr_TypeDef)(unsigned int channel, bool primary, void *user);
+
+typedef struct
+{
+	DMA_FuncPtr_TypeDef			cbFunc;
+	void						*userPtr;
+	uint8_t						primary;
+} DMA_CB_TypeDef;
+
+typedef enum
+{
+	dmaDataInc1,
+	dmaDataInc2,
+	dmaDataInc4,
+	dmaDataIncNone
+} DMA_DataInc_TypeDef;
+
+typedef enum
+{
+	dmaDataSize1,
+	dmaDataSize2,
+	dmaDataSize4
+} DMA_DataSize_TypeDef;
+
+typedef enum
+{
+	dmaArbitrate1,
+	dmaArbitrate2,
+	dmaArbitrate4,
+	dmaArbitrate8,
+	dmaArbitrate16
+} DMA_ArbiterConfig_TypeDef;
+
+typedef struct
+{
+	bool						highPri;
+	bool						enableInt;
+	uint32_t					select;
+	DMA_CB_TypeDef				*cb;
+} DMA_CfgChannel_TypeDef;
+
+typedef struct
+{
+	DMA_DataInc_TypeDef			dstInc;
+	DMA_DataInc_TypeDef			srcInc;
+	DMA_DataSize_TypeDef		size;
+	DMA_ArbiterConfig_TypeDef	arbRate;
+	uint8_t						hprot;
+} DMA_CfgDescr_TypeDef;
+
+void DMA_CfgChannel(unsigned int channel, DMA_CfgChannel_TypeDef *cfg);
+
+void DMA_CfgDescr(unsigned int channel, bool primary, DMA_CfgDescr_TypeDef *cfg);
+
+void DMA_ActivatePingPong(unsigned int channel, bool useBurst,
+		void *primDst, void *primSrc, unsigned int primNMinus1,
+		void *altDst, void *altSrc, unsigned int altNMinus1);
+
+void DMA_RefreshPingPong(unsigned int channel, bool primary, bool useBurst,
+		void *dst, void *src, unsigned int nMinus1, bool stop);
+
+void DMA_ActivateBasic(unsigned int channel, bool primary, bool useBurst,
+		void *dst, void *src, unsigned int nMinus1);
+
+void DMA_ChannelEnable(unsigned int channel, bool enable);
+
+bool DMA_ChannelEnabled(unsigned int channel);
+
+#endif /* EM_DMA_H */
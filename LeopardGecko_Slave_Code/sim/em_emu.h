@@ -0,0 +1,20 @@
+/*****************************************************************************
+ * @file 	em_emu.h
+ * @brief 	Host stand-in for the emlib EMU API, for the simulations in sim/.
+ * 			The simulation provides the functions.
+ ******************************************************************************/
+
+#ifndef EM_EMU_H
+#define EM_EMU_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "em_device.h"
+
+void EMU_EnterEM1(void);
+
+void EMU_EnterEM2(bool restore);
+
+void EMU_EnterEM3(bool restore);
+
+#endif /* EM_EMU_H */
@@ -0,0 +1,44 @@
+/*****************************************************************************
+ * @file 	em_gpio.h
+ * @brief 	Host stand-in for the emlib GPIO API, for the simulations in sim/.
+ * 			Only the definitions the simulated modules use.
+ ******************************************************************************/
+
+#ifndef EM_GPIO_H
+#define EM_GPIO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "em_device.h"
+
+typedef enum
+{
+	gpioPortA,
+	gpioPortB,
+	gpioPortC,
+	gpioPortD,
+	gpioPortE,
+	gpioPortF
+} GPIO_Port_TypeDef;
+
+typedef enum
+{
+	gpioModeDisabled,
+	gpioModeInput,
+	gpioModeInputPull,
+	gpioModeInputPullFilter,
+	gpioModePushPull = 4,
+	gpioModeWiredAnd = 8
+} GPIO_Mode_TypeDef;
+
+void GPIO_PinModeSet(GPIO_Port_TypeDef port, unsigned int pin, GPIO_Mode_TypeDef mode, unsigned int out);
+
+void GPIO_PinOutSet(GPIO_Port_TypeDef port, unsigned int pin);
+
+void GPIO_PinOutClear(GPIO_Port_TypeDef port, unsigned int pin);
+
+void GPIO_IntConfig(GPIO_Port_TypeDef port, unsigned int pin, bool risingEdge, bool fallingEdge, bool enable);
+
+void GPIO_IntClear(uint32_t flags);
+
+#endif /* EM_GPIO_H */
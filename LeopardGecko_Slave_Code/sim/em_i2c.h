@@ -0,0 +1,95 @@
+/*****************************************************************************
+ * @file 	em_i2c.h
+ * @brief 	Host stand-in for the emlib I2C API, for the simulations in sim/.
+ * 			Only the definitions the simulated modules use.
+ ******************************************************************************/
+
+#ifndef EM_I2C_H
+#define EM_I2C_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "em_device.h"
+
+#define I2C_FREQ_FAST_MAX			392157
+
+#define I2C_FLAG_WRITE				0x0001
+#define I2C_FLAG_READ				0x0002
+#define I2C_FLAG_WRITE_READ			0x0004
+#define I2C_FLAG_WRITE_WRITE		0x0008
+
+typedef enum
+{
+	i2cClockHLRStandard,
+	i2cClockHLRAsymetric,
+	i2cClockHLRFast
+} I2C_ClockHLR_TypeDef;
+
+typedef struct
+{
+	uint16_t					addr;
+	uint16_t					flags;
+	struct
+	{
+		uint8_t					*data;
+		uint16_t				len;
+	} buf[2];
+} I2C_TransferSeq_TypeDef;
+
+typedef struct
+{
+	bool						enable;
+	bool						master;
+	uint32_t					refFreq;
+	uint32_t					freq;
+	I2C_ClockHLR_TypeDef		clhr;
+} I2C_Init_TypeDef;
+
+typedef enum
+{
+	i2cTransferInProgress = 1,
+	i2cTransferDone = 0,
+	i2cTransferNack = -1,
+	i2cTransferBusErr = -2,
+	i2cTransferArbLost = -3,
+	i2cTransferUsageFault = -4,
+	i2cTransferSwFault = -5
+} I2C_TransferReturn_TypeDef;
+
+typedef struct
+{
+	volatile uint32_t CTRL;
+	volatile uint32_t CMD;
+	volatile uint32_t STATE;
+	volatile uint32_t IF;
+	volatile uint32_t IFC;
+	volatile uint32_t IEN;
+	volatile uint32_t ROUTE;
+} I2C_TypeDef;
+
+extern I2C_TypeDef sim_i2c1;
+#define I2C1						(&sim_i2c1)
+
+#define I2C_ROUTE_SDAPEN			(0x1UL << 0)
+#define I2C_ROUTE_SCLPEN			(0x1UL << 1)
+#define I2C_ROUTE_LOCATION_LOC0		(0x0UL << 8)
+#define I2C_STATE_BUSY				(0x1UL << 0)
+#define I2C_CMD_ABORT				(0x1UL << 5)
+#define _I2C_CTRL_CLTO_SHIFT		16
+#define _I2C_CTRL_CLTO_MASK			(0x7UL << 16)
+#define I2C_IF_ARBLOST				(0x1UL << 9)
+#define I2C_IF_BUSERR				(0x1UL << 10)
+#define I2C_IF_CLTO					(0x1UL << 15)
+#define I2C_IEN_CLTO				I2C_IF_CLTO
+#define I2C_IFC_ARBLOST				I2C_IF_ARBLOST
+#define I2C_IFC_BUSERR				I2C_IF_BUSERR
+#define I2C_IFC_CLTO				I2C_IF_CLTO
+#define _I2C_IFC_MASK				0x0001FFCFUL
+
+void I2C_Init(I2C_TypeDef *i2c, const I2C_Init_TypeDef *init);
+
+I2C_TransferReturn_TypeDef I2C_TransferInit(I2C_TypeDef *i2c, I2C_TransferSeq_TypeDef *seq);
+
+I2C_TransferReturn_TypeDef I2C_Transfer(I2C_TypeDef *i2c);
+
+#endif /* EM_I2C_H */
@@ -0,0 +1,216 @@
+/*****************************************************************************
+ * @file 	em_lesense.h
+ * @brief 	Host stand-in for the emlib LESENSE API, for the simulations in
+ * 			sim/. LESENSE goes through Sim_LESENSE() on every access, so that
+ * 			the simulation can run scans while the code polls it. The
+ * 			simulation provides the functions that are not register accesses.
+ ******************************************************************************/
+
+#ifndef EM_LESENSE_H
+#define EM_LESENSE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "em_device.h"
+
+typedef struct
+{
+	volatile uint32_t TIMING;
+	volatile uint32_t INTERACT;
+	volatile uint32_t EVAL;
+	uint32_t RESERVED;
+} LESENSE_CH_TypeDef;
+
+typedef struct
+{
+	volatile uint32_t DATA;
+} LESENSE_BUF_TypeDef;
+
+typedef struct
+{
+	volatile uint32_t CTRL;
+	volatile uint32_t TIMCTRL;
+	volatile uint32_t PERCTRL;
+	volatile uint32_t DECCTRL;
+	volatile uint32_t BIASCTRL;
+	volatile uint32_t CMD;
+	volatile uint32_t CHEN;
+	volatile uint32_t SCANRES;
+	volatile uint32_t STATUS;
+	volatile uint32_t PTR;
+	volatile uint32_t BUFDATA;
+	volatile uint32_t CURCH;
+	volatile uint32_t DECSTATE;
+	volatile uint32_t SENSORSTATE;
+	volatile uint32_t IDLECONF;
+	volatile uint32_t ALTEXCONF;
+	volatile uint32_t IF;
+	volatile uint32_t IFC;
+	volatile uint32_t IFS;
+	volatile uint32_t IEN;
+	volatile uint32_t SYNCBUSY;
+	volatile uint32_t ROUTE;
+	volatile uint32_t POWERDOWN;
+	LESENSE_BUF_TypeDef BUF[16];
+	LESENSE_CH_TypeDef CH[16];
+} LESENSE_TypeDef;
+
+#define LESENSE_STATUS_BUFDATAV			(0x1UL << 0)
+#define LESENSE_STATUS_BUFHALFFULL		(0x1UL << 1)
+#define LESENSE_STATUS_BUFFULL			(0x1UL << 2)
+#define LESENSE_STATUS_RUNNING			(0x1UL << 3)
+#define LESENSE_STATUS_SCANACTIVE		(0x1UL << 4)
+
+#define _LESENSE_PTR_WR_SHIFT			4
+#define _LESENSE_PTR_WR_MASK			0xF0UL
+
+#define LESENSE_IF_SCANCOMPLETE			(0x1UL << 16)
+#define LESENSE_IFC_SCANCOMPLETE		LESENSE_IF_SCANCOMPLETE
+#define LESENSE_IEN_SCANCOMPLETE		LESENSE_IF_SCANCOMPLETE
+#define _LESENSE_IEN_MASK				0x007FFFFFUL
+#define _LESENSE_IFC_MASK				0x007FFFFFUL
+
+#define LESENSE_CH_EVAL_COMP			(0x1UL << 16)
+#define _LESENSE_CH_EVAL_COMPTHRES_MASK	0xFFFFUL
+
+typedef enum { lesenseScanStartPeriodic, lesenseScanStartOneShot, lesenseScanStartPRS } LESENSE_ScanMode_TypeDef;
+typedef enum { lesensePRSCh0, lesensePRSCh1, lesensePRSCh2, lesensePRSCh3 } LESENSE_PRSSel_TypeDef;
+typedef enum { lesenseScanConfDirMap, lesenseScanConfInvMap, lesenseScanConfToggle, lesenseScanConfDecDef } LESENSE_ScanConfSel_TypeDef;
+typedef enum { lesenseBufTrigHalf, lesenseBufTrigFull } LESENSE_BufTrigLevel_TypeDef;
+typedef enum { lesenseDMAWakeUpDisable, lesenseDMAWakeUpBufValid, lesenseDMAWakeUpBufLevel } LESENSE_DMAWakeUp_TypeDef;
+typedef enum { lesenseBiasModeDutyCycle, lesenseBiasModeHighAcc, lesenseBiasModeDontTouch } LESENSE_BiasMode_TypeDef;
+typedef enum { lesenseDACIfData, lesenseACMPThres } LESENSE_ControlDACData_TypeDef;
+typedef enum { lesenseDACConvModeDisable, lesenseDACConvModeContinuous, lesenseDACConvModeSampleHold, lesenseDACConvModeSampleOff } LESENSE_ControlDACConv_TypeDef;
+typedef enum { lesenseDACOutModeDisable, lesenseDACOutModePin, lesenseDACOutModeADCACMP, lesenseDACOutModePinADCACMP } LESENSE_ControlDACOut_TypeDef;
+typedef enum { lesenseDACRefVdd, lesenseDACRefBandGap } LESENSE_DACRef_TypeDef;
+typedef enum { lesenseACMPModeDisable, lesenseACMPModeMux, lesenseACMPModeMuxThres } LESENSE_ControlACMP_TypeDef;
+typedef enum { lesenseWarmupModeNormal, lesenseWarmupModeACMP, lesenseWarmupModeDAC, lesenseWarmupModeKeepWarm } LESENSE_WarmupMode_TypeDef;
+typedef enum { lesenseDecInputSensorSt, lesenseDecInputPRS } LESENSE_DecInput_TypeDef;
+typedef enum { lesenseChPinExDis, lesenseChPinExHigh, lesenseChPinExLow, lesenseChPinExDACOut } LESENSE_ChPinExMode_TypeDef;
+typedef enum { lesenseChPinIdleDis, lesenseChPinIdleHigh, lesenseChPinIdleLow, lesenseChPinIdleDACCh0 } LESENSE_ChPinIdleMode_TypeDef;
+typedef enum { lesenseClkLF, lesenseClkHF } LESENSE_ChClk_TypeDef;
+typedef enum { lesenseClkDiv_1, lesenseClkDiv_2, lesenseClkDiv_4, lesenseClkDiv_8 } LESENSE_ClkPresc_TypeDef;
+typedef enum { lesenseSampleModeCounter, lesenseSampleModeACMP } LESENSE_ChSampleMode_TypeDef;
+typedef enum { lesenseSetIntNone, lesenseSetIntLevel, lesenseSetIntPosEdge, lesenseSetIntNegEdge } LESENSE_ChIntMode_TypeDef;
+typedef enum { lesenseCompModeLess, lesenseCompModeGreaterOrEq } LESENSE_ChCompMode_TypeDef;
+
+typedef struct
+{
+	struct
+	{
+		LESENSE_ScanMode_TypeDef		scanStart;
+		LESENSE_PRSSel_TypeDef			prsSel;
+		LESENSE_ScanConfSel_TypeDef		scanConfSel;
+		bool							invACMP0;
+		bool							invACMP1;
+		bool							dualSample;
+		bool							storeScanRes;
+		bool							bufOverWr;
+		LESENSE_BufTrigLevel_TypeDef	bufTrigLevel;
+		LESENSE_DMAWakeUp_TypeDef		wakeupOnDMA;
+		LESENSE_BiasMode_TypeDef		biasMode;
+		bool							debugRun;
+	} coreCtrl;
+	struct
+	{
+		uint8_t							startDelay;
+	} timeCtrl;
+	struct
+	{
+		LESENSE_ControlDACData_TypeDef	dacCh0Data;
+		LESENSE_ControlDACConv_TypeDef	dacCh0ConvMode;
+		LESENSE_ControlDACOut_TypeDef	dacCh0OutMode;
+		LESENSE_ControlDACData_TypeDef	dacCh1Data;
+		LESENSE_ControlDACConv_TypeDef	dacCh1ConvMode;
+		LESENSE_ControlDACOut_TypeDef	dacCh1OutMode;
+		uint8_t							dacPresc;
+		LESENSE_DACRef_TypeDef			dacRef;
+		LESENSE_ControlACMP_TypeDef		acmp0Mode;
+		LESENSE_ControlACMP_TypeDef		acmp1Mode;
+		LESENSE_WarmupMode_TypeDef		warmupMode;
+	} perCtrl;
+	struct
+	{
+		LESENSE_DecInput_TypeDef		decInput;
+		uint32_t						initState;
+		bool							chkState;
+		bool							intMap;
+		bool							hystPRS0;
+		bool							hystPRS1;
+		bool							hystPRS2;
+		bool							hystIRQ;
+		bool							prsCount;
+		LESENSE_PRSSel_TypeDef			prsChSel0;
+		LESENSE_PRSSel_TypeDef			prsChSel1;
+		LESENSE_PRSSel_TypeDef			prsChSel2;
+		LESENSE_PRSSel_TypeDef			prsChSel3;
+	} decCtrl;
+} LESENSE_Init_TypeDef;
+
+typedef struct
+{
+	bool							enaScanCh;
+	bool							enaPin;
+	bool							enaInt;
+	LESENSE_ChPinExMode_TypeDef		chPinExMode;
+	LESENSE_ChPinIdleMode_TypeDef	chPinIdleMode;
+	bool							useAltEx;
+	bool							shiftRes;
+	bool							invRes;
+	bool							storeCntRes;
+	LESENSE_ChClk_TypeDef			exClk;
+	LESENSE_ChClk_TypeDef			sampleClk;
+	uint8_t							exTime;
+	uint8_t							sampleDelay;
+	uint8_t							measDelay;
+	uint16_t						acmpThres;
+	LESENSE_ChSampleMode_TypeDef	sampleMode;
+	LESENSE_ChIntMode_TypeDef		intMode;
+	uint16_t						cntThres;
+	LESENSE_ChCompMode_TypeDef		compMode;
+} LESENSE_ChDesc_TypeDef;
+
+LESENSE_TypeDef *Sim_LESENSE(void);
+#define LESENSE						(Sim_LESENSE())
+
+void LESENSE_Init(const LESENSE_Init_TypeDef *init, bool reqReset);
+
+void LESENSE_ChannelConfig(const LESENSE_ChDesc_TypeDef *confCh, uint32_t chIdx);
+
+void LESENSE_ChannelThresSet(uint8_t chIdx, uint16_t acmpThres, uint16_t cntThres);
+
+uint32_t LESENSE_ScanFreqSet(uint32_t refFreq, uint32_t scanFreq);
+
+void LESENSE_ClkDivSet(LESENSE_ChClk_TypeDef clk, LESENSE_ClkPresc_TypeDef clkDiv);
+
+void LESENSE_ScanStart(void);
+
+void LESENSE_ScanStop(void);
+
+void LESENSE_ResultBufferClear(void);
+
+uint32_t LESENSE_ScanResultDataBufferGet(uint32_t idx);
+
+static inline void LESENSE_IntClear(uint32_t flags)
+{
+	LESENSE->IF &= ~flags;
+}
+
+static inline void LESENSE_IntEnable(uint32_t flags)
+{
+	LESENSE->IEN |= flags;
+}
+
+static inline void LESENSE_IntDisable(uint32_t flags)
+{
+	LESENSE->IEN &= ~flags;
+}
+
+static inline uint32_t LESENSE_IntGetEnabled(void)
+{
+	uint32_t ien = LESENSE->IEN;
+
+	return LESENSE->IF & ien;
+}
+
+#endif /* EM_LESENSE_H */
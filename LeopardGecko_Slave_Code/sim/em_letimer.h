@@ -0,0 +1,119 @@
+/*****************************************************************************
+ * @file 	em_letimer.h
+ * @brief 	Host stand-in for the emlib LETIMER API, for the simulations in sim/.
+ * 			LETIMER0 goes through Sim_LETIMER0() on every access, so that the
+ * 			simulation can advance the counter while the code polls it.
+ ******************************************************************************/
+
+#ifndef EM_LETIMER_H
+#define EM_LETIMER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "em_device.h"
+
+typedef struct
+{
+	volatile uint32_t CTRL;
+	volatile uint32_t CMD;
+	volatile uint32_t STATUS;
+	volatile uint32_t CNT;
+	volatile uint32_t COMP0;
+	volatile uint32_t COMP1;
+	volatile uint32_t REP0;
+	volatile uint32_t REP1;
+	volatile uint32_t IF;
+	volatile uint32_t IFS;
+	volatile uint32_t IFC;
+	volatile uint32_t IEN;
+	volatile uint32_t FREEZE;
+	volatile uint32_t SYNCBUSY;
+	volatile uint32_t ROUTE;
+} LETIMER_TypeDef;
+
+#define LETIMER_CMD_START			(0x1UL << 0)
+#define LETIMER_CMD_STOP			(0x1UL << 1)
+#define LETIMER_CMD_CLEAR			(0x1UL << 2)
+
+#define LETIMER_STATUS_RUNNING		(0x1UL << 0)
+
+#define LETIMER_SYNCBUSY_CTRL		(0x1UL << 0)
+#define LETIMER_SYNCBUSY_CMD		(0x1UL << 1)
+#define LETIMER_SYNCBUSY_COMP0		(0x1UL << 2)
+#define LETIMER_SYNCBUSY_COMP1		(0x1UL << 3)
+
+#define LETIMER_IF_COMP0			(0x1UL << 0)
+#define LETIMER_IF_COMP1			(0x1UL << 1)
+#define LETIMER_IF_UF				(0x1UL << 2)
+#define LETIMER_IF_REP0				(0x1UL << 3)
+#define LETIMER_IF_REP1				(0x1UL << 4)
+
+typedef enum
+{
+	letimerUFOANone,
+	letimerUFOAToggle,
+	letimerUFOAPulse,
+	letimerUFOAPwm
+} LETIMER_UFOA_TypeDef;
+
+typedef enum
+{
+	letimerRepeatFree,
+	letimerRepeatOneshot,
+	letimerRepeatBuffered,
+	letimerRepeatDouble
+} LETIMER_RepeatMode_TypeDef;
+
+typedef struct
+{
+	bool						enable;
+	bool						debugRun;
+	bool						rtcComp0Enable;
+	bool						rtcComp1Enable;
+	bool						comp0Top;
+	bool						bufTop;
+	uint8_t						out0Pol;
+	uint8_t						out1Pol;
+	LETIMER_UFOA_TypeDef		ufoa0;
+	LETIMER_UFOA_TypeDef		ufoa1;
+	LETIMER_RepeatMode_TypeDef	repMode;
+} LETIMER_Init_TypeDef;
+
+LETIMER_TypeDef *Sim_LETIMER0(void);
+#define LETIMER0					(Sim_LETIMER0())
+
+void LETIMER_Init(LETIMER_TypeDef *letimer, const LETIMER_Init_TypeDef *init);
+
+static inline uint32_t LETIMER_CounterGet(LETIMER_TypeDef *letimer)
+{
+	return letimer->CNT;
+}
+
+static inline uint32_t LETIMER_CompareGet(LETIMER_TypeDef *letimer, unsigned int comp)
+{
+	return comp ? letimer->COMP1 : letimer->COMP0;
+}
+
+static inline void LETIMER_CompareSet(LETIMER_TypeDef *letimer, unsigned int comp, uint32_t value)
+{
+	if (comp)
+	{
+		letimer->COMP1 = value;
+	}
+	else
+	{
+		letimer->COMP0 = value;
+	}
+}
+
+static inline void LETIMER_IntEnable(LETIMER_TypeDef *letimer, uint32_t flags)
+{
+	letimer->IEN |= flags;
+}
+
+static inline void LETIMER_IntClear(LETIMER_TypeDef *letimer, uint32_t flags)
+{
+	letimer->IF &= ~flags;
+}
+
+#endif /* EM_LETIMER_H */
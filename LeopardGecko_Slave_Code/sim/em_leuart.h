@@ -0,0 +1,28 @@
+/*****************************************************************************
+ * @file 	em_leuart.h
+ * @brief 	Host stand-in for the emlib LEUART API, for the simulations in sim/.
+ * 			Only the definitions the simulated modules use.
+ ******************************************************************************/
+
+#ifndef EM_LEUART_H
+#define EM_LEUART_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "em_device.h"
+
+typedef struct
+{
+	volatile uint32_t CTRL;
+	volatile uint32_t CMD;
+	volatile uint32_t STATUS;
+	volatile uint32_t TXDATA;
+	volatile uint32_t IF;
+	volatile uint32_t IFC;
+	volatile uint32_t IEN;
+} LEUART_TypeDef;
+
+extern LEUART_TypeDef sim_leuart0;
+#define LEUART0						(&sim_leuart0)
+
+#endif /* EM_LEUART_H */
@@ -0,0 +1,30 @@
+/*****************************************************************************
+ * @file 	em_msc.h
+ * @brief 	Host stand-in for the emlib MSC API, for the simulations in sim/.
+ * 			Only the definitions the simulated modules use.
+ ******************************************************************************/
+
+#ifndef EM_MSC_H
+#define EM_MSC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum
+{
+	mscReturnOk = 0,
+	mscReturnInvalidAddr = -1,
+	mscReturnLocked = -2,
+	mscReturnTimeOut = -3,
+	mscReturnUnaligned = -4
+} MSC_Status_TypeDef;
+
+void MSC_Init(void);
+
+void MSC_Deinit(void);
+
+MSC_Status_TypeDef MSC_ErasePage(uint32_t *startAddress);
+
+MSC_Status_TypeDef MSC_WriteWord(uint32_t *address, void const *data, uint32_t numBytes);
+
+#endif /* EM_MSC_H */
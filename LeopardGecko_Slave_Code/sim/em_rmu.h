@@ -0,0 +1,26 @@
+/*****************************************************************************
+ * @file 	em_rmu.h
+ * @brief 	Host stand-in for the emlib RMU API, for the simulations in sim/.
+ * 			Only the definitions the simulated modules use.
+ ******************************************************************************/
+
+#ifndef EM_RMU_H
+#define EM_RMU_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum
+{
+	rmuResetBU
+} RMU_Reset_TypeDef;
+
+typedef enum
+{
+	rmuResetModeClear,
+	rmuResetModeSet
+} RMU_ResetMode_TypeDef;
+
+void RMU_ResetControl(RMU_Reset_TypeDef reset, RMU_ResetMode_TypeDef mode);
+
+#endif /* EM_RMU_H */
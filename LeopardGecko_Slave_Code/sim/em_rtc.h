@@ -0,0 +1,109 @@
+/*****************************************************************************
+ * @file 	em_rtc.h
+ * @brief 	Host stand-in for the emlib RTC API, for the simulations in sim/.
+ * 			The calls work on the registers of sim_rtc, which the simulation
+ * 			counts up as its time advances.
+ ******************************************************************************/
+
+#ifndef EM_RTC_H
+#define EM_RTC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "em_device.h"
+
+typedef struct
+{
+	volatile uint32_t CTRL;
+	volatile uint32_t CNT;
+	volatile uint32_t COMP0;
+	volatile uint32_t COMP1;
+	volatile uint32_t IF;
+	volatile uint32_t IFS;
+	volatile uint32_t IFC;
+	volatile uint32_t IEN;
+	volatile uint32_t FREEZE;
+	volatile uint32_t SYNCBUSY;
+} RTC_TypeDef;
+
+#define RTC_CTRL_EN					(0x1UL << 0)
+#define RTC_CTRL_DEBUGRUN			(0x1UL << 1)
+#define RTC_CTRL_COMP0TOP			(0x1UL << 2)
+
+#define RTC_IF_OF					(0x1UL << 0)
+#define RTC_IF_COMP0				(0x1UL << 1)
+#define RTC_IF_COMP1				(0x1UL << 2)
+#define RTC_IFS_COMP0				RTC_IF_COMP0
+#define RTC_IFS_COMP1				RTC_IF_COMP1
+#define RTC_IFC_COMP0				RTC_IF_COMP0
+#define RTC_IFC_COMP1				RTC_IF_COMP1
+#define RTC_IEN_OF					RTC_IF_OF
+#define RTC_IEN_COMP0				RTC_IF_COMP0
+#define RTC_IEN_COMP1				RTC_IF_COMP1
+#define _RTC_IEN_MASK				0x7UL
+#define _RTC_CNT_MASK				0xFFFFFFUL
+
+typedef struct
+{
+	bool						enable;
+	bool						debugRun;
+	bool						comp0Top;
+} RTC_Init_TypeDef;
+
+extern RTC_TypeDef sim_rtc;
+#define RTC							(&sim_rtc)
+
+static inline void RTC_Init(const RTC_Init_TypeDef *init)
+{
+	RTC->CTRL = (init->enable ? RTC_CTRL_EN : 0) | (init->debugRun ? RTC_CTRL_DEBUGRUN : 0) |
+			(init->comp0Top ? RTC_CTRL_COMP0TOP : 0);
+}
+
+static inline void RTC_Enable(bool enable)
+{
+	RTC->CTRL = enable ? (RTC->CTRL | RTC_CTRL_EN) : (RTC->CTRL & ~RTC_CTRL_EN);
+}
+
+static inline uint32_t RTC_CounterGet(void)
+{
+	return RTC->CNT;
+}
+
+static inline void RTC_CounterReset(void)
+{
+	RTC->CNT = 0;
+}
+
+static inline uint32_t RTC_CompareGet(unsigned int comp)
+{
+	return comp ? RTC->COMP1 : RTC->COMP0;
+}
+
+static inline void RTC_CompareSet(unsigned int comp, uint32_t value)
+{
+	if (comp)
+	{
+		RTC->COMP1 = value & _RTC_CNT_MASK;
+	}
+	else
+	{
+		RTC->COMP0 = value & _RTC_CNT_MASK;
+	}
+}
+
+static inline void RTC_IntEnable(uint32_t flags)
+{
+	RTC->IEN |= flags;
+}
+
+static inline void RTC_IntDisable(uint32_t flags)
+{
+	RTC->IEN &= ~flags;
+}
+
+static inline void RTC_IntClear(uint32_t flags)
+{
+	RTC->IF &= ~flags;
+}
+
+#endif /* EM_RTC_H */
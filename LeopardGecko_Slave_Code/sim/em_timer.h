@@ -0,0 +1,75 @@
+/*****************************************************************************
+ * @file 	em_timer.h
+ * @brief 	Host stand-in for the emlib TIMER API, for the simulations in sim/.
+ * 			TIMER0 and TIMER1 go through Sim_TIMER() on every access, so that
+ * 			the simulation can advance the counters.
+ ******************************************************************************/
+
+#ifndef EM_TIMER_H
+#define EM_TIMER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct
+{
+	volatile uint32_t CTRL;
+	volatile uint32_t CMD;
+	volatile uint32_t STATUS;
+	volatile uint32_t IEN;
+	volatile uint32_t IF;
+	volatile uint32_t IFS;
+	volatile uint32_t IFC;
+	volatile uint32_t TOP;
+	volatile uint32_t TOPB;
+	volatile uint32_t CNT;
+} TIMER_TypeDef;
+
+#define TIMER_CMD_START				(0x1UL << 0)
+#define TIMER_CMD_STOP				(0x1UL << 1)
+
+typedef enum
+{
+	timerClkSelHFPerClk,
+	timerClkSelCC1,
+	timerClkSelCascade
+} TIMER_ClkSel_TypeDef;
+
+typedef enum
+{
+	timerInputActionNone,
+	timerInputActionStart,
+	timerInputActionStop,
+	timerInputActionReloadStart
+} TIMER_InputAction_TypeDef;
+
+typedef enum
+{
+	timerModeUp,
+	timerModeDown,
+	timerModeUpDown,
+	timerModeQDec
+} TIMER_Mode_TypeDef;
+
+typedef struct
+{
+	bool						enable;
+	bool						debugRun;
+	uint8_t						prescale;
+	TIMER_ClkSel_TypeDef		clkSel;
+	bool						count2x;
+	bool						ati;
+	TIMER_InputAction_TypeDef	fallAction;
+	TIMER_InputAction_TypeDef	riseAction;
+	TIMER_Mode_TypeDef			mode;
+	bool						dmaClrAct;
+	bool						quadModeX4;
+	bool						oneShot;
+	bool						sync;
+} TIMER_Init_TypeDef;
+
+TIMER_TypeDef *Sim_TIMER(int timer);
+#define TIMER0						(Sim_TIMER(0))
+#define TIMER1						(Sim_TIMER(1))
+
+#endif /* EM_TIMER_H */
@@ -0,0 +1,1418 @@
+/*****************************************************************************
+ * @file 	letouch_sim.c
+ * @brief 	Host simulation of the capacitive touch pads. Runs
+ * 			MCIoT_LESENSE_LETouch.c and MCIoT_Calibration.c against models of
+ * 			LESENSE, its DMA channel, the RTC and the flash, all counting in
+ * 			32768 Hz RTC ticks:
+ * 			- LESENSE scans the used channels every 1/LESENSE_SCAN_FREQUENCY s,
+ * 			  and SAMPLE_DELAY ticks per channel after a LESENSE_ScanStart(),
+ * 			  which is only active SIM_START_SYNC ticks after the call. With
+ * 			  the interrupts masked time passes as LESENSE is polled.
+ * 			  A scan stores the count of each pad, raises the flag of each
+ * 			  channel past its threshold and the scan complete flag.
+ * 			- Once calibrated, the DMA moves every result to the ping-pong
+ * 			  half being filled and calls back when it is full.
+ * 			- The RTC wraps at COMP0 and raises the calibration interrupt.
+ * 			- A flash page erase sets every bit, a write only clears bits.
+ * 			The pad counts drift, ramp, hold and alternate while the RTC
+ * 			calibration runs, and the calibration window is rebuilt from the
+ * 			counts the model scanned. Then 1 to 4 pads are scanned with noise
+ * 			and one of them is touched and released. Then recorded count
+ * 			profiles of touches and glitches are replayed on one of the two
+ * 			pads LESENSE_SetUp() uses, starting anywhere in a scan period.
+ * 			Last, the pads boot from the calibration record: written after a
+ * 			full calibration, taken while the pads and the conditions match,
+ * 			rewritten after they change and rejected when damaged.
+ *
+ * 			Exits non-zero if a channel maximum or minimum differs from the
+ * 			GetMaxValue/GetMinValue search the window used to be kept with,
+ * 			or a threshold from the float calculation it used to be set with,
+ * 			if the core wakes up more than once per DMA batch while no pad
+ * 			changes, if a touch is not confirmed, or confirmed later than a
+ * 			scan period and VALIDATE_CNT back to back scans, if a glitch is
+ * 			taken for a touch, or if a boot settles while the record fits or
+ * 			takes a record that does not.
+ *
+ * 			Build and run from LeopardGecko_Slave_Code, the handlers and
+ * 			deadlines the simulation does not use are left out of the link:
+ *
+ * 			  gcc -O2 -Wall -fcommon -ffunction-sections -Wl,--gc-sections -Isim -Iinc \
+ * 			    -o letouch_sim sim/letouch_sim.c src/MCIoT_LESENSE_LETouch.c \
+ * 			    src/MCIoT_Calibration.c
+ * 			  ./letouch_sim
+ ******************************************************************************/
+
+/************************************ INCLUDES **************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "em_device.h"
+#include "em_cmu.h"
+#include "em_rtc.h"
+#include "em_lesense.h"
+#include "em_acmp.h"
+#include "em_gpio.h"
+#include "em_dma.h"
+#include "em_msc.h"
+#include "MCIoT_main.h"
+#include "MCIoT_CMU.h"
+#include "MCIoT_LESENSE_Main.h"
+#include "MCIoT_LESENSE_LETouch.h"
+#include "MCIoT_ADC.h"
+#include "MCIoT_DMA.h"
+#include "MCIoT_Calibration.h"
+
+/************************************ INCLUDES **************************************/
+
+/************************************* MACROS ***************************************/
+
+/* LF clock ticks before a started scan is active */
+#define SIM_START_SYNC				2
+
+/* Register reads in a polling loop per LF clock tick, at 14 MHz */
+#define SIM_POLLS_PER_TICK			64
+
+/* Time of periodic scan n */
+#define SIM_SCAN_TICK(n)			(((uint64_t)(n) * RTC_FREQ) / LESENSE_SCAN_FREQUENCY)
+
+/* Pad counts stay within this range */
+#define SIM_COUNT_MIN				1000
+#define SIM_COUNT_MAX				60000
+
+/* RTC calibrations the window is checked over */
+#define SIM_CALIBRATIONS			2000
+
+/* Runs of each recorded profile, spread over a scan period */
+#define SIM_PROFILE_RUNS			20
+#define SIM_MAX_EVENTS				16
+
+/* Latency allowed on top of a scan period and the confirm scans, for the
+ * ramps of the recorded profiles */
+#define SIM_LATENCY_MARGIN_US		3000
+
+#define SIM_TICKS_TO_US(ticks)		((uint32_t)(((uint64_t)(ticks) * 1000000) / RTC_FREQ))
+
+/************************************* MACROS ***************************************/
+
+/********************************** ENUMERATIONS ************************************/
+
+/* Pad count at a time of a recorded profile, counts in between are interpolated */
+typedef struct
+{
+	uint32_t	us;
+	uint16_t	count;
+} SIM_POINT;
+
+typedef struct
+{
+	const char			*name;
+	const SIM_POINT		*p_points;
+	uint32_t			num_points;
+	bool				touch;
+	uint32_t			contact_us;		/* Start of the last press ramp */
+	uint32_t			release_us;		/* End of the last release ramp */
+} SIM_PROFILE;
+
+/* Pads touched after a confirmed change */
+typedef struct
+{
+	uint64_t	tick;
+	uint16_t	touched;
+} SIM_EVENT;
+
+/********************************** ENUMERATIONS ************************************/
+
+/************************************ GLOBALS ***************************************/
+
+CMU_TypeDef sim_cmu;
+RTC_TypeDef sim_rtc;
+ACMP_TypeDef sim_acmp[2];
+
+static LESENSE_TypeDef sim_lesense;
+static uint32_t sim_seed = 0x1D872B41;
+static int sim_failures;
+
+/* Time in RTC ticks, the next periodic scan and the end of a started scan */
+static uint64_t sim_now;
+static uint64_t sim_next_scan;
+static uint64_t sim_scan_done;
+static uint64_t sim_scan_active_at;
+static bool sim_scan_started;
+static bool sim_core_masked;
+static uint32_t sim_polls;
+static uint32_t sim_periodic_scans;
+
+/* Count each pad returns and how it changes from scan to scan */
+static uint16_t sim_pad_count[NUM_LESENSE_CHANNELS];
+static uint16_t sim_pad_touched;
+static uint8_t sim_pad_mode[NUM_LESENSE_CHANNELS];
+static uint8_t sim_pad_mode_scans[NUM_LESENSE_CHANNELS];
+static int16_t sim_pad_step[NUM_LESENSE_CHANNELS];
+
+/* DMA ping-pong halves and the highest count of each channel moved to them */
+static DMA_CB_TypeDef *sim_dma_cb;
+static volatile uint16_t *sim_dma_dst[2];
+static bool sim_dma_enabled;
+static bool sim_dma_primary;
+static uint32_t sim_dma_index;
+static uint16_t sim_dma_max[NUM_LESENSE_CHANNELS];
+static uint16_t sim_batch_max[NUM_LESENSE_CHANNELS];
+static bool sim_batch_ready;
+
+/* Core wakeups */
+static uint32_t sim_dma_batches;
+static uint32_t sim_lesense_irqs;
+
+/* Calibration window rebuilt from the counts scanned */
+static uint16_t sim_window[NUM_LESENSE_CHANNELS][NUMBER_OF_CALIBRATION_VALUES];
+static uint32_t sim_window_samples;
+static uint16_t sim_threshold_q8[NUM_LESENSE_CHANNELS];
+static uint32_t sim_window_checks;
+static uint32_t sim_window_mismatches;
+static uint32_t sim_threshold_mismatches;
+
+static uint32_t sim_touch_events;
+
+/* Called before every scan to set the pad counts, NULL to keep them */
+static void (*sim_pad_at_scan)(void);
+
+/* Profile being replayed, on which pad and from when */
+static const SIM_PROFILE *sim_profile;
+static uint16_t sim_profile_pad;
+static uint64_t sim_profile_start;
+
+static SIM_EVENT sim_events[SIM_MAX_EVENTS];
+static uint32_t sim_num_events;
+
+/* Flash the calibration record is kept in, erased on every page erase and
+ * only cleared bit by bit on a write */
+uint32_t sim_flash[FLASH_SIZE / sizeof(uint32_t)];
+static bool sim_msc_open;
+static bool sim_msc_reset_after_erase;
+static uint32_t sim_flash_erases;
+static uint32_t sim_flash_writes;
+static uint32_t sim_flash_overwrites;
+
+/* Pad counts of a tap, a two second hold, a touch just past the threshold, a
+ * press and a release that bounce, a 1 ms spike, a 3.5 ms dip, a burst of
+ * 5 ms dips and a slow drift over two minutes */
+static const SIM_POINT sim_tap[] =
+{
+	{ 0, 20000 }, { 2000, 14000 }, { 250000, 14000 }, { 252000, 20000 }
+};
+
+static const SIM_POINT sim_hold[] =
+{
+	{ 0, 20000 }, { 2000, 14500 }, { 500000, 14000 }, { 1000000, 14800 }, { 1500000, 14200 },
+	{ 2000000, 14500 }, { 2002000, 20000 }
+};
+
+static const SIM_POINT sim_light[] =
+{
+	{ 0, 20000 }, { 2000, 19700 }, { 1000000, 19700 }, { 1002000, 20000 }
+};
+
+static const SIM_POINT sim_bouncy[] =
+{
+	{ 0, 20000 }, { 1000, 14000 }, { 4000, 14000 }, { 5000, 20000 }, { 7000, 20000 }, { 8000, 14000 },
+	{ 10000, 14000 }, { 11000, 20000 }, { 12000, 20000 }, { 14000, 14000 }, { 500000, 14000 },
+	{ 501000, 20000 }, { 503000, 20000 }, { 504000, 14000 }, { 506000, 14000 }, { 508000, 20000 }
+};
+
+static const SIM_POINT sim_spike[] =
+{
+	{ 0, 20000 }, { 100, 10000 }, { 900, 10000 }, { 1000, 20000 }
+};
+
+static const SIM_POINT sim_dip[] =
+{
+	{ 0, 20000 }, { 500, 16000 }, { 3000, 16000 }, { 3500, 20000 }
+};
+
+#define SIM_BURST_DIP(n)	{ (n) * 10000, 20000 }, { (n) * 10000 + 200, 17000 }, \
+							{ (n) * 10000 + 4800, 17000 }, { (n) * 10000 + 5000, 20000 }
+
+static const SIM_POINT sim_burst[] =
+{
+	SIM_BURST_DIP(0), SIM_BURST_DIP(1), SIM_BURST_DIP(2), SIM_BURST_DIP(3), SIM_BURST_DIP(4),
+	SIM_BURST_DIP(5), SIM_BURST_DIP(6), SIM_BURST_DIP(7), SIM_BURST_DIP(8), SIM_BURST_DIP(9)
+};
+
+static const SIM_POINT sim_drift[] =
+{
+	{ 0, 20000 }, { 120000000, 19850 }, { 120000001, 20000 }
+};
+
+#define SIM_POINTS(points)	(points), (sizeof(points) / sizeof((points)[0]))
+
+static const SIM_PROFILE sim_profiles[] =
+{
+	{ "tap 250 ms", SIM_POINTS(sim_tap), true, 0, 252000 },
+	{ "hold 2 s", SIM_POINTS(sim_hold), true, 0, 2002000 },
+	{ "light 1.5%", SIM_POINTS(sim_light), true, 0, 1002000 },
+	{ "bouncy", SIM_POINTS(sim_bouncy), true, 12000, 508000 },
+	{ "spike 1 ms", SIM_POINTS(sim_spike), false, 0, 0 },
+	{ "dip 3.5 ms", SIM_POINTS(sim_dip), false, 0, 0 },
+	{ "5 ms dip burst", SIM_POINTS(sim_burst), false, 0, 0 },
+	{ "drift 0.75%", SIM_POINTS(sim_drift), false, 0, 0 }
+};
+
+/************************************ GLOBALS ***************************************/
+
+/* Not declared by MCIoT_LESENSE_LETouch.h */
+void RTC_IRQHandler(void);
+
+static void Sim_Scan(void);
+
+/************************************************************************************
+ * @function 	Sim_Check
+ * @params 		[in] ok - result of the check
+ * 				[in] what - description of the check
+ * @brief 		Records a failed check.
+ ************************************************************************************/
+static void Sim_Check(bool ok, const char *what)
+{
+	if (!ok)
+	{
+		printf("FAIL: %s\n", what);
+		sim_failures++;
+	}
+}
+
+/************************************************************************************
+ * @function 	Sim_Random
+ * @params 		[in] range - number of values
+ * @brief 		Returns a pseudo random value below range, the same on every run.
+ ************************************************************************************/
+static uint32_t Sim_Random(uint32_t range)
+{
+	sim_seed = sim_seed * 1103515245 + 12345;
+	return ((sim_seed >> 8) % range);
+}
+
+/************************************************************************************
+ * @function 	GetMaxValue, GetMinValue
+ * @brief 		The window search MCIoT_LESENSE_LETouch.c used before the deques.
+ ************************************************************************************/
+static uint16_t GetMaxValue(volatile uint16_t* A, uint16_t N)
+{
+	int i;
+	uint16_t max = 0;
+
+	for(i=0; i<N; i++)
+	{
+		if(max < A[i])
+		{
+			max = A[i];
+		}
+	}
+	return max;
+}
+
+static uint16_t GetMinValue(volatile uint16_t* A, uint16_t N)
+{
+	int i;
+	uint16_t min = 0xffff;
+
+	for(i=0; i<N; i++)
+	{
+		if(A[i] < min)
+		{
+			min = A[i];
+		}
+	}
+	return min;
+}
+
+/************************************************************************************
+ * Stubbed emlib calls
+ ************************************************************************************/
+LESENSE_TypeDef *Sim_LESENSE(void)
+{
+	/* With the interrupts masked LESENSE can only be polled, time passes
+	 * with the polls */
+	if (sim_core_masked && sim_scan_started && ((++sim_polls % SIM_POLLS_PER_TICK) == 0))
+	{
+		sim_now++;
+		if (sim_now >= sim_scan_done)
+		{
+			Sim_Scan();
+		}
+	}
+
+	if (sim_scan_started && (sim_now >= sim_scan_active_at))
+	{
+		sim_lesense.STATUS |= LESENSE_STATUS_SCANACTIVE;
+	}
+
+	return &sim_lesense;
+}
+
+uint32_t Sim_Core_Enter(void)
+{
+	uint32_t state = sim_core_masked;
+
+	sim_core_masked = true;
+	return state;
+}
+
+void Sim_Core_Exit(uint32_t state)
+{
+	sim_core_masked = (state != 0);
+
+	/* Flags raised while masked interrupt now */
+	if (!sim_core_masked && (LESENSE_IntGetEnabled() != 0))
+	{
+		sim_lesense_irqs++;
+		LESENSE_IRQHandler();
+	}
+}
+
+void NVIC_EnableIRQ(IRQn_Type irq)
+{
+	(void)irq;
+}
+
+void NVIC_DisableIRQ(IRQn_Type irq)
+{
+	(void)irq;
+}
+
+void NVIC_ClearPendingIRQ(IRQn_Type irq)
+{
+	(void)irq;
+}
+
+void SystemCoreClockUpdate(void)
+{
+}
+
+void GPIO_PinModeSet(GPIO_Port_TypeDef port, unsigned int pin, GPIO_Mode_TypeDef mode, unsigned int out)
+{
+	(void)port;
+	(void)pin;
+	(void)mode;
+	(void)out;
+}
+
+void ACMP_CapsenseInit(ACMP_TypeDef *acmp, const ACMP_CapsenseInit_TypeDef *init)
+{
+	(void)acmp;
+	(void)init;
+}
+
+void LESENSE_Init(const LESENSE_Init_TypeDef *init, bool reqReset)
+{
+	(void)init;
+	if (reqReset)
+	{
+		memset(&sim_lesense, 0, sizeof(sim_lesense));
+	}
+}
+
+void LESENSE_ChannelConfig(const LESENSE_ChDesc_TypeDef *confCh, uint32_t chIdx)
+{
+	sim_lesense.CHEN |= confCh->enaScanCh ? (1 << chIdx) : 0;
+	sim_lesense.IEN |= confCh->enaInt ? (1 << chIdx) : 0;
+	sim_lesense.CH[chIdx].EVAL = confCh->cntThres |
+			((confCh->compMode == lesenseCompModeGreaterOrEq) ? LESENSE_CH_EVAL_COMP : 0);
+}
+
+uint32_t LESENSE_ScanFreqSet(uint32_t refFreq, uint32_t scanFreq)
+{
+	(void)refFreq;
+	return scanFreq;
+}
+
+void LESENSE_ClkDivSet(LESENSE_ChClk_TypeDef clk, LESENSE_ClkPresc_TypeDef clkDiv)
+{
+	(void)clk;
+	(void)clkDiv;
+}
+
+void LESENSE_ScanStart(void)
+{
+	/* The start is synchronized to the LF clock before the scan is active */
+	if (!sim_scan_started && ((sim_lesense.STATUS & LESENSE_STATUS_SCANACTIVE) == 0))
+	{
+		sim_scan_started = true;
+		sim_scan_active_at = sim_now + SIM_START_SYNC;
+		sim_scan_done = sim_scan_active_at + __builtin_popcount(sim_lesense.CHEN) * SAMPLE_DELAY;
+	}
+}
+
+void LESENSE_ChannelThresSet(uint8_t chIdx, uint16_t acmpThres, uint16_t cntThres)
+{
+	sim_lesense.CH[chIdx].EVAL = (sim_lesense.CH[chIdx].EVAL & ~_LESENSE_CH_EVAL_COMPTHRES_MASK) | cntThres;
+	(void)acmpThres;
+}
+
+void LESENSE_ResultBufferClear(void)
+{
+	sim_lesense.PTR = 0;
+}
+
+uint32_t LESENSE_ScanResultDataBufferGet(uint32_t idx)
+{
+	return sim_lesense.BUF[idx].DATA;
+}
+
+void DMA_CfgChannel(unsigned int channel, DMA_CfgChannel_TypeDef *cfg)
+{
+	if (channel == DMA_CHANNEL_LESENSE)
+	{
+		sim_dma_cb = cfg->cb;
+	}
+}
+
+void DMA_CfgDescr(unsigned int channel, bool primary, DMA_CfgDescr_TypeDef *cfg)
+{
+	(void)channel;
+	(void)primary;
+	(void)cfg;
+}
+
+void DMA_ActivatePingPong(unsigned int channel, bool useBurst,
+		void *primDst, void *primSrc, unsigned int primNMinus1,
+		void *altDst, void *altSrc, unsigned int altNMinus1)
+{
+	(void)useBurst;
+	(void)primSrc;
+	(void)altSrc;
+	Sim_Check((primNMinus1 == LESENSE_DMA_BATCH_ENTRIES - 1) && (altNMinus1 == LESENSE_DMA_BATCH_ENTRIES - 1),
+			"DMA halves of LESENSE_DMA_BATCH_ENTRIES results");
+
+	sim_dma_dst[0] = primDst;
+	sim_dma_dst[1] = altDst;
+	sim_dma_enabled = (channel == DMA_CHANNEL_LESENSE);
+	sim_dma_primary = true;
+	sim_dma_index = 0;
+	memset(sim_dma_max, 0, sizeof(sim_dma_max));
+}
+
+void MSC_Init(void)
+{
+	sim_msc_open = true;
+}
+
+void MSC_Deinit(void)
+{
+	sim_msc_open = false;
+}
+
+MSC_Status_TypeDef MSC_ErasePage(uint32_t *startAddress)
+{
+	uint32_t offset = (uint32_t)((uintptr_t)startAddress - FLASH_BASE);
+
+	if (!sim_msc_open)
+	{
+		return mscReturnLocked;
+	}
+	if ((offset >= FLASH_SIZE) || (offset % FLASH_PAGE_SIZE) != 0)
+	{
+		return mscReturnInvalidAddr;
+	}
+
+	memset(startAddress, 0xFF, FLASH_PAGE_SIZE);
+	sim_flash_erases++;
+
+	return mscReturnOk;
+}
+
+MSC_Status_TypeDef MSC_WriteWord(uint32_t *address, void const *data, uint32_t numBytes)
+{
+	uint32_t offset = (uint32_t)((uintptr_t)address - FLASH_BASE);
+	uint32_t word;
+	uint32_t i;
+
+	if (!sim_msc_open)
+	{
+		return mscReturnLocked;
+	}
+	if ((offset % sizeof(uint32_t)) != 0 || (numBytes % sizeof(uint32_t)) != 0)
+	{
+		return mscReturnUnaligned;
+	}
+	if ((offset + numBytes) > FLASH_SIZE)
+	{
+		return mscReturnInvalidAddr;
+	}
+
+	/* The reset lands between the erase and the write */
+	if (sim_msc_reset_after_erase)
+	{
+		sim_msc_open = false;
+		return mscReturnTimeOut;
+	}
+
+	for (i = 0; i < numBytes / sizeof(uint32_t); i++)
+	{
+		memcpy(&word, (const uint8_t *)data + i * sizeof(uint32_t), sizeof(uint32_t));
+		if (address[i] != 0xFFFFFFFF)
+		{
+			sim_flash_overwrites++;
+		}
+
+		/* Programming only clears bits */
+		address[i] &= word;
+	}
+	sim_flash_writes++;
+
+	return mscReturnOk;
+}
+
+void DMA_RefreshPingPong(unsigned int channel, bool primary, bool useBurst,
+		void *dst, void *src, unsigned int nMinus1, bool stop)
+{
+	(void)channel;
+	(void)primary;
+	(void)useBurst;
+	(void)dst;
+	(void)src;
+	(void)nMinus1;
+	(void)stop;
+}
+
+/************************************************************************************
+ * Stubbed application calls
+ ************************************************************************************/
+bool CMU_Consumer_Start(CMU_CONSUMERS e_consumer)
+{
+	(void)e_consumer;
+	return true;
+}
+
+void CMU_Consumer_Stop(CMU_CONSUMERS e_consumer)
+{
+	(void)e_consumer;
+}
+
+void LESENSE_Auth_Touch_Event(uint16_t channels_touched, uint32_t elapsed_rtc_ticks)
+{
+	(void)elapsed_rtc_ticks;
+	sim_touch_events++;
+
+	if (sim_num_events < SIM_MAX_EVENTS)
+	{
+		sim_events[sim_num_events].tick = sim_now;
+		sim_events[sim_num_events].touched = channels_touched;
+		sim_num_events++;
+	}
+}
+
+void LESENSE_Auth_Timeout_Event(void)
+{
+}
+
+void Power_RTC_IRQHandler(void)
+{
+}
+
+/************************************************************************************
+ * @function 	Sim_Window_Push
+ * @params 		[in] p_counts - count of each channel, indexed by channel
+ * @brief 		Adds a sample to the rebuilt window, then checks the window
+ * 				maximum, minimum and threshold of every used channel.
+ ************************************************************************************/
+static void Sim_Window_Push(const uint16_t *p_counts)
+{
+	uint16_t max_value;
+	uint16_t min_value;
+	uint16_t threshold;
+	uint32_t filled;
+	uint8_t i;
+
+	filled = (sim_window_samples < NUMBER_OF_CALIBRATION_VALUES) ? sim_window_samples + 1 : NUMBER_OF_CALIBRATION_VALUES;
+
+	for (i = 0; i < NUM_LESENSE_CHANNELS; i++)
+	{
+		if (sim_threshold_q8[i] == 0)
+		{
+			continue;
+		}
+
+		sim_window[i][sim_window_samples % NUMBER_OF_CALIBRATION_VALUES] = p_counts[i];
+
+		/* The slots not filled yet used to count as 0 */
+		max_value = GetMaxValue(sim_window[i], filled);
+		min_value = GetMinValue(sim_window[i], filled);
+		threshold = (uint16_t)(max_value - ((max_value * (float)(sim_threshold_q8[i] / (float)LETOUCH_THRESHOLD_Q8_ONE)) / 100.0));
+
+		sim_window_checks++;
+		if ((LETOUCH_GetChannelMaxValue(i) != max_value) || (LETOUCH_GetChannelMinValue(i) != min_value))
+		{
+			sim_window_mismatches++;
+		}
+		if ((sim_lesense.CH[i].EVAL & _LESENSE_CH_EVAL_COMPTHRES_MASK) != threshold)
+		{
+			sim_threshold_mismatches++;
+		}
+	}
+
+	sim_window_samples++;
+}
+
+/************************************************************************************
+ * @function 	Sim_Pad_Drift
+ * @params 		None
+ * @brief 		Moves every used pad count on by one scan. Each pad holds a count,
+ * 				ramps up or down, alternates between two counts or jumps around
+ * 				its count for a random number of scans.
+ ************************************************************************************/
+static void Sim_Pad_Drift(void)
+{
+	int32_t count;
+	uint8_t i;
+
+	for (i = 0; i < NUM_LESENSE_CHANNELS; i++)
+	{
+		if (sim_threshold_q8[i] == 0)
+		{
+			continue;
+		}
+
+		if (sim_pad_mode_scans[i] == 0)
+		{
+			sim_pad_mode[i] = Sim_Random(5);
+			sim_pad_mode_scans[i] = 5 + Sim_Random(60);
+			sim_pad_step[i] = 1 + Sim_Random(300);
+		}
+		sim_pad_mode_scans[i]--;
+
+		count = sim_pad_count[i];
+		switch (sim_pad_mode[i])
+		{
+		case 0: break;
+		case 1: count += sim_pad_step[i]; break;
+		case 2: count -= sim_pad_step[i]; break;
+		case 3: count += (sim_pad_mode_scans[i] & 1) ? sim_pad_step[i] : -sim_pad_step[i]; break;
+		default: count += (int32_t)Sim_Random(2 * sim_pad_step[i] + 1) - sim_pad_step[i]; break;
+		}
+
+		if (count < SIM_COUNT_MIN)
+		{
+			count = SIM_COUNT_MIN;
+		}
+		if (count > SIM_COUNT_MAX)
+		{
+			count = SIM_COUNT_MAX;
+		}
+		sim_pad_count[i] = (uint16_t)count;
+	}
+}
+
+/************************************************************************************
+ * @function 	Sim_Pad_Noise
+ * @params 		None
+ * @brief 		Every used pad reads 20000 counts, 14000 while touched, with up to
+ * 				50 counts of noise. The noise stays within a 1 percent threshold.
+ ************************************************************************************/
+static void Sim_Pad_Noise(void)
+{
+	uint8_t i;
+
+	for (i = 0; i < NUM_LESENSE_CHANNELS; i++)
+	{
+		if (sim_threshold_q8[i] != 0)
+		{
+			sim_pad_count[i] = ((sim_pad_touched & (1 << i)) ? 14000 : 20000) + Sim_Random(101) - 50;
+		}
+	}
+}
+
+/************************************************************************************
+ * @function 	Sim_DMA_Result
+ * @params 		[in] channel - channel of the result
+ * 				[in] count - the result
+ * @brief 		Moves one result to the ping-pong half being filled, and calls
+ * 				back when the half is full.
+ ************************************************************************************/
+static void Sim_DMA_Result(uint8_t channel, uint16_t count)
+{
+	sim_dma_dst[sim_dma_primary ? 0 : 1][sim_dma_index] = count;
+	if (count > sim_dma_max[channel])
+	{
+		sim_dma_max[channel] = count;
+	}
+
+	if (++sim_dma_index < LESENSE_DMA_BATCH_ENTRIES)
+	{
+		return;
+	}
+
+	sim_dma_batches++;
+	memcpy(sim_batch_max, sim_dma_max, sizeof(sim_batch_max));
+	memset(sim_dma_max, 0, sizeof(sim_dma_max));
+	sim_batch_ready = true;
+
+	sim_dma_index = 0;
+	sim_dma_primary = !sim_dma_primary;
+	sim_dma_cb->cbFunc(DMA_CHANNEL_LESENSE, !sim_dma_primary, sim_dma_cb->userPtr);
+}
+
+/************************************************************************************
+ * @function 	Sim_Scan
+ * @params 		None
+ * @brief 		One LESENSE scan of the used channels, lowest channel first.
+ ************************************************************************************/
+static void Sim_Scan(void)
+{
+	uint32_t write;
+	uint32_t threshold;
+	uint16_t count;
+	bool settling = !LETOUCH_IsCalibrated();
+	bool past;
+	uint8_t i;
+
+	sim_scan_started = false;
+
+	if (sim_pad_at_scan != NULL)
+	{
+		sim_pad_at_scan();
+	}
+
+	for (i = 0; i < NUM_LESENSE_CHANNELS; i++)
+	{
+		if ((sim_lesense.CHEN & (1 << i)) == 0)
+		{
+			continue;
+		}
+
+		count = sim_pad_count[i];
+		if (sim_dma_enabled)
+		{
+			Sim_DMA_Result(i, count);
+		}
+		else
+		{
+			write = (sim_lesense.PTR & _LESENSE_PTR_WR_MASK) >> _LESENSE_PTR_WR_SHIFT;
+			sim_lesense.BUF[write].DATA = count;
+			write = (write + 1) % NUM_LESENSE_CHANNELS;
+			sim_lesense.PTR = (sim_lesense.PTR & ~_LESENSE_PTR_WR_MASK) | (write << _LESENSE_PTR_WR_SHIFT);
+		}
+
+		/* Below the threshold, or at or above it once the comparison is inverted */
+		threshold = sim_lesense.CH[i].EVAL & _LESENSE_CH_EVAL_COMPTHRES_MASK;
+		past = (sim_lesense.CH[i].EVAL & LESENSE_CH_EVAL_COMP) ? (count >= threshold) : (count < threshold);
+		if (past)
+		{
+			sim_lesense.IF |= (1 << i);
+		}
+	}
+
+	sim_lesense.STATUS &= ~LESENSE_STATUS_SCANACTIVE;
+	sim_lesense.IF |= LESENSE_IF_SCANCOMPLETE;
+
+	/* Each settling scan is taken into the window */
+	if (settling && (sim_lesense.IEN & LESENSE_IEN_SCANCOMPLETE))
+	{
+		sim_lesense_irqs++;
+		LESENSE_IRQHandler();
+		Sim_Window_Push(sim_pad_count);
+	}
+	else if (!sim_core_masked && (LESENSE_IntGetEnabled() != 0))
+	{
+		sim_lesense_irqs++;
+		LESENSE_IRQHandler();
+	}
+}
+
+/************************************************************************************
+ * @function 	Sim_RTC_Match
+ * @params 		None
+ * @brief 		The RTC reached COMP0. The calibration takes the highest count of
+ * 				each channel in the last DMA batch, if one completed since the
+ * 				last calibration.
+ ************************************************************************************/
+static void Sim_RTC_Match(void)
+{
+	bool batch_ready = sim_batch_ready;
+
+	sim_rtc.IF |= RTC_IF_COMP0;
+	sim_rtc.CNT = 0;
+
+	if (sim_rtc.IEN & RTC_IEN_COMP0)
+	{
+		sim_batch_ready = false;
+		RTC_IRQHandler();
+		if (batch_ready)
+		{
+			Sim_Window_Push(sim_batch_max);
+		}
+	}
+}
+
+/************************************************************************************
+ * @function 	Sim_Run
+ * @params 		[in] ticks - RTC ticks to run for
+ * 				[in] p_drift - called before each periodic scan, NULL to keep the
+ * 				pad counts
+ * @brief 		Runs the periodic scans, the started scans and the RTC in the
+ * 				order they are due.
+ ************************************************************************************/
+static void Sim_Run(uint64_t ticks, void (*p_drift)(void))
+{
+	uint64_t end = sim_now + ticks;
+	uint64_t next;
+	uint64_t rtc_match;
+	bool rtc_running;
+
+	while (sim_now < end)
+	{
+		rtc_running = (sim_rtc.CTRL & RTC_CTRL_EN) != 0;
+		rtc_match = sim_now + (sim_rtc.COMP0 - sim_rtc.CNT);
+
+		next = sim_next_scan;
+		if (sim_scan_started && (sim_scan_done < next))
+		{
+			next = sim_scan_done;
+		}
+		if (rtc_running && (rtc_match < next))
+		{
+			next = rtc_match;
+		}
+		if (next > end)
+		{
+			next = end;
+		}
+
+		if (rtc_running)
+		{
+			sim_rtc.CNT += (uint32_t)(next - sim_now);
+		}
+		sim_now = next;
+
+		if (rtc_running && (sim_rtc.CNT >= sim_rtc.COMP0))
+		{
+			Sim_RTC_Match();
+		}
+		else if (sim_scan_started && (sim_now == sim_scan_done))
+		{
+			Sim_Scan();
+		}
+		else if (sim_now == sim_next_scan)
+		{
+			/* No periodic scan starts while a started one runs */
+			sim_next_scan = SIM_SCAN_TICK(++sim_periodic_scans);
+			if (!sim_scan_started && ((sim_lesense.STATUS & LESENSE_STATUS_SCANACTIVE) == 0))
+			{
+				if (p_drift != NULL)
+				{
+					p_drift();
+				}
+				sim_lesense.STATUS |= LESENSE_STATUS_SCANACTIVE;
+				Sim_Scan();
+			}
+		}
+	}
+}
+
+/************************************************************************************
+ * @function 	Sim_Start
+ * @params 		[in] p_threshold_q8 - threshold of each channel, 0 if not used
+ * 				[in] count - count of every pad while the calibration settles
+ * @brief 		Resets the models, initializes the touch pads and runs the
+ * 				settling scans, if the calibration record does not replace them.
+ ************************************************************************************/
+static void Sim_Start(const uint16_t *p_threshold_q8, uint16_t count)
+{
+	uint8_t i;
+
+	memset(&sim_rtc, 0, sizeof(sim_rtc));
+	sim_dma_enabled = false;
+	sim_batch_ready = false;
+	sim_window_samples = 0;
+	sim_now = 0;
+	sim_scan_started = false;
+	sim_periodic_scans = 0;
+	sim_next_scan = SIM_SCAN_TICK(1);
+
+	for (i = 0; i < NUM_LESENSE_CHANNELS; i++)
+	{
+		sim_threshold_q8[i] = p_threshold_q8[i];
+		sim_pad_count[i] = count;
+		sim_pad_mode_scans[i] = 0;
+	}
+
+	LETOUCH_Init(p_threshold_q8);
+
+	/* Seeded from the calibration record, without settling scans */
+	if (LETOUCH_IsCalibrated())
+	{
+		for (i = 0; i < NUMBER_OF_CALIBRATION_VALUES; i++)
+		{
+			Sim_Window_Push(calibration_record.baseline);
+		}
+	}
+
+	/* Back to back settling scans, 30 ms per 100 channel scans */
+	Sim_Run(RTC_FREQ, NULL);
+	Sim_Check(LETOUCH_IsCalibrated() && sim_dma_enabled && (sim_rtc.CTRL & RTC_CTRL_EN),
+			"calibrated within a second, the DMA and the RTC running");
+}
+
+/************************************************************************************
+ * @function 	Sim_Window
+ * @params 		None
+ * @brief 		Runs the settling scans with drifting pads, then the RTC
+ * 				calibration for SIM_CALIBRATIONS intervals on three channels,
+ * 				batches not aligned with the scans.
+ ************************************************************************************/
+static void Sim_Window(void)
+{
+	uint16_t threshold_q8[NUM_LESENSE_CHANNELS] = { 0 };
+	uint32_t settle_checks;
+	uint8_t i;
+
+	threshold_q8[2] = LETOUCH_THRESHOLD_Q8_ONE;
+	threshold_q8[8] = 12 * LETOUCH_THRESHOLD_Q8_ONE + LETOUCH_THRESHOLD_Q8_ONE / 2;
+	threshold_q8[11] = 845;
+
+	sim_window_checks = 0;
+	sim_window_mismatches = 0;
+	sim_threshold_mismatches = 0;
+
+	Sim_Start(threshold_q8, 20000);
+	settle_checks = sim_window_checks;
+
+	/* Pads drift from different counts */
+	for (i = 0; i < NUM_LESENSE_CHANNELS; i++)
+	{
+		sim_pad_count[i] = 5000 + Sim_Random(50000);
+	}
+	Sim_Run((uint64_t)SIM_CALIBRATIONS * CALIBRATION_INTERVAL * RTC_FREQ, Sim_Pad_Drift);
+
+	printf("  %u settling scans and %u RTC calibrations on 3 channels, %u touch events: "
+			"%u max/min and %u threshold mismatches in %u checks\n", settle_checks / 3,
+			(sim_window_checks - settle_checks) / 3, sim_touch_events, sim_window_mismatches,
+			sim_threshold_mismatches, sim_window_checks);
+
+	Sim_Check(settle_checks == 3 * NUMBER_OF_CALIBRATION_VALUES * 10, "every settling scan taken into the window");
+	Sim_Check(sim_window_checks - settle_checks >= 3 * SIM_CALIBRATIONS / 2, "RTC calibrations take the DMA batches");
+	Sim_Check(sim_window_mismatches == 0, "window max/min as GetMaxValue/GetMinValue");
+	Sim_Check(sim_threshold_mismatches == 0, "threshold as the float calculation");
+}
+
+/************************************************************************************
+ * @function 	Sim_Batches
+ * @params 		None
+ * @brief 		Scans 1 to 4 pads for a minute without a touch, batches ending
+ * 				anywhere in a scan, then touches and releases the first one.
+ ************************************************************************************/
+static void Sim_Batches(void)
+{
+	static const uint16_t pad_sets[] =
+	{
+		(1 << 5),
+		(1 << 2) | (1 << 8),
+		(1 << 0) | (1 << 7) | (1 << 15),
+		(1 << 1) | (1 << 3) | (1 << 9) | (1 << 12)
+	};
+	uint16_t threshold_q8[NUM_LESENSE_CHANNELS];
+	uint32_t num_pads;
+	uint32_t scans;
+	uint32_t idle_batches;
+	uint32_t idle_irqs;
+	uint32_t press_irqs;
+	uint32_t release_irqs;
+	uint32_t calibrations;
+	uint16_t pad;
+	bool pressed;
+	bool released;
+	uint8_t n;
+	uint8_t i;
+
+	for (n = 0; n < sizeof(pad_sets) / sizeof(pad_sets[0]); n++)
+	{
+		for (i = 0; i < NUM_LESENSE_CHANNELS; i++)
+		{
+			threshold_q8[i] = (pad_sets[n] & (1 << i)) ? LETOUCH_THRESHOLD_Q8_ONE : 0;
+		}
+		num_pads = __builtin_popcount(pad_sets[n]);
+		pad = pad_sets[n] & -pad_sets[n];
+
+		sim_pad_touched = 0;
+		Sim_Start(threshold_q8, 20000);
+
+		/* A minute untouched */
+		scans = sim_periodic_scans;
+		sim_dma_batches = 0;
+		sim_lesense_irqs = 0;
+		sim_window_checks = 0;
+		sim_window_mismatches = 0;
+		sim_threshold_mismatches = 0;
+		Sim_Run(60 * RTC_FREQ, Sim_Pad_Noise);
+		scans = sim_periodic_scans - scans;
+		idle_batches = sim_dma_batches;
+		idle_irqs = sim_lesense_irqs;
+		calibrations = sim_window_checks / num_pads;
+
+		/* Touched for 2 s, then released */
+		sim_lesense_irqs = 0;
+		sim_pad_touched = pad;
+		Sim_Run(2 * RTC_FREQ, Sim_Pad_Noise);
+		pressed = (LETOUCH_GetChannelsTouched() == pad);
+		press_irqs = sim_lesense_irqs;
+
+		sim_lesense_irqs = 0;
+		sim_pad_touched = 0;
+		Sim_Run(2 * RTC_FREQ, Sim_Pad_Noise);
+		released = (LETOUCH_GetChannelsTouched() == 0);
+		release_irqs = sim_lesense_irqs;
+
+		printf("  %u pads, %u scans: %u DMA batches, %u LESENSE wakeups, %u calibrations with %u mismatches; "
+				"touch %s after %u LESENSE wakeups, release %s after %u\n", num_pads, scans, idle_batches,
+				idle_irqs, calibrations, sim_window_mismatches + sim_threshold_mismatches,
+				pressed ? "confirmed" : "NOT CONFIRMED", press_irqs, released ? "confirmed" : "NOT CONFIRMED",
+				release_irqs);
+
+		Sim_Check((idle_batches + 1 >= scans * num_pads / LESENSE_DMA_BATCH_ENTRIES) &&
+				(idle_batches <= scans * num_pads / LESENSE_DMA_BATCH_ENTRIES + 1),
+				"one DMA batch per LESENSE_DMA_BATCH_ENTRIES results");
+		Sim_Check(idle_irqs == 0, "no LESENSE wakeup while no pad changes");
+		Sim_Check((calibrations == 60 / CALIBRATION_INTERVAL) && (sim_window_mismatches == 0) &&
+				(sim_threshold_mismatches == 0), "batch maximum calibrates every pad");
+		Sim_Check(pressed && (press_irqs <= VALIDATE_CNT + 1), "touch confirmed, one wakeup per scan until then");
+		Sim_Check(released && (release_irqs <= VALIDATE_CNT + 1), "release confirmed, one wakeup per scan until then");
+	}
+}
+
+/************************************************************************************
+ * @function 	Sim_Pad_Profile
+ * @params 		None
+ * @brief 		Sets the counts of the used pads at the time of the scan, the
+ * 				pad the profile is replayed on from the profile, with up to 50
+ * 				counts of noise.
+ ************************************************************************************/
+static void Sim_Pad_Profile(void)
+{
+	const SIM_POINT *p_points = sim_profile->p_points;
+	uint32_t us = 0;
+	uint32_t n;
+	int32_t count = 20000;
+	uint8_t i;
+
+	if (sim_now >= sim_profile_start)
+	{
+		us = SIM_TICKS_TO_US(sim_now - sim_profile_start);
+		count = p_points[sim_profile->num_points - 1].count;
+
+		for (n = 1; n < sim_profile->num_points; n++)
+		{
+			if (us < p_points[n].us)
+			{
+				count = p_points[n - 1].count + ((int32_t)p_points[n].count - p_points[n - 1].count) *
+						(int32_t)(us - p_points[n - 1].us) / (int32_t)(p_points[n].us - p_points[n - 1].us);
+				break;
+			}
+		}
+	}
+
+	for (i = 0; i < NUM_LESENSE_CHANNELS; i++)
+	{
+		if (sim_threshold_q8[i] != 0)
+		{
+			sim_pad_count[i] = ((i == sim_profile_pad) ? count : 20000) + Sim_Random(101) - 50;
+		}
+	}
+}
+
+/************************************************************************************
+ * @function 	Sim_Debounce
+ * @params 		None
+ * @brief 		Replays each recorded profile SIM_PROFILE_RUNS times on pad 8 or
+ * 				11, starting at a different point of the scan period each time,
+ * 				and measures when the touch events arrive.
+ ************************************************************************************/
+static void Sim_Debounce(void)
+{
+	uint16_t threshold_q8[NUM_LESENSE_CHANNELS] = { 0 };
+	uint32_t period = (uint32_t)SIM_SCAN_TICK(1);
+	uint32_t max_latency_us;
+	uint32_t latency_us;
+	uint32_t press_us[2];
+	uint32_t release_us[2];
+	uint64_t press_sum;
+	uint64_t end;
+	uint32_t confirmed;
+	uint32_t false_touches;
+	uint32_t presses;
+	uint32_t releases;
+	uint32_t last_us;
+	uint16_t touched;
+	uint16_t pad;
+	uint8_t p;
+	uint8_t r;
+	uint8_t e;
+
+	threshold_q8[8] = LETOUCH_THRESHOLD_Q8_ONE;
+	threshold_q8[11] = LETOUCH_THRESHOLD_Q8_ONE;
+
+	/* A scan period, then VALIDATE_CNT scans of both pads */
+	max_latency_us = SIM_TICKS_TO_US(period + VALIDATE_CNT * 2 * SAMPLE_DELAY) + SIM_LATENCY_MARGIN_US;
+
+	Sim_Start(threshold_q8, 20000);
+	sim_profile = &sim_profiles[0];
+	sim_profile_start = UINT64_MAX;
+	sim_pad_at_scan = Sim_Pad_Profile;
+
+	/* Calibrated on the noisy pads */
+	Sim_Run(60 * RTC_FREQ, NULL);
+
+	for (p = 0; p < sizeof(sim_profiles) / sizeof(sim_profiles[0]); p++)
+	{
+		sim_profile = &sim_profiles[p];
+		last_us = sim_profile->p_points[sim_profile->num_points - 1].us;
+		confirmed = 0;
+		false_touches = 0;
+		press_us[0] = release_us[0] = UINT32_MAX;
+		press_us[1] = release_us[1] = 0;
+		press_sum = 0;
+
+		for (r = 0; r < SIM_PROFILE_RUNS; r++)
+		{
+			sim_profile_pad = (r & 1) ? 11 : 8;
+			pad = 1 << sim_profile_pad;
+			sim_profile_start = SIM_SCAN_TICK(sim_periodic_scans + 5) + (uint64_t)r * period / SIM_PROFILE_RUNS;
+			end = sim_profile_start + ((uint64_t)last_us * RTC_FREQ) / 1000000 + RTC_FREQ;
+			sim_num_events = 0;
+
+			Sim_Run(end - sim_now, NULL);
+
+			presses = 0;
+			releases = 0;
+			touched = 0;
+			for (e = 0; e < sim_num_events; e++)
+			{
+				latency_us = SIM_TICKS_TO_US(sim_events[e].tick - sim_profile_start);
+				if ((sim_events[e].touched & ~pad) != 0)
+				{
+					false_touches++;
+				}
+				else if ((sim_events[e].touched & pad) && !(touched & pad))
+				{
+					presses++;
+					latency_us -= sim_profile->contact_us;
+					press_sum += latency_us;
+					press_us[0] = (latency_us < press_us[0]) ? latency_us : press_us[0];
+					press_us[1] = (latency_us > press_us[1]) ? latency_us : press_us[1];
+				}
+				else if (!(sim_events[e].touched & pad) && (touched & pad))
+				{
+					releases++;
+					latency_us -= sim_profile->release_us;
+					release_us[0] = (latency_us < release_us[0]) ? latency_us : release_us[0];
+					release_us[1] = (latency_us > release_us[1]) ? latency_us : release_us[1];
+				}
+				touched = sim_events[e].touched;
+			}
+
+			if (!sim_profile->touch)
+			{
+				false_touches += presses;
+			}
+			else if ((presses == 1) && (releases == 1))
+			{
+				confirmed++;
+			}
+		}
+
+		if (sim_profile->touch)
+		{
+			printf("  %-14s %d runs: %u confirmed, press %u-%u ms (mean %u), release %u-%u ms, %u false touches\n",
+					sim_profile->name, SIM_PROFILE_RUNS, confirmed, press_us[0] / 1000, press_us[1] / 1000,
+					(uint32_t)(press_sum / SIM_PROFILE_RUNS / 1000), release_us[0] / 1000, release_us[1] / 1000,
+					false_touches);
+
+			Sim_Check(confirmed == SIM_PROFILE_RUNS, "touch confirmed once, released once");
+			Sim_Check((press_us[1] <= max_latency_us) && (release_us[1] <= max_latency_us),
+					"touch confirmed within a scan period and the confirm scans");
+		}
+		else
+		{
+			printf("  %-14s %d runs: %u false touches\n", sim_profile->name, SIM_PROFILE_RUNS, false_touches);
+		}
+		Sim_Check(false_touches == 0, "no glitch taken for a touch");
+	}
+
+	sim_pad_at_scan = NULL;
+}
+
+/************************************************************************************
+ * @function 	Sim_CRC
+ * @params 		[in] p_record - record to check
+ * @brief 		CRC-32 (reflected, polynomial 0xEDB88320) of the record up to the
+ * 				crc field, to write records of another layout.
+ ************************************************************************************/
+static uint32_t Sim_CRC(const CALIBRATION_RECORD *p_record)
+{
+	const uint8_t *p_byte = (const uint8_t *)p_record;
+	uint32_t crc = 0xFFFFFFFF;
+	uint32_t i;
+	uint8_t bit;
+
+	for (i = 0; i < offsetof(CALIBRATION_RECORD, crc); i++)
+	{
+		crc ^= p_byte[i];
+		for (bit = 0; bit < 8; bit++)
+		{
+			crc = (crc & 1) ? ((crc >> 1) ^ 0xEDB88320) : (crc >> 1);
+		}
+	}
+
+	return ~crc;
+}
+
+/************************************************************************************
+ * @function 	Sim_Boot
+ * @params 		[in] p_threshold_q8 - threshold of each channel, 0 if not used
+ * 				[in] count - count of every pad
+ * 				[in] temp_raw, vdd_raw - conditions of the boot
+ * @brief 		Boots the touch pads the way main() and LESENSE_SetUp() do,
+ * 				loading the calibration record first, and saves the calibration
+ * 				the way LESENSE_TearDown() and LESENSE_Save_Calibration() do.
+ * 				Returns the number of settling scans.
+ ************************************************************************************/
+static uint32_t Sim_Boot(const uint16_t *p_threshold_q8, uint16_t count, uint16_t temp_raw, uint16_t vdd_raw)
+{
+	uint16_t baseline[NUM_LESENSE_CHANNELS];
+	uint16_t threshold[NUM_LESENSE_CHANNELS];
+	uint16_t mask;
+	uint32_t irqs = sim_lesense_irqs;
+
+	Calibration_Record_Load(temp_raw, vdd_raw);
+	Sim_Start(p_threshold_q8, count);
+	irqs = sim_lesense_irqs - irqs;
+
+	mask = LETOUCH_GetCalibration(baseline, threshold);
+	Calibration_Record_Save(mask, baseline, threshold, 0);
+
+	return irqs;
+}
+
+/************************************************************************************
+ * @function 	Sim_Record
+ * @params 		None
+ * @brief 		Boots from the calibration record kept in the simulated flash:
+ * 				written after a full calibration, taken instead of the settling
+ * 				scans while it fits, and dropped once the pads, the channels,
+ * 				the temperature or the supply change, or the page is damaged.
+ ************************************************************************************/
+static void Sim_Record(void)
+{
+	uint16_t threshold_q8[NUM_LESENSE_CHANNELS] = { 0 };
+	uint16_t other_q8[NUM_LESENSE_CHANNELS] = { 0 };
+	uint16_t baseline[NUM_LESENSE_CHANNELS];
+	uint16_t threshold[NUM_LESENSE_CHANNELS];
+	CALIBRATION_RECORD *p_flash = (CALIBRATION_RECORD *)CAL_RECORD_FLASH_ADDR;
+	CALIBRATION_RECORD record;
+	uint32_t mismatches = sim_window_mismatches + sim_threshold_mismatches;
+	uint32_t settle;
+	uint32_t erases;
+	uint32_t i;
+
+	threshold_q8[8] = LETOUCH_THRESHOLD_Q8_ONE;
+	threshold_q8[11] = LETOUCH_THRESHOLD_Q8_ONE;
+	other_q8[2] = LETOUCH_THRESHOLD_Q8_ONE;
+	other_q8[8] = LETOUCH_THRESHOLD_Q8_ONE;
+
+	memset(sim_flash, 0xFF, sizeof(sim_flash));
+	sim_pad_touched = 0;
+
+	/* Nothing is written before the boot conditions are known */
+	Sim_Start(threshold_q8, 20000);
+	Calibration_Record_Save(LETOUCH_GetCalibration(baseline, threshold), baseline, threshold, 0);
+	Sim_Check(sim_flash_erases == 0, "no record saved before it was loaded");
+
+	/* Erased page, full calibration, then the record is written */
+	settle = Sim_Boot(threshold_q8, 20000, 2000, 1500);
+	Sim_Check(settle >= NUMBER_OF_CALIBRATION_VALUES * 10, "settling scans on an erased page");
+	Sim_Check((sim_flash_erases == 1) && (sim_flash_writes == 1) && (sim_flash_overwrites == 0),
+			"record written once to an erased page");
+	Sim_Check(p_flash->crc == Sim_CRC(p_flash), "record CRC-32");
+	printf("  erased page: %u settling scans, record written\n", settle);
+
+	/* Same pads and conditions within the drift limits */
+	erases = sim_flash_erases;
+	settle = Sim_Boot(threshold_q8, 20000, 2000 + CAL_RECORD_MAX_TEMP_DRIFT, 1500 - CAL_RECORD_MAX_VDD_DRIFT);
+	LETOUCH_GetCalibration(baseline, threshold);
+	Sim_Check(settle == 0, "calibration taken from the record");
+	Sim_Check(memcmp(threshold, p_flash->threshold, sizeof(threshold)) == 0, "thresholds taken from the record");
+	Sim_Check(sim_flash_erases == erases, "unchanged record not rewritten");
+	printf("  record boot: %u settling scans, %u page erases\n", settle, sim_flash_erases - erases);
+
+	/* Touches are tracked from the record */
+	sim_num_events = 0;
+	sim_pad_at_scan = Sim_Pad_Noise;
+	sim_pad_touched = 1 << 8;
+	Sim_Run(RTC_FREQ, NULL);
+	sim_pad_touched = 0;
+	Sim_Run(RTC_FREQ, NULL);
+	sim_pad_at_scan = NULL;
+	Sim_Check((sim_num_events == 2) && (sim_events[0].touched == (1 << 8)) && (sim_events[1].touched == 0),
+			"touch confirmed after a record boot");
+
+	/* The pads read lower, the touch part is dropped and rewritten */
+	settle = Sim_Boot(threshold_q8, 18000, 2000, 1500);
+	Sim_Check(settle >= NUMBER_OF_CALIBRATION_VALUES * 10, "settling scans once the pads drifted");
+	Sim_Check((sim_flash_erases == erases + 1) && (p_flash->baseline[8] == 18000), "drifted record rewritten");
+	printf("  pads 10%% lower: %u settling scans, record rewritten\n", settle);
+
+	/* Other channels in use */
+	settle = Sim_Boot(other_q8, 18000, 2000, 1500);
+	Sim_Check(settle >= NUMBER_OF_CALIBRATION_VALUES * 10, "settling scans for other channels");
+	settle = Sim_Boot(threshold_q8, 18000, 2000, 1500);
+	Sim_Check(settle >= NUMBER_OF_CALIBRATION_VALUES * 10, "settling scans after the channels changed back");
+	Sim_Check(sim_flash_overwrites == 0, "every write to an erased page");
+
+	/* Past the temperature and supply limits, or a damaged page */
+	Sim_Check(Calibration_Record_Load(2000, 1500), "record loaded");
+	Sim_Check(!Calibration_Record_Load(2000 + CAL_RECORD_MAX_TEMP_DRIFT + 1, 1500), "record stale past the temperature drift");
+	Sim_Check(!Calibration_Record_Load(2000 - CAL_RECORD_MAX_TEMP_DRIFT - 1, 1500), "record stale past the temperature drift");
+	Sim_Check(!Calibration_Record_Load(2000, 1500 + CAL_RECORD_MAX_VDD_DRIFT + 1), "record stale past the VDD drift");
+
+	for (i = 0; i < offsetof(CALIBRATION_RECORD, crc) * 8; i += 7)
+	{
+		((uint8_t *)p_flash)[i / 8] ^= (1 << (i % 8));
+		Sim_Check(!Calibration_Record_Load(2000, 1500), "damaged record rejected");
+		((uint8_t *)p_flash)[i / 8] ^= (1 << (i % 8));
+	}
+
+	/* Intact records of another layout */
+	record = *p_flash;
+	p_flash->version = CAL_RECORD_VERSION + 1;
+	p_flash->crc = Sim_CRC(p_flash);
+	Sim_Check(!Calibration_Record_Load(2000, 1500), "record of another version rejected");
+	*p_flash = record;
+	p_flash->size = sizeof(CALIBRATION_RECORD) - sizeof(uint32_t);
+	p_flash->crc = Sim_CRC(p_flash);
+	Sim_Check(!Calibration_Record_Load(2000, 1500), "record of another size rejected");
+	*p_flash = record;
+	Sim_Check(Calibration_Record_Load(2000, 1500), "record loaded again");
+
+	/* A reset between the erase and the write costs one full calibration */
+	erases = sim_flash_erases;
+	sim_msc_reset_after_erase = true;
+	Sim_Boot(threshold_q8, 20000, 2000, 1500);
+	sim_msc_reset_after_erase = false;
+	Sim_Check(sim_flash_erases == erases + 1, "page erased for the changed calibration");
+	settle = Sim_Boot(threshold_q8, 20000, 2000, 1500);
+	Sim_Check(settle >= NUMBER_OF_CALIBRATION_VALUES * 10, "settling scans after a reset during the write");
+	settle = Sim_Boot(threshold_q8, 20000, 2000, 1500);
+	Sim_Check(settle == 0, "record boot after the record was written again");
+	printf("  reset between erase and write: one full calibration, then record boots\n");
+
+	Sim_Check(sim_window_mismatches + sim_threshold_mismatches == mismatches, "window and thresholds of record boots");
+}
+
+int main(void)
+{
+	printf("Touch pads through LESENSE, DMA and RTC models:\n");
+	Sim_Window();
+	Sim_Batches();
+	Sim_Debounce();
+	Sim_Record();
+
+	return sim_failures ? 1 : 0;
+}
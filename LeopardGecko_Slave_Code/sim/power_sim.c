@@ -0,0 +1,402 @@
+/*****************************************************************************
+ * @file 	power_sim.c
+ * @brief 	Host simulation of the sensor power sequencer. Runs MCIoT_Power.c
+ * 			against an RTC that only counts when the simulation advances it:
+ * 			- The core sleeps between RTC interrupts, every wakeup is counted.
+ * 			- A domain's settle time starts when its pin is raised.
+ * 			Domains are switched on alone, together with different settle
+ * 			times, on and off from the deferred step of another one and across
+ * 			the wrap of the 24 bit counter, with the RTC on the LFXO and on the
+ * 			ULFRCO.
+ *
+ * 			Exits non-zero if a deferred step runs before its settle time or
+ * 			more than POWER_RTC_MIN_TICKS after it, runs for a domain switched
+ * 			off, if the core wakes up for anything but a deadline, or if the
+ * 			RTC and its EM2 block are left behind once every domain is on.
+ *
+ * 			Build and run from LeopardGecko_Slave_Code, the RTC deadline query
+ * 			is left out of the link:
+ *
+ * 			  gcc -O2 -Wall -fcommon -ffunction-sections -Wl,--gc-sections -Isim -Iinc \
+ * 			    -o power_sim sim/power_sim.c src/MCIoT_Power.c
+ * 			  ./power_sim
+ ******************************************************************************/
+
+/************************************ INCLUDES **************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "em_device.h"
+#include "em_cmu.h"
+#include "em_gpio.h"
+#include "em_rtc.h"
+#include "MCIoT_main.h"
+#include "MCIoT_CMU.h"
+#include "MCIoT_Sleep.h"
+#include "MCIoT_Power.h"
+
+/************************************ INCLUDES **************************************/
+
+/************************************* MACROS ***************************************/
+
+#define SIM_LFXO_HZ					32768
+#define SIM_ULFRCO_HZ				1000
+
+/* Sensor supplies, the TSL2561 of MCIoT_I2C.c and a faster and a slower one */
+#define SIM_TSL_PIN					0
+#define SIM_TSL_SETTLE_MS			10
+#define SIM_FAST_PIN				1
+#define SIM_FAST_SETTLE_MS			3
+#define SIM_SLOW_PIN				2
+#define SIM_SLOW_SETTLE_MS			50
+
+#define SIM_PINS					3
+
+/************************************* MACROS ***************************************/
+
+/************************************ GLOBALS ***************************************/
+
+CMU_TypeDef sim_cmu;
+RTC_TypeDef sim_rtc;
+
+static uint32_t sim_rtc_hz;
+static uint64_t sim_ticks;				/* RTC ticks since the start of the run */
+static uint32_t sim_wakeups;
+static uint32_t sim_rtc_consumers;
+static bool sim_pin_high[SIM_PINS];
+static uint64_t sim_pin_raised[SIM_PINS];
+static int sim_failures;
+
+/* Deferred steps run, with the ticks from the pin raise and the pin state */
+static uint32_t sim_ready_count[SIM_PINS];
+static uint64_t sim_ready_after[SIM_PINS];
+static bool sim_ready_pin_high[SIM_PINS];
+
+static void Sim_Ready(POWER_DOMAIN *p_domain);
+static void Sim_Ready_Chain(POWER_DOMAIN *p_domain);
+static void Sim_Ready_Cancel(POWER_DOMAIN *p_domain);
+
+static POWER_DOMAIN sim_tsl = { gpioPortD, SIM_TSL_PIN, SIM_TSL_SETTLE_MS, Sim_Ready, POWER_DOMAIN_OFF, 0, 0 };
+static POWER_DOMAIN sim_fast = { gpioPortD, SIM_FAST_PIN, SIM_FAST_SETTLE_MS, Sim_Ready, POWER_DOMAIN_OFF, 0, 0 };
+static POWER_DOMAIN sim_slow = { gpioPortD, SIM_SLOW_PIN, SIM_SLOW_SETTLE_MS, Sim_Ready, POWER_DOMAIN_OFF, 0, 0 };
+
+/************************************ GLOBALS ***************************************/
+
+/************************************************************************************
+ * @function 	Sim_Check
+ * @params 		[in] ok - result of the check
+ * 				[in] what - description of the check
+ * @brief 		Records a failed check.
+ ************************************************************************************/
+static void Sim_Check(bool ok, const char *what)
+{
+	if (!ok)
+	{
+		printf("FAIL: %s\n", what);
+		sim_failures++;
+	}
+}
+
+/************************************************************************************
+ * Stubbed emlib calls
+ ************************************************************************************/
+uint32_t Sim_Core_Enter(void)
+{
+	return 0;
+}
+
+void Sim_Core_Exit(uint32_t state)
+{
+	(void)state;
+}
+
+void NVIC_EnableIRQ(IRQn_Type irq)
+{
+	(void)irq;
+}
+
+void NVIC_DisableIRQ(IRQn_Type irq)
+{
+	(void)irq;
+}
+
+void NVIC_ClearPendingIRQ(IRQn_Type irq)
+{
+	(void)irq;
+}
+
+uint32_t CMU_ClockFreqGet(CMU_Clock_TypeDef clock)
+{
+	(void)clock;
+	return sim_rtc_hz;
+}
+
+void GPIO_PinModeSet(GPIO_Port_TypeDef port, unsigned int pin, GPIO_Mode_TypeDef mode, unsigned int out)
+{
+	bool high = (mode == gpioModePushPull) && (out != 0);
+
+	if ((port != gpioPortD) || (pin >= SIM_PINS))
+	{
+		return;
+	}
+
+	if (high && !sim_pin_high[pin])
+	{
+		sim_pin_raised[pin] = sim_ticks;
+	}
+	sim_pin_high[pin] = high;
+}
+
+void GPIO_PinOutClear(GPIO_Port_TypeDef port, unsigned int pin)
+{
+	if ((port == gpioPortD) && (pin < SIM_PINS))
+	{
+		sim_pin_high[pin] = false;
+	}
+}
+
+/************************************************************************************
+ * Stubbed application calls
+ ************************************************************************************/
+bool CMU_Consumer_Start(CMU_CONSUMERS e_consumer)
+{
+	if (e_consumer == CMU_CONSUMER_RTC)
+	{
+		sim_rtc_consumers++;
+	}
+	return true;
+}
+
+void CMU_Consumer_Stop(CMU_CONSUMERS e_consumer)
+{
+	if ((e_consumer == CMU_CONSUMER_RTC) && (sim_rtc_consumers > 0))
+	{
+		sim_rtc_consumers--;
+	}
+}
+
+void blockSleepMode(ENERGY_MODES e_energy_mode)
+{
+	sleep_block_counter[e_energy_mode]++;
+}
+
+void unblockSleepMode(ENERGY_MODES e_energy_mode)
+{
+	if (sleep_block_counter[e_energy_mode] > 0)
+	{
+		sleep_block_counter[e_energy_mode]--;
+	}
+}
+
+/************************************************************************************
+ * @function 	Sim_Ready
+ * @params 		[in] p_domain - domain that has settled
+ * @brief 		Deferred step, records when it ran and the state of the pin.
+ ************************************************************************************/
+static void Sim_Ready(POWER_DOMAIN *p_domain)
+{
+	sim_ready_count[p_domain->pin]++;
+	sim_ready_after[p_domain->pin] = sim_ticks - sim_pin_raised[p_domain->pin];
+	sim_ready_pin_high[p_domain->pin] = sim_pin_high[p_domain->pin];
+}
+
+/************************************************************************************
+ * @function 	Sim_Ready_Chain
+ * @params 		[in] p_domain - domain that has settled
+ * @brief 		Deferred step that switches on the next supply.
+ ************************************************************************************/
+static void Sim_Ready_Chain(POWER_DOMAIN *p_domain)
+{
+	Sim_Ready(p_domain);
+	Power_Domain_On(&sim_slow);
+}
+
+/************************************************************************************
+ * @function 	Sim_Ready_Cancel
+ * @params 		[in] p_domain - domain that has settled
+ * @brief 		Deferred step that switches off a supply still settling.
+ ************************************************************************************/
+static void Sim_Ready_Cancel(POWER_DOMAIN *p_domain)
+{
+	Sim_Ready(p_domain);
+	Power_Domain_Off(&sim_slow);
+}
+
+/************************************************************************************
+ * @function 	Sim_Run
+ * @params 		[in] ticks - RTC ticks to run
+ * @brief 		Sleeps the core for ticks, waking it on the RTC COMP1 match.
+ ************************************************************************************/
+static void Sim_Run(uint64_t ticks)
+{
+	while (ticks-- > 0)
+	{
+		sim_ticks++;
+
+		if ((RTC->CTRL & RTC_CTRL_EN) == 0)
+		{
+			continue;
+		}
+
+		RTC->CNT = (RTC->CNT + 1) & POWER_RTC_COUNTER_MASK;
+		if (RTC->CNT == RTC->COMP1)
+		{
+			RTC->IF |= RTC_IF_COMP1;
+			if (RTC->IEN & RTC_IEN_COMP1)
+			{
+				sim_wakeups++;
+				Power_RTC_IRQHandler();
+			}
+		}
+	}
+}
+
+/************************************************************************************
+ * @function 	Sim_Ticks
+ * @params 		[in] ms - time
+ * @brief 		Returns the RTC ticks of ms, rounded up.
+ ************************************************************************************/
+static uint64_t Sim_Ticks(uint32_t ms)
+{
+	return ((uint64_t)ms * sim_rtc_hz + 999) / 1000;
+}
+
+/************************************************************************************
+ * @function 	Sim_Settled_On_Time
+ * @params 		[in] p_domain - domain switched on
+ * @brief 		Returns true if the deferred step ran once, no earlier than the
+ * 				settle time and no more than POWER_RTC_MIN_TICKS after it, with
+ * 				the pin high.
+ ************************************************************************************/
+static bool Sim_Settled_On_Time(POWER_DOMAIN *p_domain)
+{
+	uint64_t settle = Sim_Ticks(p_domain->settle_ms);
+	uint8_t pin = p_domain->pin;
+
+	return (sim_ready_count[pin] == 1) && (sim_ready_after[pin] >= settle) &&
+			(sim_ready_after[pin] <= settle + POWER_RTC_MIN_TICKS) && sim_ready_pin_high[pin] &&
+			(p_domain->e_state == POWER_DOMAIN_ON);
+}
+
+/************************************************************************************
+ * @function 	Sim_Reset
+ * @params 		[in] rtc_hz - RTC clock
+ * 				[in] cnt - RTC counter at the start
+ * @brief 		Switches every domain off and restarts the run.
+ ************************************************************************************/
+static void Sim_Reset(uint32_t rtc_hz, uint32_t cnt)
+{
+	Power_Domain_Off(&sim_tsl);
+	Power_Domain_Off(&sim_fast);
+	Power_Domain_Off(&sim_slow);
+	sim_tsl.on_ready = Sim_Ready;
+
+	sim_rtc_hz = rtc_hz;
+	sim_rtc.CNT = cnt;
+	sim_wakeups = 0;
+	memset(sim_ready_count, 0, sizeof(sim_ready_count));
+	memset(sim_ready_after, 0, sizeof(sim_ready_after));
+}
+
+/************************************************************************************
+ * @function 	Sim_Idle
+ * @params 		None
+ * @brief 		Returns true if the RTC, its clock and the EM2 block are released.
+ ************************************************************************************/
+static bool Sim_Idle(void)
+{
+	return ((RTC->CTRL & RTC_CTRL_EN) == 0) && (sim_rtc_consumers == 0) &&
+			(sleep_block_counter[ENERGY_MODE_EM2] == 0);
+}
+
+/************************************************************************************
+ * @function 	Sim_Domains
+ * @params 		[in] name - name of the RTC clock
+ * 				[in] rtc_hz - RTC clock
+ * @brief 		Runs the domains alone, together, chained, switched off while
+ * 				settling and across the counter wrap.
+ ************************************************************************************/
+static void Sim_Domains(const char *name, uint32_t rtc_hz)
+{
+	bool alone;
+	bool together;
+	bool chained;
+	bool cancelled;
+	bool wrapped;
+	uint32_t together_wakeups;
+
+	/* One supply, the core sleeps until it has settled */
+	Sim_Reset(rtc_hz, 1000);
+	Power_Domain_On(&sim_tsl);
+	Sim_Check((sim_ready_count[SIM_TSL_PIN] == 0) && sim_pin_high[SIM_TSL_PIN] &&
+			(sleep_block_counter[ENERGY_MODE_EM2] == 1), "supply raised, EM2 kept until it has settled");
+	Sim_Run(Sim_Ticks(SIM_SLOW_SETTLE_MS));
+	alone = Sim_Settled_On_Time(&sim_tsl) && (sim_wakeups == 1) && Sim_Idle();
+
+	/* A second call on a powered domain does nothing */
+	Power_Domain_On(&sim_tsl);
+	Sim_Run(Sim_Ticks(SIM_SLOW_SETTLE_MS));
+	Sim_Check((sim_ready_count[SIM_TSL_PIN] == 1) && Sim_Idle(), "domain already on left alone");
+
+	/* Three supplies settling at the same time, raised 1 ms apart */
+	Sim_Reset(rtc_hz, 5000);
+	Power_Domain_On(&sim_slow);
+	Sim_Run(Sim_Ticks(1));
+	Power_Domain_On(&sim_tsl);
+	Sim_Run(Sim_Ticks(1));
+	Power_Domain_On(&sim_fast);
+	Sim_Run(Sim_Ticks(SIM_SLOW_SETTLE_MS));
+	together = Sim_Settled_On_Time(&sim_slow) && Sim_Settled_On_Time(&sim_tsl) &&
+			Sim_Settled_On_Time(&sim_fast) && Sim_Idle();
+	together_wakeups = sim_wakeups;
+
+	/* A deferred step switching on the next supply */
+	Sim_Reset(rtc_hz, 5000);
+	sim_tsl.on_ready = Sim_Ready_Chain;
+	Power_Domain_On(&sim_tsl);
+	Sim_Run(Sim_Ticks(SIM_TSL_SETTLE_MS + SIM_SLOW_SETTLE_MS) + POWER_RTC_MIN_TICKS);
+	chained = Sim_Settled_On_Time(&sim_tsl) && Sim_Settled_On_Time(&sim_slow) &&
+			(sim_pin_raised[SIM_SLOW_PIN] >= sim_pin_raised[SIM_TSL_PIN] + Sim_Ticks(SIM_TSL_SETTLE_MS)) && Sim_Idle();
+
+	/* A deferred step switching off a supply still settling, the one raised
+	 * after them settles on time */
+	Sim_Reset(rtc_hz, 5000);
+	sim_tsl.on_ready = Sim_Ready_Cancel;
+	Power_Domain_On(&sim_slow);
+	Power_Domain_On(&sim_tsl);
+	Sim_Run(Sim_Ticks(SIM_TSL_SETTLE_MS - 1));
+	Power_Domain_On(&sim_fast);
+	Sim_Run(Sim_Ticks(SIM_SLOW_SETTLE_MS));
+	cancelled = (sim_ready_count[SIM_SLOW_PIN] == 0) && !sim_pin_high[SIM_SLOW_PIN] &&
+			(sim_slow.e_state == POWER_DOMAIN_OFF) && Sim_Settled_On_Time(&sim_tsl) &&
+			Sim_Settled_On_Time(&sim_fast) && Sim_Idle();
+
+	/* The counter wraps while two supplies settle */
+	Sim_Reset(rtc_hz, POWER_RTC_COUNTER_MASK - 3);
+	Power_Domain_On(&sim_tsl);
+	Power_Domain_On(&sim_fast);
+	Sim_Run(Sim_Ticks(SIM_SLOW_SETTLE_MS));
+	wrapped = Sim_Settled_On_Time(&sim_tsl) && Sim_Settled_On_Time(&sim_fast) && (sim_wakeups == 2) && Sim_Idle();
+
+	printf("  %s %5u Hz: %u, %u and %u ms supplies settled with %u wakeups, alone %s, together %s, chained %s, cancelled %s, wrapped %s\n",
+			name, rtc_hz, SIM_FAST_SETTLE_MS, SIM_TSL_SETTLE_MS, SIM_SLOW_SETTLE_MS, together_wakeups,
+			alone ? "ok" : "off", together ? "ok" : "off", chained ? "ok" : "off",
+			cancelled ? "ok" : "off", wrapped ? "ok" : "off");
+
+	Sim_Check(alone, "single supply ready after its settle time, one wakeup, RTC released");
+	Sim_Check(together, "supplies settling together each ready after their own settle time");
+	Sim_Check(together_wakeups == 3, "one wakeup per deadline");
+	Sim_Check(chained, "supply switched on from a deferred step settles from its own raise");
+	Sim_Check(cancelled, "no deferred step for a supply switched off while settling, the others on time");
+	Sim_Check(wrapped, "settle time kept across the counter wrap");
+}
+
+int main(void)
+{
+	printf("Sensor supplies sequenced on the RTC:\n");
+	Sim_Domains("LFXO  ", SIM_LFXO_HZ);
+	Sim_Domains("ULFRCO", SIM_ULFRCO_HZ);
+
+	return sim_failures ? 1 : 0;
+}
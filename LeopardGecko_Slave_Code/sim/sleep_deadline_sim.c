@@ -0,0 +1,499 @@
+/*****************************************************************************
+ * @file 	sleep_deadline_sim.c
+ * @brief 	Host simulation of the sleep mode selection. Runs MCIoT_Sleep.c
+ * 			with the deadlines of MCIoT_LETimer.c, MCIoT_Power.c and
+ * 			MCIoT_LESENSE_LETouch.c against register models of LETIMER0, the
+ * 			RTC and LESENSE:
+ * 			- The ULFRCO runs at SIM_ULFRCO_HZ instead of its nominal 1 kHz,
+ * 			  osc_ratio holds the ratio the self calibration measures.
+ * 			- HFCLK runs from the HFXO, so a wakeup from EM2 waits for it.
+ * 			- Two touch pads are scanned, SAMPLE_DELAY LFXO ticks each.
+ * 			Sleep() is called with each source holding the next deadline.
+ *
+ * 			Exits non-zero if a deadline is off the time the hardware takes,
+ * 			if the earliest deadline is not the one the mode is picked for, or
+ * 			if Sleep() enters a mode it would wake from too late.
+ *
+ * 			Build and run from LeopardGecko_Slave_Code, the interrupt handlers
+ * 			of the modules are left out of the link:
+ *
+ * 			  gcc -O2 -Wall -fcommon -ffunction-sections -Wl,--gc-sections -Isim -Iinc \
+ * 			    -o sleep_deadline_sim sim/sleep_deadline_sim.c src/MCIoT_Sleep.c src/MCIoT_CMU.c \
+ * 			    src/MCIoT_LETimer.c src/MCIoT_Power.c src/MCIoT_LESENSE_LETouch.c
+ * 			  ./sleep_deadline_sim
+ ******************************************************************************/
+
+/************************************ INCLUDES **************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "em_device.h"
+#include "em_cmu.h"
+#include "em_emu.h"
+#include "em_rtc.h"
+#include "em_lesense.h"
+#include "em_letimer.h"
+#include "em_acmp.h"
+#include "em_adc.h"
+#include "em_gpio.h"
+#include "em_dma.h"
+#include "em_leuart.h"
+#include "MCIoT_main.h"
+#include "MCIoT_Sleep.h"
+#include "MCIoT_CMU.h"
+#include "MCIoT_LETimer.h"
+#include "MCIoT_Power.h"
+#include "MCIoT_LESENSE_LETouch.h"
+#include "MCIoT_ADC.h"
+#include "MCIoT_DMA.h"
+
+/************************************ INCLUDES **************************************/
+
+/************************************* MACROS ***************************************/
+
+#define SIM_ULFRCO_HZ				1180.0
+#define SIM_LFXO_HZ					32768.0
+
+/* LETIMER0 ticks left to the next event */
+#define SIM_LETIMER_TICKS			996
+
+/* Deadlines are within 0.5% or 1 us of the hardware */
+#define SIM_CLOSE(us, expected_us)	(((us) >= (expected_us) * 0.995 - 1) && ((us) <= (expected_us) * 1.005 + 1))
+
+/************************************* MACROS ***************************************/
+
+/************************************ GLOBALS ***************************************/
+
+CMU_TypeDef sim_cmu;
+RTC_TypeDef sim_rtc;
+ACMP_TypeDef sim_acmp[2];
+ADC_TypeDef sim_adc0;
+LEUART_TypeDef sim_leuart0;
+
+static LETIMER_TypeDef sim_letimer0;
+static LESENSE_TypeDef sim_lesense;
+static bool sim_lesense_dma_enabled;
+static CMU_Select_TypeDef sim_lfa_select;
+
+static ENERGY_MODES sim_entered;
+static int sim_failures;
+
+/************************************ GLOBALS ***************************************/
+
+/************************************************************************************
+ * @function 	Sim_Check
+ * @params 		[in] ok - result of the check
+ * 				[in] what - description of the check
+ * @brief 		Records a failed check.
+ ************************************************************************************/
+static void Sim_Check(bool ok, const char *what)
+{
+	if (!ok)
+	{
+		printf("FAIL: %s\n", what);
+		sim_failures++;
+	}
+}
+
+/************************************************************************************
+ * Stubbed emlib calls
+ ************************************************************************************/
+LETIMER_TypeDef *Sim_LETIMER0(void)
+{
+	return &sim_letimer0;
+}
+
+LESENSE_TypeDef *Sim_LESENSE(void)
+{
+	return &sim_lesense;
+}
+
+void EMU_EnterEM1(void)
+{
+	sim_entered = ENERGY_MODE_EM1;
+}
+
+void EMU_EnterEM2(bool restore)
+{
+	(void)restore;
+	sim_entered = ENERGY_MODE_EM2;
+}
+
+void EMU_EnterEM3(bool restore)
+{
+	(void)restore;
+	sim_entered = ENERGY_MODE_EM3;
+}
+
+void CMU_ClockEnable(CMU_Clock_TypeDef clock, bool enable)
+{
+	(void)clock;
+	(void)enable;
+}
+
+void CMU_ClockSelectSet(CMU_Clock_TypeDef clock, CMU_Select_TypeDef ref)
+{
+	if (clock == cmuClock_LFA)
+	{
+		sim_lfa_select = ref;
+	}
+}
+
+CMU_Select_TypeDef CMU_ClockSelectGet(CMU_Clock_TypeDef clock)
+{
+	return (clock == cmuClock_HF) ? cmuSelect_HFXO : sim_lfa_select;
+}
+
+uint32_t CMU_ClockDivGet(CMU_Clock_TypeDef clock)
+{
+	(void)clock;
+	return 1;
+}
+
+uint32_t CMU_ClockFreqGet(CMU_Clock_TypeDef clock)
+{
+	(void)clock;
+	return (sim_lfa_select == cmuSelect_ULFRCO) ? ULFRCO_FREQUENCY : LFXO_FREQUENCY;
+}
+
+void CMU_OscillatorEnable(CMU_Osc_TypeDef osc, bool enable, bool wait)
+{
+	(void)osc;
+	(void)enable;
+	(void)wait;
+}
+
+uint32_t Sim_Core_Enter(void)
+{
+	return 0;
+}
+
+void Sim_Core_Exit(uint32_t state)
+{
+	(void)state;
+}
+
+void NVIC_EnableIRQ(IRQn_Type irq)
+{
+	(void)irq;
+}
+
+void NVIC_DisableIRQ(IRQn_Type irq)
+{
+	(void)irq;
+}
+
+void NVIC_ClearPendingIRQ(IRQn_Type irq)
+{
+	(void)irq;
+}
+
+void SystemCoreClockUpdate(void)
+{
+}
+
+void GPIO_PinModeSet(GPIO_Port_TypeDef port, unsigned int pin, GPIO_Mode_TypeDef mode, unsigned int out)
+{
+	(void)port;
+	(void)pin;
+	(void)mode;
+	(void)out;
+}
+
+void GPIO_PinOutSet(GPIO_Port_TypeDef port, unsigned int pin)
+{
+	(void)port;
+	(void)pin;
+}
+
+void GPIO_PinOutClear(GPIO_Port_TypeDef port, unsigned int pin)
+{
+	(void)port;
+	(void)pin;
+}
+
+void ACMP_CapsenseInit(ACMP_TypeDef *acmp, const ACMP_CapsenseInit_TypeDef *init)
+{
+	(void)acmp;
+	(void)init;
+}
+
+void LESENSE_Init(const LESENSE_Init_TypeDef *init, bool reqReset)
+{
+	(void)init;
+	(void)reqReset;
+}
+
+void LESENSE_ChannelConfig(const LESENSE_ChDesc_TypeDef *confCh, uint32_t chIdx)
+{
+	(void)confCh;
+	(void)chIdx;
+}
+
+uint32_t LESENSE_ScanFreqSet(uint32_t refFreq, uint32_t scanFreq)
+{
+	(void)refFreq;
+	return scanFreq;
+}
+
+void LESENSE_ClkDivSet(LESENSE_ChClk_TypeDef clk, LESENSE_ClkPresc_TypeDef clkDiv)
+{
+	(void)clk;
+	(void)clkDiv;
+}
+
+void LESENSE_ScanStart(void)
+{
+	sim_lesense.STATUS |= LESENSE_STATUS_SCANACTIVE;
+}
+
+void LESENSE_ChannelThresSet(uint8_t chIdx, uint16_t acmpThres, uint16_t cntThres)
+{
+	sim_lesense.CH[chIdx].EVAL = (sim_lesense.CH[chIdx].EVAL & ~_LESENSE_CH_EVAL_COMPTHRES_MASK) | cntThres;
+	(void)acmpThres;
+}
+
+void LESENSE_ResultBufferClear(void)
+{
+}
+
+uint32_t LESENSE_ScanResultDataBufferGet(uint32_t idx)
+{
+	return sim_lesense.BUF[idx].DATA;
+}
+
+void DMA_CfgChannel(unsigned int channel, DMA_CfgChannel_TypeDef *cfg)
+{
+	(void)channel;
+	(void)cfg;
+}
+
+void DMA_CfgDescr(unsigned int channel, bool primary, DMA_CfgDescr_TypeDef *cfg)
+{
+	(void)channel;
+	(void)primary;
+	(void)cfg;
+}
+
+void DMA_ActivatePingPong(unsigned int channel, bool useBurst,
+		void *primDst, void *primSrc, unsigned int primNMinus1,
+		void *altDst, void *altSrc, unsigned int altNMinus1)
+{
+	(void)useBurst;
+	(void)primDst;
+	(void)primSrc;
+	(void)primNMinus1;
+	(void)altDst;
+	(void)altSrc;
+	(void)altNMinus1;
+	sim_lesense_dma_enabled = (channel == DMA_CHANNEL_LESENSE);
+}
+
+void DMA_RefreshPingPong(unsigned int channel, bool primary, bool useBurst,
+		void *dst, void *src, unsigned int nMinus1, bool stop)
+{
+	(void)channel;
+	(void)primary;
+	(void)useBurst;
+	(void)dst;
+	(void)src;
+	(void)nMinus1;
+	(void)stop;
+}
+
+bool DMA_ChannelEnabled(unsigned int channel)
+{
+	return (channel == DMA_CHANNEL_LESENSE) && sim_lesense_dma_enabled;
+}
+
+/************************************************************************************
+ * Stubbed application calls
+ ************************************************************************************/
+bool Calibration_Record_Osc_Ratio(uint32_t *p_osc_ratio)
+{
+	(void)p_osc_ratio;
+	return false;
+}
+
+bool Calibration_Record_Touch_Valid(uint16_t channels_used_mask)
+{
+	(void)channels_used_mask;
+	return false;
+}
+
+void Calibration_Record_Drop_Touch(void)
+{
+}
+
+bool Calibration_Record_Baseline_Matches(uint8_t channel, uint16_t count)
+{
+	(void)channel;
+	(void)count;
+	return true;
+}
+
+/************************************************************************************
+ * @function 	Sim_Sleep
+ * @params 		None
+ * @brief 		Calls Sleep() and returns the mode it entered.
+ ************************************************************************************/
+static ENERGY_MODES Sim_Sleep(void)
+{
+	sim_entered = ENERGY_MODE_EM0;
+	Sleep();
+	return sim_entered;
+}
+
+/************************************************************************************
+ * @function 	Sim_LETimer
+ * @params 		None
+ * @brief 		LETIMER0 runs in EM3 from a ULFRCO SIM_ULFRCO_HZ fast, with and
+ * 				without the ULFRCO calibrated.
+ ************************************************************************************/
+static void Sim_LETimer(void)
+{
+	double expected_us = SIM_LETIMER_TICKS * 1e6 / SIM_ULFRCO_HZ;
+	uint32_t nominal_us;
+	uint32_t calibrated_us;
+
+	e_letimer_energy_modes = ENERGY_MODE_EM3;
+	sim_letimer0.STATUS = LETIMER_STATUS_RUNNING;
+	sim_letimer0.COMP1 = letimer_timing_config[ENERGY_MODE_EM3].comp1_val;
+	sim_letimer0.CNT = sim_letimer0.COMP1 + SIM_LETIMER_TICKS;
+
+	osc_ratio = 0;
+	nominal_us = LETimer_Time_To_Next_Event_us();
+	osc_ratio = (uint32_t)(SIM_ULFRCO_HZ / ULFRCO_FREQUENCY * OSC_RATIO_UNITY);
+	calibrated_us = LETimer_Time_To_Next_Event_us();
+
+	printf("  LETIMER0 COMP1 in %d ULFRCO ticks, %.0f us: %u us uncalibrated, %u us calibrated\n",
+			SIM_LETIMER_TICKS, expected_us, nominal_us, calibrated_us);
+
+	Sim_Check(SIM_CLOSE(calibrated_us, expected_us), "LETIMER0 deadline scaled with osc_ratio");
+
+	sim_letimer0.STATUS = 0;
+	Sim_Check(LETimer_Time_To_Next_Event_us() == SLEEP_NO_DEADLINE, "no LETIMER0 deadline while it is stopped");
+}
+
+/************************************************************************************
+ * @function 	Sim_RTC
+ * @params 		None
+ * @brief 		A power domain settles on RTC COMP1 while LETIMER0 runs from the
+ * 				LFXO, then the RTC wraps at COMP0 for the touch calibration.
+ ************************************************************************************/
+static void Sim_RTC(void)
+{
+	POWER_DOMAIN domain = { gpioPortD, 6, 10, NULL, POWER_DOMAIN_OFF, 0, 0 };
+	double top_us = 1e6 * SIM_LETIMER_TICKS / SIM_LFXO_HZ;
+	double expected_us;
+	uint32_t sleep_us;
+	ENERGY_MODES e_near;
+	ENERGY_MODES e_far;
+
+	e_letimer_energy_modes = ENERGY_MODE_EM2;
+	sim_lfa_select = cmuSelect_LFXO;
+	sim_letimer0.STATUS = LETIMER_STATUS_RUNNING;
+	sim_letimer0.COMP1 = 0;
+	sim_letimer0.CNT = SIM_LETIMER_TICKS;
+	memset(sleep_block_counter, 0, sizeof(sleep_block_counter));
+
+	/* The supply is almost settled, the match is as close as the RTC allows */
+	sim_rtc.CNT = 1000;
+	Power_Domain_On(&domain);
+	sim_rtc.CNT = sim_rtc.COMP1 - POWER_RTC_MIN_TICKS;
+	expected_us = 1e6 * POWER_RTC_MIN_TICKS / SIM_LFXO_HZ;
+	sleep_us = Power_RTC_Time_To_Next_Event_us();
+	e_near = Sim_Sleep();
+
+	/* Further away than the HFXO restart */
+	sim_rtc.CNT = sim_rtc.COMP1 - 100;
+	e_far = Sim_Sleep();
+
+	printf("  RTC COMP1 in %d ticks, %.0f us: %u us, EM%d with LETIMER0 %.0f us away; in 100 ticks EM%d\n",
+			POWER_RTC_MIN_TICKS, expected_us, sleep_us, e_near, top_us, e_far);
+
+	Sim_Check(SIM_CLOSE(sleep_us, expected_us), "RTC COMP1 deadline");
+	Sim_Check(e_near == ENERGY_MODE_EM1, "EM1 when the HFXO restart would miss the RTC match");
+	Sim_Check(e_far == ENERGY_MODE_EM2, "EM2 when the RTC match leaves time for the HFXO restart");
+
+	Power_Domain_Off(&domain);
+	Sim_Check(Power_RTC_Time_To_Next_Event_us() == SLEEP_NO_DEADLINE, "no RTC deadline once the RTC is stopped");
+
+	/* The touch calibration wraps the counter after COMP0 */
+	RTC->CTRL = RTC_CTRL_EN | RTC_CTRL_COMP0TOP;
+	RTC->COMP0 = CALIBRATION_INTERVAL * RTC_FREQ;
+	RTC->COMP1 = 5;
+	RTC->CNT = RTC->COMP0 - 10;
+	RTC->IEN = RTC_IEN_COMP1;
+	sleep_us = Power_RTC_Time_To_Next_Event_us();
+	expected_us = 1e6 * 16 / SIM_LFXO_HZ;
+
+	printf("  RTC COMP1 16 ticks away across the COMP0 wrap, %.0f us: %u us\n", expected_us, sleep_us);
+
+	Sim_Check(SIM_CLOSE(sleep_us, expected_us), "RTC deadline across the COMP0 wrap");
+
+	RTC->CTRL = 0;
+	RTC->IEN = 0;
+	sim_letimer0.STATUS = 0;
+}
+
+/************************************************************************************
+ * @function 	Sim_Scans
+ * @params 		None
+ * @brief 		Settling scans run back to back, then the DMA batches the scans
+ * 				at LESENSE_SCAN_FREQUENCY.
+ ************************************************************************************/
+static void Sim_Scans(void)
+{
+	uint16_t threshold_q8[NUM_LESENSE_CHANNELS] = { 0 };
+	double scan_us = 1e6 * 2 * SAMPLE_DELAY / SIM_LFXO_HZ;
+	double batch_us = 1e6 * (LESENSE_DMA_BATCH_ENTRIES / 2) / LESENSE_SCAN_FREQUENCY;
+	uint32_t settle_us;
+	uint32_t idle_us;
+	uint32_t dma_us;
+	ENERGY_MODES e_idle;
+
+	/* 12.5 percent */
+	threshold_q8[8] = 12 * LETOUCH_THRESHOLD_Q8_ONE + LETOUCH_THRESHOLD_Q8_ONE / 2;
+	threshold_q8[9] = threshold_q8[8];
+	sim_lfa_select = cmuSelect_LFXO;
+	memset(sleep_block_counter, 0, sizeof(sleep_block_counter));
+	CMU_Consumer_Start(CMU_CONSUMER_LESENSE);
+	LETOUCH_Init(threshold_q8);
+
+	settle_us = LETOUCH_Time_To_Next_Event_us();
+
+	/* Between two confirm scans, nothing else keeps the core out of EM3 */
+	sim_lesense.STATUS = 0;
+	idle_us = LETOUCH_Time_To_Next_Event_us();
+	e_idle = Sim_Sleep();
+
+	/* Batches of scans moved by the DMA */
+	LESENSE_IntDisable(LESENSE_IEN_SCANCOMPLETE);
+	sim_lesense_dma_enabled = true;
+	dma_us = LETOUCH_Time_To_Next_Event_us();
+
+	printf("  LESENSE scan running %.0f us: %u us, between scans %u us in EM%d, DMA batch %.0f us: %u us\n",
+			scan_us, settle_us, idle_us, e_idle, batch_us, dma_us);
+
+	Sim_Check(SIM_CLOSE(settle_us, scan_us), "LESENSE deadline at the end of the running scan");
+	Sim_Check(idle_us == 1000000 / LESENSE_SCAN_FREQUENCY, "LESENSE deadline at most one scan period away");
+	Sim_Check(e_idle == ENERGY_MODE_EM2, "EM2 when the LFXO restart from EM3 would miss the next scan");
+	Sim_Check(SIM_CLOSE(dma_us, batch_us), "LESENSE deadline at most one DMA batch away");
+
+	sim_lesense_dma_enabled = false;
+	Sim_Check(LETOUCH_Time_To_Next_Event_us() == SLEEP_NO_DEADLINE, "no LESENSE deadline without scan interrupts");
+
+	CMU_Consumer_Stop(CMU_CONSUMER_LESENSE);
+}
+
+int main(void)
+{
+	printf("Deadlines the sleep mode is picked for, ULFRCO at %.0f Hz, HFCLK on the HFXO:\n", SIM_ULFRCO_HZ);
+	Sim_LETimer();
+	Sim_RTC();
+	Sim_Scans();
+
+	return sim_failures ? 1 : 0;
+}
@@ -0,0 +1,354 @@
+/*****************************************************************************
+ * @file 	touch_auth_sim.c
+ * @brief 	Host simulation of the touch authentication. Runs LESENSE_SetUp()
+ * 			of MCIoT_LESENSE_Main.c with MCIoT_Touch_Pattern.c and replays
+ * 			recorded touch sequences into it:
+ * 			- Every Sleep() wakes on one interrupt, the next validated press or
+ * 			  release from LESENSE_IRQHandler, or the RTC calibration interrupt
+ * 			  after CALIBRATION_INTERVAL seconds without one.
+ * 			- The RTC counter restarts on both, as in MCIoT_LESENSE_LETouch.c.
+ * 			The unlock pattern is pad 8, then pad 11 within 3 s of its release.
+ *
+ * 			Exits non-zero if a sequence is accepted or rejected other than
+ * 			expected, if LESENSE_SetUp() returns before an accepted pattern or
+ * 			not on its last release, or if the EM2 block is not released once
+ * 			it has.
+ *
+ * 			Build and run from LeopardGecko_Slave_Code, the teardown and the
+ * 			calibration record are left out of the link:
+ *
+ * 			  gcc -O2 -Wall -fcommon -ffunction-sections -Wl,--gc-sections -Isim -Iinc \
+ * 			    -o touch_auth_sim sim/touch_auth_sim.c src/MCIoT_LESENSE_Main.c src/MCIoT_Touch_Pattern.c
+ * 			  ./touch_auth_sim
+ ******************************************************************************/
+
+/************************************ INCLUDES **************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <setjmp.h>
+#include "em_device.h"
+#include "MCIoT_main.h"
+#include "MCIoT_GPIO.h"
+#include "MCIoT_Sleep.h"
+#include "MCIoT_LESENSE_Main.h"
+#include "MCIoT_LESENSE_LETouch.h"
+
+/************************************ INCLUDES **************************************/
+
+/************************************* MACROS ***************************************/
+
+#define SIM_RTC_HZ					32768
+#define SIM_QUIET_MS				(CALIBRATION_INTERVAL * 1000)
+
+/* Settling scans LESENSE_SetUp() sleeps through before touches count */
+#define SIM_CALIBRATION_SLEEPS		3
+
+/* Quiet time replayed after the last touch of a sequence */
+#define SIM_TAIL_MS					40000
+
+#define SIM_MAX_VERDICTS			16
+
+#define SIM_PAD(channel)			((uint16_t)(1 << (channel)))
+
+/************************************* MACROS ***************************************/
+
+/********************************** ENUMERATIONS ************************************/
+
+/* Pads in the touched state from ms on */
+typedef struct
+{
+	uint32_t	ms;
+	uint16_t	touched;
+} SIM_TOUCH;
+
+typedef struct
+{
+	const char			*name;
+	uint16_t			touched_at_start;
+	const SIM_TOUCH		*p_touches;
+	uint32_t			num_touches;
+	const char			*verdicts;			/* A accepted, R rejected or locked out, in order */
+	uint32_t			accepted_after_ms;	/* 0 if the pattern must not be accepted */
+} SIM_SEQUENCE;
+
+/********************************** ENUMERATIONS ************************************/
+
+/************************************ GLOBALS ***************************************/
+
+static const SIM_SEQUENCE *sim_sequence;
+static uint32_t sim_touch_index;
+static uint32_t sim_now_ms;
+static uint32_t sim_rtc_reset_ms;
+static uint32_t sim_sleeps;
+static uint32_t sim_wakeups;
+static uint32_t sim_accepted_ms;
+static char sim_verdicts[SIM_MAX_VERDICTS + 1];
+static uint32_t sim_num_verdicts;
+static bool sim_in_setup;
+static jmp_buf sim_end_jmp;
+static int sim_failures;
+
+/* Unlock pattern entered right */
+static const SIM_TOUCH sim_right[] =
+{
+	{ 1000, SIM_PAD(8) }, { 1300, 0 }, { 2000, SIM_PAD(11) }, { 2250, 0 },
+};
+
+/* Pads swapped, then right */
+static const SIM_TOUCH sim_swapped[] =
+{
+	{ 1000, SIM_PAD(11) }, { 1300, 0 }, { 2000, SIM_PAD(8) }, { 2250, 0 },
+	{ 4000, SIM_PAD(8) }, { 4300, 0 }, { 5000, SIM_PAD(11) }, { 5250, 0 },
+};
+
+/* Second pad 3.5 s after the first one is released */
+static const SIM_TOUCH sim_slow[] =
+{
+	{ 1000, SIM_PAD(8) }, { 1300, 0 }, { 4800, SIM_PAD(11) }, { 5050, 0 },
+};
+
+/* Extra pad touched with the first one */
+static const SIM_TOUCH sim_chord[] =
+{
+	{ 1000, SIM_PAD(8) }, { 1100, SIM_PAD(8) | SIM_PAD(9) }, { 1300, 0 }, { 2000, SIM_PAD(11) }, { 2250, 0 },
+};
+
+/* Pad 8 held from power on, pad 11 touched with it, both released, then right */
+static const SIM_TOUCH sim_held[] =
+{
+	{ 500, SIM_PAD(8) | SIM_PAD(11) }, { 700, SIM_PAD(8) }, { 900, 0 },
+	{ 2000, SIM_PAD(8) }, { 2300, 0 }, { 3000, SIM_PAD(11) }, { 3250, 0 },
+};
+
+/* Stalls after the first pad, then right */
+static const SIM_TOUCH sim_stalled[] =
+{
+	{ 1000, SIM_PAD(8) }, { 1300, 0 },
+	{ 9000, SIM_PAD(8) }, { 9300, 0 }, { 10000, SIM_PAD(11) }, { 10250, 0 },
+};
+
+/* Three wrong attempts, right while locked out, right once the lockout ran out */
+static const SIM_TOUCH sim_locked[] =
+{
+	{ 1000, SIM_PAD(11) }, { 1300, 0 }, { 2000, SIM_PAD(11) }, { 2300, 0 },
+	{ 3000, SIM_PAD(11) }, { 3300, 0 }, { 4000, SIM_PAD(11) }, { 4300, 0 },
+	{ 5000, SIM_PAD(11) }, { 5300, 0 }, { 6000, SIM_PAD(11) }, { 6300, 0 },
+	{ 8000, SIM_PAD(8) }, { 8300, 0 }, { 9000, SIM_PAD(11) }, { 9250, 0 },
+	{ 45000, SIM_PAD(8) }, { 45300, 0 }, { 46000, SIM_PAD(11) }, { 46250, 0 },
+};
+
+#define SIM_TOUCHES(t)				(t), (sizeof(t) / sizeof((t)[0]))
+
+static const SIM_SEQUENCE sim_sequences[] =
+{
+	{ "right",		0,			SIM_TOUCHES(sim_right),		"A",	2250 },
+	{ "swapped",	0,			SIM_TOUCHES(sim_swapped),	"RA",	5250 },
+	{ "slow",		0,			SIM_TOUCHES(sim_slow),		"R",	0 },
+	{ "chord",		0,			SIM_TOUCHES(sim_chord),		"R",	0 },
+	{ "held",		SIM_PAD(8),	SIM_TOUCHES(sim_held),		"A",	3250 },
+	{ "stalled",	0,			SIM_TOUCHES(sim_stalled),	"RA",	10250 },
+	{ "locked",		0,			SIM_TOUCHES(sim_locked),	"RRRA",	46250 },
+};
+
+/************************************ GLOBALS ***************************************/
+
+/************************************************************************************
+ * @function 	Sim_Check
+ * @params 		[in] ok - result of the check
+ * 				[in] what - description of the check
+ * @brief 		Records a failed check.
+ ************************************************************************************/
+static void Sim_Check(bool ok, const char *what)
+{
+	if (!ok)
+	{
+		printf("FAIL: %s\n", what);
+		sim_failures++;
+	}
+}
+
+/************************************************************************************
+ * Stubbed emlib calls
+ ************************************************************************************/
+uint32_t Sim_Core_Enter(void)
+{
+	return 0;
+}
+
+void Sim_Core_Exit(uint32_t state)
+{
+	(void)state;
+}
+
+/************************************************************************************
+ * Stubbed application calls
+ ************************************************************************************/
+void LED_On(GPIO_Port_TypeDef port, unsigned int pin)
+{
+	(void)port;
+	(void)pin;
+
+	if (sim_num_verdicts < SIM_MAX_VERDICTS)
+	{
+		sim_verdicts[sim_num_verdicts++] = 'A';
+	}
+	sim_accepted_ms = sim_now_ms;
+}
+
+void LED_Off(GPIO_Port_TypeDef port, unsigned int pin)
+{
+	(void)port;
+	(void)pin;
+
+	/* LESENSE_SetUp() starts with the LED off */
+	if (sim_in_setup && (sim_num_verdicts < SIM_MAX_VERDICTS))
+	{
+		sim_verdicts[sim_num_verdicts++] = 'R';
+	}
+}
+
+void blockSleepMode(ENERGY_MODES e_energy_mode)
+{
+	sleep_block_counter[e_energy_mode]++;
+}
+
+void unblockSleepMode(ENERGY_MODES e_energy_mode)
+{
+	if (sleep_block_counter[e_energy_mode] > 0)
+	{
+		sleep_block_counter[e_energy_mode]--;
+	}
+}
+
+void LETOUCH_Init(const uint16_t threshold_q8[])
+{
+	uint8_t i;
+
+	/* Only the pads of the pattern are scanned */
+	for (i = 0; i < NUM_LESENSE_CHANNELS; i++)
+	{
+		Sim_Check((threshold_q8[i] != 0) == ((i == 8) || (i == 11)), "pads of the pattern scanned, no others");
+	}
+	sim_in_setup = true;
+}
+
+bool LETOUCH_IsCalibrated(void)
+{
+	return sim_sleeps >= SIM_CALIBRATION_SLEEPS;
+}
+
+uint16_t LETOUCH_GetChannelsTouched(void)
+{
+	return sim_sequence->touched_at_start;
+}
+
+/************************************************************************************
+ * @function 	Sleep
+ * @params 		None
+ * @brief 		Sleeps until the next interrupt: a touch event of the sequence, or
+ * 				the RTC calibration interrupt after a quiet interval. Ends the run
+ * 				once the sequence has been replayed.
+ ************************************************************************************/
+void Sleep(void)
+{
+	const SIM_TOUCH *p_touch = &sim_sequence->p_touches[sim_touch_index];
+	uint32_t quiet_ms = sim_rtc_reset_ms + SIM_QUIET_MS;
+	uint32_t elapsed_ticks;
+
+	sim_sleeps++;
+	if (sim_sleeps <= SIM_CALIBRATION_SLEEPS)
+	{
+		/* A settling scan */
+		return;
+	}
+
+	sim_wakeups++;
+
+	if ((sim_touch_index < sim_sequence->num_touches) && (p_touch->ms < quiet_ms))
+	{
+		sim_now_ms = p_touch->ms;
+		elapsed_ticks = (uint32_t)(((uint64_t)(sim_now_ms - sim_rtc_reset_ms) * SIM_RTC_HZ) / 1000);
+		sim_rtc_reset_ms = sim_now_ms;
+		sim_touch_index++;
+
+		LESENSE_Auth_Touch_Event(p_touch->touched, elapsed_ticks);
+		return;
+	}
+
+	if ((sim_touch_index == sim_sequence->num_touches) &&
+			(quiet_ms > sim_sequence->p_touches[sim_touch_index - 1].ms + SIM_TAIL_MS))
+	{
+		longjmp(sim_end_jmp, 1);
+	}
+
+	sim_now_ms = quiet_ms;
+	sim_rtc_reset_ms = quiet_ms;
+	LESENSE_Auth_Timeout_Event();
+}
+
+/************************************************************************************
+ * @function 	Sim_Replay
+ * @params 		[in] p_sequence - touches to replay
+ * @brief 		Runs LESENSE_SetUp() on one sequence and checks its verdicts.
+ ************************************************************************************/
+static void Sim_Replay(const SIM_SEQUENCE *p_sequence)
+{
+	bool returned = false;
+	uint32_t expected_ms = p_sequence->accepted_after_ms;
+	uint32_t quiet_wakeups;
+
+	sim_sequence = p_sequence;
+	sim_touch_index = 0;
+	sim_now_ms = 0;
+	sim_rtc_reset_ms = 0;
+	sim_sleeps = 0;
+	sim_wakeups = 0;
+	sim_accepted_ms = 0;
+	sim_num_verdicts = 0;
+	memset(sim_verdicts, 0, sizeof(sim_verdicts));
+	sim_in_setup = false;
+	is_lesense_auth_done = false;
+	memset(sleep_block_counter, 0, sizeof(sleep_block_counter));
+
+	if (setjmp(sim_end_jmp) == 0)
+	{
+		LESENSE_SetUp();
+		returned = true;
+	}
+
+	quiet_wakeups = sim_wakeups - sim_touch_index;
+
+	printf("  %-8s %2u touch events, %2u quiet intervals, verdicts %-5s %s\n",
+			p_sequence->name, sim_touch_index, quiet_wakeups, sim_verdicts,
+			returned ? "accepted" : "not accepted");
+
+	Sim_Check(strcmp(sim_verdicts, p_sequence->verdicts) == 0, "verdicts of the sequence");
+	Sim_Check(returned == (expected_ms != 0), "LESENSE_SetUp() returns once the pattern is accepted");
+	Sim_Check(is_lesense_auth_done == returned, "is_lesense_auth_done set on acceptance only");
+	if (returned)
+	{
+		Sim_Check((sim_accepted_ms == expected_ms) && (sim_touch_index == p_sequence->num_touches),
+				"accepted on the last release");
+		Sim_Check(sleep_block_counter[LESENSE_EM] == 0, "LESENSE EM2 block released once accepted");
+	}
+	else
+	{
+		Sim_Check(sleep_block_counter[LESENSE_EM] == 1, "EM2 kept while authenticating");
+	}
+}
+
+int main(void)
+{
+	uint32_t i;
+
+	printf("Touch authentication, pad 8 then pad 11 within 3 s, %d s quiet interval:\n", CALIBRATION_INTERVAL);
+
+	for (i = 0; i < sizeof(sim_sequences) / sizeof(sim_sequences[0]); i++)
+	{
+		Sim_Replay(&sim_sequences[i]);
+	}
+
+	return sim_failures ? 1 : 0;
+}
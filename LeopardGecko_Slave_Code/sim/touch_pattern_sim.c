@@ -0,0 +1,582 @@
+/*****************************************************************************
+ * @file 	touch_pattern_sim.c
+ * @brief 	Host simulation of the touch pattern engine. Feeds synthetic touch
+ * 			streams to MCIoT_Touch_Pattern.c, without LESENSE:
+ * 			- Patterns of 1 to TOUCH_PATTERN_MAX_STEPS steps over any of the
+ * 			  16 channels, each step a chord of up to 3 pads pressed and
+ * 			  released in any order.
+ * 			- Every entry is also replayed with one pad added to or taken
+ * 			  from a chord, or with one gap just outside its window.
+ * 			- Gaps on both edges of a window, stalled entries, the lockout
+ * 			  and patterns that do not compile.
+ *
+ * 			Exits non-zero if an entry is accepted or rejected other than
+ * 			expected, if a verdict is given before the last release of the
+ * 			entry, so that it depends on where the entry went wrong, or if a
+ * 			lockout lets an entry through or does not run out.
+ *
+ * 			Build and run from LeopardGecko_Slave_Code:
+ *
+ * 			  gcc -O2 -Wall -fcommon -Isim -Iinc \
+ * 			    -o touch_pattern_sim sim/touch_pattern_sim.c src/MCIoT_Touch_Pattern.c
+ * 			  ./touch_pattern_sim
+ ******************************************************************************/
+
+/************************************ INCLUDES **************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "MCIoT_Touch_Pattern.h"
+
+/************************************ INCLUDES **************************************/
+
+/************************************* MACROS ***************************************/
+
+#define SIM_CHANNELS				16
+#define SIM_MAX_CHORD_PADS			3
+
+/* Presses and releases of the longest entry */
+#define SIM_MAX_EVENTS				(TOUCH_PATTERN_MAX_STEPS * SIM_MAX_CHORD_PADS * 2)
+
+#define SIM_RANDOM_PATTERNS			2000
+
+/* Gap the entry uses for a step, or one just outside its window */
+#define SIM_GAP_IN_WINDOW			0
+#define SIM_GAP_BELOW_MIN			1
+#define SIM_GAP_ABOVE_MAX			2
+
+/************************************* MACROS ***************************************/
+
+/********************************** ENUMERATIONS ************************************/
+
+typedef struct
+{
+	uint16_t	touched;
+	uint32_t	elapsed_ticks;
+} SIM_EVENT;
+
+typedef struct
+{
+	SIM_EVENT	events[SIM_MAX_EVENTS];
+	uint32_t	num_events;
+} SIM_ENTRY;
+
+/********************************** ENUMERATIONS ************************************/
+
+/************************************ GLOBALS ***************************************/
+
+static uint32_t sim_seed = 0x2545F491;
+static int sim_failures;
+
+static TOUCH_PATTERN sim_pattern;
+
+/************************************ GLOBALS ***************************************/
+
+/************************************************************************************
+ * @function 	Sim_Check
+ * @params 		[in] ok - result of the check
+ * 				[in] what - description of the check
+ * @brief 		Records a failed check.
+ ************************************************************************************/
+static void Sim_Check(bool ok, const char *what)
+{
+	if (!ok)
+	{
+		printf("FAIL: %s\n", what);
+		sim_failures++;
+	}
+}
+
+/************************************************************************************
+ * @function 	Sim_Random
+ * @params 		[in] range - number of values
+ * @brief 		Returns a pseudo random value below range, the same on every run.
+ ************************************************************************************/
+static uint32_t Sim_Random(uint32_t range)
+{
+	sim_seed = sim_seed * 1103515245 + 12345;
+	return ((sim_seed >> 8) % range);
+}
+
+/************************************************************************************
+ * @function 	Sim_Ticks
+ * @params 		[in] ms - time in milliseconds
+ * @brief 		Pattern ticks of a step window, as the engine compiles them.
+ ************************************************************************************/
+static uint32_t Sim_Ticks(uint32_t ms)
+{
+	uint32_t ticks = (ms * TOUCH_PATTERN_TICK_HZ) / 1000;
+
+	return (ticks > TOUCH_PATTERN_MAX_GAP_TICKS) ? TOUCH_PATTERN_MAX_GAP_TICKS : ticks;
+}
+
+/************************************************************************************
+ * @function 	Sim_Random_Chord
+ * @params 		None
+ * @brief 		Returns 1 to SIM_MAX_CHORD_PADS pads of any channels.
+ ************************************************************************************/
+static uint16_t Sim_Random_Chord(void)
+{
+	uint32_t num_pads = 1 + Sim_Random(SIM_MAX_CHORD_PADS);
+	uint16_t chord = 0;
+
+	while (__builtin_popcount(chord) < num_pads)
+	{
+		chord |= TOUCH_PATTERN_PAD(Sim_Random(SIM_CHANNELS));
+	}
+	return chord;
+}
+
+/************************************************************************************
+ * @function 	Sim_Add_Step
+ * @params 		[out] p_entry - entry to extend
+ * 				[in] chord - pads of the step
+ * 				[in] gap_ticks - time from the previous release to the first press
+ * @brief 		Presses the pads of a chord one at a time in a random order, then
+ * 				releases them the same way.
+ ************************************************************************************/
+static void Sim_Add_Step(SIM_ENTRY *p_entry, uint16_t chord, uint32_t gap_ticks)
+{
+	uint16_t left = chord;
+	uint16_t touched = 0;
+	uint16_t pad;
+	bool press = true;
+	bool first = true;
+
+	while (press || (touched != 0))
+	{
+		do
+		{
+			pad = TOUCH_PATTERN_PAD(Sim_Random(SIM_CHANNELS));
+		} while (0 == ((press ? left : touched) & pad));
+
+		if (press)
+		{
+			left &= ~pad;
+			touched |= pad;
+			press = (left != 0);
+		}
+		else
+		{
+			touched &= ~pad;
+		}
+
+		p_entry->events[p_entry->num_events].touched = touched;
+		p_entry->events[p_entry->num_events].elapsed_ticks = first ? gap_ticks : 1 + Sim_Random(TOUCH_PATTERN_TICK_HZ);
+		p_entry->num_events++;
+		first = false;
+	}
+}
+
+/************************************************************************************
+ * @function 	Sim_Build_Entry
+ * @params 		[out] p_entry - entry to build
+ * 				[in] p_steps - pattern definition
+ * 				[in] num_steps - steps of the pattern
+ * 				[in] wrong_step - step entered wrong, num_steps for none
+ * 				[in] wrong_chord - chord of the wrong step has one pad more or less
+ * 				[in] wrong_gap - SIM_GAP_ value of the wrong step
+ * @brief 		Builds an entry of the pattern, every gap inside its window unless
+ * 				the step is the wrong one.
+ ************************************************************************************/
+static void Sim_Build_Entry(SIM_ENTRY *p_entry, const TOUCH_PATTERN_STEP_DEF *p_steps, uint8_t num_steps,
+		uint8_t wrong_step, bool wrong_chord, uint32_t wrong_gap)
+{
+	uint32_t min_ticks;
+	uint32_t max_ticks;
+	uint32_t gap_ticks;
+	uint16_t chord;
+	uint16_t pad;
+	uint8_t i;
+
+	p_entry->num_events = 0;
+
+	for (i = 0; i < num_steps; i++)
+	{
+		chord = p_steps[i].chord_mask;
+		min_ticks = (i == 0) ? 0 : Sim_Ticks(p_steps[i].min_gap_ms);
+		max_ticks = (i == 0) ? TOUCH_PATTERN_MAX_GAP_TICKS : Sim_Ticks(p_steps[i].max_gap_ms);
+		gap_ticks = min_ticks + Sim_Random(max_ticks - min_ticks + 1);
+
+		if (i == wrong_step)
+		{
+			if (wrong_chord)
+			{
+				/* Any pad flipped, never the only one, and a full chord loses one */
+				do
+				{
+					pad = TOUCH_PATTERN_PAD(Sim_Random(SIM_CHANNELS));
+				} while ((chord == pad) || ((__builtin_popcount(chord) == SIM_MAX_CHORD_PADS) && !(chord & pad)));
+				chord ^= pad;
+			}
+			else if (wrong_gap == SIM_GAP_BELOW_MIN)
+			{
+				gap_ticks = min_ticks - 1;
+			}
+			else if (wrong_gap == SIM_GAP_ABOVE_MAX)
+			{
+				gap_ticks = max_ticks + 1;
+			}
+		}
+
+		Sim_Add_Step(p_entry, chord, gap_ticks);
+	}
+}
+
+/************************************************************************************
+ * @function 	Sim_Replay
+ * @params 		[in] p_entry - entry to replay
+ * 				[out] p_verdict_event - event the verdict came on
+ * @brief 		Replays an entry, returns the first verdict other than NONE.
+ ************************************************************************************/
+static TOUCH_PATTERN_RESULT Sim_Replay(const SIM_ENTRY *p_entry, uint32_t *p_verdict_event)
+{
+	TOUCH_PATTERN_RESULT result = TOUCH_PATTERN_RESULT_NONE;
+	uint32_t i;
+
+	*p_verdict_event = p_entry->num_events;
+
+	for (i = 0; i < p_entry->num_events; i++)
+	{
+		result = Touch_Pattern_Touch_Event(&sim_pattern, p_entry->events[i].touched, p_entry->events[i].elapsed_ticks);
+		if (result != TOUCH_PATTERN_RESULT_NONE)
+		{
+			*p_verdict_event = i;
+			break;
+		}
+	}
+	return result;
+}
+
+/************************************************************************************
+ * @function 	Sim_Random_Patterns
+ * @params 		None
+ * @brief 		Compiles random patterns and enters each of them right, with a wrong
+ * 				chord and with a gap just outside its window.
+ ************************************************************************************/
+static void Sim_Random_Patterns(void)
+{
+	TOUCH_PATTERN_STEP_DEF steps[TOUCH_PATTERN_MAX_STEPS];
+	SIM_ENTRY entry;
+	TOUCH_PATTERN_RESULT result;
+	uint32_t verdict_event;
+	uint32_t accepted = 0;
+	uint32_t rejected = 0;
+	uint32_t early = 0;
+	uint32_t wrong = 0;
+	uint32_t gap;
+	uint32_t n;
+	uint16_t channels;
+	uint8_t num_steps;
+	uint8_t step;
+	uint8_t i;
+
+	for (n = 0; n < SIM_RANDOM_PATTERNS; n++)
+	{
+		num_steps = 1 + Sim_Random(TOUCH_PATTERN_MAX_STEPS);
+		channels = 0;
+		for (i = 0; i < num_steps; i++)
+		{
+			steps[i].chord_mask = Sim_Random_Chord();
+			steps[i].min_gap_ms = 2 + Sim_Random(2000);
+			steps[i].max_gap_ms = steps[i].min_gap_ms + 2 + Sim_Random(3000);
+			channels |= steps[i].chord_mask;
+		}
+
+		if (false == Touch_Pattern_Compile(&sim_pattern, steps, num_steps))
+		{
+			Sim_Check(false, "random pattern compiles");
+			continue;
+		}
+		if (sim_pattern.channels_mask != channels)
+		{
+			wrong++;
+		}
+
+		/* Right */
+		Sim_Build_Entry(&entry, steps, num_steps, num_steps, false, SIM_GAP_IN_WINDOW);
+		result = Sim_Replay(&entry, &verdict_event);
+		if ((result == TOUCH_PATTERN_RESULT_ACCEPTED) && (verdict_event == entry.num_events - 1))
+		{
+			accepted++;
+		}
+		else
+		{
+			wrong++;
+		}
+
+		/* One step wrong, the chord or the gap, anywhere in the entry */
+		for (step = 0; step < num_steps; step++)
+		{
+			for (gap = SIM_GAP_IN_WINDOW; gap <= SIM_GAP_ABOVE_MAX; gap++)
+			{
+				if ((step == 0) && (gap != SIM_GAP_IN_WINDOW))
+				{
+					continue;
+				}
+
+				Touch_Pattern_Compile(&sim_pattern, steps, num_steps);
+				Sim_Build_Entry(&entry, steps, num_steps, step, (gap == SIM_GAP_IN_WINDOW), gap);
+				result = Sim_Replay(&entry, &verdict_event);
+				if (result != TOUCH_PATTERN_RESULT_REJECTED)
+				{
+					wrong++;
+				}
+				else if (verdict_event != entry.num_events - 1)
+				{
+					early++;
+				}
+				else
+				{
+					rejected++;
+				}
+			}
+		}
+	}
+
+	printf("  %d random patterns of up to %d steps: %u entered right accepted, %u entered wrong rejected, "
+			"%u verdicts early, %u wrong\n", SIM_RANDOM_PATTERNS, TOUCH_PATTERN_MAX_STEPS, accepted, rejected,
+			early, wrong);
+
+	Sim_Check(accepted == SIM_RANDOM_PATTERNS, "pattern entered right accepted on its last release");
+	Sim_Check(wrong == 0, "pattern entered wrong rejected, pads of the pattern scanned");
+	Sim_Check(early == 0, "verdict given on the last release wherever the entry went wrong");
+}
+
+/************************************************************************************
+ * @function 	Sim_Window_Edges
+ * @params 		None
+ * @brief 		Enters a two step pattern with the gap on and just past both edges
+ * 				of its window.
+ ************************************************************************************/
+static void Sim_Window_Edges(void)
+{
+	static const TOUCH_PATTERN_STEP_DEF steps[] =
+	{
+		{ TOUCH_PATTERN_PAD(3), 0, 0 },
+		{ TOUCH_PATTERN_PAD(12) | TOUCH_PATTERN_PAD(0), 250, 1500 }
+	};
+	static const int32_t offsets[] = { -1, 0, 1 };
+	uint32_t edges[2];
+	uint32_t gap;
+	uint32_t verdict_event;
+	TOUCH_PATTERN_RESULT result;
+	SIM_ENTRY entry;
+	bool ok = true;
+	uint8_t e;
+	uint8_t o;
+
+	edges[0] = Sim_Ticks(250);
+	edges[1] = Sim_Ticks(1500);
+
+	for (e = 0; e < 2; e++)
+	{
+		for (o = 0; o < 3; o++)
+		{
+			gap = edges[e] + offsets[o];
+			Touch_Pattern_Compile(&sim_pattern, steps, 2);
+			entry.num_events = 0;
+			Sim_Add_Step(&entry, steps[0].chord_mask, 0);
+			Sim_Add_Step(&entry, steps[1].chord_mask, gap);
+			result = Sim_Replay(&entry, &verdict_event);
+
+			/* Inside the window on the edge itself */
+			ok &= (result == (((gap >= edges[0]) && (gap <= edges[1])) ?
+					TOUCH_PATTERN_RESULT_ACCEPTED : TOUCH_PATTERN_RESULT_REJECTED));
+		}
+	}
+
+	/* A gap longer than the widest window saturates instead of wrapping */
+	Touch_Pattern_Compile(&sim_pattern, steps, 2);
+	entry.num_events = 0;
+	Sim_Add_Step(&entry, steps[0].chord_mask, 0);
+	Sim_Add_Step(&entry, steps[1].chord_mask, 0x10000 + edges[0]);
+	result = Sim_Replay(&entry, &verdict_event);
+
+	printf("  window of %u to %u ticks: edges %s, gap of 0x10000 + %u ticks %s\n", edges[0], edges[1],
+			ok ? "inside" : "WRONG", edges[0], (result == TOUCH_PATTERN_RESULT_REJECTED) ? "rejected" : "ACCEPTED");
+
+	Sim_Check(ok, "gap on a window edge accepted, one tick past it rejected");
+	Sim_Check(result == TOUCH_PATTERN_RESULT_REJECTED, "gap past 16 bits of ticks rejected");
+}
+
+/************************************************************************************
+ * @function 	Sim_Stall_And_Held
+ * @params 		None
+ * @brief 		Stalls an entry between and inside steps, and starts the engine with
+ * 				a pad held.
+ ************************************************************************************/
+static void Sim_Stall_And_Held(void)
+{
+	static const TOUCH_PATTERN_STEP_DEF steps[] =
+	{
+		{ TOUCH_PATTERN_PAD(15), 0, 0 },
+		{ TOUCH_PATTERN_PAD(1), 0, 3000 }
+	};
+	TOUCH_PATTERN_RESULT idle;
+	TOUCH_PATTERN_RESULT between;
+	TOUCH_PATTERN_RESULT inside;
+	TOUCH_PATTERN_RESULT held;
+
+	Touch_Pattern_Compile(&sim_pattern, steps, 2);
+
+	/* Nothing entered yet, a quiet interval is not an attempt */
+	idle = Touch_Pattern_Timeout_Event(&sim_pattern);
+
+	Touch_Pattern_Touch_Event(&sim_pattern, steps[0].chord_mask, 0);
+	Touch_Pattern_Touch_Event(&sim_pattern, 0, 100);
+	between = Touch_Pattern_Timeout_Event(&sim_pattern);
+
+	Touch_Pattern_Touch_Event(&sim_pattern, steps[0].chord_mask, 0);
+	inside = Touch_Pattern_Timeout_Event(&sim_pattern);
+
+	/* Started with the first pad held, pads touched until it is released are
+	 * not a step, the pattern entered after that is */
+	Touch_Pattern_Compile(&sim_pattern, steps, 2);
+	Touch_Pattern_Reset(&sim_pattern, steps[0].chord_mask);
+	Touch_Pattern_Touch_Event(&sim_pattern, steps[0].chord_mask | steps[1].chord_mask, 100);
+	Touch_Pattern_Touch_Event(&sim_pattern, 0, 100);
+	Touch_Pattern_Touch_Event(&sim_pattern, steps[0].chord_mask, 100);
+	Touch_Pattern_Touch_Event(&sim_pattern, 0, 100);
+	Touch_Pattern_Touch_Event(&sim_pattern, steps[1].chord_mask, 100);
+	held = Touch_Pattern_Touch_Event(&sim_pattern, 0, 100);
+
+	printf("  quiet interval: idle %d, between steps %d, inside a step %d, pad held at start then the pattern: %d\n",
+			idle, between, inside, held);
+
+	Sim_Check(idle == TOUCH_PATTERN_RESULT_NONE, "quiet interval before an entry not counted");
+	Sim_Check(between == TOUCH_PATTERN_RESULT_REJECTED, "entry stalled between steps rejected");
+	Sim_Check(inside == TOUCH_PATTERN_RESULT_REJECTED, "entry stalled inside a step rejected");
+	Sim_Check(held == TOUCH_PATTERN_RESULT_ACCEPTED, "pads held at start not taken as a step");
+}
+
+/************************************************************************************
+ * @function 	Sim_Lockout
+ * @params 		None
+ * @brief 		Fails the pattern until it locks, enters it right during and after
+ * 				the lockout.
+ ************************************************************************************/
+static void Sim_Lockout(void)
+{
+	static const TOUCH_PATTERN_STEP_DEF steps[] =
+	{
+		{ TOUCH_PATTERN_PAD(5) | TOUCH_PATTERN_PAD(6), 0, 0 },
+		{ TOUCH_PATTERN_PAD(9), 0, 3000 },
+		{ TOUCH_PATTERN_PAD(5), 500, 3000 }
+	};
+	SIM_ENTRY right;
+	SIM_ENTRY wrong;
+	TOUCH_PATTERN_RESULT result;
+	uint32_t verdict_event;
+	uint32_t fails_to_lock = 0;
+	uint32_t intervals_to_unlock = 0;
+	bool reset_on_accept;
+	bool held_out;
+
+	Touch_Pattern_Compile(&sim_pattern, steps, 3);
+	Sim_Build_Entry(&right, steps, 3, 3, false, SIM_GAP_IN_WINDOW);
+	Sim_Build_Entry(&wrong, steps, 3, 2, false, SIM_GAP_BELOW_MIN);
+
+	/* Failures in a row only, an accepted entry clears them */
+	Sim_Replay(&wrong, &verdict_event);
+	Sim_Replay(&wrong, &verdict_event);
+	Sim_Replay(&right, &verdict_event);
+	Touch_Pattern_Reset(&sim_pattern, 0);
+	Sim_Replay(&wrong, &verdict_event);
+	result = Sim_Replay(&wrong, &verdict_event);
+	reset_on_accept = (result == TOUCH_PATTERN_RESULT_REJECTED);
+
+	Touch_Pattern_Compile(&sim_pattern, steps, 3);
+	do
+	{
+		result = Sim_Replay(&wrong, &verdict_event);
+		fails_to_lock++;
+	} while ((result == TOUCH_PATTERN_RESULT_REJECTED) && (fails_to_lock < 10));
+
+	/* Touches are ignored during the lockout, the right pattern too */
+	held_out = (Sim_Replay(&right, &verdict_event) == TOUCH_PATTERN_RESULT_NONE) &&
+			(sim_pattern.e_state == TOUCH_PATTERN_STATE_LOCKED);
+
+	while ((sim_pattern.e_state == TOUCH_PATTERN_STATE_LOCKED) && (intervals_to_unlock < 100))
+	{
+		Touch_Pattern_Timeout_Event(&sim_pattern);
+		intervals_to_unlock++;
+	}
+	result = Sim_Replay(&right, &verdict_event);
+
+	printf("  locked after %u failures, right pattern %s while locked, unlocked after %u quiet intervals, "
+			"then %s\n", fails_to_lock, held_out ? "ignored" : "TAKEN", intervals_to_unlock,
+			(result == TOUCH_PATTERN_RESULT_ACCEPTED) ? "accepted" : "NOT ACCEPTED");
+
+	Sim_Check(reset_on_accept, "accepted entry clears the failures");
+	Sim_Check(fails_to_lock == TOUCH_PATTERN_MAX_FAILURES, "locked after TOUCH_PATTERN_MAX_FAILURES failures");
+	Sim_Check(held_out, "right pattern ignored while locked");
+	Sim_Check(intervals_to_unlock == TOUCH_PATTERN_LOCKOUT_INTERVALS, "lockout runs out after its intervals");
+	Sim_Check(result == TOUCH_PATTERN_RESULT_ACCEPTED, "right pattern accepted after the lockout");
+}
+
+/************************************************************************************
+ * @function 	Sim_Invalid
+ * @params 		None
+ * @brief 		Compiles patterns that do not fit the engine, then touches the pads.
+ ************************************************************************************/
+static void Sim_Invalid(void)
+{
+	static const TOUCH_PATTERN_STEP_DEF no_pads[] =
+	{
+		{ TOUCH_PATTERN_PAD(2), 0, 0 },
+		{ 0, 0, 1000 }
+	};
+	static const TOUCH_PATTERN_STEP_DEF inverted[] =
+	{
+		{ TOUCH_PATTERN_PAD(2), 0, 0 },
+		{ TOUCH_PATTERN_PAD(4), 1000, 999 }
+	};
+	TOUCH_PATTERN_STEP_DEF too_long[TOUCH_PATTERN_MAX_STEPS + 1];
+	bool compiled = false;
+	bool stays_locked = true;
+	uint8_t i;
+
+	for (i = 0; i <= TOUCH_PATTERN_MAX_STEPS; i++)
+	{
+		too_long[i].chord_mask = TOUCH_PATTERN_PAD(2);
+		too_long[i].min_gap_ms = 0;
+		too_long[i].max_gap_ms = 1000;
+	}
+
+	for (i = 0; i < 4; i++)
+	{
+		switch (i)
+		{
+		case 0: compiled |= Touch_Pattern_Compile(&sim_pattern, no_pads, 0); break;
+		case 1: compiled |= Touch_Pattern_Compile(&sim_pattern, no_pads, 2); break;
+		case 2: compiled |= Touch_Pattern_Compile(&sim_pattern, inverted, 2); break;
+		default: compiled |= Touch_Pattern_Compile(&sim_pattern, too_long, TOUCH_PATTERN_MAX_STEPS + 1); break;
+		}
+
+		/* No pads scanned, a touch or a quiet interval changes nothing */
+		stays_locked &= (sim_pattern.channels_mask == 0);
+		stays_locked &= (Touch_Pattern_Touch_Event(&sim_pattern, TOUCH_PATTERN_PAD(2), 0) == TOUCH_PATTERN_RESULT_NONE);
+		stays_locked &= (Touch_Pattern_Touch_Event(&sim_pattern, 0, 0) == TOUCH_PATTERN_RESULT_NONE);
+		stays_locked &= (Touch_Pattern_Timeout_Event(&sim_pattern) == TOUCH_PATTERN_RESULT_NONE);
+		stays_locked &= (sim_pattern.e_state == TOUCH_PATTERN_STATE_LOCKED);
+	}
+
+	printf("  empty, padless, inverted window and too long patterns: %s, %s\n",
+			compiled ? "COMPILED" : "not compiled", stays_locked ? "locked" : "NOT LOCKED");
+
+	Sim_Check(!compiled, "invalid patterns not compiled");
+	Sim_Check(stays_locked, "invalid patterns stay locked, no pads scanned");
+}
+
+int main(void)
+{
+	printf("Synthetic touch streams through the pattern engine:\n");
+	Sim_Random_Patterns();
+	Sim_Window_Edges();
+	Sim_Stall_And_Held();
+	Sim_Lockout();
+	Sim_Invalid();
+
+	return sim_failures ? 1 : 0;
+}
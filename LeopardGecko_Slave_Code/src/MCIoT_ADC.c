@@ -121,6 +121,44 @@ void ADC_Interrupt_Enable(void)
 	ADC_IntEnable(ADC0, ADC_IF_SINGLE);
 }
 
+/************************************************************************************
+ * @function 	ADC_Measure_Temp_Vdd
+ * @params 		[out] p_temp_raw - internal temperature sensor reading
+ * 				[out] p_vdd_raw - VDD/3 reading
+ * @brief 		Takes one polled reading of each against the 1.25 V reference.
+ *				The single conversion interrupt is masked meanwhile, and the
+ *				sensor channel configuration is put back afterwards. The ADC
+ *				clock has to be running.
+ ************************************************************************************/
+void ADC_Measure_Temp_Vdd(uint16_t *p_temp_raw, uint16_t *p_vdd_raw)
+{
+	ADC_InitSingle_TypeDef measure_InitSingle = ADC_INITSINGLE_DEFAULT;
+	uint32_t singlectrl = ADC0->SINGLECTRL;
+
+	ADC_IntDisable(ADC0, ADC_IF_SINGLE);
+
+	measure_InitSingle.acqTime = ADC_MEASURE_ACQ_TIME;
+	measure_InitSingle.reference = ADC_REFERENCE;
+	measure_InitSingle.resolution = ADC_RESOLUTION;
+
+	measure_InitSingle.input = adcSingleInpTemp;
+	ADC_InitSingle(ADC0, &measure_InitSingle);
+	ADC_Start(ADC0, adcStartSingle);
+	while ((ADC0->STATUS & ADC_STATUS_SINGLEDV) == 0);
+	*p_temp_raw = (uint16_t)ADC_DataSingleGet(ADC0);
+
+	measure_InitSingle.input = adcSingleInpVDDDiv3;
+	ADC_InitSingle(ADC0, &measure_InitSingle);
+	ADC_Start(ADC0, adcStartSingle);
+	while ((ADC0->STATUS & ADC_STATUS_SINGLEDV) == 0);
+	*p_vdd_raw = (uint16_t)ADC_DataSingleGet(ADC0);
+
+	ADC0->SINGLECTRL = singlectrl;
+
+	ADC_IntClear(ADC0, ADC_IF_SINGLE);
+	ADC_IntEnable(ADC0, ADC_IF_SINGLE);
+}
+
 /************************************************************************************
  * @function 	ADC0_IRQHandler
  * @params 		None
@@ -180,10 +218,10 @@ void ADC0_IRQHandler(void)
 		ADC_InitSingle(ADC0, &adc_InitSingle);
 
 	}
-	CMU_ClockEnable(cmuClock_ADC0, false);
-
 	ADC0->CMD |= ADC_CMD_SINGLESTOP;
 
+	CMU_Consumer_Stop(CMU_CONSUMER_ADC);
+
 	unblockSleepMode(1);
 
 #if 0
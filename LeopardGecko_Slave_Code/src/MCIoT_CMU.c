@@ -42,91 +42,484 @@
 #include "MCIoT_LETimer.h"
 #include "MCIoT_CMU.h"
 #include "MCIoT_Timer.h"
+#include "MCIoT_Calibration.h"
+
+/************************************ INCLUDES **************************************/
+
+/************************************* MACROS ***************************************/
+
+#define CMU_LF_TREE_LFA				0
+#define CMU_LF_TREE_LFB				1
+#define CMU_LF_TREE_MAX				2
+
+#ifdef USE_LFRCO_FOR_LEUART_IN_EM3
+#define LEUART_LF_SELECT_EM3		cmuSelect_LFRCO
+#else
+#define LEUART_LF_SELECT_EM3		cmuSelect_LFXO
+#endif
+
+/************************************* MACROS ***************************************/
+
+/********************************** ENUMERATIONS ************************************/
+
+/* Low frequency oscillators that can feed the LFA/LFB clock trees */
+typedef enum _CMU_LF_OSCILLATORS
+{
+	CMU_LF_OSC_LFXO,
+	CMU_LF_OSC_LFRCO,
+	CMU_LF_OSC_ULFRCO,
+	CMU_LF_OSC_MAX
+} CMU_LF_OSCILLATORS;
+
+/********************************** ENUMERATIONS ************************************/
+
+/************************************ GLOBALS ***************************************/
+
+/* Clock requirements of each consumer, indexed by CMU_CONSUMERS */
+static const CMU_CONSUMER_CONFIG cmu_consumer_config[CMU_CONSUMER_MAX] =
+{
+	[CMU_CONSUMER_GPIO] =
+	{
+		.branches			= CMU_BRANCH(CMU_BRANCH_HFPER) | CMU_BRANCH(CMU_BRANCH_GPIO),
+		.lf_tree			= cmuClock_LFA,
+		.lf_select_em0_em2	= cmuSelect_Disabled,
+		.lf_select_em3_em4	= cmuSelect_Disabled
+	},
+	[CMU_CONSUMER_ACMP] =
+	{
+		.branches			= CMU_BRANCH(CMU_BRANCH_HFPER) | CMU_BRANCH(CMU_BRANCH_ACMP0),
+		.lf_tree			= cmuClock_LFA,
+		.lf_select_em0_em2	= cmuSelect_Disabled,
+		.lf_select_em3_em4	= cmuSelect_Disabled
+	},
+	[CMU_CONSUMER_ADC] =
+	{
+		.branches			= CMU_BRANCH(CMU_BRANCH_HFPER) | CMU_BRANCH(CMU_BRANCH_ADC0),
+		.lf_tree			= cmuClock_LFA,
+		.lf_select_em0_em2	= cmuSelect_Disabled,
+		.lf_select_em3_em4	= cmuSelect_Disabled
+	},
+	[CMU_CONSUMER_DMA] =
+	{
+		.branches			= CMU_BRANCH(CMU_BRANCH_DMA),
+		.lf_tree			= cmuClock_LFA,
+		.lf_select_em0_em2	= cmuSelect_Disabled,
+		.lf_select_em3_em4	= cmuSelect_Disabled
+	},
+	[CMU_CONSUMER_I2C] =
+	{
+		.branches			= CMU_BRANCH(CMU_BRANCH_HFPER) | CMU_BRANCH(CMU_BRANCH_I2C1),
+		.lf_tree			= cmuClock_LFA,
+		.lf_select_em0_em2	= cmuSelect_Disabled,
+		.lf_select_em3_em4	= cmuSelect_Disabled
+	},
+	[CMU_CONSUMER_LESENSE] =
+	{
+		.branches			= CMU_BRANCH(CMU_BRANCH_HFPER) | CMU_BRANCH(CMU_BRANCH_GPIO) |
+							  CMU_BRANCH(CMU_BRANCH_ACMP0) | CMU_BRANCH(CMU_BRANCH_ACMP1) |
+							  CMU_BRANCH(CMU_BRANCH_CORELE) | CMU_BRANCH(CMU_BRANCH_LESENSE) |
+							  CMU_BRANCH(CMU_BRANCH_RTC),
+		.lf_tree			= cmuClock_LFA,
+		.lf_select_em0_em2	= cmuSelect_LFXO,
+		.lf_select_em3_em4	= cmuSelect_LFXO
+	},
+	[CMU_CONSUMER_LETIMER] =
+	{
+		.branches			= CMU_BRANCH(CMU_BRANCH_CORELE) | CMU_BRANCH(CMU_BRANCH_LETIMER0),
+		.lf_tree			= cmuClock_LFA,
+		.lf_select_em0_em2	= cmuSelect_LFXO,
+		.lf_select_em3_em4	= cmuSelect_ULFRCO
+	},
+	[CMU_CONSUMER_LEUART] =
+	{
+		.branches			= CMU_BRANCH(CMU_BRANCH_CORELE) | CMU_BRANCH(CMU_BRANCH_LEUART0),
+		.lf_tree			= cmuClock_LFB,
+		.lf_select_em0_em2	= cmuSelect_LFXO,
+		.lf_select_em3_em4	= LEUART_LF_SELECT_EM3
+	},
+	[CMU_CONSUMER_OSC_CALIBRATION] =
+	{
+		.branches			= CMU_BRANCH(CMU_BRANCH_HFPER) | CMU_BRANCH(CMU_BRANCH_TIMER0) |
+							  CMU_BRANCH(CMU_BRANCH_TIMER1),
+		.lf_tree			= cmuClock_LFA,
+		.lf_select_em0_em2	= cmuSelect_Disabled,
+		.lf_select_em3_em4	= cmuSelect_Disabled
+	},
+	[CMU_CONSUMER_OSC_CALIBRATION_LFXO] =
+	{
+		/* Reference count of the ULFRCO calibration, LETIMER0 on the LFXO in any mode */
+		.branches			= CMU_BRANCH(CMU_BRANCH_CORELE) | CMU_BRANCH(CMU_BRANCH_LETIMER0),
+		.lf_tree			= cmuClock_LFA,
+		.lf_select_em0_em2	= cmuSelect_LFXO,
+		.lf_select_em3_em4	= cmuSelect_LFXO
+	},
+	[CMU_CONSUMER_RTC] =
+	{
+		/* Shares the LFA tree with LETIMER0, so it follows the same source */
+		.branches			= CMU_BRANCH(CMU_BRANCH_CORELE) | CMU_BRANCH(CMU_BRANCH_RTC),
+		.lf_tree			= cmuClock_LFA,
+		.lf_select_em0_em2	= cmuSelect_LFXO,
+		.lf_select_em3_em4	= cmuSelect_ULFRCO
+	}
+};
+
+/* emlib clock for each planner branch, indexed by CMU_CLOCK_BRANCHES */
+static const CMU_Clock_TypeDef cmu_branch_clock[CMU_BRANCH_MAX] =
+{
+	[CMU_BRANCH_HFPER]		= cmuClock_HFPER,
+	[CMU_BRANCH_GPIO]		= cmuClock_GPIO,
+	[CMU_BRANCH_ACMP0]		= cmuClock_ACMP0,
+	[CMU_BRANCH_ACMP1]		= cmuClock_ACMP1,
+	[CMU_BRANCH_ADC0]		= cmuClock_ADC0,
+	[CMU_BRANCH_DMA]		= cmuClock_DMA,
+	[CMU_BRANCH_I2C1]		= cmuClock_I2C1,
+	[CMU_BRANCH_TIMER0]		= cmuClock_TIMER0,
+	[CMU_BRANCH_TIMER1]		= cmuClock_TIMER1,
+	[CMU_BRANCH_CORELE]		= cmuClock_CORELE,
+	[CMU_BRANCH_LETIMER0]	= cmuClock_LETIMER0,
+	[CMU_BRANCH_LEUART0]	= cmuClock_LEUART0,
+	[CMU_BRANCH_LESENSE]	= cmuClock_LESENSE,
+	[CMU_BRANCH_RTC]		= cmuClock_RTC
+};
+
+static const CMU_Osc_TypeDef cmu_lf_osc[CMU_LF_OSC_MAX] =
+{
+	[CMU_LF_OSC_LFXO]		= cmuOsc_LFXO,
+	[CMU_LF_OSC_LFRCO]		= cmuOsc_LFRCO,
+	[CMU_LF_OSC_ULFRCO]		= cmuOsc_ULFRCO
+};
+
+/* Number of active consumers holding each branch, oscillator and LF tree */
+static uint8_t cmu_branch_refs[CMU_BRANCH_MAX];
+static uint8_t cmu_lf_osc_refs[CMU_LF_OSC_MAX];
+static uint8_t cmu_lf_tree_refs[CMU_LF_TREE_MAX];
+
+/* CMU_CONSUMERS bitmask of the consumers that are started */
+static uint32_t cmu_active_consumers;
+
+/* LF source each consumer was started with, so that stop releases the same one */
+static CMU_Select_TypeDef cmu_consumer_lf_select[CMU_CONSUMER_MAX];
+
+/* Source of each LF tree while it has consumers. All consumers on a tree run
+ * from the same source, a consumer asking for another one is not started */
+static CMU_Select_TypeDef cmu_lf_tree_select[CMU_LF_TREE_MAX];
+
+/************************************ GLOBALS ***************************************/
 
 /************************************************************************************
- * @function 	CMU_SetUp
- * @params 		None
- * @brief 		Configures and starts necessary clocks.
- ************************************************************************************/
-void CMU_SetUp(void)
+ * @function 	CMU_Consumer_LF_Select
+ * @params 		[in] e_consumer - clock consumer
+ * @brief 		Returns the LF tree source the consumer needs in the current
+ *				LETIMER energy mode.
+ ************************************************************************************/
+static CMU_Select_TypeDef CMU_Consumer_LF_Select(CMU_CONSUMERS e_consumer)
 {
-	CMU_ClockEnable(cmuClock_CORELE, true); /* To enable the low frequency clock tree */
+	if (e_letimer_energy_modes >= ENERGY_MODE_EM3)
+	{
+		return cmu_consumer_config[e_consumer].lf_select_em3_em4;
+	}
 
-	if (e_letimer_energy_modes == ENERGY_MODE_EM3)
+	return cmu_consumer_config[e_consumer].lf_select_em0_em2;
+}
+
+/************************************************************************************
+ * @function 	CMU_LF_Osc_From_Select
+ * @params 		[in] lf_select - LF tree source
+ * @brief 		Maps an LF tree source onto the oscillator that drives it.
+ ************************************************************************************/
+static CMU_LF_OSCILLATORS CMU_LF_Osc_From_Select(CMU_Select_TypeDef lf_select)
+{
+	if (lf_select == cmuSelect_LFRCO)
+	{
+		return CMU_LF_OSC_LFRCO;
+	}
+	else if (lf_select == cmuSelect_ULFRCO)
 	{
-		/* Enable necessary clocks */
-		CMU_OscillatorEnable(cmuOsc_ULFRCO, true, true); /* To enable the LFXO */
-		CMU_ClockSelectSet(cmuClock_LFA, cmuSelect_ULFRCO); /* To support energy modes EM0-EM2 */
-		CMU_ClockEnable(cmuClock_LETIMER0, true); /* To enable the LFA clock tree to LETimer0 */
+		return CMU_LF_OSC_ULFRCO;
+	}
 
-#ifdef ULFRCO_SELF_CALIBRATE
+	return CMU_LF_OSC_LFXO;
+}
 
-		/* Perform self calibration of ULFRCO */
-		CMU_ClockEnable(cmuClock_TIMER0, true); /* To enable HFPER clock tree for Timer0 peripheral */
-		CMU_ClockEnable(cmuClock_TIMER1, true); /* To enable HFPER clock tree for Timer1 peripheral */
+/************************************************************************************
+ * @function 	CMU_LF_Tree_Index
+ * @params 		[in] lf_tree - cmuClock_LFA or cmuClock_LFB
+ * @brief 		Maps an LF tree onto its index in the reference counts.
+ ************************************************************************************/
+static uint8_t CMU_LF_Tree_Index(CMU_Clock_TypeDef lf_tree)
+{
+	return (lf_tree == cmuClock_LFB) ? CMU_LF_TREE_LFB : CMU_LF_TREE_LFA;
+}
 
-		/* Routine to self calibrate ULFRCO */
-		Calibrate_ULFRCO();
+/************************************************************************************
+ * @function 	CMU_Consumer_Prepare
+ * @params 		[in] e_consumer - clock consumer that will be started later
+ * @brief 		Starts the LF oscillator of a consumer without waiting for it to be
+ *				ready, so that its start-up overlaps with other work. No reference
+ *				is taken, CMU_Consumer_Start() must still be called.
+ ************************************************************************************/
+void CMU_Consumer_Prepare(CMU_CONSUMERS e_consumer)
+{
+	CMU_Select_TypeDef lf_select = CMU_Consumer_LF_Select(e_consumer);
 
-		CMU_OscillatorEnable(cmuOsc_ULFRCO, true, true); /* To enable the LFXO */
-		CMU_ClockSelectSet(cmuClock_LFA, cmuSelect_ULFRCO); /* To support energy modes EM0-EM2 */
+	if (lf_select != cmuSelect_Disabled)
+	{
+		CMU_OscillatorEnable(cmu_lf_osc[CMU_LF_Osc_From_Select(lf_select)], true, false);
+	}
+}
 
+/************************************************************************************
+ * @function 	CMU_Consumer_Start
+ * @params 		[in] e_consumer - clock consumer
+ * @brief 		Enables the oscillator, LF tree and clock branches the consumer
+ *				needs. Clocks shared with other active consumers are reference
+ *				counted. Starting a consumer that is already active does nothing.
+ *				The references are taken and the oscillator is started with
+ *				interrupts masked, the wait for the oscillator is done with them
+ *				enabled. The LF tree is switched over once the oscillator is ready.
+ *				Returns false, and starts nothing, if the LF tree is held by
+ *				consumers running from another source.
+ ************************************************************************************/
+bool CMU_Consumer_Start(CMU_CONSUMERS e_consumer)
+{
+	const CMU_CONSUMER_CONFIG *p_config = &cmu_consumer_config[e_consumer];
+	CMU_Select_TypeDef lf_select = cmuSelect_Disabled;
+	uint8_t lf_tree = CMU_LF_Tree_Index(p_config->lf_tree);
+	bool started = true;
+	int branch;
+
+#ifdef USE_INT
+	INT_Disable();
+#else
+	CORE_DECLARE_IRQ_STATE;
+	CORE_ENTER_ATOMIC();
 #endif
 
+	if ((cmu_active_consumers & (1UL << e_consumer)) == 0)
+	{
+		lf_select = CMU_Consumer_LF_Select(e_consumer);
+
+		/* Re-sourcing the tree would change the clock of the consumers on it */
+		if ((lf_select != cmuSelect_Disabled) && (cmu_lf_tree_refs[lf_tree] != 0) &&
+			(cmu_lf_tree_select[lf_tree] != lf_select))
+		{
+			lf_select = cmuSelect_Disabled;
+			started = false;
+		}
+		else
+		{
+			cmu_active_consumers |= (1UL << e_consumer);
+			cmu_consumer_lf_select[e_consumer] = lf_select;
+
+			if (lf_select != cmuSelect_Disabled)
+			{
+				/* Started without waiting, the wait is done below */
+				if (cmu_lf_osc_refs[CMU_LF_Osc_From_Select(lf_select)]++ == 0)
+				{
+					CMU_OscillatorEnable(cmu_lf_osc[CMU_LF_Osc_From_Select(lf_select)], true, false);
+				}
+
+				cmu_lf_tree_refs[lf_tree]++;
+				cmu_lf_tree_select[lf_tree] = lf_select;
+			}
+
+			for (branch = 0; branch < CMU_BRANCH_MAX; branch++)
+			{
+				if ((p_config->branches & CMU_BRANCH(branch)) && (cmu_branch_refs[branch]++ == 0))
+				{
+					CMU_ClockEnable(cmu_branch_clock[branch], true);
+				}
+			}
+		}
 	}
-	else
+
+#ifdef USE_INT
+	INT_Enable();
+#else
+	CORE_EXIT_ATOMIC();
+#endif
+
+	if (lf_select == cmuSelect_Disabled)
 	{
-		/* Enable necessary clocks */
-		CMU_OscillatorEnable(cmuOsc_LFXO, true, true); /* To enable the LFXO */
-		CMU_ClockSelectSet(cmuClock_LFA, cmuSelect_LFXO); /* To support energy modes EM0-EM2 */
-		CMU_ClockEnable(cmuClock_LETIMER0, true); /* To enable the LFA clock tree to LETimer0 */
+		return started;
 	}
 
-	CMU_ClockEnable(cmuClock_HFPER, true); 	/* To enable the clock tree for Timer peripherals */
+	/* Only blocks if the oscillator has not been prepared or is still starting */
+	CMU_OscillatorEnable(cmu_lf_osc[CMU_LF_Osc_From_Select(lf_select)], true, true);
 
-#ifndef USE_ACTIVE_ALS
-	CMU_ClockEnable(cmuClock_ACMP0, true); 	/* To enable clock to ACMP0 */
+#ifdef USE_INT
+	INT_Disable();
+#else
+	CORE_ENTER_ATOMIC();
 #endif
 
-#ifdef ENABLE_ADC_MODULE
-	CMU_ClockEnable(cmuClock_ADC0, true); 	/* To enable clock to ADC0 */
-#endif
+	/* The consumer may have been stopped from an interrupt while waiting */
+	if (((cmu_active_consumers & (1UL << e_consumer)) != 0) &&
+		(cmu_lf_tree_select[lf_tree] == lf_select))
+	{
+		CMU_ClockSelectSet(p_config->lf_tree, lf_select);
+	}
 
-#ifdef USE_DMA_FOR_ADC
-	CMU_ClockEnable(cmuClock_DMA, true); 	/* To enable clock to DMA */
+#ifdef USE_INT
+	INT_Enable();
+#else
+	CORE_EXIT_ATOMIC();
 #endif
 
-	CMU_ClockEnable(cmuClock_GPIO, true);	/* To enable clock to GPIO */
+	return true;
+}
 
-#ifdef USE_ACTIVE_ALS
-	CMU_ClockEnable(cmuClock_I2C1, true); 	/* To enable clock to I2C1 */
+/************************************************************************************
+ * @function 	CMU_Consumer_Stop
+ * @params 		[in] e_consumer - clock consumer
+ * @brief 		Releases the clocks of a consumer. Branches, LF trees and
+ *				oscillators that no other active consumer holds are turned off.
+ ************************************************************************************/
+void CMU_Consumer_Stop(CMU_CONSUMERS e_consumer)
+{
+	const CMU_CONSUMER_CONFIG *p_config = &cmu_consumer_config[e_consumer];
+	CMU_Select_TypeDef lf_select;
+	CMU_LF_OSCILLATORS e_lf_osc;
+	uint8_t lf_tree;
+	int branch;
+
+#ifdef USE_INT
+	INT_Disable();
+#else
+	CORE_DECLARE_IRQ_STATE;
+	CORE_ENTER_ATOMIC();
 #endif
 
-#ifdef ENABLE_LEUART_MODULE
-	if (e_letimer_energy_modes == ENERGY_MODE_EM3)
+	if ((cmu_active_consumers & (1UL << e_consumer)) != 0)
 	{
-#ifdef USE_LFRCO_FOR_LEUART_IN_EM3
-		CMU_OscillatorEnable(cmuOsc_LFXO, false, false); /* To enable the LFXO */
-		CMU_OscillatorEnable(cmuOsc_LFRCO, true, true); /* To enable the LFXO */
-		CMU_ClockSelectSet(cmuClock_LFB, cmuSelect_LFRCO); /* To support energy modes EM0-EM2 */
+		cmu_active_consumers &= ~(1UL << e_consumer);
+
+		/* Release in reverse order, LE branches before CORELE */
+		for (branch = CMU_BRANCH_MAX - 1; branch >= 0; branch--)
+		{
+			if ((p_config->branches & CMU_BRANCH(branch)) && (--cmu_branch_refs[branch] == 0))
+			{
+				CMU_ClockEnable(cmu_branch_clock[branch], false);
+			}
+		}
+
+		lf_select = cmu_consumer_lf_select[e_consumer];
+
+		if (lf_select != cmuSelect_Disabled)
+		{
+			e_lf_osc = CMU_LF_Osc_From_Select(lf_select);
+			lf_tree = CMU_LF_Tree_Index(p_config->lf_tree);
+
+			/* Disabled once nobody is left on the tree */
+			if (--cmu_lf_tree_refs[lf_tree] == 0)
+			{
+				cmu_lf_tree_select[lf_tree] = cmuSelect_Disabled;
+				CMU_ClockSelectSet(p_config->lf_tree, cmuSelect_Disabled);
+			}
+
+			/* The ULFRCO cannot be turned off */
+			if ((--cmu_lf_osc_refs[e_lf_osc] == 0) && (e_lf_osc != CMU_LF_OSC_ULFRCO))
+			{
+				CMU_OscillatorEnable(cmu_lf_osc[e_lf_osc], false, false);
+			}
+		}
+	}
+
+#ifdef USE_INT
+	INT_Enable();
 #else
-		CMU_ClockSelectSet(cmuClock_LFB, cmuSelect_LFXO); /* To support energy modes EM0-EM2 */
+	CORE_EXIT_ATOMIC();
 #endif
-	}
-	else
+}
+
+/************************************************************************************
+ * @function 	CMU_Is_LFXO_In_Use
+ * @params 		None
+ * @brief 		Returns true if an active consumer runs from the LFXO.
+ ************************************************************************************/
+bool CMU_Is_LFXO_In_Use(void)
+{
+	return (cmu_lf_osc_refs[CMU_LF_OSC_LFXO] != 0);
+}
+
+/************************************************************************************
+ * @function 	CMU_SetUp
+ * @params 		None
+ * @brief 		Configures and starts necessary clocks.
+ ************************************************************************************/
+void CMU_SetUp(void)
+{
+	CMU_SetUp_LF_Clocks();
+
+	CMU_SetUp_HF_Clocks();
+}
+
+/************************************************************************************
+ * @function 	CMU_SetUp_LF_Clocks
+ * @params 		None
+ * @brief 		Routes the low frequency clock trees to LETIMER0 and LEUART0.
+ ************************************************************************************/
+void CMU_SetUp_LF_Clocks(void)
+{
+	/* LFXO for energy modes EM0-EM2, ULFRCO for EM3 */
+	CMU_Consumer_Start(CMU_CONSUMER_LETIMER);
+
+#ifdef ULFRCO_SELF_CALIBRATE
+	if (e_letimer_energy_modes == ENERGY_MODE_EM3)
 	{
-		CMU_ClockSelectSet(cmuClock_LFB, cmuSelect_LFXO); /* To support energy modes EM0-EM2 */
+#ifdef USE_CALIBRATION_RECORD
+		/* The stored ratio holds while temperature and supply have not drifted */
+		if (false == Calibration_Record_Osc_Ratio(&osc_ratio))
+#endif
+		{
+			/* Perform self calibration of ULFRCO on TIMER0/TIMER1 */
+			CMU_Consumer_Start(CMU_CONSUMER_OSC_CALIBRATION);
+
+			/* Routine to self calibrate ULFRCO */
+			Calibrate_ULFRCO();
+
+			CMU_Consumer_Stop(CMU_CONSUMER_OSC_CALIBRATION);
+		}
 	}
+#endif
+
+#ifdef ENABLE_LEUART_MODULE
+	CMU_Consumer_Start(CMU_CONSUMER_LEUART);
+#endif
+}
+
+/************************************************************************************
+ * @function 	CMU_SetUp_HF_Clocks
+ * @params 		None
+ * @brief 		Enables the high frequency peripheral clocks needed during set up.
+ *				None of these depend on the LFXO, so they are set up while the
+ *				LFXO is still starting. ACMP0 and ADC0 are gated per sample by the
+ *				LETIMER0 interrupt.
+ ************************************************************************************/
+void CMU_SetUp_HF_Clocks(void)
+{
+	CMU_Consumer_Start(CMU_CONSUMER_GPIO);
 
-	CMU_ClockEnable(cmuClock_LEUART0, true);    /* Enable LEUART0 clock */
+#ifdef ENABLE_ADC_MODULE
+	CMU_Consumer_Start(CMU_CONSUMER_ADC);
 #endif
 
+#if defined(USE_DMA_FOR_ADC) || defined(USE_DMA_FOR_LESENSE)
+	CMU_Consumer_Start(CMU_CONSUMER_DMA);
+#endif
+
+#ifdef USE_ACTIVE_ALS
+	CMU_Consumer_Start(CMU_CONSUMER_I2C);
+#endif
 }
 
 /************************************************************************************
  * @function 	Calibrate_ULFRCO
  * @params 		None
- * @brief 		Routine to self calibrate ULFRCO.
+ * @brief 		Routine to self calibrate ULFRCO. Counts the ULFRCO on the LFA tree
+ *				held by the LETIMER0 consumer, then hands the tree to the LFXO
+ *				count and back. LETIMER0 has not been started yet, so nothing
+ *				runs from the tree while it is switched.
  ************************************************************************************/
 void Calibrate_ULFRCO(void)
 {
@@ -192,22 +585,18 @@ void Calibrate_ULFRCO(void)
 	TIMER1->CNT = 0;
 	TIMER0->CNT = 0;
 
-	CMU_OscillatorEnable(cmuOsc_ULFRCO, false, false); /* To disable the ULFRCO */
-
-	CMU_OscillatorEnable(cmuOsc_LFXO, true, true); /* To enable the LFXO */
-	CMU_ClockSelectSet(cmuClock_LFA, cmuSelect_LFXO); /* To support energy modes EM0-EM2 */
-	CMU_ClockEnable(cmuClock_LETIMER0, true); /* To enable the LFA clock tree to LETimer0 */
+	/* Route the LFXO to LETIMER0, the LFA tree only has one source at a time */
+	CMU_Consumer_Stop(CMU_CONSUMER_LETIMER);
+	CMU_Consumer_Start(CMU_CONSUMER_OSC_CALIBRATION_LFXO);
 
 	/* Obtain LFXO count */
 	CMU_Obtain_Freq_Count(&lfxo_count, LFXO_FREQUENCY, CALIBRATION_PERIOD);
 
-	osc_ratio = (float)lfxo_count/(float)ulfrco_count;
-
-	CMU_OscillatorEnable(cmuOsc_LFXO, false, false); /* To disable the LFXO */
-
-	CMU_ClockEnable(cmuClock_TIMER0, false); /* To disable HFPER clock tree for Timer0 peripheral */
-	CMU_ClockEnable(cmuClock_TIMER1, false); /* To disable HFPER clock tree for Timer1 peripheral */
+	/* Back to the ULFRCO for LETIMER0 */
+	CMU_Consumer_Stop(CMU_CONSUMER_OSC_CALIBRATION_LFXO);
+	CMU_Consumer_Start(CMU_CONSUMER_LETIMER);
 
+	osc_ratio = (uint32_t)(((uint64_t)lfxo_count << OSC_RATIO_FRAC_BITS) / ulfrco_count);
 }
 
 void CMU_Obtain_Freq_Count(uint32_t *count, uint32_t freq,
@@ -236,52 +625,44 @@ void CMU_Obtain_Freq_Count(uint32_t *count, uint32_t freq,
 }
 
 /************************************************************************************
- * @function 	check_and_comp_prescaler_if
- * @params 		[in] period - duration that has to be achieved (greater than 2 secs)
- * 				[in] osc_cnt - Oscillator count value
- * @brief 		Check if prescaler value needs to be computed and write the PRESCALER
- *				register in CMU to reduce the LFXO frequency.
- ************************************************************************************/
-void check_and_comp_prescaler_if(float period, uint32_t osc_cnt)
+ * @function 	CMU_Set_LETimer_Prescaler
+ * @params 		[in] e_energy_mode - energy mode the LETIMER0 will run in
+ * @brief 		Writes the compile time LETIMER0 prescaler for the energy mode into
+ *				the LFAPRESC0 register in CMU.
+ ************************************************************************************/
+void CMU_Set_LETimer_Prescaler(ENERGY_MODES e_energy_mode)
 {
-	//uint32_t cmu_sync_busy;
-
-	if (period > MAX_PERIOD_32kHZ)
-	{
-		cal_prescaler_value(period, osc_cnt);
-	}
-	else
-	{
-		letimer0_prescaler = 0;
-		prescaled_two_power = 1;
-	}
-
-	CMU->LFAPRESC0 |= letimer0_prescaler << _CMU_LFAPRESC0_LETIMER0_SHIFT;
-
-	//while ((cmu_sync_busy = CMU->SYNCBUSY & CMU_SYNCBUSY_LFAPRESC0) == CMU_SYNCBUSY_LFAPRESC0);
+	CMU->LFAPRESC0 = (CMU->LFAPRESC0 & ~_CMU_LFAPRESC0_LETIMER0_MASK) |
+			((uint32_t)letimer_timing_config[e_energy_mode].prescaler << _CMU_LFAPRESC0_LETIMER0_SHIFT);
 }
 
 /************************************************************************************
- * @function 	cal_prescaler_value
- * @params 		[in] period - duration that has to be achieved (greater than 2 secs)
- * 				[in] osc_cnt - Oscillator count value
- * @brief 		Calculates the prescaler value that will divide the clock to achieve
- *				time duration greater than 2 seconds.
- * @credits		Slides from Professor Keith Graham
- ************************************************************************************/
-void cal_prescaler_value(float period, uint32_t osc_cnt)
+ * @function 	CMU_LF_Ticks_To_us
+ * @params 		[in] lf_select - source of the LF tree the ticks were counted on
+ * 				[in] ticks - oscillator ticks, prescaler included
+ * @brief 		Converts LF ticks to us, saturating at CMU_LF_US_MAX. ULFRCO ticks
+ *				are scaled with the self calibrated osc_ratio, as the ULFRCO can
+ *				run tens of percent off its nominal frequency.
+ ************************************************************************************/
+uint32_t CMU_LF_Ticks_To_us(CMU_Select_TypeDef lf_select, uint64_t ticks)
 {
-	uint32_t desired_period = 0;
-	uint32_t temp = 0;
+	uint64_t us;
 
-	desired_period = period * osc_cnt;
-	temp = desired_period/1;
-	prescaled_two_power = 1;
-
-	while(temp > LETIMER0_MAX_COUNT)
+	if (lf_select != cmuSelect_ULFRCO)
 	{
-		letimer0_prescaler++;
-		prescaled_two_power = prescaled_two_power * 2;
-		temp = desired_period/prescaled_two_power;
+		/* The LFXO and the LFRCO both run at 32.768 kHz */
+		us = (ticks * 1000000) / LFXO_FREQUENCY;
 	}
+	else
+	{
+		us = (ticks * 1000000) / ULFRCO_FREQUENCY;
+
+		/* osc_ratio is the measured ULFRCO frequency over the nominal one */
+		if ((osc_ratio != 0) && (us <= ((uint64_t)CMU_LF_US_MAX << 1)))
+		{
+			us = (us << OSC_RATIO_FRAC_BITS) / osc_ratio;
+		}
+	}
+
+	return (us > CMU_LF_US_MAX) ? CMU_LF_US_MAX : (uint32_t)us;
 }
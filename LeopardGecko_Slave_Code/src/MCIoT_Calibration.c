@@ -0,0 +1,274 @@
+/*****************************************************************************
+ * @file 	MCIoT_Calibration.c
+ * @brief 	This file describes the calibration record kept in the last flash
+ * 			page. It holds the touch pad baselines and thresholds and the ULFRCO
+ * 			ratio, so a boot at a similar temperature and supply can skip the
+ * 			settling scans and the oscillator calibration.
+ * @author 	Pavan Dhareshwar
+ * @version 1.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2013 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ ************************************************************************************/
+
+/************************************ INCLUDES **************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "em_msc.h"
+#include "MCIoT_Calibration.h"
+
+/************************************ INCLUDES **************************************/
+
+/************************************ GLOBALS ***************************************/
+
+/* Conditions at this boot, a record written now is stamped with them */
+static bool boot_conditions_known;
+static uint16_t boot_temp_raw;
+static uint16_t boot_vdd_raw;
+
+/* The touch part of calibration_record can be dropped on its own, the ULFRCO
+ * ratio stays usable */
+static bool calibration_touch_valid;
+
+/************************************ GLOBALS ***************************************/
+
+/****************************** FUNCTION PROTOTYPES *********************************/
+
+static uint32_t Calibration_Record_CRC(const CALIBRATION_RECORD *p_record);
+
+static uint16_t Calibration_Abs_Diff(uint16_t a, uint16_t b);
+
+/****************************** FUNCTION PROTOTYPES *********************************/
+
+/************************************************************************************
+ * @function 	Calibration_Record_Load
+ * @params 		[in] temp_raw - temperature sensor reading at this boot
+ * 				[in] vdd_raw - VDD/3 reading at this boot
+ * @brief 		Copies the flash record to calibration_record if it is intact and
+ *				was written at a similar temperature and supply. Returns whether
+ *				calibration_record_valid was set.
+ ************************************************************************************/
+bool Calibration_Record_Load(uint16_t temp_raw, uint16_t vdd_raw)
+{
+	const CALIBRATION_RECORD *p_flash = (const CALIBRATION_RECORD *)CAL_RECORD_FLASH_ADDR;
+
+	boot_temp_raw = temp_raw;
+	boot_vdd_raw = vdd_raw;
+	boot_conditions_known = true;
+
+	calibration_record_valid = false;
+
+	/* An erased page reads as all ones and fails the magic check */
+	if ((p_flash->magic != CAL_RECORD_MAGIC) || (p_flash->version != CAL_RECORD_VERSION)
+			|| (p_flash->size != sizeof(CALIBRATION_RECORD)))
+	{
+		return false;
+	}
+
+	if (p_flash->crc != Calibration_Record_CRC(p_flash))
+	{
+		return false;
+	}
+
+	if ((Calibration_Abs_Diff(temp_raw, p_flash->temp_raw) > CAL_RECORD_MAX_TEMP_DRIFT)
+			|| (Calibration_Abs_Diff(vdd_raw, p_flash->vdd_raw) > CAL_RECORD_MAX_VDD_DRIFT))
+	{
+		return false;
+	}
+
+	calibration_record = *p_flash;
+	calibration_record_valid = true;
+	calibration_touch_valid = true;
+
+	return true;
+}
+
+/************************************************************************************
+ * @function 	Calibration_Record_Touch_Valid
+ * @params 		[in] channels_used_mask - LESENSE channels in use
+ * @brief 		Returns true if the touch baselines and thresholds of the record
+ *				can be used for these channels.
+ ************************************************************************************/
+bool Calibration_Record_Touch_Valid(uint16_t channels_used_mask)
+{
+	return (true == calibration_record_valid) && (true == calibration_touch_valid)
+			&& (calibration_record.channels_used_mask == channels_used_mask);
+}
+
+/************************************************************************************
+ * @function 	Calibration_Record_Drop_Touch
+ * @params 		None
+ * @brief 		Drops the touch part of the record once a fresh scan disagrees
+ *				with it. The ULFRCO ratio is kept, and the next save rewrites
+ *				the page.
+ ************************************************************************************/
+void Calibration_Record_Drop_Touch(void)
+{
+	calibration_touch_valid = false;
+}
+
+/************************************************************************************
+ * @function 	Calibration_Record_Baseline_Matches
+ * @params 		[in] channel - LESENSE channel
+ * 				[in] count - fresh count of the channel
+ * @brief 		A count matches the stored baseline if it is within half the
+ *				distance between the stored baseline and threshold, so a stale
+ *				baseline can neither hide a touch nor raise a false one.
+ ************************************************************************************/
+bool Calibration_Record_Baseline_Matches(uint8_t channel, uint16_t count)
+{
+	uint16_t baseline = calibration_record.baseline[channel];
+	uint16_t threshold = calibration_record.threshold[channel];
+	uint16_t margin = (baseline > threshold) ? ((baseline - threshold) / 2) : 0;
+
+	return (Calibration_Abs_Diff(count, baseline) <= margin);
+}
+
+/************************************************************************************
+ * @function 	Calibration_Record_Osc_Ratio
+ * @params 		[out] p_osc_ratio - ULFRCO ratio from the record
+ * @brief 		Returns false, leaving p_osc_ratio untouched, if there is no valid
+ *				record or the ULFRCO was not calibrated when it was written.
+ ************************************************************************************/
+bool Calibration_Record_Osc_Ratio(uint32_t *p_osc_ratio)
+{
+	if ((false == calibration_record_valid) || (calibration_record.osc_ratio == 0))
+	{
+		return false;
+	}
+
+	*p_osc_ratio = calibration_record.osc_ratio;
+
+	return true;
+}
+
+/************************************************************************************
+ * @function 	Calibration_Record_Save
+ * @params 		[in] channels_used_mask - LESENSE channels in use
+ * 				[in] p_baseline - baseline count of each channel
+ * 				[in] p_threshold - threshold of each channel
+ * 				[in] osc_ratio - ULFRCO ratio, 0 if not calibrated
+ * @brief 		Writes a new record stamped with the conditions at this boot. The
+ *				page is left alone while the loaded record still matches, to keep
+ *				flash wear down. Does nothing if Calibration_Record_Load was not
+ *				called, as the record could not be checked for drift later.
+ ************************************************************************************/
+void Calibration_Record_Save(uint16_t channels_used_mask, const uint16_t *p_baseline, const uint16_t *p_threshold, uint32_t osc_ratio)
+{
+	CALIBRATION_RECORD record;
+	bool unchanged;
+	uint8_t i;
+
+	if (false == boot_conditions_known)
+	{
+		return;
+	}
+
+	if ((true == calibration_record_valid) && (true == calibration_touch_valid))
+	{
+		unchanged = (calibration_record.channels_used_mask == channels_used_mask)
+				&& (calibration_record.osc_ratio == osc_ratio);
+
+		for (i = 0; (true == unchanged) && (i < CAL_RECORD_CHANNELS); i++)
+		{
+			if ((channels_used_mask & (1 << i)) && (false == Calibration_Record_Baseline_Matches(i, p_baseline[i])))
+			{
+				unchanged = false;
+			}
+		}
+
+		if (true == unchanged)
+		{
+			return;
+		}
+	}
+
+	record.magic = CAL_RECORD_MAGIC;
+	record.version = CAL_RECORD_VERSION;
+	record.size = sizeof(CALIBRATION_RECORD);
+	record.channels_used_mask = channels_used_mask;
+	record.temp_raw = boot_temp_raw;
+	record.vdd_raw = boot_vdd_raw;
+	record.reserved = 0;
+	record.osc_ratio = osc_ratio;
+	memcpy(record.baseline, p_baseline, sizeof(record.baseline));
+	memcpy(record.threshold, p_threshold, sizeof(record.threshold));
+	record.crc = Calibration_Record_CRC(&record);
+
+	/* A reset between the erase and the write leaves an erased page, which
+	 * only costs a full calibration on the next boot */
+	MSC_Init();
+
+	if ((mscReturnOk == MSC_ErasePage(CAL_RECORD_FLASH_ADDR))
+			&& (mscReturnOk == MSC_WriteWord(CAL_RECORD_FLASH_ADDR, &record, sizeof(CALIBRATION_RECORD))))
+	{
+		calibration_record = record;
+		calibration_record_valid = true;
+		calibration_touch_valid = true;
+	}
+
+	MSC_Deinit();
+}
+
+/************************************************************************************
+ * @function 	Calibration_Record_CRC
+ * @params 		[in] p_record - record to check
+ * @brief 		CRC-32 (reflected, polynomial 0xEDB88320) of the record up to the
+ *				crc field. Bitwise, as it only runs once per boot.
+ ************************************************************************************/
+static uint32_t Calibration_Record_CRC(const CALIBRATION_RECORD *p_record)
+{
+	const uint8_t *p_byte = (const uint8_t *)p_record;
+	uint32_t crc = 0xFFFFFFFF;
+	uint32_t i;
+	uint8_t bit;
+
+	for (i = 0; i < offsetof(CALIBRATION_RECORD, crc); i++)
+	{
+		crc ^= p_byte[i];
+
+		for (bit = 0; bit < 8; bit++)
+		{
+			crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+		}
+	}
+
+	return ~crc;
+}
+
+/************************************************************************************
+ * @function 	Calibration_Abs_Diff
+ * @params 		[in] a, b - values to compare
+ * @brief 		Returns the distance between two unsigned readings.
+ ************************************************************************************/
+static uint16_t Calibration_Abs_Diff(uint16_t a, uint16_t b)
+{
+	return (a > b) ? (a - b) : (b - a);
+}
@@ -0,0 +1,230 @@
+/*****************************************************************************
+ * @file 	MCIoT_CoreProfile.c
+ * @brief 	This file times the sections interrupts are masked in. emlib calls
+ * 			the hooks below on every CORE_ENTER_* and CORE_EXIT_*, the worst
+ * 			time of each call site is kept in core_profile_table.
+ * @author 	Pavan Dhareshwar
+ * @version 1.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2013 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ ************************************************************************************/
+
+
+/************************************ INCLUDES **************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "em_device.h"
+#include "em_core.h"
+#include "MCIoT_CoreProfile.h"
+
+/************************************ INCLUDES **************************************/
+
+#if defined(CORE_PROFILE_HOOKS) && (CORE_PROFILE_HOOKS == 1)
+
+/********************************** ENUMERATIONS ************************************/
+
+/* A section that is open */
+typedef struct _CORE_PROFILE_FRAME_
+{
+	uint32_t	call_site;
+	uint32_t	start_cycles;
+	bool		outermost;			/* Opened with interrupts enabled, timed on exit */
+} CORE_PROFILE_FRAME;
+
+/********************************** ENUMERATIONS ************************************/
+
+/************************************ GLOBALS ***************************************/
+
+CORE_PROFILE_ENTRY core_profile_table[CORE_PROFILE_TABLE_SIZE];
+
+/* One frame per nesting level. A CRITICAL section inside a BASEPRI ATOMIC
+ * section, or the sections of an interrupt taken during a yield, open on top
+ * of the section they interrupt and do not overwrite its start */
+static CORE_PROFILE_FRAME core_profile_stack[CORE_PROFILE_NESTING_MAX];
+static uint32_t core_profile_depth;
+
+/************************************ GLOBALS ***************************************/
+
+/************************************************************************************
+ * @function 	CORE_Profile_Record
+ * @params 		[in] call_site - return address of the CORE_Enter* call
+ * 				[in] cycles - time the section had interrupts masked
+ * @brief 		Folds a closed section into core_profile_table. A new call site
+ * 				takes the entry with the shortest worst case when the table is
+ * 				full, if it took longer.
+ ************************************************************************************/
+static void CORE_Profile_Record(uint32_t call_site, uint32_t cycles)
+{
+	uint32_t i;
+	uint32_t slot = 0;
+
+	for (i = 0; i < CORE_PROFILE_TABLE_SIZE; i++)
+	{
+		if (core_profile_table[i].call_site == call_site)
+		{
+			slot = i;
+			break;
+		}
+		if (core_profile_table[i].max_cycles < core_profile_table[slot].max_cycles)
+		{
+			slot = i;
+		}
+	}
+
+	if (core_profile_table[slot].call_site != call_site)
+	{
+		if ((core_profile_table[slot].call_site != 0) && (cycles <= core_profile_table[slot].max_cycles))
+		{
+			return;
+		}
+		core_profile_table[slot].call_site = call_site;
+		core_profile_table[slot].max_cycles = 0;
+		core_profile_table[slot].count = 0;
+	}
+
+	if (cycles > core_profile_table[slot].max_cycles)
+	{
+		core_profile_table[slot].max_cycles = cycles;
+	}
+	core_profile_table[slot].count++;
+}
+
+/************************************************************************************
+ * @function 	CORE_ProfileReset
+ * @params 		None
+ * @brief 		Clears the table and starts the cycle counter. Sections open
+ * 				across the reset are not timed.
+ ************************************************************************************/
+void CORE_ProfileReset(void)
+{
+	uint32_t i;
+	uint32_t primask = __get_PRIMASK();
+
+	/* Masked directly so the reset itself does not show up in the table */
+	__disable_irq();
+
+	for (i = 0; i < CORE_PROFILE_TABLE_SIZE; i++)
+	{
+		core_profile_table[i].call_site = 0;
+		core_profile_table[i].max_cycles = 0;
+		core_profile_table[i].count = 0;
+	}
+
+	for (i = 0; (i < core_profile_depth) && (i < CORE_PROFILE_NESTING_MAX); i++)
+	{
+		core_profile_stack[i].outermost = false;
+	}
+
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	if (primask == 0)
+	{
+		__enable_irq();
+	}
+}
+
+/************************************************************************************
+ * @function 	CORE_ProfileEnterHook
+ * @params 		[in] irqState - state returned by the enter call, 0 if interrupts
+ * 				were enabled
+ * 				[in] callSite - return address of the enter call
+ * @brief 		Opens a frame for the section. Called with interrupts masked.
+ ************************************************************************************/
+void CORE_ProfileEnterHook(CORE_irqState_t irqState, void *callSite)
+{
+	CORE_PROFILE_FRAME *p_frame;
+
+	if (core_profile_depth < CORE_PROFILE_NESTING_MAX)
+	{
+		p_frame = &core_profile_stack[core_profile_depth];
+		p_frame->call_site = (uint32_t)(uintptr_t)callSite;
+		p_frame->start_cycles = CORE_PROFILE_CYCLES();
+		p_frame->outermost = (irqState == 0);
+	}
+
+	core_profile_depth++;
+}
+
+/************************************************************************************
+ * @function 	CORE_ProfileExitHook
+ * @params 		[in] irqState - state being restored
+ * @brief 		Closes the innermost frame, an outermost section is recorded.
+ * 				Called before interrupts are unmasked, so the table update is
+ * 				itself atomic.
+ ************************************************************************************/
+void CORE_ProfileExitHook(CORE_irqState_t irqState)
+{
+	CORE_PROFILE_FRAME *p_frame;
+
+	(void)irqState;
+
+	if (core_profile_depth == 0)
+	{
+		return;
+	}
+
+	core_profile_depth--;
+
+	if (core_profile_depth < CORE_PROFILE_NESTING_MAX)
+	{
+		p_frame = &core_profile_stack[core_profile_depth];
+		if (p_frame->outermost)
+		{
+			CORE_Profile_Record(p_frame->call_site, CORE_PROFILE_CYCLES() - p_frame->start_cycles);
+		}
+	}
+}
+
+/************************************************************************************
+ * @function 	CORE_ProfileYieldHook
+ * @params 		[in] resumed - false before interrupts are enabled, true once
+ * 				they are masked again
+ * @brief 		Splits the open outermost sections around a yield, the time spent
+ * 				with interrupts enabled is not part of their masked time.
+ ************************************************************************************/
+void CORE_ProfileYieldHook(bool resumed)
+{
+	uint32_t now = CORE_PROFILE_CYCLES();
+	uint32_t i;
+
+	for (i = 0; (i < core_profile_depth) && (i < CORE_PROFILE_NESTING_MAX); i++)
+	{
+		if (resumed)
+		{
+			core_profile_stack[i].start_cycles = now;
+		}
+		else if (core_profile_stack[i].outermost)
+		{
+			CORE_Profile_Record(core_profile_stack[i].call_site, now - core_profile_stack[i].start_cycles);
+		}
+	}
+}
+
+#endif /* CORE_PROFILE_HOOKS */
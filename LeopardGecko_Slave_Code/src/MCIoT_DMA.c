@@ -48,7 +48,8 @@
 /************************************************************************************
  * @function 	DMA_SetUp
  * @params 		None
- * @brief 		Configures the DMA.
+ * @brief 		Configures the DMA and the ADC channel. The LESENSE channel is
+ *				set up by LETOUCH_Init.
  ************************************************************************************/
 void DMA_SetUp(void)
 {
@@ -62,6 +63,7 @@ void DMA_SetUp(void)
 
 	DMA_Init(&dmaInit);
 
+#ifdef USE_DMA_FOR_ADC
 	/* Setting up call-back function */
 	/* Callback function is DMA's version of interrupt handling function */
 	dma_cb_fn.cbFunc  = (DMA_FuncPtr_TypeDef)ADC_dma_ch0_TransferComplete;
@@ -83,6 +85,7 @@ void DMA_SetUp(void)
 	descrCfg.hprot   = 0;
 
 	DMA_CfgDescr(DMA_CHANNEL_ADC, true, &descrCfg);
+#endif
 }
 
 /************************************************************************************
@@ -101,7 +104,7 @@ void ADC_dma_ch0_TransferComplete(uint32_t channel, bool primary, void *user)
 	ADC0->CMD |= ADC_CMD_SINGLESTOP;
 
 	/* Disable clock to ADC0 */
-	CMU_ClockEnable(cmuClock_ADC0, false); /* To enable clock to ADC0 */
+	CMU_Consumer_Stop(CMU_CONSUMER_ADC);
 
 	unblockSleepMode(ADC_EM);
 
@@ -43,6 +43,79 @@
 #include "MCIoT_I2C.h"
 #include "MCIoT_Sleep.h"
 #include "MCIoT_LEUART.h"
+#include "MCIoT_Power.h"
+
+/************************************ INCLUDES **************************************/
+
+/****************************** FUNCTION PROTOTYPES *********************************/
+
+static void I2C_Transfer_Complete(I2C_TRANSFER_STATUS e_status);
+
+static void I2C_TSL_Power_Ready(POWER_DOMAIN *p_domain);
+
+/****************************** FUNCTION PROTOTYPES *********************************/
+
+/************************************ GLOBALS ***************************************/
+
+/* Latest burst read of the TSL2561, see MCIoT_I2C.h */
+uint16_t tsl_ch0;
+uint16_t tsl_ch1;
+uint32_t tsl_lux;
+volatile bool tsl_lux_available;
+
+/* Transfers in submission order, the head one owns the bus */
+static I2C_TRANSFER *i2c_transfer_queue[I2C_TRANSFER_QUEUE_SIZE];
+static uint8_t i2c_transfer_queue_head;
+static uint8_t i2c_transfer_queue_count;
+
+/* LETIMER0 periods the head transfer has been on the bus */
+static uint8_t i2c_transfer_age;
+
+/* Command byte followed by the block write of registers 0x00..0x06 */
+static uint8_t tsl_init_cmd[] =
+{
+	I2C_TSL_INIT_CMD_REG_VAL,
+	I2C_TSL_INIT_NUM_REGS_TO_WRITE,
+	I2C_TSL_INIT_CTRL_REG_VAL,
+	I2C_TSL_INIT_TIM_REG_VAL,
+	(I2C_TSL_INIT_THRES_LOW_REG_VAL & BITMASK_LOWER_BYTE),
+	((I2C_TSL_INIT_THRES_LOW_REG_VAL >> SHIFT_BY_EIGHT) & BITMASK_LOWER_BYTE),
+	(I2C_TSL_INIT_THRES_HIGH_REG_VAL & BITMASK_LOWER_BYTE),
+	((I2C_TSL_INIT_THRES_HIGH_REG_VAL >> SHIFT_BY_EIGHT) & BITMASK_LOWER_BYTE),
+	I2C_TSL_INIT_INT_CTRL_REG_VAL
+};
+
+/* Datasheet K, B and M coefficients for the T, FN and CL packages */
+static const TSL_LUX_SEGMENT tsl_lux_segments[TSL_LUX_SEGMENTS] =
+{
+	{ 0x0040, 0x01F2, 0x01BE },		/* 0 < CH1/CH0 <= 0.125 */
+	{ 0x0080, 0x0214, 0x02D1 },		/* 0.125 < CH1/CH0 <= 0.250 */
+	{ 0x00C0, 0x023F, 0x037B },		/* 0.250 < CH1/CH0 <= 0.375 */
+	{ 0x0100, 0x0270, 0x03FE },		/* 0.375 < CH1/CH0 <= 0.50 */
+	{ 0x0138, 0x016F, 0x01FC },		/* 0.50 < CH1/CH0 <= 0.61 */
+	{ 0x019A, 0x00D2, 0x00FB },		/* 0.61 < CH1/CH0 <= 0.80 */
+	{ 0x029A, 0x0018, 0x0012 },		/* 0.80 < CH1/CH0 <= 1.30 */
+	{ 0xFFFF, 0x0000, 0x0000 }		/* CH1/CH0 > 1.30 */
+};
+
+static uint8_t tsl_read_cmd = I2C_TSL_INIT_CMD_REG_VAL_2;
+static uint8_t tsl_clear_cmd = I2C_TSL_INIT_CMD_REG_VAL;
+static uint8_t tsl_data[I2C_TSL_DATA_NUM_BYTES];
+
+static I2C_TRANSFER tsl_init_transfer;
+static I2C_TRANSFER tsl_read_transfer;
+static I2C_TRANSFER tsl_clear_transfer;
+
+/* TSL2561 supply, the sensor is initialized once it has settled */
+static POWER_DOMAIN tsl_power_domain =
+{
+	.port		= GPIO_PORT_D,
+	.pin		= TSL2651_POWER_PIN,
+	.settle_ms	= I2C_TSL_POWER_SETTLE_MS,
+	.on_ready	= I2C_TSL_Power_Ready
+};
+
+/************************************ GLOBALS ***************************************/
 
 /************************************************************************************
  * @function 	I2C_SetUp
@@ -80,119 +153,282 @@ void I2C_SetUp(void)
 		I2C1->CMD = I2C_CMD_ABORT;
 	}
 
+	/* Report a slave holding SCL low instead of waiting on it forever */
+	I2C1->CTRL = (I2C1->CTRL & ~_I2C_CTRL_CLTO_MASK) | (I2C_CLOCK_LOW_TIMEOUT << _I2C_CTRL_CLTO_SHIFT);
+
 	/* Clearing any interrupt that would have been inadvertently configured */
 	i2c_flags = I2C1->IF;
 	I2C1->IFC = i2c_flags;
 
+	i2c_transfer_queue_head = 0;
+	i2c_transfer_queue_count = 0;
+
+	NVIC_ClearPendingIRQ(I2C1_IRQn);
+	NVIC_EnableIRQ(I2C1_IRQn);
+
 	I2C_GPIO_Enable();
 }
 
 /************************************************************************************
- * @function 	Initialize_TSL2651
- * @params 		None
- * @brief 		Routine to initialize TSL2561 ALS.
- ************************************************************************************/
-void Initialize_TSL2651(void)
+ * @function 	I2C_Transfer_Prepare
+ * @params 		[in] p_transfer - (I2C_TRANSFER *) descriptor to fill
+ * 				[in] slave_addr - (uint8_t) 7 bit slave address
+ * 				[in] p_write_buf, write_len - bytes sent first, write_len may be 0
+ * 				[in] p_read_buf, read_len - bytes read after a repeated start,
+ * 											read_len may be 0
+ * 				[in] callback - (I2C_TRANSFER_CALLBACK) completion callback or NULL
+ * @brief 		Fills a transfer descriptor. Must not be called on a queued descriptor.
+ ************************************************************************************/
+void I2C_Transfer_Prepare(I2C_TRANSFER *p_transfer, uint8_t slave_addr,
+		uint8_t *p_write_buf, uint16_t write_len,
+		uint8_t *p_read_buf, uint16_t read_len,
+		I2C_TRANSFER_CALLBACK callback)
 {
-	uint8_t 	i2c_slave_address = I2C_TSL2561_SLAVE_ADDR;
-	uint8_t		i2c_slave_data = 0;
-	uint8_t 	read_write_bit = 0;
-	uint8_t		i = 0;
+	p_transfer->seq.addr = slave_addr << 1;
 
-	/* Write Operation*/
-	read_write_bit = 0;
-
-	I2C_Send_Start();
+	if (read_len == 0)
+	{
+		p_transfer->seq.flags = I2C_FLAG_WRITE;
+		p_transfer->seq.buf[0].data = p_write_buf;
+		p_transfer->seq.buf[0].len = write_len;
+	}
+	else if (write_len == 0)
+	{
+		p_transfer->seq.flags = I2C_FLAG_READ;
+		p_transfer->seq.buf[0].data = p_read_buf;
+		p_transfer->seq.buf[0].len = read_len;
+	}
+	else
+	{
+		p_transfer->seq.flags = I2C_FLAG_WRITE_READ;
+		p_transfer->seq.buf[0].data = p_write_buf;
+		p_transfer->seq.buf[0].len = write_len;
+		p_transfer->seq.buf[1].data = p_read_buf;
+		p_transfer->seq.buf[1].len = read_len;
+	}
 
-	i2c_slave_data = (i2c_slave_address << 1) | read_write_bit;
-	I2C_Write_And_Wait_for_ACK(i2c_slave_data);
+	p_transfer->callback = callback;
+}
 
-	/* Specify the address of consecutive registers to be written
-	 * using the command register of TSL2561 */
-	I2C_Write_And_Wait_for_ACK(I2C_TSL_INIT_CMD_REG_VAL);
+/************************************************************************************
+ * @function 	I2C_Transfer_Start_Next
+ * @params 		None
+ * @brief 		Puts the transfer at the head of the queue on the bus. The core is
+ * 				kept in EM1 until it completes. Called with interrupts masked.
+ ************************************************************************************/
+static void I2C_Transfer_Start_Next(void)
+{
+	I2C_TRANSFER *p_transfer;
 
-	for (i = 0; i < 30; i++);
+	if (i2c_transfer_queue_count == 0)
+	{
+		return;
+	}
 
-	I2C_Write_And_Wait_for_ACK(I2C_TSL_INIT_NUM_REGS_TO_WRITE);
+	p_transfer = i2c_transfer_queue[i2c_transfer_queue_head];
+	p_transfer->e_status = I2C_TRANSFER_IN_PROGRESS;
+	i2c_transfer_age = 0;
 
-	I2C_Write_And_Wait_for_ACK(I2C_TSL_INIT_CTRL_REG_VAL);
+	blockSleepMode(I2C_EM);
 
-	for (i = 0; i < 30; i++);
+	/* Sends START and the address, the rest is advanced from I2C1_IRQHandler */
+	if (I2C_TransferInit(I2C1, &p_transfer->seq) == i2cTransferUsageFault)
+	{
+		/* Malformed descriptor, nothing was put on the bus */
+		I2C_Transfer_Complete(I2C_TRANSFER_BUS_ERROR);
+		return;
+	}
 
-	I2C_Write_And_Wait_for_ACK(I2C_TSL_INIT_TIM_REG_VAL);
+	I2C1->IEN |= I2C_IEN_CLTO;
+}
 
-	I2C_Write_And_Wait_for_ACK((I2C_TSL_INIT_THRES_LOW_REG_VAL & BITMASK_LOWER_BYTE));
-	I2C_Write_And_Wait_for_ACK(((I2C_TSL_INIT_THRES_LOW_REG_VAL >> SHIFT_BY_EIGHT) & BITMASK_LOWER_BYTE));
+/************************************************************************************
+ * @function 	I2C_Transfer_Complete
+ * @params 		[in] e_status - (I2C_TRANSFER_STATUS) outcome of the head transfer
+ * @brief 		Retires the head transfer, runs its callback and starts the next one.
+ * 				Called with interrupts masked.
+ ************************************************************************************/
+static void I2C_Transfer_Complete(I2C_TRANSFER_STATUS e_status)
+{
+	I2C_TRANSFER *p_transfer = i2c_transfer_queue[i2c_transfer_queue_head];
 
-	for (i = 0; i < 30; i++);
+	I2C1->IEN = 0;
 
-	I2C_Write_And_Wait_for_ACK((I2C_TSL_INIT_THRES_HIGH_REG_VAL & BITMASK_LOWER_BYTE));
-	I2C_Write_And_Wait_for_ACK(((I2C_TSL_INIT_THRES_HIGH_REG_VAL >> SHIFT_BY_EIGHT) & BITMASK_LOWER_BYTE));
+	unblockSleepMode(I2C_EM);
 
-	I2C_Write_And_Wait_for_ACK(I2C_TSL_INIT_INT_CTRL_REG_VAL);
+	p_transfer->e_status = e_status;
 
-	for (i = 0; i < 30; i++);
+	/* The callback may submit a follow-up transfer. It stays at the head until
+	 * the callback returns, so the follow-up is queued and not started here */
+	if (p_transfer->callback != NULL)
+	{
+		p_transfer->callback(p_transfer);
+	}
 
-	I2C_Send_Stop();
+	i2c_transfer_queue_head = (i2c_transfer_queue_head + 1) % I2C_TRANSFER_QUEUE_SIZE;
+	i2c_transfer_queue_count--;
 
+	if (i2c_transfer_queue_count > 0)
+	{
+		I2C_Transfer_Start_Next();
+	}
 }
 
 /************************************************************************************
- * @function 	I2C_Write_And_Wait_for_ACK
- * @params 		None
- * @brief 		Routine to write to transmit buffer of I2C and wait for acknowledgement.
- ************************************************************************************/
-void I2C_Write_And_Wait_for_ACK(uint8_t data)
+ * @function 	I2C_Transfer_Submit
+ * @params 		[in] p_transfer - (I2C_TRANSFER *) descriptor filled by I2C_Transfer_Prepare
+ * @brief 		Queues a transfer and starts it if the bus is free. Returns false if
+ * 				the queue is full or the descriptor is already queued.
+ ************************************************************************************/
+bool I2C_Transfer_Submit(I2C_TRANSFER *p_transfer)
 {
-	I2C1->TXDATA = data;
+	bool is_queued = false;
+	uint8_t tail;
 
-	I2C_Wait_For_Ack();
+#ifdef USE_INT
+	INT_Disable();
+#else
+	CORE_DECLARE_IRQ_STATE;
+	CORE_ENTER_ATOMIC();
+#endif
+
+	if ((i2c_transfer_queue_count < I2C_TRANSFER_QUEUE_SIZE) &&
+			(p_transfer->e_status != I2C_TRANSFER_PENDING) &&
+			(p_transfer->e_status != I2C_TRANSFER_IN_PROGRESS))
+	{
+		tail = (i2c_transfer_queue_head + i2c_transfer_queue_count) % I2C_TRANSFER_QUEUE_SIZE;
+		i2c_transfer_queue[tail] = p_transfer;
+		i2c_transfer_queue_count++;
+
+		p_transfer->e_status = I2C_TRANSFER_PENDING;
+		is_queued = true;
+
+		if (i2c_transfer_queue_count == 1)
+		{
+			I2C_Transfer_Start_Next();
+		}
+	}
+
+#ifdef USE_INT
+	INT_Enable();
+#else
+	CORE_EXIT_ATOMIC();
+#endif
+
+	return is_queued;
 }
 
 /************************************************************************************
- * @function 	I2C_Wait_For_Ack
+ * @function 	I2C_Transfer_Timeout_Tick
  * @params 		None
- * @brief 		Routine to wait for acknowledgement.
- ************************************************************************************/
-void I2C_Wait_For_Ack(void)
+ * @brief 		Called once per LETIMER0 period. Aborts a transfer that has made no
+ * 				progress for I2C_TRANSFER_TIMEOUT_PERIODS, e.g. because the bus
+ * 				never went idle for its START.
+ ************************************************************************************/
+void I2C_Transfer_Timeout_Tick(void)
 {
-	/* Wait for the slave to respond with an acknowlegdement (ACK) */
-	while ((I2C1->IF & I2C_IF_ACK) == 0);
+#ifdef USE_INT
+	INT_Disable();
+#else
+	CORE_DECLARE_IRQ_STATE;
+	CORE_ENTER_ATOMIC();
+#endif
+
+	if ((i2c_transfer_queue_count > 0) && (++i2c_transfer_age >= I2C_TRANSFER_TIMEOUT_PERIODS))
+	{
+		I2C1->CMD = I2C_CMD_ABORT;
+		I2C_Transfer_Complete(I2C_TRANSFER_TIMEOUT);
+	}
 
-	/* Once we have received ACK from slave, clear it from the IF register */
-	I2C1->IFC = I2C_IF_ACK;
+#ifdef USE_INT
+	INT_Enable();
+#else
+	CORE_EXIT_ATOMIC();
+#endif
 }
 
 /************************************************************************************
- * @function 	I2C_Send_Start
+ * @function 	I2C1_IRQHandler
  * @params 		None
- * @brief 		Routine to send I2C start bit.
- ************************************************************************************/
-void I2C_Send_Start(void)
+ * @brief 		Advances the active transfer through the emlib master state machine.
+ ************************************************************************************/
+void I2C1_IRQHandler(void)
 {
-	I2C1->CMD |= I2C_CMD_START;
+	I2C_TransferReturn_TypeDef e_result;
+
+#ifdef USE_INT
+	INT_Disable();
+#else
+	CORE_DECLARE_IRQ_STATE;
+	CORE_ENTER_ATOMIC();
+#endif
+
+	if (i2c_transfer_queue_count == 0)
+	{
+		/* Spurious, nothing owns the bus */
+		I2C1->IEN = 0;
+		I2C1->IFC = _I2C_IFC_MASK;
+	}
+	else if (I2C1->IF & I2C_IF_CLTO)
+	{
+		/* Slave is stretching the clock past I2C_CLOCK_LOW_TIMEOUT */
+		I2C1->IFC = I2C_IFC_CLTO;
+		I2C1->CMD = I2C_CMD_ABORT;
+		I2C_Transfer_Complete(I2C_TRANSFER_TIMEOUT);
+	}
+	else
+	{
+		e_result = I2C_Transfer(I2C1);
+
+		if (e_result == i2cTransferDone)
+		{
+			I2C_Transfer_Complete(I2C_TRANSFER_DONE);
+		}
+		else if (e_result == i2cTransferNack)
+		{
+			I2C_Transfer_Complete(I2C_TRANSFER_NACK);
+		}
+		else if (e_result != i2cTransferInProgress)
+		{
+			I2C1->CMD = I2C_CMD_ABORT;
+			I2C1->IFC = I2C_IFC_BUSERR | I2C_IFC_ARBLOST;
+			I2C_Transfer_Complete(I2C_TRANSFER_BUS_ERROR);
+		}
+	}
+
+#ifdef USE_INT
+	INT_Enable();
+#else
+	CORE_EXIT_ATOMIC();
+#endif
 }
 
 /************************************************************************************
- * @function 	I2C_Send_Stop
- * @params 		None
- * @brief 		Routine to send I2C stop bit.
- ************************************************************************************/
-void I2C_Send_Stop(void)
+ * @function 	Initialize_TSL2651_Done
+ * @params 		[in] p_transfer - (I2C_TRANSFER *) completed init transfer
+ * @brief 		Arms the TSL2561 interrupt line once its thresholds are written.
+ ************************************************************************************/
+static void Initialize_TSL2651_Done(I2C_TRANSFER *p_transfer)
 {
-	I2C1->CMD |= I2C_CMD_STOP;
+	if (p_transfer->e_status == I2C_TRANSFER_DONE)
+	{
+		/* Enable TSL Interrupt */
+		I2C_TSL2561_Interrupt_Enable();
+	}
 }
 
 /************************************************************************************
- * @function 	I2C_Check_Data_Valid_and_Store
+ * @function 	Initialize_TSL2651
  * @params 		None
- * @brief 		Routine to check if received data is valid and store it.
- ************************************************************************************/
-void I2C_Check_Data_Valid_and_Store(uint8_t *data)
+ * @brief 		Routine to initialize TSL2561 ALS. Queues a block write of the
+ * 				control, timing, threshold and interrupt registers.
+ ************************************************************************************/
+void Initialize_TSL2651(void)
 {
-	while(((I2C1->IF & I2C_IF_RXDATAV) == 0) && ((I2C1->STATUS & I2C_STATUS_RXDATAV) == 0));
+	I2C_Transfer_Prepare(&tsl_init_transfer, I2C_TSL2561_SLAVE_ADDR,
+			tsl_init_cmd, sizeof(tsl_init_cmd), NULL, 0, Initialize_TSL2651_Done);
 
-	*data = I2C1->RXDATA;
+	I2C_Transfer_Submit(&tsl_init_transfer);
 }
 
 /************************************************************************************
@@ -202,8 +438,7 @@ void I2C_Check_Data_Valid_and_Store(uint8_t *data)
  ************************************************************************************/
 void I2C_TSL2651_GPIO_Enable(void)
 {
-	/* Configure TSL power pin as push pull output */
-	GPIO_PinModeSet(GPIO_PORT_D, TSL2651_POWER_PIN, gpioModePushPull, 0);
+	/* The TSL power pin is driven by tsl_power_domain */
 
 	/* Configure TSL interrupt pin as input */
 	GPIO_PinModeSet(GPIO_PORT_D, TSL2651_INTERRUPT_PIN, gpioModeInput, 1);
@@ -236,9 +471,6 @@ void I2C_TSL2651_GPIO_Disable(void)
 {
 	/* Configure TSL interrupt pin as input */
 	GPIO_PinModeSet(GPIO_PORT_D, TSL2651_INTERRUPT_PIN, gpioModeDisabled, 0);
-
-	/* Configure TSL power pin as push pull output */
-	GPIO_PinModeSet(GPIO_PORT_D, TSL2651_POWER_PIN, gpioModeDisabled, 0);
 }
 
 /************************************************************************************
@@ -262,15 +494,23 @@ void I2C_TSL2561_Interrupt_Disable(void)
  ************************************************************************************/
 void I2C_TSL_PowerOn_Routine(void)
 {
-	uint32_t i = 0;
-
 	/* Enable the TSL2651 onto the I2C bus */
 	I2C_TSL2651_GPIO_Enable();
 
-	/* Turn on power to TSL device */
-	GPIO_PinOutSet(GPIO_PORT_D, TSL2651_POWER_PIN);
+	/* Turn on power to TSL device, I2C_TSL_Power_Ready runs once it has settled */
+	Power_Domain_On(&tsl_power_domain);
+}
+
+/************************************************************************************
+ * @function 	I2C_TSL_Power_Ready
+ * @params 		[in] p_domain - (POWER_DOMAIN *) TSL2561 supply
+ * @brief 		Deferred step of the TSL2561 power on, runs from the RTC interrupt.
+ ************************************************************************************/
+static void I2C_TSL_Power_Ready(POWER_DOMAIN *p_domain)
+{
+	(void)p_domain;
 
-	for (i = 0; i < 30000; i++);
+	I2C_TSL_Init();
 }
 
 /************************************************************************************
@@ -282,10 +522,8 @@ void I2C_TSL_Init(void)
 {
 	I2C_GPIO_Enable();
 
+	/* The TSL interrupt is enabled once the init transfer completes */
 	Initialize_TSL2651();
-
-	/* Enable TSL Interrupt */
-	I2C_TSL2561_Interrupt_Enable();
 }
 
 /************************************************************************************
@@ -301,10 +539,8 @@ void I2C_TSL_PowerOff_Routine(void)
 
 	I2C_TSL2651_GPIO_Disable();
 
-	/* Turn off power to TSL device */
-	GPIO_PinOutClear(GPIO_PORT_D, TSL2651_POWER_PIN);
-
-	GPIO_PinModeSet(GPIO_PORT_D, TSL2651_POWER_PIN, gpioModeDisabled, 0);
+	/* Turn off power to TSL device, cancels a pending I2C_TSL_Power_Ready */
+	Power_Domain_Off(&tsl_power_domain);
 }
 
 /************************************************************************************
@@ -318,126 +554,177 @@ void I2C_TSL_Deinit(void)
 }
 
 /************************************************************************************
- * @function 	GPIO_ODD_IRQHandler
- * @params 		None
- * @brief 		GPIO IRQ Handler.
- ************************************************************************************/
-void GPIO_ODD_IRQHandler(void)
+ * @function 	I2C_TSL_Calculate_Lux
+ * @params 		[in] ch0 - (uint16_t) channel 0 (visible + IR) ADC count
+ * 				[in] ch1 - (uint16_t) channel 1 (IR) ADC count
+ * 				[in] timing_reg_val - (uint8_t) value programmed in the timing register
+ * @brief 		Integer lux from the datasheet piecewise CH1/CH0 ratio formula.
+ ************************************************************************************/
+uint32_t I2C_TSL_Calculate_Lux(uint16_t ch0, uint16_t ch1, uint8_t timing_reg_val)
 {
-	uint8_t 	i2c_slave_address = I2C_TSL2561_SLAVE_ADDR;	/* TSL2561 Slave Address */
-	uint8_t		i2c_slave_data = 0;
-	uint8_t 	read_write_bit = 0;
-	uint8_t		i2c_data0_low = 0;
-	uint8_t		i2c_data0_high = 0;
-	uint8_t		i2c_data1_low = 0;
-	uint8_t		i2c_data1_high = 0;
-
-	uint16_t	i2c_data0 = 0;
-	//uint16_t	i2c_data1 = 0;
-
-#ifdef USE_INT
-	INT_Disable();
-#else
-	CORE_DECLARE_IRQ_STATE;
-	CORE_ENTER_ATOMIC();
-#endif
-
-	/* Clearing the source of interrupt: LETIMER0 comp0 interrupt flag */
-	GPIO_IntClear(I2C_TSL_INT_CLEAR_FLAG);
-
-	/* Write Operation*/
-	read_write_bit = 0;
-
-	I2C_Send_Start();
-
-	i2c_slave_data = (i2c_slave_address << 1) | read_write_bit;
-	I2C_Write_And_Wait_for_ACK(i2c_slave_data);
+	uint32_t	ch_scale = 0;
+	uint32_t	channel0 = 0;
+	uint32_t	channel1 = 0;
+	uint32_t	ratio = 0;
+	uint32_t	i = 0;
+	uint32_t	visible = 0;
+	uint32_t	infrared = 0;
+
+	/* Normalise the counts to the nominal 402 ms integration time */
+	switch (timing_reg_val & TSL_TIMING_INTEG_MASK)
+	{
+		case 0:
+			ch_scale = TSL_CHSCALE_TINT0;
+			break;
+		case 1:
+			ch_scale = TSL_CHSCALE_TINT1;
+			break;
+		default:
+			ch_scale = (1 << TSL_CH_SCALE);
+			break;
+	}
 
-	I2C_Write_And_Wait_for_ACK(I2C_TSL_INIT_CMD_REG_VAL_2);
+	/* and to 16x gain */
+	if ((timing_reg_val & TSL_TIMING_GAIN_16X) == 0)
+	{
+		ch_scale <<= 4;
+	}
 
-	read_write_bit = 1;
-	I2C_Send_Start(); 		/* Repeat Start */
+	channel0 = (ch0 * ch_scale) >> TSL_CH_SCALE;
+	channel1 = (ch1 * ch_scale) >> TSL_CH_SCALE;
 
-	i2c_slave_data = (i2c_slave_address << 1) | read_write_bit;
-	I2C_Write_And_Wait_for_ACK(i2c_slave_data);
+	/* CH1/CH0 ratio scaled by 2^TSL_RATIO_SCALE, rounded */
+	if (channel0 != 0)
+	{
+		ratio = ((channel1 << (TSL_RATIO_SCALE + 1)) / channel0 + 1) >> 1;
+	}
 
-	I2C_Check_Data_Valid_and_Store(&i2c_data0_low);
-	I2C1->CMD |= I2C_CMD_ACK;
+	while (ratio > tsl_lux_segments[i].ratio_max)
+	{
+		i++;
+	}
 
-	I2C_Check_Data_Valid_and_Store(&i2c_data0_high);
-	I2C1->CMD |= I2C_CMD_ACK;
+	/* Unsigned throughout, a saturated CH0 at 16x scaling overflows int32_t */
+	visible = channel0 * tsl_lux_segments[i].b;
+	infrared = channel1 * tsl_lux_segments[i].m;
+	if (infrared >= visible)
+	{
+		return 0;
+	}
 
-	I2C_Check_Data_Valid_and_Store(&i2c_data1_low);
-	I2C1->CMD |= I2C_CMD_ACK;
+	/* Round and drop the LSB fraction */
+	return ((visible - infrared) + (1 << (TSL_LUX_SCALE - 1))) >> TSL_LUX_SCALE;
+}
 
-	I2C_Check_Data_Valid_and_Store(&i2c_data1_high);
-	I2C1->CMD |= I2C_CMD_NACK;
+/************************************************************************************
+ * @function 	I2C_TSL_Read_Done
+ * @params 		[in] p_transfer - (I2C_TRANSFER *) completed ADC channel read
+ * @brief 		Publishes both channels and the lux value, switches the LED on the
+ * 				channel 0 thresholds, then clears the TSL2561 interrupt.
+ ************************************************************************************/
+static void I2C_TSL_Read_Done(I2C_TRANSFER *p_transfer)
+{
+	uint16_t	i2c_data0 = 0;
 
-	I2C_Send_Stop();
+	if (p_transfer->e_status == I2C_TRANSFER_DONE)
+	{
+		i2c_data0 = (tsl_data[1] << 8) | tsl_data[0];
 
-	i2c_data0 = (i2c_data0_high << 8) | i2c_data0_low;
-	//i2c_data1 = (i2c_data1_high << 8) | i2c_data1_low;
+		tsl_ch0 = i2c_data0;
+		tsl_ch1 = (tsl_data[3] << 8) | tsl_data[2];
+		tsl_lux = I2C_TSL_Calculate_Lux(tsl_ch0, tsl_ch1, I2C_TSL_INIT_TIM_REG_VAL);
+		tsl_lux_available = true;
 
-	if (i2c_als_state == ALS_STATE_DARK)
-	{
-		/* Dark State */
-		if (i2c_data0 < I2C_TSL_INIT_THRES_LOW_REG_VAL)
+		if (i2c_als_state == ALS_STATE_DARK)
 		{
-			/* Turning on LED1 */
-			LED_On(LED0_1_GPIO_PORT, LED0_GPIO_PIN);
+			/* Dark State */
+			if (i2c_data0 < I2C_TSL_INIT_THRES_LOW_REG_VAL)
+			{
+				/* Turning on LED1 */
+				LED_On(LED0_1_GPIO_PORT, LED0_GPIO_PIN);
 
-			i2c_als_state = ALS_STATE_LIGHT;
+				i2c_als_state = ALS_STATE_LIGHT;
 
-			leuart_led_data = ((LEUART_LED_DATA_IDENTIFIER << 7) | 0);
+				leuart_led_data = ((LEUART_LED_DATA_IDENTIFIER << 7) | 0);
+			}
 		}
-	}
-	else
-	{
-		/* Bright State */
-		if (i2c_data0 > I2C_TSL_INIT_THRES_HIGH_REG_VAL)
+		else
 		{
-			/* Turning off LED1 */
-			LED_Off(LED0_1_GPIO_PORT, LED0_GPIO_PIN);
+			/* Bright State */
+			if (i2c_data0 > I2C_TSL_INIT_THRES_HIGH_REG_VAL)
+			{
+				/* Turning off LED1 */
+				LED_Off(LED0_1_GPIO_PORT, LED0_GPIO_PIN);
 
-			i2c_als_state = ALS_STATE_DARK;
+				i2c_als_state = ALS_STATE_DARK;
 
-			leuart_led_data = ((LEUART_LED_DATA_IDENTIFIER << 7) | 1);
+				leuart_led_data = ((LEUART_LED_DATA_IDENTIFIER << 7) | 1);
+			}
 		}
-	}
 
-	if (false == state_is_em1_for_leuart_tx)
-	{
-		blockSleepMode(LEUART_EM);
-		state_is_em1_for_leuart_tx = true;
-	}
+		if (false == state_is_em1_for_leuart_tx)
+		{
+			blockSleepMode(LEUART_EM);
+			state_is_em1_for_leuart_tx = true;
+		}
 #if 0
 #ifdef USE_CIRC_BUFFER_FOR_LEUART
-	WriteDataToCircBuff(&leuart_circ_buff, leuart_led_data);
+		WriteDataToCircBuff(&leuart_circ_buff, leuart_led_data);
 #else
-	*puart_buffer = leuart_led_data;
-	puart_buffer++;
+		*puart_buffer = leuart_led_data;
+		puart_buffer++;
 #endif
 #endif
-	led_data_available = true;
+		led_data_available = true;
 
-	if (false == leuart_nvic_is_enabled)
-	{
-		/* Enable the NVIC for LEUART0 so that the IRQ handler can be
-		 * triggered to transmit the data */
-		NVIC_EnableIRQ(LEUART0_IRQn);
-		leuart_nvic_is_enabled = true;
+		if (false == leuart_nvic_is_enabled)
+		{
+			/* Enable the NVIC for LEUART0 so that the IRQ handler can be
+			 * triggered to transmit the data */
+			NVIC_EnableIRQ(LEUART0_IRQn);
+			leuart_nvic_is_enabled = true;
+		}
 	}
 
-	read_write_bit = 0;
+	/* Clear the TSL interrupt even if the read failed so it can fire again */
+	I2C_Transfer_Prepare(&tsl_clear_transfer, I2C_TSL2561_SLAVE_ADDR,
+			&tsl_clear_cmd, 1, NULL, 0, NULL);
+
+	I2C_Transfer_Submit(&tsl_clear_transfer);
+}
 
-	I2C_Send_Start();
+/************************************************************************************
+ * @function 	I2C_TSL_Read_Lux
+ * @params 		None
+ * @brief 		Queues one block read of DATA0LOW..DATA1HIGH. The result is
+ * 				published in tsl_ch0, tsl_ch1 and tsl_lux.
+ ************************************************************************************/
+void I2C_TSL_Read_Lux(void)
+{
+	I2C_Transfer_Prepare(&tsl_read_transfer, I2C_TSL2561_SLAVE_ADDR,
+			&tsl_read_cmd, 1, tsl_data, I2C_TSL_DATA_NUM_BYTES, I2C_TSL_Read_Done);
 
-	i2c_slave_data = (i2c_slave_address << 1) | read_write_bit;
-	I2C_Write_And_Wait_for_ACK(i2c_slave_data);
+	I2C_Transfer_Submit(&tsl_read_transfer);
+}
 
-	I2C_Write_And_Wait_for_ACK(I2C_TSL_INIT_CMD_REG_VAL);
+/************************************************************************************
+ * @function 	GPIO_ODD_IRQHandler
+ * @params 		None
+ * @brief 		GPIO IRQ Handler. Queues a block read of both TSL2561 ADC channels.
+ ************************************************************************************/
+void GPIO_ODD_IRQHandler(void)
+{
+#ifdef USE_INT
+	INT_Disable();
+#else
+	CORE_DECLARE_IRQ_STATE;
+	CORE_ENTER_ATOMIC();
+#endif
+
+	/* Clearing the source of interrupt: TSL2561 interrupt line */
+	GPIO_IntClear(I2C_TSL_INT_CLEAR_FLAG);
 
-	I2C_Send_Stop();
+	I2C_TSL_Read_Lux();
 
 #ifdef USE_INT
 	INT_Enable();
@@ -36,8 +36,17 @@
 #include "em_device.h"
 #include "em_rtc.h"
 #include "em_lesense.h"
+#include "MCIoT_main.h"
+#include "MCIoT_CMU.h"
 #include "MCIoT_LESENSE_Main.h"
 #include "MCIoT_LESENSE_LETouch.h"
+#include "MCIoT_Power.h"
+#include "MCIoT_Calibration.h"
+#include "MCIoT_Sleep.h"
+#ifdef USE_DMA_FOR_LESENSE
+#include "MCIoT_ADC.h"
+#include "MCIoT_DMA.h"
+#endif
 
 static volatile uint16_t calibration_value[NUM_LESENSE_CHANNELS][NUMBER_OF_CALIBRATION_VALUES];
 static volatile uint16_t buttons_pressed;
@@ -46,7 +55,40 @@ static volatile uint16_t channel_min_value[NUM_LESENSE_CHANNELS];
 
 static uint16_t channels_used_mask;
 static uint8_t num_channels_used;
-static float channel_threshold_percent[NUM_LESENSE_CHANNELS];
+static uint16_t channel_threshold_q8[NUM_LESENSE_CHANNELS];
+
+/* Sliding window max/min over calibration_value, one pair of deques per channel */
+static LETOUCH_DEQUE calibration_max_deque[NUM_LESENSE_CHANNELS];
+static LETOUCH_DEQUE calibration_min_deque[NUM_LESENSE_CHANNELS];
+static uint8_t calibration_value_index;
+
+/* Set while the RTC calibration waits for the running scan to complete */
+static bool calibration_deferred;
+
+/* Settling scans still to run from the scan complete interrupt, touches are
+ * not tracked until it reaches 0 */
+static volatile uint16_t calibration_settle_scans;
+
+/* Channels seen in the changed state that are not confirmed yet, the channel
+ * flags raised since the last scan complete and the scans counted so far */
+static uint16_t debounce_pending_mask;
+static uint16_t debounce_seen_mask;
+static uint8_t debounce_scan_count[NUM_LESENSE_CHANNELS];
+
+#ifdef USE_DMA_FOR_LESENSE
+/* Scan results moved from the LESENSE buffer by the DMA, one ping-pong half per batch */
+static volatile uint16_t lesense_dma_ring[2][LESENSE_DMA_BATCH_ENTRIES];
+static DMA_CB_TypeDef lesense_dma_cb;
+
+/* Used channels in scan order, results arrive in this order */
+static uint8_t channels_used_list[NUM_LESENSE_CHANNELS];
+static uint8_t dma_channel_slot;
+
+/* Highest count of each channel in the batch being processed and in the last complete one */
+static uint16_t channel_batch_max[NUM_LESENSE_CHANNELS];
+static volatile uint16_t channel_batch_value[NUM_LESENSE_CHANNELS];
+static volatile bool lesense_batch_ready;
+#endif
 
 /* Function prototypes */
 static void LETOUCH_setupACMP(void);
@@ -55,8 +97,23 @@ static void LETOUCH_setupGPIO(void);
 static void LETOUCH_setupRTC(void);
 static void LETOUCH_setupCMU(void);
 
-static uint16_t GetMaxValue(volatile uint16_t* A, uint16_t N);
-static uint16_t GetMinValue(volatile uint16_t* A, uint16_t N);
+static void LETOUCH_Read_Last_Scan(uint16_t *p_scan);
+static void LETOUCH_Calibration_Update(const volatile uint16_t *p_scan);
+static void LETOUCH_Settle_Scan(void);
+static void LETOUCH_Calibration_Done(void);
+#ifdef USE_CALIBRATION_RECORD
+static bool LETOUCH_Calibration_From_Record(void);
+#endif
+#ifdef USE_DMA_FOR_LESENSE
+static void LETOUCH_setupDMA(void);
+static void LETOUCH_DMA_Batch_Done(unsigned int channel, bool primary, void *user);
+static void LETOUCH_Process_Batch(const volatile uint16_t *p_results, uint16_t num_results);
+#endif
+static void LETOUCH_Scan_Complete_Enable(void);
+static void LETOUCH_Debounce_Scan(uint32_t elapsed_rtc_ticks);
+static void LETOUCH_Toggle_Channel(uint8_t channel);
+static void LETOUCH_Deque_Expire(LETOUCH_DEQUE *p_deque, uint8_t slot);
+static void LETOUCH_Deque_Push(LETOUCH_DEQUE *p_deque, volatile uint16_t *values, uint8_t slot, bool keep_larger);
 
 /**************************************************************************//**
  * Insertion sort, can be used to implement median filter instead of just using max-value
@@ -67,19 +124,27 @@ static uint16_t GetMinValue(volatile uint16_t* A, uint16_t N);
 /**************************************************************************//**
  * @brief Initializes the capacitive touch system with LESENSE.
  *
- * @param[in] sensitivity
- *   An array of floats, indication of threshold level, in percent,
- *   of nominal count value.
+ * @param[in] threshold_q8
+ *   Threshold level per channel, in percent of nominal count value, in Q8
+ *   (LETOUCH_THRESHOLD_Q8_ONE is 1 percent). A value of 0 indicates inactive
+ *   channel.
  *
  *****************************************************************************/
-void LETOUCH_Init(float sensitivity[])
+void LETOUCH_Init(const uint16_t threshold_q8[])
 {
 	uint8_t i;
 	channels_used_mask = 0;
 	num_channels_used = 0;
+	calibration_value_index = 0;
+	calibration_deferred = false;
+	calibration_settle_scans = 0;
+	debounce_pending_mask = 0;
+	debounce_seen_mask = 0;
+	/* LESENSE is reset below, so no channel starts in the touched state */
+	buttons_pressed = 0;
 
 	/* Initialize channels used mask and threshold array for each channel */
-	/* Uses the sensitivity array to deduce which channels to enable and how */
+	/* Uses the threshold array to deduce which channels to enable and how */
 	/* many channels that are enabled */
 
 	for(i = 0; i < NUM_LESENSE_CHANNELS; i++)
@@ -87,11 +152,17 @@ void LETOUCH_Init(float sensitivity[])
 		/* Init min and max values for each channel */
 		channel_max_value[i] = 0;
 		channel_min_value[i] = 0xffff;
+		calibration_max_deque[i].count = 0;
+		calibration_min_deque[i].count = 0;
 
-		/* Add to channels used mask if sensitivity is not zero */
-		if(sensitivity[i] != 0.0){
-			channel_threshold_percent[i] = sensitivity[i];
+		/* Add to channels used mask if threshold is not zero */
+		channel_threshold_q8[i] = threshold_q8[i];
+		if(threshold_q8[i] != 0){
 			channels_used_mask |= (1 << i);
+#ifdef USE_DMA_FOR_LESENSE
+			channels_used_list[num_channels_used] = i;
+			channel_batch_max[i] = 0;
+#endif
 			num_channels_used++;
 		}
 	}
@@ -112,14 +183,25 @@ void LETOUCH_Init(float sensitivity[])
 	LETOUCH_setupACMP();
 	/* Setup LESENSE. */
 	LETOUCH_setupLESENSE();
-	/* Do initial calibration "N_calibration_values * 10" times to make sure */
-	/* it settles on values after potential startup transients */
-	for(i = 0; i < NUMBER_OF_CALIBRATION_VALUES * 10; i++){
+#ifdef USE_CALIBRATION_RECORD
+	/* A stored calibration that still fits replaces the settling scans */
+	if(false == LETOUCH_Calibration_From_Record())
+#endif
+	{
+		/* Do initial calibration "N_calibration_values * 10" times to make sure */
+		/* it settles on values after potential startup transients. The scans */
+		/* run back to back from the scan complete interrupt, with the core */
+		/* asleep and the other interrupts served, see LETOUCH_IsCalibrated. */
+		calibration_settle_scans = NUMBER_OF_CALIBRATION_VALUES * 10;
+	}
+	LESENSE_IntClear(LESENSE_IFC_SCANCOMPLETE);
+	if(calibration_settle_scans != 0){
+		LESENSE_IntEnable(LESENSE_IEN_SCANCOMPLETE);
 		LESENSE_ScanStart();
-		LETOUCH_Calibration();
 	}
-	/* Setup RTC for calibration interrupt */
-	LETOUCH_setupRTC();
+	else{
+		LETOUCH_Calibration_Done();
+	}
 
 	/* Initialization done, enable interrupts globally. */
 #ifdef USE_INT
@@ -130,6 +212,51 @@ void LETOUCH_Init(float sensitivity[])
 
 }
 
+/**************************************************************************//**
+ * @brief Stops LESENSE scanning and the RTC calibration timer and releases
+ *   the clocks taken by LETOUCH_Init.
+ *****************************************************************************/
+void LETOUCH_DeInit(void)
+{
+	NVIC_DisableIRQ(RTC_IRQn);
+	NVIC_DisableIRQ(LESENSE_IRQn);
+
+	RTC_Enable(false);
+
+#ifdef USE_DMA_FOR_LESENSE
+	DMA_ChannelEnable(DMA_CHANNEL_LESENSE, false);
+#endif
+
+	/* Let the current scan finish before gating the LESENSE clock */
+	LESENSE_ScanStop();
+	while(LESENSE->STATUS & LESENSE_STATUS_SCANACTIVE);
+
+	LESENSE_IntDisable(_LESENSE_IEN_MASK);
+	LESENSE_IntClear(_LESENSE_IFC_MASK);
+
+	/* COMP0 belongs to the calibration and authentication timeouts, a later
+	 * Power_RTC_Start() only enables COMP1 */
+	RTC_IntDisable(RTC_IEN_COMP0);
+	RTC_IntClear(RTC_IFC_COMP0);
+
+	NVIC_ClearPendingIRQ(LESENSE_IRQn);
+	NVIC_ClearPendingIRQ(RTC_IRQn);
+
+	CMU_Consumer_Stop(CMU_CONSUMER_LESENSE);
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Check whether the settling scans started by LETOUCH_Init are done.
+ *
+ * @return
+ *   true once touches are tracked.
+ ******************************************************************************/
+bool LETOUCH_IsCalibrated(void)
+{
+	return (calibration_settle_scans == 0);
+}
+
 /***************************************************************************//**
  * @brief
  *   Get the buttons pressed variable, one bit for each channel pressed
@@ -174,6 +301,74 @@ uint16_t LETOUCH_GetChannelMinValue(uint8_t channel)
 	return channel_min_value[channel];
 }
 
+/***************************************************************************//**
+ * @brief
+ *   Get the current calibration of every channel, to be stored while the
+ *   LESENSE clock is still running.
+ *
+ * @param[out] p_baseline
+ *   Baseline (window maximum) of each channel, NUM_LESENSE_CHANNELS entries.
+ *
+ * @param[out] p_threshold
+ *   Threshold of each channel without the touch hysteresis,
+ *   NUM_LESENSE_CHANNELS entries.
+ *
+ * @return
+ *   The channels used mask.
+ ******************************************************************************/
+uint16_t LETOUCH_GetCalibration(uint16_t *p_baseline, uint16_t *p_threshold)
+{
+	uint8_t i;
+
+	for(i = 0; i < NUM_LESENSE_CHANNELS; i++){
+		p_baseline[i] = channel_max_value[i];
+		p_threshold[i] = LESENSE->CH[i].EVAL & _LESENSE_CH_EVAL_COMPTHRES_MASK;
+
+		/* A touched channel has its threshold raised by 1 LSB */
+		if(LESENSE->CH[i].EVAL & LESENSE_CH_EVAL_COMP){
+			p_threshold[i] -= 1;
+		}
+	}
+
+	return channels_used_mask;
+}
+
+/***************************************************************************//**
+ * @brief
+ *   Get the time until LESENSE next wakes the core up on its own.
+ *
+ * @details
+ *   A running scan completes after the sample delay of each used channel.
+ *   The scan timer cannot be read, so between scans this is the longest the
+ *   wait can be: one scan period while the scan complete interrupt is
+ *   enabled, one DMA batch of scans otherwise. Touches wake the core at any
+ *   time and have no deadline.
+ *
+ * @return
+ *   Time in us, SLEEP_NO_DEADLINE if no scan wakes the core up.
+ ******************************************************************************/
+uint32_t LETOUCH_Time_To_Next_Event_us(void)
+{
+	uint32_t scans;
+
+	if(LESENSE->IEN & LESENSE_IEN_SCANCOMPLETE){
+		if(LESENSE->STATUS & LESENSE_STATUS_SCANACTIVE){
+			return CMU_LF_Ticks_To_us(cmuSelect_LFXO, (uint64_t)num_channels_used * SAMPLE_DELAY);
+		}
+		scans = 1;
+	}
+#ifdef USE_DMA_FOR_LESENSE
+	else if((num_channels_used != 0) && DMA_ChannelEnabled(DMA_CHANNEL_LESENSE)){
+		scans = LESENSE_DMA_BATCH_ENTRIES / num_channels_used;
+	}
+#endif
+	else{
+		return SLEEP_NO_DEADLINE;
+	}
+
+	return (scans * 1000000) / LESENSE_SCAN_FREQUENCY;
+}
+
 /**************************************************************************//**
  * @brief  Enable clocks for all the peripherals to be used
  *****************************************************************************/
@@ -182,26 +377,8 @@ static void LETOUCH_setupCMU( void )
 	/* Ensure core frequency has been updated */
 	SystemCoreClockUpdate();
 
-	/* ACMP */
-	CMU_ClockEnable(cmuClock_ACMP0, true);
-	CMU_ClockEnable(cmuClock_ACMP1, true);
-
-	/* GPIO */
-	CMU_ClockEnable(cmuClock_GPIO, true);
-
-	/* Low energy peripherals
-	 *   LESENSE
-	 *   LFXO clock must be enabled prior to enabling
-	 *   clock for the low energy peripherals */
-	CMU_ClockSelectSet(cmuClock_LFA, cmuSelect_LFXO);
-	CMU_ClockEnable(cmuClock_CORELE, true);
-	CMU_ClockEnable(cmuClock_LESENSE, true);
-
-	/* RTC */
-	CMU_ClockEnable(cmuClock_RTC, true);
-
-	/* Disable clock source for LFB clock */
-	CMU_ClockSelectSet(cmuClock_LFB, cmuSelect_Disabled);
+	/* ACMP0/1, GPIO and the LFXO clocked LESENSE and RTC, held until LETOUCH_DeInit */
+	CMU_Consumer_Start(CMU_CONSUMER_LESENSE);
 }
 
 /**************************************************************************//**
@@ -364,7 +541,7 @@ static void LETOUCH_setupLESENSE( void )
       .storeScanRes = false,
       .bufOverWr    = true,
       .bufTrigLevel = lesenseBufTrigHalf,
-      .wakeupOnDMA  = lesenseDMAWakeUpDisable,
+      .wakeupOnDMA  = LESENSE_CORE_CTRL_DMA_WAKEUP,
       .biasMode     = lesenseBiasModeDutyCycle,
       .debugRun     = false
     },
@@ -494,16 +671,48 @@ void LETOUCH_setupRTC( void )
 }
 
 /**************************************************************************//**
- * Calibration function
-*****************************************************************************/
+ * @brief Calibration function, called from the RTC calibration interrupt.
+ *   With USE_DMA_FOR_LESENSE it uses the last batch moved by the DMA.
+ *   Otherwise it works on the last complete scan, and if a scan is in
+ *   progress the LESENSE scan complete interrupt does the update instead of
+ *   waiting for it here.
+ *****************************************************************************/
 void LETOUCH_Calibration( void )
 {
-	int i,k;
-	uint16_t nominal_count;
-	static uint8_t calibration_value_index = 0;
+#ifdef USE_DMA_FOR_LESENSE
+	/* No new sample if scanning stalled since the last calibration */
+	if(lesense_batch_ready){
+		lesense_batch_ready = false;
+		LETOUCH_Calibration_Update(channel_batch_value);
+	}
+#else
+	uint16_t scan[NUM_LESENSE_CHANNELS];
 
-	/* Wait for current scan to finish */
-	while(LESENSE->STATUS & LESENSE_STATUS_SCANACTIVE);
+	/* Arm first, a scan that completes after the check below raises the interrupt */
+	LETOUCH_Scan_Complete_Enable();
+
+	if(LESENSE->STATUS & LESENSE_STATUS_SCANACTIVE){
+		calibration_deferred = true;
+		return;
+	}
+
+	if(debounce_pending_mask == 0){
+		LESENSE_IntDisable(LESENSE_IEN_SCANCOMPLETE);
+	}
+
+	LETOUCH_Read_Last_Scan(scan);
+	LETOUCH_Calibration_Update(scan);
+#endif
+}
+
+/**************************************************************************//**
+ * @brief Reads the counts of the last complete scan from the LESENSE result
+ *   buffer into p_scan, indexed by channel.
+ *****************************************************************************/
+static void LETOUCH_Read_Last_Scan( uint16_t *p_scan )
+{
+	int k;
+	uint16_t mask;
 
 	/* Get position for first channel data in count buffer from lesense write pointer */
 	k = ((LESENSE->PTR & _LESENSE_PTR_WR_MASK) >> _LESENSE_PTR_WR_SHIFT);
@@ -516,11 +725,49 @@ void LETOUCH_Calibration( void )
 		k = k - num_channels_used + NUM_LESENSE_CHANNELS;
 	}
 
-	/* Fill calibration values array with buffer values */
-	for(i = 0; i < NUM_LESENSE_CHANNELS; i++){
-		if((channels_used_mask >> i) & 0x1){
-			calibration_value[i][calibration_value_index] = LESENSE_ScanResultDataBufferGet(k++);
-		}
+	/* Used channels only, lowest channel first as they are stored in the buffer */
+	for(mask = channels_used_mask; mask != 0; mask &= mask - 1){
+		p_scan[__CLZ(__RBIT(mask))] = LESENSE_ScanResultDataBufferGet(k);
+		k = (k + 1) & (NUM_LESENSE_CHANNELS - 1);
+	}
+}
+
+/**************************************************************************//**
+ * @brief Adds one count per used channel to the calibration window and sets
+ *   the threshold of each used channel from the window maximum. Only used
+ *   channels are visited, and monotonic deques keep the window max/min, so
+ *   the cost does not grow with NUMBER_OF_CALIBRATION_VALUES.
+ *
+ * @param[in] p_scan
+ *   Count of each channel, indexed by channel.
+ *****************************************************************************/
+static void LETOUCH_Calibration_Update( const volatile uint16_t *p_scan )
+{
+	uint8_t i, slot;
+	uint16_t mask, nominal_count;
+
+	/* The sample held in this slot leaves the window */
+	slot = calibration_value_index;
+
+	for(mask = channels_used_mask; mask != 0; mask &= mask - 1){
+		i = __CLZ(__RBIT(mask));
+
+		LETOUCH_Deque_Expire(&calibration_max_deque[i], slot);
+		LETOUCH_Deque_Expire(&calibration_min_deque[i], slot);
+
+		calibration_value[i][slot] = p_scan[i];
+
+		LETOUCH_Deque_Push(&calibration_max_deque[i], calibration_value[i], slot, true);
+		LETOUCH_Deque_Push(&calibration_min_deque[i], calibration_value[i], slot, false);
+
+		channel_max_value[i] = calibration_value[i][calibration_max_deque[i].slot[calibration_max_deque[i].head]];
+		channel_min_value[i] = calibration_value[i][calibration_min_deque[i].slot[calibration_min_deque[i].head]];
+
+		/* nominal - nominal * percent / 100, with the product rounded up so the
+		 * result truncates the same way the float calculation did */
+		nominal_count = channel_max_value[i];
+		LESENSE_ChannelThresSet(i, 0x0, nominal_count - (uint16_t)(((uint32_t)nominal_count * channel_threshold_q8[i]
+				+ (LETOUCH_THRESHOLD_Q8_DIVISOR - 1)) / LETOUCH_THRESHOLD_Q8_DIVISOR));
 	}
 
 	/* Wrap around calibration_values_index */
@@ -528,17 +775,243 @@ void LETOUCH_Calibration( void )
 	if(calibration_value_index >= NUMBER_OF_CALIBRATION_VALUES){
 		calibration_value_index = 0;
 	}
+}
 
-	/* Calculate max/min-value for each channel and set threshold */
-	for(i = 0; i < NUM_LESENSE_CHANNELS; i++){
-		if((channels_used_mask >> i) & 0x1){
-			channel_max_value[i] = GetMaxValue(calibration_value[i], NUMBER_OF_CALIBRATION_VALUES);
-			channel_min_value[i] = GetMinValue(calibration_value[i], NUMBER_OF_CALIBRATION_VALUES);
+/**************************************************************************//**
+ * @brief One settling scan, called from the scan complete interrupt. The next
+ *   scan is started straight away rather than at LESENSE_SCAN_FREQUENCY.
+ *****************************************************************************/
+static void LETOUCH_Settle_Scan( void )
+{
+	uint16_t scan[NUM_LESENSE_CHANNELS];
+
+	LETOUCH_Read_Last_Scan(scan);
+	LETOUCH_Calibration_Update(scan);
+
+	if(--calibration_settle_scans != 0){
+		LESENSE_ScanStart();
+		return;
+	}
 
-			nominal_count = channel_max_value[i];
-			LESENSE_ChannelThresSet(i, 0x0,(uint16_t) (nominal_count - ((nominal_count * channel_threshold_percent[i])/100.0)) );
+	LESENSE_IntDisable(LESENSE_IEN_SCANCOMPLETE);
+	LETOUCH_Calibration_Done();
+}
+
+/**************************************************************************//**
+ * @brief Starts tracking touches once the calibration has settled.
+ *****************************************************************************/
+static void LETOUCH_Calibration_Done( void )
+{
+#ifdef USE_DMA_FOR_LESENSE
+	/* From here on the DMA empties the result buffer */
+	LETOUCH_setupDMA();
+#endif
+	/* Setup RTC for calibration interrupt */
+	LETOUCH_setupRTC();
+}
+
+#ifdef USE_CALIBRATION_RECORD
+/**************************************************************************//**
+ * @brief Seeds the calibration window and the thresholds from the stored
+ *   record instead of running the settling scans. One fresh scan has to
+ *   match every stored baseline, otherwise the touch part of the record is
+ *   dropped and a full touch calibration is needed. The RTC calibration replaces one seeded sample
+ *   per interval from here on.
+ *
+ * @return
+ *   true if the calibration was taken from the record.
+ *****************************************************************************/
+static bool LETOUCH_Calibration_From_Record( void )
+{
+	uint8_t i;
+	uint16_t mask;
+	uint16_t scan[NUM_LESENSE_CHANNELS];
+
+	if(false == Calibration_Record_Touch_Valid(channels_used_mask)){
+		return false;
+	}
+
+	/* SCANACTIVE is only set once the start is synchronized to the LF clock,
+	 * so wait for the scan complete flag. A scan already running completes
+	 * and sets it too. */
+	LESENSE_IntClear(LESENSE_IFC_SCANCOMPLETE);
+	LESENSE_ScanStart();
+	while((LESENSE->IF & LESENSE_IF_SCANCOMPLETE) == 0);
+	LETOUCH_Read_Last_Scan(scan);
+
+	for(mask = channels_used_mask; mask != 0; mask &= mask - 1){
+		i = __CLZ(__RBIT(mask));
+
+		if(false == Calibration_Record_Baseline_Matches(i, scan[i])){
+			/* The pads drifted, the ULFRCO ratio is still good */
+			Calibration_Record_Drop_Touch();
+			return false;
+		}
+	}
+
+	for(i = 0; i < NUMBER_OF_CALIBRATION_VALUES; i++){
+		LETOUCH_Calibration_Update(calibration_record.baseline);
+	}
+
+	for(mask = channels_used_mask; mask != 0; mask &= mask - 1){
+		i = __CLZ(__RBIT(mask));
+		LESENSE_ChannelThresSet(i, 0x0, calibration_record.threshold[i]);
+	}
+
+	return true;
+}
+#endif
+
+#ifdef USE_DMA_FOR_LESENSE
+/**************************************************************************//**
+ * @brief Moves the LESENSE result buffer to lesense_dma_ring. The buffer
+ *   requests the DMA, waking it up in EM2, once it is half full, and the
+ *   core only wakes up when a ping-pong half of LESENSE_DMA_BATCH_ENTRIES
+ *   results is complete.
+ *****************************************************************************/
+static void LETOUCH_setupDMA( void )
+{
+	DMA_CfgChannel_TypeDef  chnlCfg;
+	DMA_CfgDescr_TypeDef    descrCfg;
+
+	dma_channel_slot = 0;
+	lesense_batch_ready = false;
+
+	lesense_dma_cb.cbFunc  = LETOUCH_DMA_Batch_Done;
+	lesense_dma_cb.userPtr = NULL;
+
+	chnlCfg.highPri   = false;
+	chnlCfg.enableInt = true;
+	chnlCfg.select    = DMA_LESENSE_SIGNAL_SOURCE;
+	chnlCfg.cb        = &lesense_dma_cb;
+	DMA_CfgChannel(DMA_CHANNEL_LESENSE, &chnlCfg);
+
+	descrCfg.dstInc  = dmaDataInc2;
+	descrCfg.srcInc  = dmaDataIncNone;				/* BUFDATA pops the oldest result */
+	descrCfg.size    = dmaDataSize2;
+	descrCfg.arbRate = DMA_LESENSE_ARBRATE;
+	descrCfg.hprot   = 0;
+	DMA_CfgDescr(DMA_CHANNEL_LESENSE, true, &descrCfg);
+	DMA_CfgDescr(DMA_CHANNEL_LESENSE, false, &descrCfg);
+
+	/* Start from an empty buffer so the first result is the first used channel */
+	LESENSE_ResultBufferClear();
+
+	DMA_ActivatePingPong(DMA_CHANNEL_LESENSE, false,
+			(void *)lesense_dma_ring[0], (void *)&LESENSE->BUFDATA, LESENSE_DMA_BATCH_ENTRIES - 1,
+			(void *)lesense_dma_ring[1], (void *)&LESENSE->BUFDATA, LESENSE_DMA_BATCH_ENTRIES - 1);
+}
+
+/**************************************************************************//**
+ * @brief DMA callback, a ping-pong half of lesense_dma_ring is full. The
+ *   DMA carries on in the other half while this one is processed.
+ *****************************************************************************/
+static void LETOUCH_DMA_Batch_Done(unsigned int channel, bool primary, void *user)
+{
+	LETOUCH_Process_Batch(lesense_dma_ring[primary ? 0 : 1], LESENSE_DMA_BATCH_ENTRIES);
+
+	DMA_RefreshPingPong(channel, primary, false, NULL, NULL, LESENSE_DMA_BATCH_ENTRIES - 1, false);
+}
+
+/**************************************************************************//**
+ * @brief Reduces a batch of results to the highest count of each channel,
+ *   which is the untouched count as a touch lowers it. A batch does not
+ *   have to end on a scan boundary, dma_channel_slot carries the position
+ *   in the scan over to the next batch.
+ *
+ *   Only the baseline tracking is batched. Touches are still detected by
+ *   the LESENSE channel interrupts, which wake the core on every scan from
+ *   the one that finds a pad past its threshold until the change is
+ *   confirmed. Detecting them from the batch would add up to a batch of
+ *   scans to the touch latency.
+ *
+ * @param[in] p_results
+ *   Results in the order LESENSE stored them.
+ *
+ * @param[in] num_results
+ *   Number of results in the batch.
+ *****************************************************************************/
+static void LETOUCH_Process_Batch(const volatile uint16_t *p_results, uint16_t num_results)
+{
+	uint16_t i;
+	uint8_t channel;
+
+	for(i = 0; i < num_results; i++){
+		channel = channels_used_list[dma_channel_slot];
+		if(p_results[i] > channel_batch_max[channel]){
+			channel_batch_max[channel] = p_results[i];
 		}
+
+		if(++dma_channel_slot >= num_channels_used){
+			dma_channel_slot = 0;
+		}
+	}
+
+	for(i = 0; i < num_channels_used; i++){
+		channel = channels_used_list[i];
+		channel_batch_value[channel] = channel_batch_max[channel];
+		channel_batch_max[channel] = 0;
 	}
+
+	lesense_batch_ready = true;
+}
+#endif
+
+/**************************************************************************//**
+ * @brief Drops the sample in the given slot from a deque. It is the oldest
+ *   sample of the window, so it can only be at the front.
+ *****************************************************************************/
+static void LETOUCH_Deque_Expire(LETOUCH_DEQUE *p_deque, uint8_t slot)
+{
+	if((p_deque->count != 0) && (p_deque->slot[p_deque->head] == slot)){
+		p_deque->head++;
+		if(p_deque->head >= NUMBER_OF_CALIBRATION_VALUES){
+			p_deque->head = 0;
+		}
+		p_deque->count--;
+	}
+}
+
+/**************************************************************************//**
+ * @brief Appends a sample to a monotonic deque. Older samples that can no
+ *   longer be the window max (keep_larger) or min are dropped from the back,
+ *   so the front of the deque is always the max/min of the window.
+ *
+ * @param[in] p_deque
+ *   Deque of calibration_value slots, oldest at the front.
+ *
+ * @param[in] values
+ *   Calibration values of the channel, indexed by slot.
+ *
+ * @param[in] slot
+ *   Slot of the new sample.
+ *
+ * @param[in] keep_larger
+ *   true for the max deque, false for the min deque.
+ *****************************************************************************/
+static void LETOUCH_Deque_Push(LETOUCH_DEQUE *p_deque, volatile uint16_t *values, uint8_t slot, bool keep_larger)
+{
+	uint8_t back;
+	uint16_t value = values[slot];
+
+	while(p_deque->count != 0){
+		back = p_deque->head + p_deque->count - 1;
+		if(back >= NUMBER_OF_CALIBRATION_VALUES){
+			back -= NUMBER_OF_CALIBRATION_VALUES;
+		}
+
+		if(keep_larger ? (values[p_deque->slot[back]] > value) : (values[p_deque->slot[back]] < value)){
+			break;
+		}
+		p_deque->count--;
+	}
+
+	back = p_deque->head + p_deque->count;
+	if(back >= NUMBER_OF_CALIBRATION_VALUES){
+		back -= NUMBER_OF_CALIBRATION_VALUES;
+	}
+	p_deque->slot[back] = slot;
+	p_deque->count++;
 }
 
 /**************************************************************************//**
@@ -565,39 +1038,87 @@ static void InsertionSort(uint16_t* A, uint16_t N){
 */
 
 /**************************************************************************//**
- * Returns maximum value in input array of size N
-*****************************************************************************/
-static uint16_t GetMaxValue(volatile uint16_t* A, uint16_t N)
+ * @brief Enables the scan complete interrupt, dropping a flag left over from
+ *   the scans that completed while it was disabled.
+ *****************************************************************************/
+static void LETOUCH_Scan_Complete_Enable( void )
 {
-	int i;
-	uint16_t max = 0;
+	if((LESENSE->IEN & LESENSE_IEN_SCANCOMPLETE) == 0){
+		LESENSE_IntClear(LESENSE_IFC_SCANCOMPLETE);
+		LESENSE_IntEnable(LESENSE_IEN_SCANCOMPLETE);
+	}
+}
 
-	for(i=0; i<N; i++)
-	{
-		if(max < A[i])
-		{
-			max = A[i];
+/**************************************************************************//**
+ * @brief Counter filter, run once per scan while a channel change is being
+ *   confirmed. A channel that is still in the changed state counts one more
+ *   scan and is confirmed after VALIDATE_CNT of them. A channel that went
+ *   back before that was a false touch and is dropped. The scans are started
+ *   back to back from the scan complete interrupt, nothing waits for them.
+ *
+ * @param[in] elapsed_rtc_ticks
+ *   RTC ticks since the last confirmed touch event.
+ *****************************************************************************/
+static void LETOUCH_Debounce_Scan( uint32_t elapsed_rtc_ticks )
+{
+	uint8_t channel;
+	uint16_t mask;
+	bool changed = false;
+
+	for(mask = debounce_pending_mask; mask != 0; mask &= mask - 1){
+		channel = __CLZ(__RBIT(mask));
+
+		if((debounce_seen_mask & (1 << channel)) == 0){
+			debounce_pending_mask &= ~(1 << channel);
+		}
+		else if(++debounce_scan_count[channel] >= VALIDATE_CNT){
+			debounce_pending_mask &= ~(1 << channel);
+			LETOUCH_Toggle_Channel(channel);
+
+			/* Changes confirmed on the same scan happened at the same time */
+			LESENSE_Auth_Touch_Event(buttons_pressed, elapsed_rtc_ticks);
+			elapsed_rtc_ticks = 0;
+			changed = true;
 		}
 	}
-	return max;
+
+	debounce_seen_mask = 0;
+
+	if(changed){
+		/* Need to reset RTC counter so we don't get new calibration event right after buttons are pushed/released. */
+		RTC_CounterReset();
+	}
 }
 
 /**************************************************************************//**
- * Returns minimum value in input array of size N
-*****************************************************************************/
-static uint16_t GetMinValue(volatile uint16_t* A, uint16_t N)
+ * @brief Records a confirmed press or release of a channel and inverts its
+ *   comparison, so the channel flag is raised again on the opposite change.
+ *****************************************************************************/
+static void LETOUCH_Toggle_Channel( uint8_t channel )
 {
-	int i;
-	uint16_t min = 0xffff;
+	uint16_t threshold_value;
 
-	for(i=0; i<N; i++)
+	/* If logic was switched clear button flag and set logic back, else set button flag and invert logic. */
+	if(LESENSE->CH[channel].EVAL & LESENSE_CH_EVAL_COMP)
 	{
-		if(A[i] < min)
-		{
-			min = A[i];
-		}
+		buttons_pressed &= ~(1 << channel);
+		LESENSE->CH[channel].EVAL &= ~LESENSE_CH_EVAL_COMP;
+
+		threshold_value = LESENSE->CH[channel].EVAL & (_LESENSE_CH_EVAL_COMPTHRES_MASK);
+		/* Change threshold value 1 LSB for hysteresis. */
+		threshold_value -= 1;
+		LESENSE_ChannelThresSet(channel, 0, threshold_value);
+	}
+	else
+	{
+		buttons_pressed |= (1 << channel);
+		LESENSE->CH[channel].EVAL |= LESENSE_CH_EVAL_COMP;
+
+		threshold_value = LESENSE->CH[channel].EVAL & (_LESENSE_CH_EVAL_COMPTHRES_MASK);
+		/* Change threshold value 1 LSB for hysteresis. */
+		threshold_value += 1;
+		LESENSE_ChannelThresSet(channel, 0, threshold_value);
 	}
-	return min;
 }
 
 /**************************************************************************//**
@@ -610,92 +1131,104 @@ static uint16_t GetMinValue(volatile uint16_t* A, uint16_t N)
  *****************************************************************************/
 void RTC_IRQHandler( void )
 {
-	/* Clear interrupt flag */
-	RTC_IntClear(RTC_IFS_COMP0);
+	uint32_t flags = RTC->IF & RTC->IEN;
 
-	LETOUCH_Calibration();
+	if (flags & RTC_IF_COMP0)
+	{
+		/* Clear interrupt flag */
+		RTC_IntClear(RTC_IFS_COMP0);
 
-	/* Reset counter */
-	RTC_CounterReset();
+		LETOUCH_Calibration();
+
+		/* No touch event for a whole calibration interval */
+		LESENSE_Auth_Timeout_Event();
+
+		/* Reset counter */
+		RTC_CounterReset();
+	}
+
+	/* COMP1 times the settling of the sensor power domains */
+	if (flags & RTC_IF_COMP1)
+	{
+		Power_RTC_IRQHandler();
+	}
 }
 
 /**************************************************************************//**
  * @brief LESENSE_IRQHandler
- * Interrupt Service Routine for LESENSE Interrupt Line
+ * Interrupt Service Routine for LESENSE Interrupt Line. The channel flags
+ * are level triggered, so they are raised on every scan that finds a channel
+ * in the changed state. The scan complete interrupt is only enabled while a
+ * change is being confirmed or a calibration waits for the running scan.
  *****************************************************************************/
 void LESENSE_IRQHandler( void )
 {
-	uint8_t channel, i, valid_touch;
-	uint32_t interrupt_flags, tmp, channels_enabled;
-	uint16_t threshold_value;
+	uint16_t channel_flags, mask;
+	uint32_t interrupt_flags;
+
+	/* The counter is reset on every touch event, so it holds the time since the last one */
+	uint32_t elapsed_rtc_ticks = RTC_CounterGet();
 
 	/* Get interrupt flag */
-	interrupt_flags = LESENSE_IntGet();
+	interrupt_flags = LESENSE_IntGetEnabled();
 
 	/* Clear interrupt flag */
 	LESENSE_IntClear(interrupt_flags);
 
-	/* Interrupt handles only one channel at a time */
-	/* therefore only first active channel found is handled by the interrupt. */
-	for(channel = 0; channel < NUM_LESENSE_CHANNELS; channel++)
+	/* Touches are not tracked while the calibration settles */
+	if(calibration_settle_scans != 0)
 	{
-		if( (interrupt_flags >> channel) & 0x1 )
+		if(interrupt_flags & LESENSE_IF_SCANCOMPLETE)
 		{
-			break;
+			LETOUCH_Settle_Scan();
 		}
+		return;
 	}
 
-	/* To filter out possible false touches, the suspected channel is measured several times */
-	/* All samples should be below threshold to trigger an actual touch. */
+	channel_flags = (uint16_t)(interrupt_flags & channels_used_mask);
+	debounce_seen_mask |= channel_flags;
 
-	/* Disable other channels. */
-	channels_enabled = LESENSE->CHEN;
-	LESENSE->CHEN = 1 << channel;
-
-	/* Evaluate VALIDATE_CNT results for touched channel. */
-	valid_touch = 1;
-	for(i = 0; i < VALIDATE_CNT; i++)
+	/* A channel that just changed starts counting scans */
+	mask = channel_flags & ~debounce_pending_mask;
+	if(mask != 0)
 	{
-		/* Start new scan and wait while active. */
-		LESENSE_ScanStart();
-		while(LESENSE->STATUS & LESENSE_STATUS_SCANACTIVE);
+		debounce_pending_mask |= mask;
+		for(; mask != 0; mask &= mask - 1)
+		{
+			debounce_scan_count[__CLZ(__RBIT(mask))] = 0;
+		}
 
-		tmp = LESENSE->SCANRES;
-		if((tmp & (1 << channel)) == 0)
+		LETOUCH_Scan_Complete_Enable();
+
+		/* The change is confirmed over scans started back to back */
+		if((interrupt_flags & LESENSE_IF_SCANCOMPLETE) == 0)
 		{
-			valid_touch = 0;
+			LESENSE_ScanStart();
 		}
 	}
 
-	/* Enable all channels again. */
-	LESENSE->CHEN = channels_enabled;
+	if(interrupt_flags & LESENSE_IF_SCANCOMPLETE)
+	{
+		/* Calibration deferred by the RTC interrupt while a scan was active */
+		if(calibration_deferred)
+		{
+			uint16_t scan[NUM_LESENSE_CHANNELS];
+
+			calibration_deferred = false;
+			LETOUCH_Read_Last_Scan(scan);
+			LETOUCH_Calibration_Update(scan);
+		}
 
+		LETOUCH_Debounce_Scan(elapsed_rtc_ticks);
 
-	if(valid_touch){
-		/* If logic was switched clear button flag and set logic back, else set button flag and invert logic. */
-		if(LESENSE->CH[channel].EVAL & LESENSE_CH_EVAL_COMP)
+		if(debounce_pending_mask == 0)
 		{
-			buttons_pressed &= ~(1 << channel);
-			LESENSE->CH[channel].EVAL &= ~LESENSE_CH_EVAL_COMP;
-
-			threshold_value = LESENSE->CH[channel].EVAL & (_LESENSE_CH_EVAL_COMPTHRES_MASK);
-			/* Change threshold value 1 LSB for hysteresis. */
-			threshold_value -= 1;
-			LESENSE_ChannelThresSet(channel, 0, threshold_value);
+			LESENSE_IntDisable(LESENSE_IEN_SCANCOMPLETE);
 		}
 		else
 		{
-			buttons_pressed |= (1 << channel);
-			LESENSE->CH[channel].EVAL |= LESENSE_CH_EVAL_COMP;
-
-			threshold_value = LESENSE->CH[channel].EVAL & (_LESENSE_CH_EVAL_COMPTHRES_MASK);
-			/* Change threshold value 1 LSB for hysteresis. */
-			threshold_value += 1;
-			LESENSE_ChannelThresSet(channel, 0, threshold_value);
+			/* Next confirm scan */
+			LESENSE_ScanStart();
 		}
 	}
-
-	/* Need to reset RTC counter so we don't get new calibration event right after buttons are pushed/released. */
-	RTC_CounterReset();
-
 }
@@ -37,210 +37,177 @@
 #include "MCIoT_LESENSE_LETouch.h"
 #include "MCIoT_GPIO.h"
 #include "MCIoT_main.h"
-
+#include "MCIoT_Sleep.h"
+#include "MCIoT_Touch_Pattern.h"
+#include "MCIoT_Calibration.h"
+
+/* Unlock pattern: pad PC8, then pad PC11 within 3 s of releasing PC8.
+ * A chord is written as several pads in one step, e.g.
+ * { TOUCH_PATTERN_PAD(9) | TOUCH_PATTERN_PAD(10), 200, 2000 } */
+static const TOUCH_PATTERN_STEP_DEF touch_auth_steps[] =
+{
+	{ TOUCH_PATTERN_PAD(8),		0,	0 },
+	{ TOUCH_PATTERN_PAD(11),	0,	3000 },
+};
+
+/* Only changed from the LESENSE and RTC interrupts once armed */
+static TOUCH_PATTERN touch_auth_pattern;
+
+#ifdef USE_CALIBRATION_RECORD
+/* Touch calibration read back by LESENSE_TearDown, saved once the ULFRCO ratio is known */
+static uint16_t lesense_channels_used_mask;
+static uint16_t lesense_baseline[NUM_LESENSE_CHANNELS];
+static uint16_t lesense_threshold[NUM_LESENSE_CHANNELS];
+#endif
+
+static void LESENSE_Auth_Result(TOUCH_PATTERN_RESULT e_result);
+
+/************************************************************************************
+ * @function 	LESENSE_SetUp
+ * @params 		None
+ * @brief 		Starts capacitive touch sensing on the pads used by the unlock
+ *				pattern and sleeps in EM2 until the pattern engine, driven by the
+ *				LESENSE and RTC interrupts, accepts the pattern. Success is
+ *				reported through is_lesense_auth_done.
+ ************************************************************************************/
 void LESENSE_SetUp(void)
 {
-	/* Bitmask for the currently touched channels */
-	uint16_t channels_touched = 0;
-
-	/* Four pins PC8, PC9, PC10 and PC11 corresponding to the four slider pads. */
-
-	/* Four pins active, PC8, PC9, PC10 and PC11. A value of 0.0 indicates inactive channel. */
-	//float sensitivity[] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0,1.0, 1.0, 1.0, 1.0, 0.0, 0.0, 0.0, 0.0};
-
-	/* Sensitivity array with only one slider pad active, pin: PC8. */
-	float sensitivity[] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 0.0};
+	/* Threshold per channel in percent, Q8, a value of 0 indicates inactive channel */
+	uint16_t threshold_q8[NUM_LESENSE_CHANNELS] = {0};
 
-	bool new_channel_event = false;
-	bool awaiting_next_touch_event = false;
-	uint8_t is_the_channel_to_be_checked[NUM_LESENSE_CHANNELS] = {0};
-	uint8_t is_the_channel_to_be_checked_saved[NUM_LESENSE_CHANNELS] = {0};
-	uint8_t valid_touch_count = 0;
-
-	uint8_t num_channels_enabled = 0;
-
-	CMU_ClockEnable(cmuClock_LETIMER0, false); /* To disable the clock for LETIMER */
+	if (false == Touch_Pattern_Compile(&touch_auth_pattern, touch_auth_steps,
+			sizeof(touch_auth_steps) / sizeof(touch_auth_steps[0])))
+	{
+		return;
+	}
 
+	/* Only the pads the pattern uses are scanned */
 	for (int i = 0; i < NUM_LESENSE_CHANNELS; i++)
 	{
-		if (sensitivity[i] != 0)
+		if (touch_auth_pattern.channels_mask & (1 << i))
 		{
-			is_the_channel_to_be_checked[i] = 1;
-			num_channels_enabled++;
+			threshold_q8[i] = LETOUCH_THRESHOLD_Q8_ONE;
 		}
 	}
 
-	memcpy(is_the_channel_to_be_checked_saved, is_the_channel_to_be_checked, NUM_LESENSE_CHANNELS);
-
-	uint8_t num_channels_enabled_saved = num_channels_enabled;
+	LED_Off(LED0_1_GPIO_PORT, LED0_GPIO_PIN);
 
-	/* Init GPIO for LED, turn LED off */
-	//CMU_ClockEnable(cmuClock_GPIO, true);
-	//GPIO_PinModeSet(LED_PORT, LED_PIN, gpioModePushPull, 0);
+	/* LESENSE and its calibration RTC run from the LFXO, which stops in EM3 */
+	blockSleepMode(LESENSE_EM);
 
-	/* Init Capacitive touch for channels configured in sensitivity array */
-	LETOUCH_Init(sensitivity);
+	/* Init Capacitive touch for channels configured in threshold array */
+	LETOUCH_Init(threshold_q8);
 
-	/* If any channels are touched while starting, the calibration will not be correct. */
-	/* Wait while channels are touched to be sure we continue in a calibrated state. */
-	while(LETOUCH_GetChannelsTouched() != 0);
-
-	/* Enter infinite loop. */
-	while (1)
+	/* The settling scans run from the LESENSE interrupt */
+	while (false == LETOUCH_IsCalibrated())
 	{
-		int i = 8;
-		/* Get channels that are pressed, result is or'ed together */
-		channels_touched = LETOUCH_GetChannelsTouched();
+		Sleep();
+	}
 
-		if (num_channels_enabled > 0)
-		{
-			if (is_the_channel_to_be_checked[i++] != 0)
-			{
-				if (channels_touched == CHANNEL_EIGHT_TOUCH_VAL)
-				{
-					num_channels_enabled--;
-					if (false == awaiting_next_touch_event)
-					{
-						awaiting_next_touch_event = true;
-						valid_touch_count++;
-					}
-					is_the_channel_to_be_checked[i-1] = 0;
-				}
-			}
-			else
-			{
-				if (channels_touched == CHANNEL_EIGHT_TOUCH_VAL)
-				{
-					num_channels_enabled--;
-					if (true == awaiting_next_touch_event)
-					{
-						awaiting_next_touch_event = false;
-						valid_touch_count--;
-					}
-				}
-			}
-
-			for (int j = 0; j < 10000; j++);
-
-
-			if (is_the_channel_to_be_checked[i++] != 0)
-			{
-				if (channels_touched == CHANNEL_NINE_TOUCH_VAL)
-				{
-					num_channels_enabled--;
-					if (false == awaiting_next_touch_event)
-					{
-						awaiting_next_touch_event = true;
-						valid_touch_count++;
-					}
-					is_the_channel_to_be_checked[i-1] = 0;
-				}
-			}
-			else
-			{
-				if (channels_touched == CHANNEL_NINE_TOUCH_VAL)
-				{
-					num_channels_enabled--;
-					if (true == awaiting_next_touch_event)
-					{
-						awaiting_next_touch_event = false;
-						valid_touch_count--;
-					}
-				}
-			}
-
-			for (int j = 0; j < 10000; j++);
-
-			if (is_the_channel_to_be_checked[i++] != 0)
-			{
-				if (channels_touched == CHANNEL_TEN_TOUCH_VAL)
-				{
-					num_channels_enabled--;
-					if (false == awaiting_next_touch_event)
-					{
-						awaiting_next_touch_event = true;
-						valid_touch_count++;
-					}
-					is_the_channel_to_be_checked[i-1] = 0;
-				}
-			}
-			else
-			{
-				if (channels_touched == CHANNEL_TEN_TOUCH_VAL)
-				{
-					num_channels_enabled--;
-					if (true == awaiting_next_touch_event)
-					{
-						awaiting_next_touch_event = false;
-						valid_touch_count--;
-					}
-				}
-			}
-
-			for (int j = 0; j < 10000; j++);
-
-			if (is_the_channel_to_be_checked[i++] != 0)
-			{
-				if (channels_touched == CHANNEL_ELEVEN_TOUCH_VAL)
-				{
-					num_channels_enabled--;
-					if (false == awaiting_next_touch_event)
-					{
-						awaiting_next_touch_event = true;
-						valid_touch_count++;
-					}
-					is_the_channel_to_be_checked[i-1] = 0;
-				}
-			}
-			else
-			{
-				if (channels_touched == CHANNEL_ELEVEN_TOUCH_VAL)
-				{
-					num_channels_enabled--;
-					if (true == awaiting_next_touch_event)
-					{
-						awaiting_next_touch_event = false;
-						valid_touch_count--;
-					}
-				}
-			}
-
-			for (int j = 0; j < 10000; j++);
+	BOOT_TRACE(BOOT_STAGE_TOUCH_CALIBRATED);
 
-		}
-		else
-		{
-			num_channels_enabled = num_channels_enabled_saved;
-			memcpy(is_the_channel_to_be_checked, is_the_channel_to_be_checked_saved, NUM_LESENSE_CHANNELS);
-		}
+	/* If any channels are touched while starting, the calibration will not be correct.
+	 * The pattern engine waits for them to be released before the first step. */
+#ifdef USE_INT
+	INT_Disable();
+#else
+	CORE_DECLARE_IRQ_STATE;
+	CORE_ENTER_ATOMIC();
+#endif
 
-		if (valid_touch_count == num_channels_enabled_saved)
-		{
-			new_channel_event = true;
-		}
+	Touch_Pattern_Reset(&touch_auth_pattern, LETOUCH_GetChannelsTouched());
 
+#ifdef USE_INT
+	INT_Enable();
+#else
+	CORE_EXIT_ATOMIC();
+#endif
 
-		/* Check if any channels are in the touched state. */
+	/* Every touch event and calibration tick wakes the core, nothing else to do in between */
+	while (false == is_lesense_auth_done)
+	{
+		Sleep();
+	}
 
-		if (new_channel_event == true)
-		{
-			/* Turn on LED */
-			//GPIO_PinModeSet(LED_PORT, LED_PIN, gpioModePushPull, 1);
-			LED_On(LED0_1_GPIO_PORT, LED0_GPIO_PIN);
-			new_channel_event = false;
+	unblockSleepMode(LESENSE_EM);
+}
 
-			is_lesense_auth_done = true;
-			break;
+/************************************************************************************
+ * @function 	LESENSE_Auth_Touch_Event
+ * @params 		[in] channels_touched - pads in the touched state after a validated
+ *				press or release, one bit per channel
+ * 				[in] elapsed_rtc_ticks - RTC ticks since the previous touch event
+ * @brief 		Called from LESENSE_IRQHandler, feeds the pattern engine.
+ ************************************************************************************/
+void LESENSE_Auth_Touch_Event(uint16_t channels_touched, uint32_t elapsed_rtc_ticks)
+{
+	LESENSE_Auth_Result(Touch_Pattern_Touch_Event(&touch_auth_pattern, channels_touched,
+			elapsed_rtc_ticks >> TOUCH_PATTERN_TICK_SHIFT));
+}
 
-		}
-		else
-		{
-			/* Turn off LED */
-			//GPIO_PinModeSet(LED_PORT, LED_PIN, gpioModePushPull, 0);
-			LED_Off(LED0_1_GPIO_PORT, LED0_GPIO_PIN);
-		}
+/************************************************************************************
+ * @function 	LESENSE_Auth_Timeout_Event
+ * @params 		None
+ * @brief 		Called from the RTC calibration interrupt, which only fires after
+ *				CALIBRATION_INTERVAL seconds without a touch event. That interval
+ *				is the quiet interval of the pattern engine.
+ ************************************************************************************/
+void LESENSE_Auth_Timeout_Event(void)
+{
+	LESENSE_Auth_Result(Touch_Pattern_Timeout_Event(&touch_auth_pattern));
+}
 
-		/* Enter EM2 */
-		//EMU_EnterEM2(true);
+/************************************************************************************
+ * @function 	LESENSE_Auth_Result
+ * @params 		[in] e_result - verdict of the pattern engine for the last event
+ * @brief 		LED0 is lit once the pattern is accepted and turned off by a failed
+ *				attempt.
+ ************************************************************************************/
+static void LESENSE_Auth_Result(TOUCH_PATTERN_RESULT e_result)
+{
+	switch (e_result)
+	{
+	case TOUCH_PATTERN_RESULT_ACCEPTED:
+		LED_On(LED0_1_GPIO_PORT, LED0_GPIO_PIN);
+		is_lesense_auth_done = true;
+		break;
+	case TOUCH_PATTERN_RESULT_REJECTED:
+	case TOUCH_PATTERN_RESULT_LOCKED:
+		LED_Off(LED0_1_GPIO_PORT, LED0_GPIO_PIN);
+		break;
+	default:
+		break;
 	}
 }
+
+/************************************************************************************
+ * @function 	LESENSE_TearDown
+ * @params 		None
+ * @brief 		Touch sensing is only needed for authentication. Reads back the
+ *				touch calibration, stops LESENSE and releases its ACMP, RTC and
+ *				LESENSE clocks.
+ ************************************************************************************/
+void LESENSE_TearDown(void)
+{
+#ifdef USE_CALIBRATION_RECORD
+	/* The thresholds are read back from LESENSE, before its clock is gated */
+	lesense_channels_used_mask = LETOUCH_GetCalibration(lesense_baseline, lesense_threshold);
+#endif
+
+	LETOUCH_DeInit();
+}
+
+/************************************************************************************
+ * @function 	LESENSE_Save_Calibration
+ * @params 		None
+ * @brief 		Stores the touch calibration read back by LESENSE_TearDown for the
+ *				next boot, with the ULFRCO ratio. Called once the LF clocks are set
+ *				up, so that a ratio calibrated on this boot is stored too.
+ ************************************************************************************/
+void LESENSE_Save_Calibration(void)
+{
+#ifdef USE_CALIBRATION_RECORD
+	/* The next boot starts from this calibration */
+	Calibration_Record_Save(lesense_channels_used_mask, lesense_baseline, lesense_threshold, osc_ratio);
+#endif
+}
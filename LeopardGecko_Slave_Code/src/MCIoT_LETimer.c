@@ -51,6 +51,59 @@
 
 /************************************ INCLUDES **************************************/
 
+/******************************* COMPILE TIME CHECKS ********************************/
+
+#if LETIMER_LFXO_PRESCALER > LETIMER0_MAX_PRESCALER
+#error "ALS_EXCITE_PERIOD_MS cannot be represented by the 16 bit LETIMER0 on LFXO"
+#endif
+
+#if LETIMER_ULFRCO_PRESCALER > LETIMER0_MAX_PRESCALER
+#error "ALS_EXCITE_PERIOD_MS cannot be represented by the 16 bit LETIMER0 on ULFRCO"
+#endif
+
+#if (LETIMER_LFXO_EXCITE_TICKS == 0) || (LETIMER_ULFRCO_EXCITE_TICKS == 0)
+#error "ALS_MIN_EXCITE_PERIOD_MS is shorter than one LETIMER0 tick"
+#endif
+
+#if ALS_MIN_EXCITE_PERIOD_MS >= ALS_EXCITE_PERIOD_MS
+#error "ALS_MIN_EXCITE_PERIOD_MS must be shorter than ALS_EXCITE_PERIOD_MS"
+#endif
+
+/******************************* COMPILE TIME CHECKS ********************************/
+
+/************************************ GLOBALS ***************************************/
+
+#define LETIMER_TIMING_LFXO		{ cmuSelect_LFXO, LETIMER_LFXO_PRESCALER, \
+								  LETIMER_LFXO_COMP0_VAL, LETIMER_LFXO_COMP1_VAL }
+#define LETIMER_TIMING_ULFRCO	{ cmuSelect_ULFRCO, LETIMER_ULFRCO_PRESCALER, \
+								  LETIMER_ULFRCO_COMP0_VAL, LETIMER_ULFRCO_COMP1_VAL }
+
+const LETIMER_TIMING_CONFIG letimer_timing_config[LETIMER_ENERGY_MODE_MAX] =
+{
+	[ENERGY_MODE_EM0] = LETIMER_TIMING_LFXO,
+	[ENERGY_MODE_EM1] = LETIMER_TIMING_LFXO,
+	[ENERGY_MODE_EM2] = LETIMER_TIMING_LFXO,
+	[ENERGY_MODE_EM3] = LETIMER_TIMING_ULFRCO,
+	[ENERGY_MODE_EM4] = LETIMER_TIMING_ULFRCO
+};
+
+/************************************ GLOBALS ***************************************/
+
+#ifdef ULFRCO_SELF_CALIBRATE
+/************************************************************************************
+ * @function 	LETimer_Apply_Osc_Ratio
+ * @params 		[in] count - nominal ULFRCO tick count
+ * @brief 		Corrects a nominal ULFRCO count with the self calibrated oscillator
+ * 				ratio, saturating at the LETIMER0 counter width.
+ ************************************************************************************/
+static uint32_t LETimer_Apply_Osc_Ratio(uint32_t count)
+{
+	uint64_t corrected = ((uint64_t)count * osc_ratio) >> OSC_RATIO_FRAC_BITS;
+
+	return (corrected > LETIMER0_MAX_COUNT) ? LETIMER0_MAX_COUNT : (uint32_t)corrected;
+}
+#endif
+
 /************************************************************************************
  * @function 	LETimer_Config_LETimer
  * @params 		None
@@ -65,16 +118,18 @@ void LETimer_Config_LETimer(LETIMER_TypeDef *LETimer,
 
 	blockSleepMode(LETIMER_MIN_ENERGY_MODE);
 
-	if (e_letimer_energy_modes == ENERGY_MODE_EM3)
-	{
-		comp0_val = ULFRCO_FREQUENCY*osc_ratio*ALS_EXCITE_PERIOD;
-		comp1_val = comp0_val - ULFRCO_FREQUENCY*osc_ratio*ALS_MIN_EXCITE_PERIOD;
-	}
-	else
+	/* Compare values are resolved at compile time for every energy mode */
+	comp0_val = letimer_timing_config[e_letimer_energy_modes].comp0_val;
+	comp1_val = letimer_timing_config[e_letimer_energy_modes].comp1_val;
+
+#ifdef ULFRCO_SELF_CALIBRATE
+	if ((letimer_timing_config[e_letimer_energy_modes].lfa_clock == cmuSelect_ULFRCO)
+			&& (osc_ratio != 0))
 	{
-		comp0_val = (LFXO_FREQUENCY/prescaled_two_power)*ALS_EXCITE_PERIOD;
-		comp1_val = comp0_val - (LFXO_FREQUENCY/prescaled_two_power)*ALS_MIN_EXCITE_PERIOD;
+		comp0_val = LETimer_Apply_Osc_Ratio(comp0_val);
+		comp1_val = LETimer_Apply_Osc_Ratio(comp1_val);
 	}
+#endif
 
 #ifdef USE_ACTIVE_ALS
 	letimer0_comp0_period_count = 0;
@@ -128,17 +183,8 @@ void LETimer_Config(LETIMER_TypeDef *LETimer,
 {
 	uint32_t letimer_sync_busy;
 
-	/* Enable necessary clocks */
-	if (e_letimer_energy_modes == ENERGY_MODE_EM3)
-	{
-		CMU_OscillatorEnable(cmuOsc_ULFRCO, true, true); /* To enable the ULFRCO */
-		CMU_ClockSelectSet(cmuClock_LFA, cmuSelect_ULFRCO); /* To support energy modes EM3 */
-	}
-	else
-	{
-		CMU_OscillatorEnable(cmuOsc_LFXO, true, true); /* To enable the LFXO */
-		CMU_ClockSelectSet(cmuClock_LFA, cmuSelect_LFXO); /* To support energy modes EM0-EM2 */
-	}
+	/* Enable necessary clocks, LFXO for energy modes EM0-EM2 and ULFRCO for EM3 */
+	CMU_Consumer_Start(CMU_CONSUMER_LETIMER);
 
 	LETIMER_Setup(LETimer, letimer_init_params);
 
@@ -189,6 +235,118 @@ void LETIMER_Interrupt_Enable(LETIMER_TypeDef *LETimer)
 	LETIMER_IntEnable(LETimer, LETIMER_IF_COMP1);
 }
 
+/************************************************************************************
+ * @function 	LETimer_Time_To_Next_Event_us
+ * @params 		None
+ * @brief 		Returns the time until the next COMP1 match or underflow of LETIMER0,
+ *				or SLEEP_NO_DEADLINE if LETIMER0 is not running.
+ ************************************************************************************/
+uint32_t LETimer_Time_To_Next_Event_us(void)
+{
+	const LETIMER_TIMING_CONFIG *p_timing = &letimer_timing_config[e_letimer_energy_modes];
+	uint32_t count;
+	uint32_t comp1;
+	uint32_t ticks;
+
+	if ((LETIMER0->STATUS & LETIMER_STATUS_RUNNING) == 0)
+	{
+		return SLEEP_NO_DEADLINE;
+	}
+
+	/* The counter runs down from COMP0, COMP1 fires on the way to the underflow */
+	count = LETIMER_CounterGet(LETIMER0);
+	comp1 = LETIMER_CompareGet(LETIMER0, 1);
+	ticks = (count > comp1) ? (count - comp1) : count;
+
+	return CMU_LF_Ticks_To_us(p_timing->lfa_clock, (uint64_t)ticks << p_timing->prescaler);
+}
+
+#if defined(USE_ANY_ALS) && defined(USE_ADAPTIVE_ALS)
+/************************************************************************************
+ * @function 	LETimer_ALS_Check_Due
+ * @params 		None
+ * @brief 		Called on every COMP0 for the passive ALS, and at the start of every
+ * 				power cycle for the active ALS. Returns true if the ALS has to be
+ * 				excited and checked in this period or cycle.
+ ************************************************************************************/
+static bool LETimer_ALS_Check_Due(void)
+{
+	if (als_periods_to_check > 0)
+	{
+		als_periods_to_check--;
+		als_checks_skipped++;
+		return false;
+	}
+
+	return true;
+}
+
+/************************************************************************************
+ * @function 	LETimer_ALS_Back_Off
+ * @params 		[in] is_stable - (bool) the light level did not change in this check
+ * @brief 		Doubles the check interval while the light level is stable, up to
+ * 				ALS_MAX_CHECK_INTERVAL, and goes back to every check when it changes.
+ ************************************************************************************/
+static void LETimer_ALS_Back_Off(bool is_stable)
+{
+	if ((als_check_interval == 0) || !is_stable)
+	{
+		als_check_interval = 1;
+	}
+	else if (als_check_interval < ALS_MAX_CHECK_INTERVAL)
+	{
+		als_check_interval <<= 1;
+	}
+
+	als_periods_to_check = als_check_interval - 1;
+}
+
+#ifdef USE_ACTIVE_ALS
+/************************************************************************************
+ * @function 	LETimer_ALS_Consume_Lux
+ * @params 		None
+ * @brief 		Takes the lux value of this power cycle, if the TSL2561 read
+ * 				completed, and backs off the next power cycles while it stays
+ * 				within 1/2^ALS_LUX_STABLE_SHIFT of the previous one.
+ ************************************************************************************/
+static void LETimer_ALS_Consume_Lux(void)
+{
+	static uint32_t als_last_lux;
+	uint32_t lux;
+	uint32_t lux_delta;
+
+	if (false == tsl_lux_available)
+	{
+		/* The read failed, check again in the next cycle */
+		LETimer_ALS_Back_Off(false);
+		return;
+	}
+
+	lux = tsl_lux;
+	tsl_lux_available = false;
+
+	lux_delta = (lux > als_last_lux) ? (lux - als_last_lux) : (als_last_lux - lux);
+
+	/* One lux of slack so that a dark room does not count as changing */
+	LETimer_ALS_Back_Off(lux_delta <= ((als_last_lux >> ALS_LUX_STABLE_SHIFT) + 1));
+
+	als_last_lux = lux;
+}
+#else
+/************************************************************************************
+ * @function 	LETimer_ALS_Update_Interval
+ * @params 		[in] acmp_out_val - (uint32_t) ACMP output of this check
+ * @brief 		Backs off the passive ALS checks while the ACMP output is stable.
+ ************************************************************************************/
+static void LETimer_ALS_Update_Interval(uint32_t acmp_out_val)
+{
+	LETimer_ALS_Back_Off(acmp_out_val == als_last_acmp_out);
+
+	als_last_acmp_out = acmp_out_val;
+}
+#endif
+#endif
+
 /************************************************************************************
  * @function 	LETIMER0_IRQHandler
  * @params 		None
@@ -218,8 +376,13 @@ void LETIMER0_IRQHandler(void)
 		//LED_On(LED0_1_GPIO_PORT, LED0_GPIO_PIN);
 #ifdef USE_ANY_ALS
 #ifndef USE_ACTIVE_ALS
+#ifdef USE_ADAPTIVE_ALS
+		als_check_pending = LETimer_ALS_Check_Due();
+		if (als_check_pending)
+		{
+#endif
 
-		CMU_ClockEnable(cmuClock_ACMP0, true); /* To enable clock to ACMP0 */
+		CMU_Consumer_Start(CMU_CONSUMER_ACMP); /* To enable clock to ACMP0 */
 
 		/* Turn on ACMP */
 		ACMP0->CTRL |= ACMP_CTRL_EN;
@@ -229,13 +392,30 @@ void LETIMER0_IRQHandler(void)
 		/* Waiting for the ACMPACT bit to be set in ACMP0_STATUS register
 		 * indicating that the ACMP is warmed up */
 		while ((ACMP0->STATUS & ACMP_STATUS_ACMPACT) != ACMP_STATUS_ACMPACT);
+
+#ifdef USE_ADAPTIVE_ALS
+		}
+#endif
 #else
 
+		I2C_Transfer_Timeout_Tick();
+
+#ifdef USE_ADAPTIVE_ALS
+		/* A whole power cycle of the TSL2651 is either run or skipped */
+		if (letimer0_comp0_period_count % 3 == 0)
+		{
+			als_check_pending = LETimer_ALS_Check_Due();
+		}
+
+		if (als_check_pending)
+		{
+#endif
 		if (letimer0_comp0_period_count % 3 == 1)
 		{
 			/* LETimer Periods 1,4,7,... */
-			/* Monitor the TSL2651 via its interrupt line */
-			/* Do Nothing */
+			/* Monitor the TSL2651 via its interrupt line and
+			 * publish the current light level */
+			I2C_TSL_Read_Lux();
 		}
 		else if (letimer0_comp0_period_count % 3 == 2)
 		{
@@ -243,6 +423,11 @@ void LETIMER0_IRQHandler(void)
 			/* Disable the TSL2651 */
 
 			I2C_TSL_PowerOff_Routine();
+
+#ifdef USE_ADAPTIVE_ALS
+			/* The read of period 1 has completed or timed out by now */
+			LETimer_ALS_Consume_Lux();
+#endif
 		}
 		else
 		{
@@ -254,11 +439,14 @@ void LETIMER0_IRQHandler(void)
 
 			I2C_TSL_PowerOn_Routine();
 		}
+#ifdef USE_ADAPTIVE_ALS
+		}
+#endif
 #endif
 #endif
 
 		/* ADC part*/
-		CMU_ClockEnable(cmuClock_ADC0, true); /* To enable clock to ADC0 */
+		CMU_Consumer_Start(CMU_CONSUMER_ADC); /* To enable clock to ADC0 */
 
 #ifndef USE_DMA_FOR_ADC
 		/* Set up the DMA */
@@ -307,22 +495,33 @@ void LETIMER0_IRQHandler(void)
 			/* LETimer Periods 2,5,8,... */
 			/* Disable the TSL2651 */
 
+#ifdef USE_ADAPTIVE_ALS
+			/* Nothing was powered on in a skipped cycle */
+			if (als_check_pending)
+#endif
 			I2C_TSL_Deinit();
 		}
 		else
 		{
 			/* LETimer Periods 0,3,6,... */
 
-			/* 1. Enable the TSL2651 onto the I2C bus
-			 * 2. Initialize/start the TSL2651
-			 * 3. monitor the TSL2651 via its interrupt line */
-
-			I2C_TSL_Init();
+			/* The TSL2651 is enabled onto the I2C bus and initialized by its
+			 * power domain once the supply has settled, see I2C_TSL_PowerOn_Routine */
 		}
 #else
+#ifdef USE_ADAPTIVE_ALS
+		/* Nothing to check if the ALS was not excited this period */
+		if (als_check_pending)
+		{
+		als_check_pending = false;
+#endif
 		/* Check the ACMP out value and decide the action and switch off ACMP */
 		acmp_out_val = (ACMP0->STATUS & ACMP_STATUS_ACMPOUT) >> 1;
 
+#ifdef USE_ADAPTIVE_ALS
+		LETimer_ALS_Update_Interval(acmp_out_val);
+#endif
+
 		if (!acmp_out_val)
 		{
 			/* Turning on LED1 */
@@ -375,9 +574,12 @@ void LETIMER0_IRQHandler(void)
 		/* Turn off the ACMP */
 		ACMP0->CTRL &= ~ACMP_CTRL_EN;
 
-		CMU_ClockEnable(cmuClock_ACMP0, false); /* To disable clock to ACMP0 */
+		CMU_Consumer_Stop(CMU_CONSUMER_ACMP); /* To disable clock to ACMP0 */
 
 		GPIO_PinModeSet(ALS_GPIO_PORT, ALS_SENSE_GPIO_PIN, gpioModeDisabled, 0);
+#ifdef USE_ADAPTIVE_ALS
+		}
+#endif
 #endif
 
 
@@ -142,6 +142,9 @@ void LEUART0_IRQHandler(void)
 #endif
 	static bool temp_data_read_in_progress = false;
 	static bool is_next_temp_data_mantissa = false;
+#ifdef ENABLE_BOOT_TRACE
+	static bool is_first_sample_traced = false;
+#endif
 	uint8_t		flex_sensor_value = 0;
 	uint8_t 	led_data = 0;
 	uint8_t 	temp_sign_data = 0;
@@ -171,6 +174,15 @@ void LEUART0_IRQHandler(void)
 
 			LEUART0->TXDATA = flex_sensor_value;
 
+#ifdef ENABLE_BOOT_TRACE
+			/* Only the first transmit is a boot stage */
+			if (false == is_first_sample_traced)
+			{
+				is_first_sample_traced = true;
+				BOOT_TRACE(BOOT_STAGE_FIRST_SAMPLE_TX);
+			}
+#endif
+
 			while((LEUART0->IF & LEUART_IF_TXC) == 0);
 
 			if (e_letimer_energy_modes == ENERGY_MODE_EM2)
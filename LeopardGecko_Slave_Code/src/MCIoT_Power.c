@@ -0,0 +1,345 @@
+/*****************************************************************************
+ * @file 	MCIoT_Power.c
+ * @brief 	This file describes the power sequencing of external sensor supplies.
+ * 			A supply is switched on, the core sleeps in EM2 while the RTC times
+ * 			its settle time, and the sensor init continues from the RTC interrupt.
+ * @author 	Pavan Dhareshwar
+ * @version 1.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2013 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ ************************************************************************************/
+
+
+/************************************ INCLUDES **************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "MCIoT_main.h"
+#include "MCIoT_Power.h"
+#include "MCIoT_CMU.h"
+#include "MCIoT_Sleep.h"
+
+/************************************ INCLUDES **************************************/
+
+/************************************ GLOBALS ***************************************/
+
+/* Domains waiting for their settle time, in no particular order */
+static POWER_DOMAIN *power_settling[POWER_DOMAIN_MAX];
+static uint8_t power_settling_count;
+
+static bool power_rtc_running;
+
+/************************************ GLOBALS ***************************************/
+
+/************************************************************************************
+ * @function 	Power_RTC_Start
+ * @params 		None
+ * @brief 		Starts the RTC free running on the LFA tree. The core may sleep
+ * 				no deeper than EM2 until the last domain has settled.
+ * 				The RTC is shared with the touch calibration, which is stopped by
+ * 				LETOUCH_DeInit before any sensor is powered.
+ ************************************************************************************/
+static void Power_RTC_Start(void)
+{
+	static const RTC_Init_TypeDef rtc_init =
+	{
+		.enable   = true,
+		.debugRun = false,
+		.comp0Top = false			/* Wrap at 2^24, deadlines are kept modulo the counter */
+	};
+
+	CMU_Consumer_Start(CMU_CONSUMER_RTC);
+
+	RTC_Init(&rtc_init);
+
+	/* Only the power domain deadlines wake the core from here on */
+	RTC_IntDisable(_RTC_IEN_MASK);
+	RTC_IntClear(RTC_IFC_COMP1);
+	RTC_IntEnable(RTC_IEN_COMP1);
+
+	NVIC_ClearPendingIRQ(RTC_IRQn);
+	NVIC_EnableIRQ(RTC_IRQn);
+
+	blockSleepMode(ENERGY_MODE_EM2);
+
+	power_rtc_running = true;
+}
+
+/************************************************************************************
+ * @function 	Power_RTC_Stop
+ * @params 		None
+ * @brief 		Stops the RTC and releases its clock and the EM2 sleep block.
+ ************************************************************************************/
+static void Power_RTC_Stop(void)
+{
+	RTC_IntDisable(RTC_IEN_COMP1);
+	RTC_IntClear(RTC_IFC_COMP1);
+
+	NVIC_DisableIRQ(RTC_IRQn);
+
+	RTC_Enable(false);
+
+	CMU_Consumer_Stop(CMU_CONSUMER_RTC);
+
+	unblockSleepMode(ENERGY_MODE_EM2);
+
+	power_rtc_running = false;
+}
+
+/************************************************************************************
+ * @function 	Power_RTC_Service
+ * @params 		None
+ * @brief 		Runs the deferred step of every domain whose settle time has
+ * 				elapsed and arms COMP1 for the earliest remaining one. Called with
+ * 				interrupts masked.
+ ************************************************************************************/
+static void Power_RTC_Service(void)
+{
+	POWER_DOMAIN *p_domain;
+	uint32_t now = RTC_CounterGet();
+	uint32_t elapsed;
+	uint32_t next_ticks = POWER_RTC_COUNTER_MASK;
+	uint8_t i = 0;
+
+	while (i < power_settling_count)
+	{
+		p_domain = power_settling[i];
+		elapsed = (now - p_domain->start_tick) & POWER_RTC_COUNTER_MASK;
+
+		if (elapsed >= p_domain->settle_ticks)
+		{
+			power_settling[i] = power_settling[--power_settling_count];
+			p_domain->e_state = POWER_DOMAIN_ON;
+
+			if (p_domain->on_ready != NULL)
+			{
+				/* The step may switch other domains on or off, rescan */
+				p_domain->on_ready(p_domain);
+
+				now = RTC_CounterGet();
+				next_ticks = POWER_RTC_COUNTER_MASK;
+				i = 0;
+			}
+		}
+		else
+		{
+			if ((p_domain->settle_ticks - elapsed) < next_ticks)
+			{
+				next_ticks = p_domain->settle_ticks - elapsed;
+			}
+			i++;
+		}
+	}
+
+	if (power_settling_count == 0)
+	{
+		if (power_rtc_running)
+		{
+			Power_RTC_Stop();
+		}
+		return;
+	}
+
+	if (next_ticks < POWER_RTC_MIN_TICKS)
+	{
+		next_ticks = POWER_RTC_MIN_TICKS;
+	}
+
+	RTC_CompareSet(1, (now + next_ticks) & POWER_RTC_COUNTER_MASK);
+}
+
+/************************************************************************************
+ * @function 	Power_Domain_On
+ * @params 		[in] p_domain - (POWER_DOMAIN *) supply to switch on
+ * @brief 		Drives the supply pin high and returns. on_ready is called from the
+ * 				RTC interrupt after settle_ms, the core sleeps in EM2 meanwhile.
+ * 				Does nothing if the domain is already on or settling.
+ ************************************************************************************/
+void Power_Domain_On(POWER_DOMAIN *p_domain)
+{
+	uint32_t rtc_freq;
+
+#ifdef USE_INT
+	INT_Disable();
+#else
+	CORE_DECLARE_IRQ_STATE;
+	CORE_ENTER_ATOMIC();
+#endif
+
+	if ((p_domain->e_state == POWER_DOMAIN_OFF) && (power_settling_count < POWER_DOMAIN_MAX))
+	{
+		GPIO_PinModeSet(p_domain->port, p_domain->pin, gpioModePushPull, 1);
+
+		if (!power_rtc_running)
+		{
+			Power_RTC_Start();
+		}
+
+		/* Round up, a supply must never be used early */
+		rtc_freq = CMU_ClockFreqGet(cmuClock_RTC);
+		p_domain->settle_ticks = ((p_domain->settle_ms * rtc_freq) + 999) / 1000;
+		p_domain->start_tick = RTC_CounterGet();
+		p_domain->e_state = POWER_DOMAIN_SETTLING;
+
+		power_settling[power_settling_count++] = p_domain;
+
+		Power_RTC_Service();
+	}
+
+#ifdef USE_INT
+	INT_Enable();
+#else
+	CORE_EXIT_ATOMIC();
+#endif
+}
+
+/************************************************************************************
+ * @function 	Power_Domain_Off
+ * @params 		[in] p_domain - (POWER_DOMAIN *) supply to switch off
+ * @brief 		Drives the supply pin low and disables it. A pending on_ready of a
+ * 				settling domain is cancelled.
+ ************************************************************************************/
+void Power_Domain_Off(POWER_DOMAIN *p_domain)
+{
+	uint8_t i;
+
+#ifdef USE_INT
+	INT_Disable();
+#else
+	CORE_DECLARE_IRQ_STATE;
+	CORE_ENTER_ATOMIC();
+#endif
+
+	if (p_domain->e_state == POWER_DOMAIN_SETTLING)
+	{
+		for (i = 0; i < power_settling_count; i++)
+		{
+			if (power_settling[i] == p_domain)
+			{
+				power_settling[i] = power_settling[--power_settling_count];
+				break;
+			}
+		}
+	}
+
+	GPIO_PinOutClear(p_domain->port, p_domain->pin);
+	GPIO_PinModeSet(p_domain->port, p_domain->pin, gpioModeDisabled, 0);
+
+	p_domain->e_state = POWER_DOMAIN_OFF;
+
+	if (power_rtc_running)
+	{
+		Power_RTC_Service();
+	}
+
+#ifdef USE_INT
+	INT_Enable();
+#else
+	CORE_EXIT_ATOMIC();
+#endif
+}
+
+/************************************************************************************
+ * @function 	Power_RTC_Time_To_Next_Event_us
+ * @params 		None
+ * @brief 		Returns the time until the next RTC compare match with its interrupt
+ * 				enabled, COMP1 of the power domains or COMP0 of the touch
+ * 				calibration, or SLEEP_NO_DEADLINE if the RTC is stopped.
+ ************************************************************************************/
+uint32_t Power_RTC_Time_To_Next_Event_us(void)
+{
+	static const uint32_t comp_ien[2] = { RTC_IEN_COMP0, RTC_IEN_COMP1 };
+	uint32_t now;
+	uint32_t top;
+	uint32_t compare;
+	uint32_t ticks;
+	uint32_t next_ticks = SLEEP_NO_DEADLINE;
+	uint8_t comp;
+
+	if ((RTC->CTRL & RTC_CTRL_EN) == 0)
+	{
+		return SLEEP_NO_DEADLINE;
+	}
+
+	now = RTC_CounterGet();
+
+	/* The touch calibration wraps the counter after COMP0 */
+	top = (RTC->CTRL & RTC_CTRL_COMP0TOP) ? RTC_CompareGet(0) : POWER_RTC_COUNTER_MASK;
+
+	for (comp = 0; comp < 2; comp++)
+	{
+		if ((RTC->IEN & comp_ien[comp]) == 0)
+		{
+			continue;
+		}
+
+		compare = RTC_CompareGet(comp);
+		ticks = (compare >= now) ? (compare - now) : ((top - now) + compare + 1);
+
+		if (ticks < next_ticks)
+		{
+			next_ticks = ticks;
+		}
+	}
+
+	if (next_ticks == SLEEP_NO_DEADLINE)
+	{
+		return SLEEP_NO_DEADLINE;
+	}
+
+	return CMU_LF_Ticks_To_us(CMU_ClockSelectGet(cmuClock_LFA),
+			(uint64_t)next_ticks * CMU_ClockDivGet(cmuClock_RTC));
+}
+
+/************************************************************************************
+ * @function 	Power_RTC_IRQHandler
+ * @params 		None
+ * @brief 		RTC COMP1 handler, dispatched from RTC_IRQHandler.
+ ************************************************************************************/
+void Power_RTC_IRQHandler(void)
+{
+#ifdef USE_INT
+	INT_Disable();
+#else
+	CORE_DECLARE_IRQ_STATE;
+	CORE_ENTER_ATOMIC();
+#endif
+
+	RTC_IntClear(RTC_IFC_COMP1);
+
+	if (power_rtc_running)
+	{
+		Power_RTC_Service();
+	}
+
+#ifdef USE_INT
+	INT_Enable();
+#else
+	CORE_EXIT_ATOMIC();
+#endif
+}
@@ -42,6 +42,85 @@
 #include "MCIoT_ADC.h"
 #include "MCIoT_CMU.h"
 #include "MCIoT_GPIO.h"
+#include "MCIoT_LETimer.h"
+#include "MCIoT_Power.h"
+#include "MCIoT_LESENSE_LETouch.h"
+
+/************************************ INCLUDES **************************************/
+
+/************************************ GLOBALS ***************************************/
+
+const SLEEP_MODE_COST sleep_mode_cost[LETIMER_ENERGY_MODE_MAX] =
+{
+	[ENERGY_MODE_EM0] = { SLEEP_EM0_CURRENT_NA, 0 },
+	[ENERGY_MODE_EM1] = { SLEEP_EM1_CURRENT_NA, SLEEP_EM1_WAKEUP_US },
+	[ENERGY_MODE_EM2] = { SLEEP_EM2_CURRENT_NA, SLEEP_EM2_WAKEUP_US },
+	[ENERGY_MODE_EM3] = { SLEEP_EM3_CURRENT_NA, SLEEP_EM3_WAKEUP_US }
+};
+
+/************************************ GLOBALS ***************************************/
+
+/************************************************************************************
+ * @function 	Sleep_Wakeup_Latency_us
+ * @params 		[in] e_sleep_mode - energy mode to wake up from
+ * @brief 		Returns the time spent in EM0 after a wakeup from a mode before the
+ *				next LETIMER0 event can be serviced: restart of the HF and LF
+ *				oscillators the mode stops, and warm-up of the ADC sample.
+ ************************************************************************************/
+static uint32_t Sleep_Wakeup_Latency_us(ENERGY_MODES e_sleep_mode)
+{
+	uint32_t latency_us = sleep_mode_cost[e_sleep_mode].wakeup_latency_us;
+
+	if (e_sleep_mode < ENERGY_MODE_EM2)
+	{
+		return latency_us;
+	}
+
+	if (CMU_ClockSelectGet(cmuClock_HF) == cmuSelect_HFXO)
+	{
+		latency_us += SLEEP_HFXO_RESTART_US;
+	}
+
+#ifdef ENABLE_ADC_MODULE
+	/* In normal warm-up mode the ADC warms up for every sample, in EM1 as well */
+	if (ADC_WARMUPMODE != adcWarmupNormal)
+	{
+		latency_us += SLEEP_ADC_WARMUP_US;
+	}
+#endif
+
+	if ((e_sleep_mode >= ENERGY_MODE_EM3) && CMU_Is_LFXO_In_Use())
+	{
+		latency_us += SLEEP_LFXO_RESTART_US;
+	}
+
+	return latency_us;
+}
+
+/************************************************************************************
+ * @function 	Sleep_Time_To_Next_Event_us
+ * @params 		None
+ * @brief 		Returns the time until the earliest known wakeup: the next LETIMER0
+ *				event, RTC compare match or LESENSE scan interrupt.
+ ************************************************************************************/
+static uint32_t Sleep_Time_To_Next_Event_us(void)
+{
+	uint32_t time_to_event_us = LETimer_Time_To_Next_Event_us();
+	uint32_t rtc_us = Power_RTC_Time_To_Next_Event_us();
+	uint32_t lesense_us = LETOUCH_Time_To_Next_Event_us();
+
+	if (rtc_us < time_to_event_us)
+	{
+		time_to_event_us = rtc_us;
+	}
+
+	if (lesense_us < time_to_event_us)
+	{
+		time_to_event_us = lesense_us;
+	}
+
+	return time_to_event_us;
+}
 
 /************************************************************************************
  * @function 	blockSleepMode
@@ -101,24 +180,95 @@ void unblockSleepMode(ENERGY_MODES e_letimer_energy_modes)
  ************************************************************************************/
 void Sleep(void)
 {
+	ENERGY_MODES e_sleep_mode;
+
 	if (sleep_block_counter[EM0] > 0)
 	{
 		return; 				/* Block everything below EM0, just return */
 	}
 	else if (sleep_block_counter[EM1] > 0)
 	{
-		EMU_EnterEM1(); 	/* Block everything below EM2, enter EM2 */
+		e_sleep_mode = ENERGY_MODE_EM1; 	/* Block everything below EM1 */
 	}
 	else if (sleep_block_counter[EM2] > 0)
 	{
-		EMU_EnterEM2(true); 	/* Block everything below EM2, enter EM2 */
+		e_sleep_mode = ENERGY_MODE_EM2; 	/* Block everything below EM2 */
 	}
-	else if (sleep_block_counter[EM3] > 0)
+	else
 	{
-		EMU_EnterEM3(true); 	/* Block everything below EM3, enter EM3 */
+		e_sleep_mode = ENERGY_MODE_EM3; 	/* Block everything below EM3, or nothing is blocked */
 	}
-	else
+
+	/* Back off from the deepest allowed mode if waking from it would miss the
+	 * next timer or scan event or cost more energy than it saves */
+	e_sleep_mode = Sleep_Select_Mode(e_sleep_mode, Sleep_Time_To_Next_Event_us());
+
+	switch (e_sleep_mode)
 	{
-		EMU_EnterEM3(true);  	/* Nothing is blocked, enter EM3 */
+	case ENERGY_MODE_EM1:
+		EMU_EnterEM1();
+		break;
+	case ENERGY_MODE_EM2:
+		EMU_EnterEM2(true);
+		break;
+	default:
+		EMU_EnterEM3(true);
+		break;
 	}
 }
+
+/************************************************************************************
+ * @function 	Sleep_Select_Mode
+ * @params 		[in] e_deepest_mode - deepest mode allowed by the sleep block counters
+ * 				[in] time_to_event_us - time until the next known wakeup event
+ * @brief 		Picks the deepest mode, no deeper than e_deepest_mode, that wakes up
+ *				before the event and uses less energy than staying in EM1. Energy
+ *				is compared as current x time, with the wakeup spent in EM0.
+ ************************************************************************************/
+ENERGY_MODES Sleep_Select_Mode(ENERGY_MODES e_deepest_mode, uint32_t time_to_event_us)
+{
+	ENERGY_MODES e_mode;
+	uint32_t latency_us;
+	uint64_t em1_energy;
+	uint64_t sleep_energy;
+
+	if (e_deepest_mode <= ENERGY_MODE_EM1)
+	{
+		return e_deepest_mode;
+	}
+
+	/* EM4 has no cost entry, it is never entered from here */
+	if (e_deepest_mode > ENERGY_MODE_EM3)
+	{
+		e_deepest_mode = ENERGY_MODE_EM3;
+	}
+
+	/* Without a known deadline the wakeup cost is amortized over an unbounded sleep */
+	if (time_to_event_us == SLEEP_NO_DEADLINE)
+	{
+		return e_deepest_mode;
+	}
+
+	em1_energy = (uint64_t)sleep_mode_cost[ENERGY_MODE_EM1].current_na * time_to_event_us;
+
+	for (e_mode = e_deepest_mode; e_mode > ENERGY_MODE_EM1; e_mode--)
+	{
+		latency_us = Sleep_Wakeup_Latency_us(e_mode);
+
+		/* Waking up from this mode would miss the deadline */
+		if (latency_us >= time_to_event_us)
+		{
+			continue;
+		}
+
+		sleep_energy = (uint64_t)sleep_mode_cost[e_mode].current_na * (time_to_event_us - latency_us)
+				+ (uint64_t)sleep_mode_cost[ENERGY_MODE_EM0].current_na * latency_us;
+
+		if (sleep_energy < em1_energy)
+		{
+			return e_mode;
+		}
+	}
+
+	return ENERGY_MODE_EM1;
+}
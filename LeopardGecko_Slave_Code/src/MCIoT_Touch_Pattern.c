@@ -0,0 +1,303 @@
+/*****************************************************************************
+ * @file 	MCIoT_Touch_Pattern.c
+ * @brief 	This file describes the touch pattern authentication engine. A pattern
+ * 			is compiled into a step table and matched against the validated press
+ * 			and release events of the capacitive touch pads. It does not access
+ * 			any peripheral, so it can be fed synthetic touch streams.
+ * @author 	Pavan Dhareshwar
+ * @version 1.0
+ ******************************************************************************
+ * @section License
+ * <b>(C) Copyright 2013 Energy Micro AS, http://www.energymicro.com</b>
+ *******************************************************************************
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ * 4. The source and compiled code may only be used on Energy Micro "EFM32"
+ *    microcontrollers and "EFR4" radios.
+ *
+ * DISCLAIMER OF WARRANTY/LIMITATION OF REMEDIES: Energy Micro AS has no
+ * obligation to support this Software. Energy Micro AS is providing the
+ * Software "AS IS", with no express or implied warranties of any kind,
+ * including, but not limited to, any implied warranties of merchantability
+ * or fitness for any particular purpose or warranties against infringement
+ * of any proprietary rights of a third party.
+ *
+ * Energy Micro AS will not be liable for any consequential, incidental, or
+ * special damages, or any other relief, or for any claim by any third party,
+ * arising from your use of this Software.
+ *
+ ************************************************************************************/
+
+
+/************************************ INCLUDES **************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "MCIoT_Touch_Pattern.h"
+
+/************************************ INCLUDES **************************************/
+
+/****************************** FUNCTION PROTOTYPES *********************************/
+
+static uint16_t Touch_Pattern_Ms_To_Ticks(uint32_t ms);
+
+static TOUCH_PATTERN_RESULT Touch_Pattern_Fail(TOUCH_PATTERN *p_pattern);
+
+static void Touch_Pattern_Restart(TOUCH_PATTERN *p_pattern);
+
+/****************************** FUNCTION PROTOTYPES *********************************/
+
+/************************************************************************************
+ * @function 	Touch_Pattern_Compile
+ * @params 		[out] p_pattern - pattern to build
+ * 				[in] p_steps - step definitions, in the order they have to be entered
+ * 				[in] num_steps - number of step definitions
+ * @brief 		Builds the step table and resets the matching state. Returns false,
+ *				leaving the pattern locked, if a step has no pads or an inverted
+ *				timing window, or if the pattern does not fit the table.
+ ************************************************************************************/
+bool Touch_Pattern_Compile(TOUCH_PATTERN *p_pattern, const TOUCH_PATTERN_STEP_DEF *p_steps, uint8_t num_steps)
+{
+	uint8_t i;
+
+	p_pattern->num_steps = 0;
+	p_pattern->channels_mask = 0;
+	p_pattern->e_state = TOUCH_PATTERN_STATE_LOCKED;
+
+	if ((num_steps == 0) || (num_steps > TOUCH_PATTERN_MAX_STEPS))
+	{
+		return false;
+	}
+
+	for (i = 0; i < num_steps; i++)
+	{
+		if ((p_steps[i].chord_mask == 0) || (p_steps[i].min_gap_ms > p_steps[i].max_gap_ms))
+		{
+			p_pattern->channels_mask = 0;
+			return false;
+		}
+
+		p_pattern->steps[i].chord_mask = p_steps[i].chord_mask;
+
+		if (i == 0)
+		{
+			/* Nothing to time the first step against */
+			p_pattern->steps[i].min_gap_ticks = 0;
+			p_pattern->steps[i].max_gap_ticks = TOUCH_PATTERN_MAX_GAP_TICKS;
+		}
+		else
+		{
+			p_pattern->steps[i].min_gap_ticks = Touch_Pattern_Ms_To_Ticks(p_steps[i].min_gap_ms);
+			p_pattern->steps[i].max_gap_ticks = Touch_Pattern_Ms_To_Ticks(p_steps[i].max_gap_ms);
+		}
+
+		p_pattern->channels_mask |= p_steps[i].chord_mask;
+	}
+
+	p_pattern->num_steps = num_steps;
+	p_pattern->failures = 0;
+	p_pattern->lockout_intervals = 0;
+
+	Touch_Pattern_Reset(p_pattern, 0);
+
+	return true;
+}
+
+/************************************************************************************
+ * @function 	Touch_Pattern_Reset
+ * @params 		[in] p_pattern - compiled pattern
+ * 				[in] channels_touched - pads in the touched state right now
+ * @brief 		Drops any progress. Pads that are already held have to be released
+ *				before the first step is accepted.
+ ************************************************************************************/
+void Touch_Pattern_Reset(TOUCH_PATTERN *p_pattern, uint16_t channels_touched)
+{
+	p_pattern->last_touched = channels_touched;
+
+	Touch_Pattern_Restart(p_pattern);
+}
+
+/************************************************************************************
+ * @function 	Touch_Pattern_Touch_Event
+ * @params 		[in] p_pattern - compiled pattern
+ * 				[in] channels_touched - pads in the touched state after a validated
+ *				press or release, one bit per channel
+ * 				[in] elapsed_ticks - TOUCH_PATTERN_TICK_HZ ticks since the previous
+ *				touch event
+ * @brief 		A step starts with the first pad pressed and ends when every pad is
+ *				released. The pads touched in between form the chord of the step.
+ *				A wrong chord or a gap outside the step window is only recorded.
+ *				The verdict is given after as many steps as the pattern has, so it
+ *				does not reveal where the entered pattern went wrong.
+ ************************************************************************************/
+TOUCH_PATTERN_RESULT Touch_Pattern_Touch_Event(TOUCH_PATTERN *p_pattern, uint16_t channels_touched, uint32_t elapsed_ticks)
+{
+	const TOUCH_PATTERN_STEP *p_step;
+	uint16_t gap_ticks;
+
+	p_pattern->last_touched = channels_touched;
+	p_pattern->quiet_intervals = 0;
+
+	switch (p_pattern->e_state)
+	{
+	case TOUCH_PATTERN_STATE_WAIT_RELEASE:
+		if (channels_touched == 0)
+		{
+			p_pattern->e_state = TOUCH_PATTERN_STATE_IDLE;
+		}
+		break;
+
+	case TOUCH_PATTERN_STATE_IDLE:
+		if (channels_touched == 0)
+		{
+			break;
+		}
+
+		p_step = &p_pattern->steps[p_pattern->step_index];
+		gap_ticks = (elapsed_ticks > TOUCH_PATTERN_MAX_GAP_TICKS) ? TOUCH_PATTERN_MAX_GAP_TICKS : (uint16_t)elapsed_ticks;
+
+		/* Both bounds are always evaluated, the result only accumulates */
+		p_pattern->mismatch |= (uint16_t)(gap_ticks < p_step->min_gap_ticks);
+		p_pattern->mismatch |= (uint16_t)(gap_ticks > p_step->max_gap_ticks);
+
+		p_pattern->chord_touched = channels_touched;
+		p_pattern->e_state = TOUCH_PATTERN_STATE_CHORD;
+		break;
+
+	case TOUCH_PATTERN_STATE_CHORD:
+		p_pattern->chord_touched |= channels_touched;
+
+		if (channels_touched != 0)
+		{
+			break;
+		}
+
+		p_step = &p_pattern->steps[p_pattern->step_index];
+		p_pattern->mismatch |= p_pattern->chord_touched ^ p_step->chord_mask;
+
+		if (++p_pattern->step_index < p_pattern->num_steps)
+		{
+			p_pattern->e_state = TOUCH_PATTERN_STATE_IDLE;
+			break;
+		}
+
+		if (p_pattern->mismatch != 0)
+		{
+			return Touch_Pattern_Fail(p_pattern);
+		}
+
+		p_pattern->failures = 0;
+		p_pattern->e_state = TOUCH_PATTERN_STATE_DONE;
+		return TOUCH_PATTERN_RESULT_ACCEPTED;
+
+	default:
+		/* Touches do not count while locked out or once accepted */
+		break;
+	}
+
+	return TOUCH_PATTERN_RESULT_NONE;
+}
+
+/************************************************************************************
+ * @function 	Touch_Pattern_Timeout_Event
+ * @params 		[in] p_pattern - compiled pattern
+ * @brief 		To be called once per quiet interval, a fixed time without a touch
+ *				event. A started pattern that stalls for
+ *				TOUCH_PATTERN_STEP_TIMEOUT_INTERVALS counts as a failed attempt.
+ *				A lockout runs out after TOUCH_PATTERN_LOCKOUT_INTERVALS, so
+ *				touching the pads during the lockout extends it.
+ ************************************************************************************/
+TOUCH_PATTERN_RESULT Touch_Pattern_Timeout_Event(TOUCH_PATTERN *p_pattern)
+{
+	switch (p_pattern->e_state)
+	{
+	case TOUCH_PATTERN_STATE_LOCKED:
+		if ((p_pattern->num_steps != 0) && (--p_pattern->lockout_intervals == 0))
+		{
+			Touch_Pattern_Restart(p_pattern);
+		}
+		break;
+
+	case TOUCH_PATTERN_STATE_IDLE:
+		if (p_pattern->step_index == 0)
+		{
+			break;
+		}
+		/* no break */
+
+	case TOUCH_PATTERN_STATE_CHORD:
+		if (++p_pattern->quiet_intervals >= TOUCH_PATTERN_STEP_TIMEOUT_INTERVALS)
+		{
+			return Touch_Pattern_Fail(p_pattern);
+		}
+		break;
+
+	default:
+		break;
+	}
+
+	return TOUCH_PATTERN_RESULT_NONE;
+}
+
+/************************************************************************************
+ * @function 	Touch_Pattern_Ms_To_Ticks
+ * @params 		[in] ms - time in milliseconds
+ * @brief 		Converts milliseconds to pattern ticks, saturating at the widest
+ *				window a step can hold.
+ ************************************************************************************/
+static uint16_t Touch_Pattern_Ms_To_Ticks(uint32_t ms)
+{
+	uint32_t ticks = (ms * TOUCH_PATTERN_TICK_HZ) / 1000;
+
+	return (ticks > TOUCH_PATTERN_MAX_GAP_TICKS) ? TOUCH_PATTERN_MAX_GAP_TICKS : (uint16_t)ticks;
+}
+
+/************************************************************************************
+ * @function 	Touch_Pattern_Fail
+ * @params 		[in] p_pattern - compiled pattern
+ * @brief 		Counts a failed attempt. Starts over, or locks the pattern out once
+ *				TOUCH_PATTERN_MAX_FAILURES attempts have failed in a row.
+ ************************************************************************************/
+static TOUCH_PATTERN_RESULT Touch_Pattern_Fail(TOUCH_PATTERN *p_pattern)
+{
+	if (++p_pattern->failures >= TOUCH_PATTERN_MAX_FAILURES)
+	{
+		p_pattern->failures = 0;
+		p_pattern->lockout_intervals = TOUCH_PATTERN_LOCKOUT_INTERVALS;
+		p_pattern->e_state = TOUCH_PATTERN_STATE_LOCKED;
+		return TOUCH_PATTERN_RESULT_LOCKED;
+	}
+
+	Touch_Pattern_Restart(p_pattern);
+
+	return TOUCH_PATTERN_RESULT_REJECTED;
+}
+
+/************************************************************************************
+ * @function 	Touch_Pattern_Restart
+ * @params 		[in] p_pattern - compiled pattern
+ * @brief 		Goes back to the first step, waiting for held pads to be released.
+ ************************************************************************************/
+static void Touch_Pattern_Restart(TOUCH_PATTERN *p_pattern)
+{
+	p_pattern->step_index = 0;
+	p_pattern->chord_touched = 0;
+	p_pattern->mismatch = 0;
+	p_pattern->quiet_intervals = 0;
+
+	if (p_pattern->num_steps == 0)
+	{
+		p_pattern->e_state = TOUCH_PATTERN_STATE_LOCKED;
+	}
+	else
+	{
+		p_pattern->e_state = (p_pattern->last_touched != 0) ? TOUCH_PATTERN_STATE_WAIT_RELEASE : TOUCH_PATTERN_STATE_IDLE;
+	}
+}
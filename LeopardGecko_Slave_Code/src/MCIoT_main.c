@@ -52,6 +52,14 @@
 #include "MCIoT_I2C.h"
 #include "MCIoT_LEUART.h"
 #include "MCIoT_LESENSE_Main.h"
+#include "MCIoT_Calibration.h"
+#if defined(CORE_PROFILE_HOOKS) && (CORE_PROFILE_HOOKS == 1)
+#include "MCIoT_CoreProfile.h"
+#endif
+#ifdef ENABLE_BOOT_TRACE
+#include "em_burtc.h"
+#include "em_rmu.h"
+#endif
 
 /************************************ INCLUDES **************************************/
 
@@ -63,6 +71,10 @@
  ************************************************************************************/
 int main(void)
 {
+#if defined(ENABLE_ADC_MODULE) && defined(USE_CALIBRATION_RECORD)
+	uint16_t temp_raw, vdd_raw;
+#endif
+
 	/* Global Variables Initialization */
 	e_letimer_energy_modes = ENERGY_MODE_EM2;
 
@@ -70,39 +82,96 @@ int main(void)
 	/* Oscillator Ratio (used for self-calibration) */
 	osc_ratio = 0;
 #else
-	osc_ratio = 1;
+	osc_ratio = OSC_RATIO_UNITY;
 #endif
 
-	prescaled_two_power = 0;
-	letimer0_prescaler = 0;
+	BOOT_TRACE(BOOT_STAGE_RESET);
 
 	/* Align different chip revisions */
 	CHIP_Init();
 
-	/* Compute prescalar value if the energy mode is EM 0-2 */
-	if (e_letimer_energy_modes != ENERGY_MODE_EM3)
-	{
-		check_and_comp_prescaler_if(ALS_EXCITE_PERIOD, LFXO_FREQUENCY);
-	}
+#if defined(CORE_PROFILE_HOOKS) && (CORE_PROFILE_HOOKS == 1)
+	/* Starts the cycle counter the profiled sections are timed with */
+	CORE_ProfileReset();
+#endif
+
+	/* The LFXO takes hundreds of ms to start, let it settle while the
+	 * rest of the boot sequence runs */
+	CMU_Consumer_Prepare(CMU_CONSUMER_LESENSE);
+
+	BOOT_TRACE(BOOT_STAGE_CHIP_INIT);
+
+	/* Peripherals on the HF clock tree do not depend on the LFXO */
+	CMU_SetUp_HF_Clocks();
+
+	GPIO_SetUp();
+
+#ifndef USE_ACTIVE_ALS
+	/* Configure ACMP */
+	//	ACMP_SetUp();
+#else
+	I2C_SetUp();
+#endif
 
-	CMU_SetUp();
+#ifdef ENABLE_ADC_MODULE
+	/* ADC SetUp */
+	ADC_SetUp();
+
+#ifdef USE_CALIBRATION_RECORD
+	/* The stored calibration only applies at a similar temperature and supply */
+	ADC_Measure_Temp_Vdd(&temp_raw, &vdd_raw);
+	Calibration_Record_Load(temp_raw, vdd_raw);
+#endif
+#endif
+
+#if defined(USE_DMA_FOR_ADC) || defined(USE_DMA_FOR_LESENSE)
+	/* DMA SetUp */
+	DMA_SetUp();
+#endif
+
+#ifdef ENABLE_ADC_MODULE
+	/* ADC0 keeps its configuration while gated, the LETIMER0 interrupt
+	 * turns the clock back on for each sample */
+	CMU_Consumer_Stop(CMU_CONSUMER_ADC);
+#endif
+
+	BOOT_TRACE(BOOT_STAGE_HF_PERIPHERALS);
 
 	is_lesense_auth_done = false;
 
+	/* LESENSE selects the LFXO for LFA and waits for it to be ready */
 	LESENSE_SetUp();
 
 	if (true == is_lesense_auth_done)
 	{
-		/* Align different chip revisions */
-		CHIP_Init();
+		BOOT_TRACE(BOOT_STAGE_TOUCH_AUTH);
 
-		/* Compute prescalar value if the energy mode is EM 0-2 */
+		/* Apply the compile time prescaler value if the energy mode is EM 0-2 */
 		if (e_letimer_energy_modes != ENERGY_MODE_EM3)
 		{
-			check_and_comp_prescaler_if(ALS_EXCITE_PERIOD, LFXO_FREQUENCY);
+			CMU_Set_LETimer_Prescaler(e_letimer_energy_modes);
 		}
 
-		CMU_SetUp();
+		/* Route the LF clock trees once. In EM0-EM2 LETIMER0 and LEUART0 take
+		 * their own reference on the LFXO before LESENSE releases it. In EM3
+		 * LETIMER0 moves the LFA tree to the ULFRCO, which it can only do once
+		 * LESENSE has released it */
+		if (e_letimer_energy_modes == ENERGY_MODE_EM3)
+		{
+			LESENSE_TearDown();
+
+			CMU_SetUp_LF_Clocks();
+		}
+		else
+		{
+			CMU_SetUp_LF_Clocks();
+
+			LESENSE_TearDown();
+		}
+
+		LESENSE_Save_Calibration();
+
+		BOOT_TRACE(BOOT_STAGE_LF_CLOCKS);
 
 		blockSleepMode(e_letimer_energy_modes);
 
@@ -123,25 +192,6 @@ int main(void)
 
 		LETimer_Config_LETimer(LETIMER0, letimer0_init_params);
 
-		GPIO_SetUp();
-
-#ifndef USE_ACTIVE_ALS
-		/* Configure ACMP */
-		//	ACMP_SetUp();
-#else
-		I2C_SetUp();
-#endif
-
-#ifdef ENABLE_ADC_MODULE
-		/* ADC SetUp */
-		ADC_SetUp();
-#endif
-
-#ifdef USE_DMA_FOR_ADC
-		/* DMA SetUp */
-		DMA_SetUp();
-#endif
-
 #ifdef ENABLE_LEUART_MODULE
 		LEUART_SetUp();
 #endif
@@ -152,6 +202,8 @@ int main(void)
 		/* Enable LETIMER0 interrupt vector in NVIC*/
 		NVIC_EnableIRQ(LETIMER0_IRQn);
 
+		BOOT_TRACE(BOOT_STAGE_LETIMER_STARTED);
+
 		while(1)
 		{
 			Sleep();
@@ -159,6 +211,53 @@ int main(void)
 	}
 }
 
+#ifdef ENABLE_BOOT_TRACE
+/************************************************************************************
+ * @function 	Boot_Trace_Stage
+ * @params 		[in] e_boot_stage - boot stage that has just completed
+ * @brief 		Records the BURTC count the first time a boot stage is reached.
+ *				BOOT_STAGE_RESET starts the BURTC from zero on the LFRCO, which
+ *				no clock consumer uses, so it runs through EM2 and EM3 and the
+ *				stages reached after sleeping get their wall clock time. The
+ *				span to the first sample leaves out the wait for the user to
+ *				complete the touch authentication.
+ ************************************************************************************/
+void Boot_Trace_Stage(BOOT_STAGES e_boot_stage)
+{
+	static const BURTC_Init_TypeDef burtc_init =
+	{
+		.enable			= true,
+		.mode			= burtcModeEM3,		/* Counts in EM0-EM3 */
+		.debugRun		= false,
+		.clkSel			= burtcClkSelLFRCO,
+		.clkDiv			= burtcClkDiv_1,
+		.lowPowerComp	= 0,
+		.timeStamp		= false,
+		.compare0Top	= false,
+		.lowPowerMode	= burtcLPDisable
+	};
+
+	if (e_boot_stage == BOOT_STAGE_RESET)
+	{
+		/* The BURTC is held in reset in the backup domain until released */
+		RMU_ResetControl(rmuResetBU, rmuResetModeClear);
+		CMU_OscillatorEnable(cmuOsc_LFRCO, true, true);
+		BURTC_Init(&burtc_init);
+	}
+
+	if ((e_boot_stage == BOOT_STAGE_RESET) || (boot_trace_ticks[e_boot_stage] == 0))
+	{
+		boot_trace_ticks[e_boot_stage] = BURTC_CounterGet();
+	}
+
+	if ((e_boot_stage == BOOT_STAGE_FIRST_SAMPLE_TX) && (boot_trace_span_ticks == 0))
+	{
+		boot_trace_span_ticks = (boot_trace_ticks[BOOT_STAGE_FIRST_SAMPLE_TX] - boot_trace_ticks[BOOT_STAGE_RESET]) -
+				(boot_trace_ticks[BOOT_STAGE_TOUCH_AUTH] - boot_trace_ticks[BOOT_STAGE_TOUCH_CALIBRATED]);
+	}
+}
+#endif
+
 /* This code is originally copy righted by Silicon Labs and it grants permission
  * to anyone to use this software for any purpose, including commercial applications,
  * and to alter it and redistribute it freely, subject to the following restrictions: